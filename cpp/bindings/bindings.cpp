@@ -3,17 +3,35 @@
 #include <pybind11/functional.h>
 
 #include "common/types.h"
+#include "common/ohlcv_series.h"
+#include "common/ohlcv_columns.h"
+#include "common/rolling_median.h"
+#include "common/bar_resampler.h"
+#include "common/calendar.h"
 #include "collectors/base_collector.h"
 #include "normalizers/data_normalizer.h"
 #include "cleaners/data_cleaner.h"
+#include "pipeline/pipeline.h"
+#include "pipeline/stages.h"
 #include "collectors/binance_collector.h"
 #include "storage/kline_storage.h"
 #include "config/config_manager.h"
 #include "strategy/strategy_base.h"
 #include "strategy/ma_cross_strategy.h"
 #include "backtest/backtest_engine.h"
+#include "backtest/vectorized_backtest.h"
+#include "backtest/result_cache.h"
+#include "backtest/result_sink.h"
+#include "backtest/parameter_optimizer.h"
+#include "backtest/multi_strategy_engine.h"
 #include "analysis/performance_metrics.h"
 #include "analysis/performance_analyzer.h"
+#include "analysis/equity_statistics.h"
+#include "analysis/performance_tracker.h"
+#include "analysis/trade_ledger.h"
+#include "analysis/period_returns.h"
+#include "analysis/drawdown_episodes.h"
+#include "analysis/batch_analyzer.h"
 // #include "common/result.h"
 
 namespace py = pybind11;
@@ -82,6 +100,57 @@ PYBIND11_MODULE(quant_crypto_core, m) {
                    " V:" + std::to_string(ohlcv.volume) + ">";
         });
 
+    // 只读共享K线序列：Python侧构造一次，可传给多个回测引擎而不复制数据
+    py::class_<OHLCVSeries>(m, "OHLCVSeries")
+        .def(py::init<>())
+        .def(py::init([](std::vector<OHLCV> bars) {
+            return OHLCVSeries(std::move(bars));
+        }), "从K线列表构造（只转换一次）", py::arg("bars"))
+        .def("__len__", &OHLCVSeries::size)
+        .def("__getitem__", [](const OHLCVSeries& series, size_t i) {
+            if (i >= series.size()) throw py::index_error();
+            return series[i];
+        })
+        .def("slice", &OHLCVSeries::slice,
+             "获取子区间视图（共享数据）", py::arg("offset"), py::arg("count"));
+
+    // 列式K线：用于批量清洗，每个字段一个数组
+    py::class_<OHLCVColumns>(m, "OHLCVColumns")
+        .def(py::init<>())
+        .def_readwrite("symbol", &OHLCVColumns::symbol)
+        .def_readwrite("exchange", &OHLCVColumns::exchange)
+        .def_readwrite("timeframe", &OHLCVColumns::timeframe)
+        .def_readwrite("timestamp", &OHLCVColumns::timestamp)
+        .def_readwrite("open", &OHLCVColumns::open)
+        .def_readwrite("high", &OHLCVColumns::high)
+        .def_readwrite("low", &OHLCVColumns::low)
+        .def_readwrite("close", &OHLCVColumns::close)
+        .def_readwrite("volume", &OHLCVColumns::volume)
+        .def_readwrite("quote_volume", &OHLCVColumns::quote_volume)
+        .def_readwrite("trades_count", &OHLCVColumns::trades_count)
+        .def_readwrite("quality", &OHLCVColumns::quality)
+        .def("__len__", &OHLCVColumns::size)
+        .def("consistent", &OHLCVColumns::consistent)
+        .def("push_back", &OHLCVColumns::push_back, py::arg("bar"))
+        .def("row", [](const OHLCVColumns& columns, size_t i) {
+            if (!columns.consistent()) throw py::value_error("OHLCVColumns: 各列长度不一致");
+            if (i >= columns.size()) throw py::index_error();
+            return columns.row(i);
+        }, py::arg("index"))
+        .def("to_bars", &OHLCVColumns::to_bars)
+        .def_static("from_bars", &OHLCVColumns::from_bars, py::arg("bars"));
+
+    // 滑动窗口中位数 / MAD（逐笔数据上做稳健统计）
+    py::class_<RollingMedian>(m, "RollingMedian")
+        .def(py::init<size_t>(), py::arg("window"))
+        .def("push", &RollingMedian::push, py::arg("value"))
+        .def("clear", &RollingMedian::clear)
+        .def("median", &RollingMedian::median)
+        .def("mad", &RollingMedian::mad)
+        .def("__len__", &RollingMedian::size)
+        .def_property_readonly("window", &RollingMedian::window)
+        .def_property_readonly("full", &RollingMedian::full);
+
     py::class_<Tick>(m, "Tick")
         .def(py::init<>())
         .def_readwrite("timestamp", &Tick::timestamp)
@@ -131,6 +200,42 @@ PYBIND11_MODULE(quant_crypto_core, m) {
     m.def("string_to_timeframe", &string_to_timeframe, "将字符串转为Timeframe枚举");
     m.def("timeframe_to_milliseconds", &timeframe_to_milliseconds, "获取时间周期的毫秒数");
 
+    // ========== 多周期重采样 ==========
+    py::class_<BarResampler>(m, "BarResampler")
+        .def(py::init<>())
+        .def("subscribe", &BarResampler::subscribe, "订阅周期", py::arg("timeframe"))
+        .def("reset", &BarResampler::reset, "清空正在形成的K线")
+        .def("timeframes", &BarResampler::timeframes)
+        .def("update", [](BarResampler& self, const OHLCV& bar) {
+                 std::vector<std::pair<Timeframe, OHLCV>> closed;
+                 self.update(bar, [&closed](Timeframe timeframe, const OHLCV& out) {
+                     closed.emplace_back(timeframe, out);
+                 });
+                 return closed;
+             },
+             "输入一根基础K线，返回本次收盘的 (周期, K线) 列表", py::arg("bar"))
+        .def("partial", [](const BarResampler& self, Timeframe timeframe) -> py::object {
+                 const OHLCV* bar = self.partial(timeframe);
+                 return bar ? py::cast(*bar) : py::none();
+             },
+             "正在形成的K线（没有时返回None）", py::arg("timeframe"));
+
+    // ========== UTC 日历 ==========
+    py::enum_<calendar::Period>(m, "CalendarPeriod")
+        .value("DAY", calendar::Period::DAY)
+        .value("WEEK", calendar::Period::WEEK)
+        .value("MONTH", calendar::Period::MONTH)
+        .value("YEAR", calendar::Period::YEAR)
+        .export_values();
+
+    m.def("period_bounds", [](calendar::Period period, Timestamp timestamp) {
+              Timestamp start, end;
+              calendar::period_bounds(period, timestamp, start, end);
+              return std::make_pair(start, end);
+          },
+          "时间戳所在日历周期的 (开始, 结束) 时间（UTC）", py::arg("period"), py::arg("timestamp"));
+    m.def("periods_per_year", &calendar::periods_per_year, "K线周期每年的个数", py::arg("timeframe"));
+
     // ========== 数据标准化器 ==========
     py::class_<normalizers::DataNormalizer>(m, "DataNormalizer")
         .def(py::init<>())
@@ -159,12 +264,73 @@ PYBIND11_MODULE(quant_crypto_core, m) {
                    "验证OrderBook数据");
 
     // ========== 数据清洗器 ==========
-    py::class_<cleaners::DataCleaner>(m, "DataCleaner")
+    py::enum_<cleaners::DuplicatePolicy>(m, "DuplicatePolicy")
+        .value("KEEP_FIRST", cleaners::DuplicatePolicy::KEEP_FIRST)
+        .value("KEEP_LAST", cleaners::DuplicatePolicy::KEEP_LAST)
+        .export_values();
+
+    py::enum_<cleaners::FillMethod>(m, "FillMethod")
+        .value("FORWARD", cleaners::FillMethod::FORWARD)
+        .value("BACKWARD", cleaners::FillMethod::BACKWARD)
+        .value("INTERPOLATE", cleaners::FillMethod::INTERPOLATE)
+        .export_values();
+
+    py::class_<cleaners::DataGap>(m, "DataGap")
         .def(py::init<>())
-        .def("clean_ohlcv", &cleaners::DataCleaner::clean_ohlcv,
-             "清洗OHLCV数据")
-        .def("clean_ohlcv_batch", &cleaners::DataCleaner::clean_ohlcv_batch,
-             "批量清洗OHLCV数据")
+        .def_readonly("start", &cleaners::DataGap::start)
+        .def_readonly("end", &cleaners::DataGap::end)
+        .def_readonly("index", &cleaners::DataGap::index)
+        .def_readonly("missing_bars", &cleaners::DataGap::missing_bars)
+        .def_readonly("filled", &cleaners::DataGap::filled)
+        .def("duration_ms", &cleaners::DataGap::duration_ms);
+
+    py::class_<cleaners::GapReport>(m, "GapReport")
+        .def(py::init<>())
+        .def_readonly("gaps", &cleaners::GapReport::gaps)
+        .def_readonly("missing_bars", &cleaners::GapReport::missing_bars)
+        .def_readonly("filled_bars", &cleaners::GapReport::filled_bars)
+        .def_readonly("max_gap_ms", &cleaners::GapReport::max_gap_ms)
+        .def("gap_count", &cleaners::GapReport::gap_count);
+
+    py::class_<cleaners::CleaningContext>(m, "CleaningContext")
+        .def(py::init<>())
+        .def("reset", &cleaners::CleaningContext::reset, "清空历史")
+        .def("size", &cleaners::CleaningContext::size);
+
+    py::class_<cleaners::DataCleaner, std::shared_ptr<cleaners::DataCleaner>>(m, "DataCleaner")
+        .def(py::init<>())
+        .def("clean_ohlcv",
+             py::overload_cast<OHLCV&>(&cleaners::DataCleaner::clean_ohlcv, py::const_),
+             "清洗OHLCV数据（按交易所/交易对/周期使用内部上下文）", py::arg("data"))
+        .def("clean_ohlcv",
+             py::overload_cast<OHLCV&, cleaners::CleaningContext&>(
+                 &cleaners::DataCleaner::clean_ohlcv, py::const_),
+             "使用指定上下文清洗OHLCV数据", py::arg("data"), py::arg("context"))
+        .def("clean_ohlcv_batch",
+             py::overload_cast<const std::vector<OHLCV>&>(
+                 &cleaners::DataCleaner::clean_ohlcv_batch, py::const_),
+             "批量清洗OHLCV数据", py::arg("data_list"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("clean_ohlcv_batch",
+             py::overload_cast<const std::vector<OHLCV>&, cleaners::CleaningContext&>(
+                 &cleaners::DataCleaner::clean_ohlcv_batch, py::const_),
+             "使用指定上下文批量清洗OHLCV数据", py::arg("data_list"), py::arg("context"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("validity_mask", &cleaners::DataCleaner::validity_mask,
+             "计算列式数据的保留掩码（可疑行写入quality）", py::arg("columns"), py::arg("context"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("clean_columns",
+             py::overload_cast<OHLCVColumns&>(&cleaners::DataCleaner::clean_columns, py::const_),
+             "原地清洗列式数据，返回保留的行数", py::arg("columns"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("clean_columns",
+             py::overload_cast<OHLCVColumns&, cleaners::CleaningContext&>(
+                 &cleaners::DataCleaner::clean_columns, py::const_),
+             "使用指定上下文原地清洗列式数据", py::arg("columns"), py::arg("context"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("create_context", &cleaners::DataCleaner::create_context, "创建与当前规则对应的上下文")
+        .def("reset_streams", &cleaners::DataCleaner::reset_streams, "清空内部保存的数据流上下文")
+        .def("stream_count", &cleaners::DataCleaner::stream_count)
         .def("clean_tick", &cleaners::DataCleaner::clean_tick,
              "清洗Tick数据")
         .def("clean_orderbook", &cleaners::DataCleaner::clean_orderbook,
@@ -179,11 +345,35 @@ PYBIND11_MODULE(quant_crypto_core, m) {
                    "检查时间戳连续性",
                    py::arg("current_ts"), py::arg("previous_ts"),
                    py::arg("expected_interval"), py::arg("tolerance") = 1000)
-        .def_static("deduplicate", &cleaners::DataCleaner::deduplicate,
-                   "去除重复数据")
-        .def_static("fill_missing", &cleaners::DataCleaner::fill_missing,
+        .def_static("deduplicate",
+                   py::overload_cast<const std::vector<OHLCV>&, cleaners::DuplicatePolicy>(
+                       &cleaners::DataCleaner::deduplicate),
+                   "去除重复数据（交易所/交易对/时间戳相同）",
+                   py::arg("data_list"), py::arg("policy") = cleaners::DuplicatePolicy::KEEP_FIRST,
+                   py::call_guard<py::gil_scoped_release>())
+        .def_static("fill_missing",
+                   py::overload_cast<const std::vector<OHLCV>&, Timeframe, const std::string&>(
+                       &cleaners::DataCleaner::fill_missing),
                    "填补缺失数据",
-                   py::arg("data_list"), py::arg("timeframe"), py::arg("method") = "forward");
+                   py::arg("data_list"), py::arg("timeframe"), py::arg("method") = "forward")
+        .def_static("fill_missing_with_report",
+                   [](const std::vector<OHLCV>& data_list, Timeframe timeframe,
+                      cleaners::FillMethod method, size_t max_gap_bars) {
+                       cleaners::GapReport report;
+                       std::vector<OHLCV> result;
+                       {
+                           py::gil_scoped_release release;
+                           result = cleaners::DataCleaner::fill_missing(
+                               data_list, timeframe, method, &report, max_gap_bars);
+                       }
+                       return py::make_tuple(result, report);
+                   },
+                   "填补缺失数据，返回 (数据, 缺口报告)",
+                   py::arg("data_list"), py::arg("timeframe"),
+                   py::arg("method") = cleaners::FillMethod::FORWARD, py::arg("max_gap_bars") = 0)
+        .def_static("find_gaps", &cleaners::DataCleaner::find_gaps,
+                   "检测缺失数据的缺口",
+                   py::arg("data_list"), py::arg("timeframe"), py::arg("max_gap_bars") = 0);
 
     py::class_<config::BinanceConfig>(m, "BinanceConfig")
         .def(py::init<>())
@@ -262,13 +452,50 @@ PYBIND11_MODULE(quant_crypto_core, m) {
         .def_readwrite("quantity", &strategy::Trade::quantity)
         .def_readwrite("pnl", &strategy::Trade::pnl);
 
+    py::enum_<strategy::OrderStatus>(m, "OrderStatus")
+        .value("PENDING", strategy::OrderStatus::PENDING)
+        .value("FILLED", strategy::OrderStatus::FILLED)
+        .value("CANCELLED", strategy::OrderStatus::CANCELLED)
+        .value("REJECTED", strategy::OrderStatus::REJECTED)
+        .export_values();
+
+    py::class_<strategy::Order>(m, "Order")
+        .def(py::init<>())
+        .def_readwrite("id", &strategy::Order::id)
+        .def_readwrite("side", &strategy::Order::side)
+        .def_readwrite("type", &strategy::Order::type)
+        .def_readwrite("price", &strategy::Order::price)
+        .def_readwrite("stop_price", &strategy::Order::stop_price)
+        .def_readwrite("quantity", &strategy::Order::quantity)
+        .def_readwrite("oco_group", &strategy::Order::oco_group)
+        .def_readwrite("status", &strategy::Order::status)
+        .def_readwrite("triggered", &strategy::Order::triggered)
+        .def_readwrite("created_at", &strategy::Order::created_at)
+        .def_readwrite("filled_at", &strategy::Order::filled_at)
+        .def_readwrite("fill_price", &strategy::Order::fill_price);
+
     // 先绑定基类 StrategyBase
     py::class_<strategy::StrategyBase>(m, "StrategyBase")
         .def("on_init", &strategy::StrategyBase::on_init)
         .def("get_capital", &strategy::StrategyBase::get_capital)
         .def("get_total_equity", &strategy::StrategyBase::get_total_equity)
         .def("get_total_return", &strategy::StrategyBase::get_total_return)
-        .def("get_position", &strategy::StrategyBase::get_position);
+        .def("get_position", &strategy::StrategyBase::get_position)
+        .def("submit_order", &strategy::StrategyBase::submit_order,
+             "提交订单（下一根Bar开始撮合）",
+             py::arg("side"), py::arg("type"), py::arg("quantity") = 0.0,
+             py::arg("price") = 0.0, py::arg("stop_price") = 0.0, py::arg("oco_group") = 0)
+        .def("buy_limit", &strategy::StrategyBase::buy_limit,
+             py::arg("price"), py::arg("quantity") = 0.0)
+        .def("buy_stop", &strategy::StrategyBase::buy_stop,
+             py::arg("stop_price"), py::arg("quantity") = 0.0)
+        .def("stop_loss", &strategy::StrategyBase::stop_loss,
+             py::arg("stop_price"), py::arg("oco_group") = 0)
+        .def("take_profit", &strategy::StrategyBase::take_profit,
+             py::arg("price"), py::arg("oco_group") = 0)
+        .def("cancel_order", &strategy::StrategyBase::cancel_order, py::arg("id"))
+        .def("subscribe_timeframe", &strategy::StrategyBase::subscribe_timeframe, py::arg("timeframe"))
+        .def("subscribed_timeframes", &strategy::StrategyBase::subscribed_timeframes);
 
     py::class_<strategy::MACrossConfig>(m, "MACrossConfig")
         .def(py::init<>())
@@ -287,11 +514,63 @@ PYBIND11_MODULE(quant_crypto_core, m) {
         .def("get_slow_ma", &strategy::MACrossStrategy::get_slow_ma);
 
     // ========== 回测模块 ==========
+    py::enum_<backtest::EquityRecordMode>(m, "EquityRecordMode")
+        .value("FULL", backtest::EquityRecordMode::FULL)
+        .value("EVERY_N_BARS", backtest::EquityRecordMode::EVERY_N_BARS)
+        .value("ON_CHANGE", backtest::EquityRecordMode::ON_CHANGE)
+        .value("NONE", backtest::EquityRecordMode::NONE)
+        .export_values();
+
+    py::class_<backtest::StopConditions>(m, "StopConditions")
+        .def(py::init<>())
+        .def_readwrite("max_drawdown", &backtest::StopConditions::max_drawdown)
+        .def_readwrite("equity_floor", &backtest::StopConditions::equity_floor)
+        .def_readwrite("min_trades", &backtest::StopConditions::min_trades)
+        .def_readwrite("min_trades_bars", &backtest::StopConditions::min_trades_bars);
+
+    py::enum_<backtest::StopReason>(m, "StopReason")
+        .value("NONE", backtest::StopReason::NONE)
+        .value("MAX_DRAWDOWN", backtest::StopReason::MAX_DRAWDOWN)
+        .value("EQUITY_FLOOR", backtest::StopReason::EQUITY_FLOOR)
+        .value("MIN_TRADES", backtest::StopReason::MIN_TRADES)
+        .export_values();
+
+    py::class_<backtest::LatencyConfig>(m, "LatencyConfig")
+        .def(py::init<>())
+        .def_readwrite("fixed_ms", &backtest::LatencyConfig::fixed_ms)
+        .def_readwrite("jitter_ms", &backtest::LatencyConfig::jitter_ms)
+        .def_readwrite("samples_ms", &backtest::LatencyConfig::samples_ms)
+        .def_readwrite("seed", &backtest::LatencyConfig::seed)
+        .def("enabled", &backtest::LatencyConfig::enabled);
+
     py::class_<backtest::BacktestConfig>(m, "BacktestConfig")
         .def(py::init<>())
         .def_readwrite("initial_capital", &backtest::BacktestConfig::initial_capital)
         .def_readwrite("commission_rate", &backtest::BacktestConfig::commission_rate)
-        .def_readwrite("slippage_rate", &backtest::BacktestConfig::slippage_rate);
+        .def_readwrite("slippage_rate", &backtest::BacktestConfig::slippage_rate)
+        .def_readwrite("position_size", &backtest::BacktestConfig::position_size)
+        .def_readwrite("record_mode", &backtest::BacktestConfig::record_mode)
+        .def_readwrite("record_interval", &backtest::BacktestConfig::record_interval)
+        .def_readwrite("stop", &backtest::BacktestConfig::stop)
+        .def_readwrite("latency", &backtest::BacktestConfig::latency);
+
+    py::class_<analysis::EquityStatistics>(m, "EquityStatistics")
+        .def(py::init<>())
+        .def("update", &analysis::EquityStatistics::update,
+             "追加一个权益点", py::arg("timestamp"), py::arg("equity"))
+        .def("reset", &analysis::EquityStatistics::reset)
+        .def_property_readonly("count", &analysis::EquityStatistics::count)
+        .def_property_readonly("first_timestamp", &analysis::EquityStatistics::first_timestamp)
+        .def_property_readonly("last_timestamp", &analysis::EquityStatistics::last_timestamp)
+        .def_property_readonly("last_equity", &analysis::EquityStatistics::last_equity)
+        .def_property_readonly("peak", &analysis::EquityStatistics::peak)
+        .def_property_readonly("max_drawdown", &analysis::EquityStatistics::max_drawdown)
+        .def_property_readonly("current_drawdown", &analysis::EquityStatistics::current_drawdown)
+        .def_property_readonly("mean_return", &analysis::EquityStatistics::mean_return)
+        .def_property_readonly("volatility", &analysis::EquityStatistics::volatility)
+        .def_property_readonly("downside_deviation", &analysis::EquityStatistics::downside_deviation)
+        .def_property_readonly("sharpe_ratio", &analysis::EquityStatistics::sharpe_ratio)
+        .def_property_readonly("sortino_ratio", &analysis::EquityStatistics::sortino_ratio);
 
     py::class_<backtest::BacktestResult>(m, "BacktestResult")
         .def(py::init<>())
@@ -304,21 +583,275 @@ PYBIND11_MODULE(quant_crypto_core, m) {
         .def_readwrite("losing_trades", &backtest::BacktestResult::losing_trades)
         .def_readwrite("trades", &backtest::BacktestResult::trades)
         .def_readwrite("equity_curve", &backtest::BacktestResult::equity_curve)
-        .def_readwrite("timestamps", &backtest::BacktestResult::timestamps);
+        .def_readwrite("timestamps", &backtest::BacktestResult::timestamps)
+        .def_readwrite("record_mode", &backtest::BacktestResult::record_mode)
+        .def_readwrite("equity_stats", &backtest::BacktestResult::equity_stats)
+        .def_readwrite("stop_reason", &backtest::BacktestResult::stop_reason)
+        .def_readwrite("stopped_at", &backtest::BacktestResult::stopped_at);
+
+    py::class_<backtest::ResultSink>(m, "ResultSink");
+
+    py::class_<backtest::BinaryResultWriter, backtest::ResultSink>(m, "BinaryResultWriter")
+        .def(py::init<const std::string&, size_t>(),
+             "构造函数", py::arg("path"), py::arg("buffer_bytes") = 1 << 20)
+        .def("is_open", &backtest::BinaryResultWriter::is_open)
+        .def("flush", &backtest::BinaryResultWriter::flush)
+        .def("close", &backtest::BinaryResultWriter::close)
+        .def_property_readonly("equity_count", &backtest::BinaryResultWriter::equity_count)
+        .def_property_readonly("trade_count", &backtest::BinaryResultWriter::trade_count);
+
+    py::class_<backtest::BacktestCheckpoint, std::shared_ptr<backtest::BacktestCheckpoint>>(m, "BacktestCheckpoint")
+        .def_readonly("result", &backtest::BacktestCheckpoint::result)
+        .def_readonly("last_timestamp", &backtest::BacktestCheckpoint::last_timestamp)
+        .def_readonly("bars_processed", &backtest::BacktestCheckpoint::bars_processed);
 
     py::class_<backtest::BacktestEngine>(m, "BacktestEngine")
         .def(py::init<const backtest::BacktestConfig&>(),
              "构造函数", py::arg("config"))
         .def("set_strategy", &backtest::BacktestEngine::set_strategy,
              "设置策略", py::arg("strategy"))
-        .def("set_data", &backtest::BacktestEngine::set_data,
+        .def("set_data", py::overload_cast<OHLCVSeries>(&backtest::BacktestEngine::set_data),
+             "设置共享数据（无拷贝）", py::arg("data"))
+        .def("set_data", [](backtest::BacktestEngine& engine, std::vector<OHLCV> data) {
+                 engine.set_data(std::move(data));
+             },
              "设置数据", py::arg("data"))
         .def("run", &backtest::BacktestEngine::run,
-             "运行回测")
+             "运行回测", py::call_guard<py::gil_scoped_release>())
+        .def("resume", &backtest::BacktestEngine::resume,
+             "增量回测（只处理新K线）", py::arg("new_bars"), py::call_guard<py::gil_scoped_release>())
+        .def("resume", [](backtest::BacktestEngine& engine, const std::vector<OHLCV>& new_bars) {
+                 OHLCVSeries series(new_bars);
+                 py::gil_scoped_release release;
+                 engine.resume(series);
+             },
+             "增量回测（只处理新K线）", py::arg("new_bars"))
+        .def("checkpoint", &backtest::BacktestEngine::checkpoint, "保存断点")
+        .def("restore", &backtest::BacktestEngine::restore, "从断点恢复", py::arg("checkpoint"))
+        .def("get_strategy", &backtest::BacktestEngine::get_strategy,
+             "当前使用的策略", py::return_value_policy::reference_internal)
+        .def_property_readonly("bars_processed", &backtest::BacktestEngine::bars_processed)
+        .def("set_sink", &backtest::BacktestEngine::set_sink,
+             "设置流式输出（None取消）", py::arg("sink"), py::keep_alive<1, 2>())
         .def("get_result", &backtest::BacktestEngine::get_result,
-             "获取回测结果");
+             "获取回测结果（引用，不复制）", py::return_value_policy::reference_internal)
+        .def("take_result", &backtest::BacktestEngine::take_result,
+             "移出回测结果");
+
+    py::class_<backtest::MultiStrategyEngine>(m, "MultiStrategyEngine")
+        .def(py::init<const backtest::BacktestConfig&>(),
+             "构造函数", py::arg("config"))
+        .def("add_strategy",
+             py::overload_cast<strategy::StrategyBase*>(&backtest::MultiStrategyEngine::add_strategy),
+             "添加策略", py::arg("strategy"), py::keep_alive<1, 2>())
+        .def("add_strategy",
+             py::overload_cast<strategy::StrategyBase*, const backtest::BacktestConfig&>(
+                 &backtest::MultiStrategyEngine::add_strategy),
+             "添加策略（单独的回测配置）", py::arg("strategy"), py::arg("config"), py::keep_alive<1, 2>())
+        .def("set_data", &backtest::MultiStrategyEngine::set_data, "设置数据", py::arg("data"))
+        .def("run", &backtest::MultiStrategyEngine::run,
+             "一次遍历数据运行全部策略", py::call_guard<py::gil_scoped_release>())
+        .def("size", &backtest::MultiStrategyEngine::size)
+        .def("get_result", &backtest::MultiStrategyEngine::get_result,
+             "获取第index个策略的结果", py::arg("index"), py::return_value_policy::reference_internal)
+        .def("take_results", &backtest::MultiStrategyEngine::take_results, "移出全部结果");
+
+    py::class_<backtest::VectorizedBacktest>(m, "VectorizedBacktest")
+        .def(py::init<const backtest::BacktestConfig&>(),
+             "构造函数", py::arg("config"))
+        .def("run", py::overload_cast<const std::vector<double>&, const std::vector<double>&,
+                                      const std::vector<Timestamp>&, const std::string&>(
+                 &backtest::VectorizedBacktest::run, py::const_),
+             "按收盘价与目标持仓数组回测",
+             py::arg("closes"), py::arg("target_positions"), py::arg("timestamps"),
+             py::arg("symbol") = "", py::call_guard<py::gil_scoped_release>())
+        .def("run", py::overload_cast<const OHLCVSeries&, const std::vector<double>&>(
+                 &backtest::VectorizedBacktest::run, py::const_),
+             "按K线序列与目标持仓数组回测",
+             py::arg("data"), py::arg("target_positions"),
+             py::call_guard<py::gil_scoped_release>());
+
+    // ========== 参数优化 ==========
+    py::class_<backtest::HalvingOptions>(m, "HalvingOptions")
+        .def(py::init<>())
+        .def_readwrite("initial_fraction", &backtest::HalvingOptions::initial_fraction)
+        .def_readwrite("keep_fraction", &backtest::HalvingOptions::keep_fraction)
+        .def_readwrite("min_survivors", &backtest::HalvingOptions::min_survivors)
+        .def_readwrite("threads", &backtest::HalvingOptions::threads);
+
+    py::class_<backtest::OptimizationResult>(m, "OptimizationResult")
+        .def_readonly("params", &backtest::OptimizationResult::params)
+        .def_readonly("score", &backtest::OptimizationResult::score)
+        .def_readonly("rounds_survived", &backtest::OptimizationResult::rounds_survived)
+        .def_readonly("bars_processed", &backtest::OptimizationResult::bars_processed)
+        .def_readonly("stop_reason", &backtest::OptimizationResult::stop_reason)
+        .def_readonly("final_equity", &backtest::OptimizationResult::final_equity)
+        .def_readonly("total_return", &backtest::OptimizationResult::total_return)
+        .def_readonly("total_trades", &backtest::OptimizationResult::total_trades)
+        .def_readonly("max_drawdown", &backtest::OptimizationResult::max_drawdown)
+        .def_readonly("sharpe_ratio", &backtest::OptimizationResult::sharpe_ratio);
+
+    // Python 侧目前只支持内置策略（按名称选择工厂）
+    py::class_<backtest::SuccessiveHalvingOptimizer>(m, "SuccessiveHalvingOptimizer")
+        .def(py::init([](const std::string& strategy_name, const backtest::BacktestConfig& config,
+                         const backtest::HalvingOptions& options) {
+                 if (strategy_name != "ma_cross") {
+                     throw std::invalid_argument("不支持的策略: " + strategy_name);
+                 }
+                 return backtest::SuccessiveHalvingOptimizer(
+                     backtest::SuccessiveHalvingOptimizer::ma_cross_factory(), config, options);
+             }),
+             "构造函数", py::arg("strategy_name"), py::arg("config"),
+             py::arg("options") = backtest::HalvingOptions())
+        .def("set_score_function", &backtest::SuccessiveHalvingOptimizer::set_score_function,
+             "设置评分函数（参数为 BacktestResult）", py::arg("score"))
+        .def("run", &backtest::SuccessiveHalvingOptimizer::run,
+             "运行逐级减半优化", py::arg("data"), py::arg("candidates"),
+             py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("last_bars_processed",
+                               &backtest::SuccessiveHalvingOptimizer::last_bars_processed);
+
+    // ========== 回测结果缓存 ==========
+    py::class_<backtest::BacktestCacheKey>(m, "BacktestCacheKey")
+        .def(py::init<>())
+        .def_readwrite("data_hash", &backtest::BacktestCacheKey::data_hash)
+        .def_readwrite("bar_count", &backtest::BacktestCacheKey::bar_count)
+        .def_readwrite("params_hash", &backtest::BacktestCacheKey::params_hash)
+        .def("__str__", &backtest::BacktestCacheKey::to_string);
+
+    py::class_<backtest::CacheStats>(m, "CacheStats")
+        .def_readonly("hits", &backtest::CacheStats::hits)
+        .def_readonly("disk_hits", &backtest::CacheStats::disk_hits)
+        .def_readonly("misses", &backtest::CacheStats::misses)
+        .def_readonly("evictions", &backtest::CacheStats::evictions)
+        .def_readonly("spills", &backtest::CacheStats::spills);
+
+    // 缓存条目只读共享（Python侧持有引用计数，不复制结果）
+    py::class_<backtest::CachedBacktest, std::shared_ptr<backtest::CachedBacktest>>(m, "CachedBacktest")
+        .def_readonly("key", &backtest::CachedBacktest::key)
+        .def_readonly("result", &backtest::CachedBacktest::result)
+        .def_readonly("metrics", &backtest::CachedBacktest::metrics);
+
+    py::class_<backtest::BacktestResultCache>(m, "BacktestResultCache")
+        .def(py::init<size_t, const std::string&>(),
+             "构造函数", py::arg("capacity") = 64, py::arg("spill_dir") = "")
+        .def_static("make_key", &backtest::BacktestResultCache::make_key,
+             "生成缓存键", py::arg("data"), py::arg("strategy_name"), py::arg("params"), py::arg("config"))
+        .def_static("make_key", [](const std::vector<OHLCV>& data, const std::string& strategy_name,
+                                   const std::map<std::string, double>& params,
+                                   const backtest::BacktestConfig& config) {
+                 backtest::BacktestCacheKey key;
+                 key.data_hash = backtest::BacktestResultCache::hash_data(data);
+                 key.bar_count = data.size();
+                 key.params_hash = backtest::BacktestResultCache::hash_params(strategy_name, params, config);
+                 return key;
+             },
+             "生成缓存键", py::arg("data"), py::arg("strategy_name"), py::arg("params"), py::arg("config"))
+        .def("find", [](backtest::BacktestResultCache& cache, const backtest::BacktestCacheKey& key) {
+                 return std::const_pointer_cast<backtest::CachedBacktest>(cache.find(key));
+             },
+             "精确查找（未命中返回None）", py::arg("key"))
+        .def("put", [](backtest::BacktestResultCache& cache, const backtest::BacktestCacheKey& key,
+                       const backtest::BacktestResult& result, const analysis::PerformanceMetrics& metrics) {
+                 return std::const_pointer_cast<backtest::CachedBacktest>(cache.put(key, result, metrics));
+             },
+             "写入缓存", py::arg("key"), py::arg("result"), py::arg("metrics"))
+        .def("clear", &backtest::BacktestResultCache::clear)
+        .def("__len__", &backtest::BacktestResultCache::size)
+        .def_property_readonly("stats", &backtest::BacktestResultCache::stats);
 
     // ========== 性能分析模块 ==========
+    py::class_<analysis::RollingMetrics>(m, "RollingMetrics")
+        .def(py::init<>())
+        .def_readonly("window_bars", &analysis::RollingMetrics::window_bars)
+        .def_readonly("window_ms", &analysis::RollingMetrics::window_ms)
+        .def_readonly("timestamps", &analysis::RollingMetrics::timestamps)
+        .def_readonly("mean_return", &analysis::RollingMetrics::mean_return)
+        .def_readonly("volatility", &analysis::RollingMetrics::volatility)
+        .def_readonly("sharpe_ratio", &analysis::RollingMetrics::sharpe_ratio)
+        .def_readonly("sortino_ratio", &analysis::RollingMetrics::sortino_ratio)
+        .def_readonly("drawdown", &analysis::RollingMetrics::drawdown)
+        .def("size", &analysis::RollingMetrics::size);
+
+    m.def("compute_rolling_metrics",
+          [](const std::vector<double>& equity_curve, const std::vector<Timestamp>& timestamps,
+             size_t window_bars, int64_t window_ms) {
+              if (equity_curve.size() != timestamps.size()) {
+                  throw std::invalid_argument("equity_curve 与 timestamps 长度不一致");
+              }
+              return analysis::compute_rolling_metrics(equity_curve.data(), timestamps.data(),
+                                                       equity_curve.size(), window_bars, window_ms);
+          },
+          "计算滚动窗口指标（按点数或时长）",
+          py::arg("equity_curve"), py::arg("timestamps"),
+          py::arg("window_bars") = 0, py::arg("window_ms") = 0);
+
+    py::class_<analysis::PeriodReturns>(m, "PeriodReturns")
+        .def(py::init<>())
+        .def_readonly("period", &analysis::PeriodReturns::period)
+        .def_readonly("start", &analysis::PeriodReturns::start)
+        .def_readonly("open_equity", &analysis::PeriodReturns::open_equity)
+        .def_readonly("close_equity", &analysis::PeriodReturns::close_equity)
+        .def_readonly("returns", &analysis::PeriodReturns::returns)
+        .def("size", &analysis::PeriodReturns::size);
+
+    m.def("compute_period_returns",
+          [](const std::vector<double>& equity_curve, const std::vector<Timestamp>& timestamps,
+             calendar::Period period) {
+              if (equity_curve.size() != timestamps.size()) {
+                  throw std::invalid_argument("equity_curve 与 timestamps 长度不一致");
+              }
+              return analysis::compute_period_returns(equity_curve.data(), timestamps.data(),
+                                                      equity_curve.size(), period);
+          },
+          "按 UTC 日/周/月/年计算周期收益表",
+          py::arg("equity_curve"), py::arg("timestamps"), py::arg("period"));
+
+    py::class_<analysis::DrawdownEpisode>(m, "DrawdownEpisode")
+        .def(py::init<>())
+        .def_readonly("start_time", &analysis::DrawdownEpisode::start_time)
+        .def_readonly("trough_time", &analysis::DrawdownEpisode::trough_time)
+        .def_readonly("end_time", &analysis::DrawdownEpisode::end_time)
+        .def_readonly("start_index", &analysis::DrawdownEpisode::start_index)
+        .def_readonly("trough_index", &analysis::DrawdownEpisode::trough_index)
+        .def_readonly("end_index", &analysis::DrawdownEpisode::end_index)
+        .def_readonly("peak_equity", &analysis::DrawdownEpisode::peak_equity)
+        .def_readonly("trough_equity", &analysis::DrawdownEpisode::trough_equity)
+        .def_readonly("depth", &analysis::DrawdownEpisode::depth)
+        .def_readonly("recovered", &analysis::DrawdownEpisode::recovered)
+        .def_property_readonly("duration_ms", &analysis::DrawdownEpisode::duration_ms)
+        .def_property_readonly("decline_ms", &analysis::DrawdownEpisode::decline_ms)
+        .def_property_readonly("recovery_ms", &analysis::DrawdownEpisode::recovery_ms)
+        .def("__repr__", [](const analysis::DrawdownEpisode& e) {
+            return "<DrawdownEpisode start=" + std::to_string(e.start_time) +
+                   " depth=" + std::to_string(e.depth) +
+                   " recovered=" + (e.recovered ? "True" : "False") + ">";
+        });
+
+    py::class_<analysis::DrawdownReport>(m, "DrawdownReport")
+        .def(py::init<>())
+        .def_readonly("episodes", &analysis::DrawdownReport::episodes)
+        .def_readonly("episode_count", &analysis::DrawdownReport::episode_count)
+        .def_readonly("max_duration_ms", &analysis::DrawdownReport::max_duration_ms)
+        .def_readonly("avg_duration_ms", &analysis::DrawdownReport::avg_duration_ms)
+        .def_readonly("max_recovery_ms", &analysis::DrawdownReport::max_recovery_ms)
+        .def_readonly("avg_depth", &analysis::DrawdownReport::avg_depth)
+        .def_readonly("under_water_ms", &analysis::DrawdownReport::under_water_ms)
+        .def_readonly("total_ms", &analysis::DrawdownReport::total_ms)
+        .def_property_readonly("under_water_ratio", &analysis::DrawdownReport::under_water_ratio);
+
+    m.def("compute_drawdown_episodes",
+          [](const std::vector<double>& equity_curve, const std::vector<Timestamp>& timestamps,
+             double min_depth) {
+              if (equity_curve.size() != timestamps.size()) {
+                  throw std::invalid_argument("equity_curve 与 timestamps 长度不一致");
+              }
+              return analysis::compute_drawdown_episodes(equity_curve.data(), timestamps.data(),
+                                                         equity_curve.size(), min_depth);
+          },
+          "计算回撤区间与水下时间",
+          py::arg("equity_curve"), py::arg("timestamps"), py::arg("min_depth") = 0.0);
+
     py::class_<analysis::PerformanceMetrics>(m, "PerformanceMetrics")
         .def(py::init<>())
         .def_readwrite("annualized_return", &analysis::PerformanceMetrics::annualized_return)
@@ -330,21 +863,265 @@ PYBIND11_MODULE(quant_crypto_core, m) {
         .def_readwrite("calmar_ratio", &analysis::PerformanceMetrics::calmar_ratio)
         .def_readwrite("volatility", &analysis::PerformanceMetrics::volatility)
         .def_readwrite("downside_deviation", &analysis::PerformanceMetrics::downside_deviation)
+        .def_readwrite("periods_per_year", &analysis::PerformanceMetrics::periods_per_year)
         .def_readwrite("profit_loss_ratio", &analysis::PerformanceMetrics::profit_loss_ratio)
         .def_readwrite("max_consecutive_wins", &analysis::PerformanceMetrics::max_consecutive_wins)
         .def_readwrite("max_consecutive_losses", &analysis::PerformanceMetrics::max_consecutive_losses)
         .def_readwrite("avg_holding_period", &analysis::PerformanceMetrics::avg_holding_period)
         .def_readwrite("trade_frequency_per_year", &analysis::PerformanceMetrics::trade_frequency_per_year)
-        .def_readwrite("drawdown_curve", &analysis::PerformanceMetrics::drawdown_curve);
+        .def_readwrite("drawdown_curve", &analysis::PerformanceMetrics::drawdown_curve)
+        .def_readwrite("drawdowns", &analysis::PerformanceMetrics::drawdowns)
+        .def_readwrite("daily_returns", &analysis::PerformanceMetrics::daily_returns)
+        .def_readwrite("weekly_returns", &analysis::PerformanceMetrics::weekly_returns)
+        .def_readwrite("monthly_returns", &analysis::PerformanceMetrics::monthly_returns)
+        .def_readwrite("rolling", &analysis::PerformanceMetrics::rolling);
+
+    py::class_<analysis::AnalyzeOptions>(m, "AnalyzeOptions")
+        .def(py::init<>())
+        .def_readwrite("keep_equity_curve", &analysis::AnalyzeOptions::keep_equity_curve)
+        .def_readwrite("keep_drawdown_curve", &analysis::AnalyzeOptions::keep_drawdown_curve)
+        .def_readwrite("keep_period_returns", &analysis::AnalyzeOptions::keep_period_returns)
+        .def_readwrite("keep_drawdown_episodes", &analysis::AnalyzeOptions::keep_drawdown_episodes)
+        .def_readwrite("min_drawdown_depth", &analysis::AnalyzeOptions::min_drawdown_depth)
+        .def_readwrite("periods_per_year", &analysis::AnalyzeOptions::periods_per_year)
+        .def_readwrite("rolling_window_bars", &analysis::AnalyzeOptions::rolling_window_bars)
+        .def_readwrite("rolling_window_ms", &analysis::AnalyzeOptions::rolling_window_ms);
 
     py::class_<analysis::PerformanceAnalyzer>(m, "PerformanceAnalyzer")
         .def(py::init<>())
-        .def("analyze", &analysis::PerformanceAnalyzer::analyze,
+        .def("analyze",
+             py::overload_cast<const std::vector<double>&,
+                               const std::vector<Timestamp>&,
+                               const std::vector<strategy::Trade>&,
+                               double,
+                               const analysis::AnalyzeOptions&>(&analysis::PerformanceAnalyzer::analyze),
              "分析回测结果",
              py::arg("equity_curve"),
              py::arg("timestamps"),
              py::arg("trades"),
-             py::arg("initial_captial"));
+             py::arg("initial_captial"),
+             py::arg("options") = analysis::AnalyzeOptions())
+        .def("analyze",
+             py::overload_cast<const backtest::BacktestResult&, const analysis::AnalyzeOptions&>(
+                 &analysis::PerformanceAnalyzer::analyze),
+             "直接分析回测结果（支持任意权益曲线记录模式）",
+             py::arg("result"), py::arg("options") = analysis::AnalyzeOptions())
+        .def("analyze_stream", &analysis::PerformanceAnalyzer::analyze_stream,
+             "分析流式结果文件（单次顺序读取）",
+             py::arg("path"), py::arg("options") = analysis::AnalyzeOptions(),
+             py::call_guard<py::gil_scoped_release>());
+
+    // ========== 批量分析 ==========
+    py::enum_<analysis::Metric>(m, "Metric")
+        .value("ANNUALIZED_RETURN", analysis::Metric::ANNUALIZED_RETURN)
+        .value("CUMULATIVE_RETURN", analysis::Metric::CUMULATIVE_RETURN)
+        .value("MAX_DRAWDOWN", analysis::Metric::MAX_DRAWDOWN)
+        .value("SHARPE_RATIO", analysis::Metric::SHARPE_RATIO)
+        .value("SORTINO_RATIO", analysis::Metric::SORTINO_RATIO)
+        .value("CALMAR_RATIO", analysis::Metric::CALMAR_RATIO)
+        .value("VOLATILITY", analysis::Metric::VOLATILITY)
+        .value("DOWNSIDE_DEVIATION", analysis::Metric::DOWNSIDE_DEVIATION)
+        .value("PROFIT_LOSS_RATIO", analysis::Metric::PROFIT_LOSS_RATIO)
+        .value("MAX_CONSECUTIVE_WINS", analysis::Metric::MAX_CONSECUTIVE_WINS)
+        .value("MAX_CONSECUTIVE_LOSSES", analysis::Metric::MAX_CONSECUTIVE_LOSSES)
+        .value("AVG_HOLDING_PERIOD", analysis::Metric::AVG_HOLDING_PERIOD)
+        .value("TRADE_FREQUENCY", analysis::Metric::TRADE_FREQUENCY)
+        .value("MAX_DRAWDOWN_DAYS", analysis::Metric::MAX_DRAWDOWN_DAYS)
+        .value("UNDER_WATER_RATIO", analysis::Metric::UNDER_WATER_RATIO)
+        .export_values();
+
+    py::class_<analysis::MetricsTable>(m, "MetricsTable")
+        .def(py::init<size_t>(), py::arg("rows") = 0)
+        .def("size", &analysis::MetricsTable::size)
+        .def("__len__", &analysis::MetricsTable::size)
+        .def("column", [](const analysis::MetricsTable& self, analysis::Metric metric) {
+                 return self.column(metric);
+             },
+             "指标列", py::arg("metric"))
+        .def("column", [](const analysis::MetricsTable& self, const std::string& name) {
+                 return self.column(analysis::MetricsTable::metric_from_string(name));
+             },
+             "按名称取指标列", py::arg("name"))
+        .def("to_dict", [](const analysis::MetricsTable& self) {
+                 py::dict columns;
+                 for (size_t i = 0; i < analysis::METRIC_COUNT; i++) {
+                     auto metric = static_cast<analysis::Metric>(i);
+                     columns[py::str(analysis::MetricsTable::metric_name(metric))] = self.column(metric);
+                 }
+                 return columns;
+             },
+             "{指标名: 列} 字典（可直接构造 DataFrame）")
+        .def("top_k", &analysis::MetricsTable::top_k,
+             "按指标取前k行的行号（部分排序）",
+             py::arg("metric"), py::arg("k"), py::arg("descending") = true)
+        .def("argsort", &analysis::MetricsTable::argsort,
+             "全部行号按指标排序", py::arg("metric"), py::arg("descending") = true)
+        .def("filter", &analysis::MetricsTable::filter,
+             "指标在 [min_value, max_value] 内的行号",
+             py::arg("metric"), py::arg("min_value"), py::arg("max_value"))
+        .def("select", &analysis::MetricsTable::select, "按行号生成子表", py::arg("rows"))
+        .def_static("metric_name", &analysis::MetricsTable::metric_name)
+        .def_static("metric_from_string", &analysis::MetricsTable::metric_from_string);
+
+    py::class_<analysis::BatchAnalyzer>(m, "BatchAnalyzer")
+        .def(py::init<size_t, const analysis::AnalyzeOptions&>(),
+             py::arg("threads") = 0, py::arg("options") = analysis::BatchAnalyzer::default_options())
+        .def_static("default_options", &analysis::BatchAnalyzer::default_options)
+        .def("analyze",
+             py::overload_cast<const std::vector<backtest::BacktestResult>&>(
+                 &analysis::BatchAnalyzer::analyze, py::const_),
+             "并行分析回测结果", py::arg("results"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("analyze",
+             py::overload_cast<const std::vector<std::vector<double>>&,
+                               const std::vector<std::vector<Timestamp>>&,
+                               const std::vector<std::vector<strategy::Trade>>&,
+                               double>(&analysis::BatchAnalyzer::analyze, py::const_),
+             "并行分析权益曲线（timestamps 可只传一条共用）",
+             py::arg("equity_curves"), py::arg("timestamps"),
+             py::arg("trades") = std::vector<std::vector<strategy::Trade>>(),
+             py::arg("initial_capital") = 10000.0,
+             py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("threads", &analysis::BatchAnalyzer::threads);
+
+    // ========== 数据处理流水线 ==========
+    py::class_<pipeline::ShardInfo>(m, "ShardInfo")
+        .def(py::init<>())
+        .def(py::init<Exchange, Symbol, Timeframe>(),
+             py::arg("exchange"), py::arg("symbol"), py::arg("timeframe"))
+        .def_readwrite("exchange", &pipeline::ShardInfo::exchange)
+        .def_readwrite("symbol", &pipeline::ShardInfo::symbol)
+        .def_readwrite("timeframe", &pipeline::ShardInfo::timeframe);
+
+    py::class_<pipeline::StageStats>(m, "StageStats")
+        .def_readonly("name", &pipeline::StageStats::name)
+        .def_readonly("batches", &pipeline::StageStats::batches)
+        .def_readonly("bars_in", &pipeline::StageStats::bars_in)
+        .def_readonly("bars_out", &pipeline::StageStats::bars_out)
+        .def_readonly("seconds", &pipeline::StageStats::seconds)
+        .def("dropped", &pipeline::StageStats::dropped)
+        .def("added", &pipeline::StageStats::added)
+        .def("throughput", &pipeline::StageStats::throughput);
+
+    py::class_<pipeline::ShardReport>(m, "ShardReport")
+        .def_readonly("shard", &pipeline::ShardReport::shard)
+        .def_readonly("stages", &pipeline::ShardReport::stages)
+        .def_readonly("ok", &pipeline::ShardReport::ok)
+        .def_readonly("error", &pipeline::ShardReport::error)
+        .def_readonly("seconds", &pipeline::ShardReport::seconds);
+
+    py::class_<pipeline::PipelineReport>(m, "PipelineReport")
+        .def_readonly("shards", &pipeline::PipelineReport::shards)
+        .def_readonly("stages", &pipeline::PipelineReport::stages)
+        .def_readonly("failed", &pipeline::PipelineReport::failed)
+        .def_readonly("seconds", &pipeline::PipelineReport::seconds);
+
+    py::class_<pipeline::Stage, std::shared_ptr<pipeline::Stage>>(m, "PipelineStage")
+        .def_property_readonly("name", &pipeline::Stage::name);
+
+    py::class_<pipeline::NormalizeStage, pipeline::Stage, std::shared_ptr<pipeline::NormalizeStage>>(m, "NormalizeStage")
+        .def(py::init<int, int, bool, bool>(),
+             py::arg("price_precision") = 8, py::arg("volume_precision") = 8,
+             py::arg("normalize_symbol") = false, py::arg("drop_invalid") = true);
+
+    py::class_<pipeline::CleanStage, pipeline::Stage, std::shared_ptr<pipeline::CleanStage>>(m, "CleanStage")
+        .def(py::init([](std::shared_ptr<cleaners::DataCleaner> cleaner) {
+            return std::make_shared<pipeline::CleanStage>(std::move(cleaner));
+        }), py::arg("cleaner"));
+
+    py::class_<pipeline::DedupStage, pipeline::Stage, std::shared_ptr<pipeline::DedupStage>>(m, "DedupStage")
+        .def(py::init<cleaners::DuplicatePolicy>(),
+             py::arg("policy") = cleaners::DuplicatePolicy::KEEP_FIRST);
+
+    py::class_<pipeline::FillStage, pipeline::Stage, std::shared_ptr<pipeline::FillStage>>(m, "FillStage")
+        .def(py::init<cleaners::FillMethod, size_t>(),
+             py::arg("method") = cleaners::FillMethod::FORWARD, py::arg("max_gap_bars") = 0);
+
+    py::class_<pipeline::StoreStage, pipeline::Stage, std::shared_ptr<pipeline::StoreStage>>(m, "StoreStage")
+        .def(py::init<const std::string&>(), py::arg("data_dir"));
+
+    // Python 侧的数据源：按交易对提供已加载的K线（数据源在工作线程中创建，不能回调 Python）
+    py::class_<pipeline::Pipeline>(m, "Pipeline")
+        .def(py::init([](std::map<std::string, std::vector<OHLCV>> data, size_t threads, size_t max_batch_bars) {
+            auto bars = std::make_shared<std::map<std::string, std::shared_ptr<const std::vector<OHLCV>>>>();
+            for (auto& item : data) {
+                (*bars)[item.first] = std::make_shared<const std::vector<OHLCV>>(std::move(item.second));
+            }
+            return pipeline::Pipeline([bars](const pipeline::ShardInfo& shard) -> std::unique_ptr<pipeline::ShardSource> {
+                auto it = bars->find(shard.symbol);
+                if (it == bars->end()) {
+                    throw std::runtime_error("Pipeline: 没有交易对的数据 " + shard.symbol);
+                }
+                return std::make_unique<pipeline::VectorSource>(it->second);
+            }, threads, max_batch_bars);
+        }), "按交易对提供K线数据构造流水线",
+             py::arg("data"), py::arg("threads") = 0, py::arg("max_batch_bars") = 100000)
+        .def("add_stage", &pipeline::Pipeline::add_stage, py::return_value_policy::reference_internal,
+             "添加阶段（inputs 为空时接在上一个阶段之后）",
+             py::arg("stage"), py::arg("inputs") = std::vector<std::string>())
+        .def("run", &pipeline::Pipeline::run, "并行处理全部分片", py::arg("shards"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("stage_names", &pipeline::Pipeline::stage_names)
+        .def_property_readonly("threads", &pipeline::Pipeline::threads)
+        .def_property_readonly("max_batch_bars", &pipeline::Pipeline::max_batch_bars);
+
+    // ========== 交易台账 ==========
+    py::class_<analysis::RoundTrip>(m, "RoundTrip")
+        .def_readonly("symbol_id", &analysis::RoundTrip::symbol_id)
+        .def_readonly("entry_time", &analysis::RoundTrip::entry_time)
+        .def_readonly("exit_time", &analysis::RoundTrip::exit_time)
+        .def_readonly("entry_price", &analysis::RoundTrip::entry_price)
+        .def_readonly("exit_price", &analysis::RoundTrip::exit_price)
+        .def_readonly("quantity", &analysis::RoundTrip::quantity)
+        .def_readonly("gross_pnl", &analysis::RoundTrip::gross_pnl)
+        .def_readonly("pnl", &analysis::RoundTrip::pnl)
+        .def_readonly("mae", &analysis::RoundTrip::mae)
+        .def_readonly("mfe", &analysis::RoundTrip::mfe)
+        .def("holding_ms", &analysis::RoundTrip::holding_ms);
+
+    py::class_<analysis::TradeLedger>(m, "TradeLedger")
+        .def(py::init<bool>(), "构造函数", py::arg("keep_round_trips") = true)
+        .def("reset", &analysis::TradeLedger::reset)
+        .def("symbol_id", &analysis::TradeLedger::symbol_id, py::arg("symbol"))
+        .def("symbol_name", &analysis::TradeLedger::symbol_name, py::arg("id"))
+        .def("add_trade", py::overload_cast<const strategy::Trade&>(&analysis::TradeLedger::add_trade),
+             "记录一笔成交", py::arg("trade"))
+        .def("mark", py::overload_cast<const OHLCV&>(&analysis::TradeLedger::mark),
+             "输入K线，更新未平仓批次的价格极值", py::arg("bar"))
+        .def("replay", &analysis::TradeLedger::replay,
+             "按时间合并K线与交易，一次遍历", py::arg("trades"), py::arg("bars"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("round_trips", &analysis::TradeLedger::round_trips, py::return_value_policy::reference_internal)
+        .def_property_readonly("round_trip_count", &analysis::TradeLedger::round_trip_count)
+        .def_property_readonly("winning_round_trips", &analysis::TradeLedger::winning_round_trips)
+        .def_property_readonly("losing_round_trips", &analysis::TradeLedger::losing_round_trips)
+        .def_property_readonly("total_pnl", &analysis::TradeLedger::total_pnl)
+        .def_property_readonly("total_gross_pnl", &analysis::TradeLedger::total_gross_pnl)
+        .def_property_readonly("avg_holding_ms", &analysis::TradeLedger::avg_holding_ms)
+        .def_property_readonly("avg_mae", &analysis::TradeLedger::avg_mae)
+        .def_property_readonly("avg_mfe", &analysis::TradeLedger::avg_mfe)
+        .def_property_readonly("open_lot_count", &analysis::TradeLedger::open_lot_count);
+
+    // ========== 增量绩效跟踪 ==========
+    py::class_<analysis::PerformanceSnapshot>(m, "PerformanceSnapshot")
+        .def_readonly("timestamp", &analysis::PerformanceSnapshot::timestamp)
+        .def_readonly("points", &analysis::PerformanceSnapshot::points)
+        .def_readonly("trades", &analysis::PerformanceSnapshot::trades)
+        .def_readonly("equity", &analysis::PerformanceSnapshot::equity)
+        .def_readonly("peak_equity", &analysis::PerformanceSnapshot::peak_equity)
+        .def_readonly("current_drawdown", &analysis::PerformanceSnapshot::current_drawdown)
+        .def_readonly("net_pnl", &analysis::PerformanceSnapshot::net_pnl)
+        .def_readonly("metrics", &analysis::PerformanceSnapshot::metrics);
+
+    py::class_<analysis::PerformanceTracker, backtest::ResultSink>(m, "PerformanceTracker")
+        .def(py::init<double>(), "构造函数", py::arg("initial_capital") = 0.0)
+        .def("reset", &analysis::PerformanceTracker::reset, py::arg("initial_capital"))
+        .def("update_equity", &analysis::PerformanceTracker::update_equity,
+             "追加一个权益点", py::arg("timestamp"), py::arg("equity"))
+        .def("update_trade", &analysis::PerformanceTracker::update_trade,
+             "追加一笔交易", py::arg("trade"))
+        .def("snapshot", &analysis::PerformanceTracker::snapshot, "当前绩效快照")
+        .def_property_readonly("initial_capital", &analysis::PerformanceTracker::initial_capital);
 
 
 }
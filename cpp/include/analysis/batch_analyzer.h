@@ -0,0 +1,56 @@
+#pragma once
+
+#include "analysis/metrics_table.h"
+#include "analysis/performance_analyzer.h"
+#include "backtest/backtest_engine.h"
+#include "common/types.h"
+#include <vector>
+
+namespace quant_crypto {
+namespace analysis {
+
+/**
+ * @class BatchAnalyzer
+ * @brief 并行分析大量回测结果，输出列式指标表
+ *
+ * 每个结果由一个线程独立分析（按原子下标领取，结果长短不一时自动均衡），
+ * 写入指标表中对应的行，行号与输入顺序一致，不需要加锁。
+ * 默认选项不保留曲线与周期收益表，单个结果分析完只留下表中的一行。
+ */
+class BatchAnalyzer {
+public:
+    /**
+     * @param threads 线程数（0 = 硬件线程数）
+     * @param options 单个结果的分析选项
+     */
+    explicit BatchAnalyzer(size_t threads = 0, const AnalyzeOptions& options = default_options());
+
+    // 批量分析的默认选项：只计算标量指标与回撤区间汇总
+    static AnalyzeOptions default_options();
+
+    // 分析回测结果（例如 MultiStrategyEngine::take_results 的输出）
+    MetricsTable analyze(const std::vector<backtest::BacktestResult>& results) const;
+
+    /**
+     * @brief 分析权益曲线
+     * @param equity_curves 权益曲线
+     * @param timestamps 时间戳：与曲线一一对应，或只有一条（所有曲线共用）
+     * @param trades 交易记录：与曲线一一对应，或为空（不计算交易指标）
+     * @param initial_capital 初始资金
+     * @throws std::invalid_argument 数组个数或曲线长度不匹配
+     */
+    MetricsTable analyze(const std::vector<std::vector<double>>& equity_curves,
+                         const std::vector<std::vector<Timestamp>>& timestamps,
+                         const std::vector<std::vector<strategy::Trade>>& trades,
+                         double initial_capital) const;
+
+    size_t threads() const { return threads_; }
+    const AnalyzeOptions& options() const { return options_; }
+
+private:
+    size_t threads_;
+    AnalyzeOptions options_;
+};
+
+} // namespace analysis
+} // namespace quant_crypto
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "common/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace quant_crypto {
+namespace analysis {
+
+// 一次回撤：从峰值跌落，到重新达到峰值（或数据结束）为止
+struct DrawdownEpisode {
+    Timestamp start_time;       // 峰值时间（开始下跌前最后一个处于峰值的点）
+    Timestamp trough_time;      // 谷底时间
+    Timestamp end_time;         // 恢复时间（未恢复时为最后一个点的时间）
+    size_t start_index;
+    size_t trough_index;
+    size_t end_index;
+    double peak_equity;
+    double trough_equity;
+    double depth;               // (峰值 - 谷底) / 峰值
+    bool recovered;             // 是否已重新达到峰值
+
+    DrawdownEpisode()
+        : start_time(0), trough_time(0), end_time(0), start_index(0), trough_index(0), end_index(0),
+          peak_equity(0.0), trough_equity(0.0), depth(0.0), recovered(false) {}
+
+    int64_t duration_ms() const { return end_time - start_time; }     // 水下时长
+    int64_t decline_ms() const { return trough_time - start_time; }   // 下跌时长
+    int64_t recovery_ms() const { return end_time - trough_time; }    // 从谷底恢复的时长
+};
+
+// 回撤区间汇总
+struct DrawdownReport {
+    std::vector<DrawdownEpisode> episodes;  // 深度 >= 最小深度的回撤，按开始时间升序
+    size_t episode_count;                   // 上述回撤的个数
+    int64_t max_duration_ms;                // 最长水下时长
+    double avg_duration_ms;
+    int64_t max_recovery_ms;                // 已恢复回撤中最长的恢复时长
+    double avg_depth;
+    int64_t under_water_ms;                 // 权益低于峰值的总时长（包含所有回撤）
+    int64_t total_ms;                       // 权益曲线的时间跨度
+
+    DrawdownReport()
+        : episode_count(0), max_duration_ms(0), avg_duration_ms(0.0), max_recovery_ms(0),
+          avg_depth(0.0), under_water_ms(0), total_ms(0) {}
+
+    // 水下时间占比
+    double under_water_ratio() const {
+        return total_ms > 0 ? static_cast<double>(under_water_ms) / static_cast<double>(total_ms) : 0.0;
+    }
+};
+
+/**
+ * @class DrawdownEpisodeTracker
+ * @brief 顺序输入权益点，识别回撤区间并统计水下时间
+ *
+ * 峰值口径与 EquityStatistics 相同（以起点为初始峰值），权益重新达到峰值即视为恢复。
+ * 每个点只做常数次比较，可与回撤曲线放在同一次遍历中。
+ * 深度小于 min_depth 的回撤计入水下时间，但不保存明细，避免长曲线上的大量微小回撤占用内存。
+ */
+class DrawdownEpisodeTracker {
+public:
+    explicit DrawdownEpisodeTracker(double min_depth = 0.0);
+
+    void reset();
+
+    void update(Timestamp timestamp, double equity) {
+        size_t index = count_++;
+        if (index == 0) {
+            first_time_ = timestamp;
+            set_peak(timestamp, equity, index);
+        } else if (equity >= peak_) {
+            if (in_drawdown_) close_episode(timestamp, index, true);
+            set_peak(timestamp, equity, index);
+        } else if (!in_drawdown_) {
+            in_drawdown_ = true;
+            trough_ = equity;
+            trough_time_ = timestamp;
+            trough_index_ = index;
+        } else if (equity < trough_) {
+            trough_ = equity;
+            trough_time_ = timestamp;
+            trough_index_ = index;
+        }
+        last_time_ = timestamp;
+    }
+
+    void update_batch(const Timestamp* timestamps, const double* equity, size_t n) {
+        for (size_t i = 0; i < n; i++) update(timestamps[i], equity[i]);
+    }
+
+    bool in_drawdown() const { return in_drawdown_; }
+
+    /**
+     * @brief 结束输入，未恢复的回撤以最后一个点结束并计入结果
+     * @return 回撤区间汇总（明细从 tracker 移出，之后需 reset 才能重新使用）
+     */
+    DrawdownReport finish();
+
+private:
+    double min_depth_;
+    size_t count_;
+    Timestamp first_time_;
+    Timestamp last_time_;
+
+    double peak_;
+    Timestamp peak_time_;
+    size_t peak_index_;
+    bool in_drawdown_;
+    double trough_;
+    Timestamp trough_time_;
+    size_t trough_index_;
+
+    // 已结束的回撤
+    std::vector<DrawdownEpisode> episodes_;
+    int64_t under_water_ms_;
+    int64_t duration_sum_ms_;
+    int64_t max_duration_ms_;
+    int64_t max_recovery_ms_;
+    double depth_sum_;
+
+    void set_peak(Timestamp timestamp, double equity, size_t index) {
+        peak_ = equity;
+        peak_time_ = timestamp;
+        peak_index_ = index;
+    }
+
+    DrawdownEpisode current_episode(Timestamp end_time, size_t end_index, bool recovered) const;
+    void close_episode(Timestamp end_time, size_t end_index, bool recovered);
+};
+
+/**
+ * @brief 计算整条权益曲线的回撤区间，O(n)
+ * @param equity_curve 权益曲线
+ * @param timestamps 时间戳（与权益曲线等长，升序）
+ * @param min_depth 保存明细的最小回撤深度
+ */
+DrawdownReport compute_drawdown_episodes(
+    const double* equity_curve,
+    const Timestamp* timestamps,
+    size_t n,
+    double min_depth = 0.0
+);
+
+} // namespace analysis
+} // namespace quant_crypto
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "common/types.h"
+#include <cstddef>
+
+namespace quant_crypto {
+namespace analysis {
+
+/**
+ * @class EquityStatistics
+ * @brief 权益序列的在线统计（逐点更新，O(1)内存）
+ *
+ * 与 PerformanceAnalyzer 的批量计算口径一致：
+ *   - 收益率 r = (e[i] - e[i-1]) / e[i-1]，前值 <= 0 时跳过
+ *   - 波动率为收益率的总体标准差（Welford 算法）
+ *   - 下行波动率 = sqrt(负收益平方的均值)
+ *   - 回撤以起点为初始峰值
+ * 回测引擎只按采样策略保存部分权益点时，仍可用它得到精确的回撤与收益指标。
+ */
+class EquityStatistics {
+public:
+    // 全部内部状态（用于序列化与断点恢复）
+    struct State {
+        size_t count;
+        Timestamp first_timestamp;
+        Timestamp last_timestamp;
+        double first_equity;
+        double last_equity;
+        double peak;
+        double max_drawdown;
+        size_t return_count;
+        double return_mean;
+        double return_m2;
+        size_t downside_count;
+        double downside_sum_sq;
+    };
+
+    EquityStatistics() { reset(); }
+
+    void reset();
+
+    /**
+     * @brief 追加一个权益点
+     * @param timestamp 时间戳
+     * @param equity 总权益
+     */
+    void update(Timestamp timestamp, double equity) {
+        if (count_ == 0) {
+            first_timestamp_ = timestamp;
+            first_equity_ = equity;
+            peak_ = equity;
+        } else {
+            if (last_equity_ > 0) {
+                double ret = (equity - last_equity_) / last_equity_;
+                // Welford 在线均值/方差
+                return_count_++;
+                double delta = ret - return_mean_;
+                return_mean_ += delta / static_cast<double>(return_count_);
+                return_m2_ += delta * (ret - return_mean_);
+                if (ret < 0.0) {
+                    downside_count_++;
+                    downside_sum_sq_ += ret * ret;
+                }
+            }
+            if (equity > peak_) peak_ = equity;
+        }
+        double drawdown = peak_ > 0.0 ? (peak_ - equity) / peak_ : 0.0;   // 峰值 <= 0 时回撤无意义
+        if (drawdown > max_drawdown_) max_drawdown_ = drawdown;
+
+        last_timestamp_ = timestamp;
+        last_equity_ = equity;
+        count_++;
+    }
+
+    /**
+     * @brief 批量追加权益点（分块计算收益率矩，再与已有统计合并）
+     *
+     * 结果与逐点 update 相同（仅有浮点舍入差异），但内层循环没有跨元素依赖，
+     * 编译器可以向量化。
+     */
+    void update_batch(const Timestamp* timestamps, const double* equity, size_t n);
+
+    size_t count() const { return count_; }
+    Timestamp first_timestamp() const { return first_timestamp_; }
+    Timestamp last_timestamp() const { return last_timestamp_; }
+    double first_equity() const { return first_equity_; }
+    double last_equity() const { return last_equity_; }
+    double peak() const { return peak_; }
+
+    double max_drawdown() const { return max_drawdown_; }
+    double current_drawdown() const;
+
+    size_t return_count() const { return return_count_; }
+    double mean_return() const { return return_mean_; }
+    double volatility() const;           // 收益率标准差
+    double downside_deviation() const;   // 下行波动率
+    double sharpe_ratio() const;         // 均值/波动率（无风险利率=0）
+    double sortino_ratio() const;        // 均值/下行波动率
+
+    State state() const;
+    void restore(const State& state);
+
+private:
+    size_t count_;
+    Timestamp first_timestamp_;
+    Timestamp last_timestamp_;
+    double first_equity_;
+    double last_equity_;
+    double peak_;
+    double max_drawdown_;
+
+    size_t return_count_;
+    double return_mean_;
+    double return_m2_;          // 偏差平方和
+    size_t downside_count_;
+    double downside_sum_sq_;    // 负收益平方和
+};
+
+} // namespace analysis
+} // namespace quant_crypto
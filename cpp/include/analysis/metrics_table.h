@@ -0,0 +1,81 @@
+#pragma once
+
+#include "analysis/performance_metrics.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace quant_crypto {
+namespace analysis {
+
+// 指标表中的列
+enum class Metric {
+    ANNUALIZED_RETURN,
+    CUMULATIVE_RETURN,
+    MAX_DRAWDOWN,
+    SHARPE_RATIO,
+    SORTINO_RATIO,
+    CALMAR_RATIO,
+    VOLATILITY,
+    DOWNSIDE_DEVIATION,
+    PROFIT_LOSS_RATIO,
+    MAX_CONSECUTIVE_WINS,
+    MAX_CONSECUTIVE_LOSSES,
+    AVG_HOLDING_PERIOD,
+    TRADE_FREQUENCY,
+    MAX_DRAWDOWN_DAYS,      // 最长水下时间（天）
+    UNDER_WATER_RATIO,      // 水下时间占比
+    COUNT
+};
+
+const size_t METRIC_COUNT = static_cast<size_t>(Metric::COUNT);
+
+/**
+ * @class MetricsTable
+ * @brief 列式指标表：每个指标一个连续数组，第 i 行对应第 i 个输入
+ *
+ * 排序、筛选与 top-k 都只返回行号，不移动数据；select() 按行号生成子表。
+ * 整数指标（连续盈亏次数）也以 double 存储，所有列可以统一处理。
+ * NaN 在任何排序方向下都排在最后。
+ */
+class MetricsTable {
+public:
+    explicit MetricsTable(size_t rows = 0);
+
+    size_t size() const { return rows_; }
+    bool empty() const { return rows_ == 0; }
+
+    std::vector<double>& column(Metric metric) { return columns_[static_cast<size_t>(metric)]; }
+    const std::vector<double>& column(Metric metric) const { return columns_[static_cast<size_t>(metric)]; }
+    double value(Metric metric, size_t row) const { return column(metric)[row]; }
+
+    // 写入一行（row < size()）
+    void set_row(size_t row, const PerformanceMetrics& metrics);
+
+    /**
+     * @brief 按指标取前 k 行（部分排序，O(n log k)）
+     * @param descending true 时取最大的 k 个（夏普等越大越好的指标），false 时取最小的
+     * @return 行号，按指标排好序
+     */
+    std::vector<size_t> top_k(Metric metric, size_t k, bool descending = true) const;
+
+    // 全部行号按指标排序（稳定排序，相等时保持输入顺序）
+    std::vector<size_t> argsort(Metric metric, bool descending = true) const;
+
+    // 指标落在 [min_value, max_value] 内的行号（升序）
+    std::vector<size_t> filter(Metric metric, double min_value, double max_value) const;
+
+    // 按行号生成子表（行号可重复、可乱序）
+    MetricsTable select(const std::vector<size_t>& rows) const;
+
+    static std::string metric_name(Metric metric);
+    // @throws std::invalid_argument 未知的指标名
+    static Metric metric_from_string(const std::string& name);
+
+private:
+    size_t rows_;
+    std::vector<std::vector<double>> columns_;   // 按 Metric 下标
+};
+
+} // namespace analysis
+} // namespace quant_crypto
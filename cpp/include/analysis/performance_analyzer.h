@@ -1,14 +1,39 @@
 #pragma once
 
 #include "analysis/performance_metrics.h"
+#include "analysis/equity_statistics.h"
+#include "analysis/trade_statistics.h"
+#include "backtest/backtest_engine.h"
 #include "strategy/strategy_base.h"
 #include "common/types.h"
+#include <string>
 #include <vector>
 
 
 namespace quant_crypto {
 namespace analysis{
 
+    // 分析选项：参数扫描时关闭曲线输出，分析过程不分配与曲线长度相关的内存
+    // 默认只保存权益/回撤曲线；周期收益、回撤区间与滚动指标需显式开启
+    struct AnalyzeOptions {
+        bool keep_equity_curve;     // 在结果中保存权益曲线
+        bool keep_drawdown_curve;   // 在结果中保存回撤曲线
+        bool keep_period_returns;   // 计算日/周/月收益表（默认关闭）
+        bool keep_drawdown_episodes;  // 计算回撤区间（默认关闭）
+        double min_drawdown_depth;  // 保存明细的最小回撤深度（更浅的回撤只计入水下时间）
+        double periods_per_year;    // 年化的每年周期数（0 = 按时间戳推断K线频率）
+        size_t rolling_window_bars; // 滚动指标窗口点数（0 = 不按点数）
+        int64_t rolling_window_ms;  // 滚动指标窗口时长（0 = 不计算滚动指标）
+
+        AnalyzeOptions()
+            : keep_equity_curve(true), keep_drawdown_curve(true),
+              keep_period_returns(false), keep_drawdown_episodes(false), min_drawdown_depth(0.0),
+              periods_per_year(0.0),
+              rolling_window_bars(0), rolling_window_ms(0) {}
+
+        bool rolling_enabled() const { return rolling_window_bars > 0 || rolling_window_ms > 0; }
+    };
+
     /** 性能分析器，（后处理计算方式） 
     * 计算收益指标
     * 计算风险指标
@@ -19,20 +44,110 @@ public:
 
     /**
      * @brief 分析回测结果
+     *
+     * 单次遍历权益曲线：按块计算收益率矩与峰值/回撤，（可选的）回撤曲线在同一块内写出，
+     * 不生成收益率序列等临时数组。
      * @param equity_curve 权益曲线（每个Bar的总权益）
      * @param timestamps 时间戳（每个Bar的时间戳）
      * @param trades 交易记录
      * @param initial_capital 初始资金
+     * @param options 分析选项
      * @return 性能指标
      */
     PerformanceMetrics analyze(
         const std::vector<double>& equity_curve,
         const std::vector<Timestamp>& timestamps,
         const std::vector<strategy::Trade>& trades,
+        double initial_captial,
+        const AnalyzeOptions& options = AnalyzeOptions()
+    );
+
+    // 同上，直接使用数组（长度均为 n）
+    PerformanceMetrics analyze(
+        const double* equity_curve,
+        const Timestamp* timestamps,
+        size_t n,
+        const std::vector<strategy::Trade>& trades,
+        double initial_captial,
+        const AnalyzeOptions& options = AnalyzeOptions()
+    );
+
+    /**
+     * @brief 直接分析回测结果
+     *
+     * 收益与风险指标取自 result.equity_stats（覆盖全部Bar），
+     * 因此在任何权益曲线记录模式下最大回撤、收益率都是精确的；
+     * 回撤曲线按已记录的（可能是采样的）权益点计算。
+     * @param result 回测结果
+     * @param options 分析选项
+     * @return 性能指标
+     */
+    PerformanceMetrics analyze(const backtest::BacktestResult& result,
+                               const AnalyzeOptions& options = AnalyzeOptions());
+
+    /**
+     * @brief 分析流式结果文件（BinaryResultWriter 写出），顺序读一遍
+     *
+     * 文件末尾有汇总记录时，收益与风险指标取自其中的在线统计（覆盖全部Bar）；
+     * 没有汇总记录（回测中断）时按文件中的权益点计算。
+     * 曲线、周期收益、回撤区间与滚动指标按 options 计算，与 analyze 口径相同；
+     * 全部关闭时内存占用与文件大小无关。
+     * @param path 结果文件路径
+     * @param options 分析选项
+     * @return 性能指标（文件无法读取时返回空指标）
+     */
+    PerformanceMetrics analyze_stream(const std::string& path,
+                                      const AnalyzeOptions& options = AnalyzeOptions());
+
+    /**
+     * @brief 由在线统计量生成指标（不含曲线），O(1)
+     * @param equity_stats 权益统计
+     * @param trade_stats 交易统计
+     * @param initial_capital 初始资金
+     */
+    PerformanceMetrics summarize(
+        const EquityStatistics& equity_stats,
+        const TradeStatistics& trade_stats,
         double initial_captial
     );
 
 private:
+    // 单次遍历权益点：更新在线统计，按选项写出权益/回撤曲线
+    void scan_equity(
+        PerformanceMetrics& metrics,
+        EquityStatistics& stats,
+        const double* equity_curve,
+        const Timestamp* timestamps,
+        size_t n,
+        const AnalyzeOptions& options
+    );
+
+    /**
+     * 根据在线统计量填充收益与风险指标
+     * 波动率、夏普与索提诺按每年周期数年化；periods_per_year 为0时
+     * 由收益率个数与时间跨度推断（收益率个数 / 年数）
+     */
+    void fill_equity_metrics(
+        PerformanceMetrics& metrics,
+        const EquityStatistics& stats,
+        double initial_captial,
+        double periods_per_year = 0.0
+    );
+
+    // 填充交易指标
+    void fill_trade_metrics(
+        PerformanceMetrics& metrics,
+        const std::vector<strategy::Trade>& trades,
+        Timestamp start_time,
+        Timestamp end_time
+    );
+    void fill_trade_metrics(
+        PerformanceMetrics& metrics,
+        const TradeStatistics& stats,
+        Timestamp start_time,
+        Timestamp end_time
+    );
+
     // ============ 收益指标计算 =============
     // 年化收益率
     double calculate_annualized_return(
@@ -49,33 +164,15 @@ private:
     );
 
     // ============ 风险指标计算  ============
-    // 最大回撤
-    double calculate_max_drawdown(const std::vector<double>& equity_curve);
-    // 夏普比率
-    double calculate_sharpe_ratio(const std::vector<double>& returns);
-    // 索提诺比率
-    double calculate_sortino_ratio(const std::vector<double>& returns);
+    // 最大回撤、波动率、下行波动率、夏普与索提诺比率见 EquityStatistics
     // 卡尔玛比率
     double calculate_calmar_ratio(
         double annualized_return,
         double max_drawdown
     );
-    // 波动率
-    double calculate_volatility(const std::vector<double>& returns);
-    // 下行波动率
-    double calculate_downside_deviation(const std::vector<double>& returns);
 
     // =============  交易指标计算 ==========
-    // 平均盈亏比
-    double calculate_profit_loss_ratio(const std::vector<strategy::Trade>& trades);
-    // 最大连续盈利次数和最大连续亏损次数
-    std::pair<int, int> calculate_max_consecutive(
-        const std::vector<strategy::Trade>& trades
-    );
-    // 平均持仓时间
-    double calculate_avg_holding_period(
-        const std::vector<strategy::Trade>& trades
-    );
+    // 盈亏比、连续盈亏次数、平均持仓时间见 TradeStatistics
     // 交易频率
     double calculate_trade_frequency(
         int total_trades,
@@ -83,12 +180,6 @@ private:
         Timestamp end_time
     );
 
-    // ========= 辅助方法 ========
-    // 计算收益率
-    std::vector<double> calculate_returns(const std::vector<double>& equity_curve);
-    // 计算回撤曲线
-    std::vector<double> calculate_drawdown_curve(const std::vector<double>& equity_curve);
-
 };
 
 
@@ -3,6 +3,9 @@
 #include<vector>
 #include<cstdint>
 #include "common/types.h"
+#include "analysis/rolling_metrics.h"
+#include "analysis/period_returns.h"
+#include "analysis/drawdown_episodes.h"
 
 namespace quant_crypto {
 namespace analysis {
@@ -18,8 +21,9 @@ struct PerformanceMetrics {
     double sharpe_ratio;       // 夏普比率（无风险利率=0）
     double sortino_ratio;      // 索提诺比率
     double calmar_ratio;       // 卡尔玛比率
-    double volatility;         // 波动率 （年化， %）
-    double downside_deviation;  // 下行波动率
+    double volatility;         // 波动率（年化）
+    double downside_deviation;  // 下行波动率（年化）
+    double periods_per_year;   // 年化使用的每年收益率个数（按K线频率）
 
     // 交易指标
     double profit_loss_ratio;     // 平均盈亏比
@@ -30,10 +34,21 @@ struct PerformanceMetrics {
 
     // 回撤数据 ===============
     std::vector<double> drawdown_curve;      // 回撤曲线数据（每个Bar的回撤）
+    DrawdownReport drawdowns;                // 回撤区间与水下时间
+
+    // 日历周期收益表（UTC）
+    PeriodReturns daily_returns;
+    PeriodReturns weekly_returns;
+    PeriodReturns monthly_returns;
+
+    // 滚动窗口指标（AnalyzeOptions 设置了窗口时计算）
+    RollingMetrics rolling;
 
 
     // 构造函数：初始化所有指标为0
-    PerformanceMetrics() : annualized_return(0.0), cumulative_return(0.0), max_drawdown(0.0), sharpe_ratio(0.0), sortino_ratio(0.0), calmar_ratio(0.0), volatility(0.0), downside_deviation(0.0), profit_loss_ratio(0.0), max_consecutive_wins(0), max_consecutive_losses(0), avg_holding_period(0.0), trade_frequency_per_year(0.0) {}
+    PerformanceMetrics() : annualized_return(0.0), cumulative_return(0.0), max_drawdown(0.0), sharpe_ratio(0.0), sortino_ratio(0.0), calmar_ratio(0.0), volatility(0.0), downside_deviation(0.0), periods_per_year(0.0), profit_loss_ratio(0.0), max_consecutive_wins(0), max_consecutive_losses(0), avg_holding_period(0.0), trade_frequency_per_year(0.0),
+                           daily_returns(calendar::Period::DAY), weekly_returns(calendar::Period::WEEK),
+                           monthly_returns(calendar::Period::MONTH) {}
 
 };
 
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "analysis/performance_metrics.h"
+#include "analysis/equity_statistics.h"
+#include "analysis/trade_statistics.h"
+#include "backtest/result_sink.h"
+#include "strategy/strategy_base.h"
+#include "common/types.h"
+#include <mutex>
+
+namespace quant_crypto {
+namespace analysis {
+
+// 某一时刻的绩效快照（不含曲线，复制成本固定）
+struct PerformanceSnapshot {
+    Timestamp timestamp;        // 最后一个权益点的时间戳
+    size_t points;              // 已接收的权益点数量
+    size_t trades;              // 已接收的交易数量
+    double equity;              // 当前权益
+    double peak_equity;         // 历史最高权益
+    double current_drawdown;    // 当前回撤
+    double net_pnl;             // 已实现盈亏（平仓交易 pnl 之和）
+    PerformanceMetrics metrics; // 与 PerformanceAnalyzer 口径一致的指标（曲线为空）
+
+    PerformanceSnapshot()
+        : timestamp(0), points(0), trades(0), equity(0.0), peak_equity(0.0),
+          current_drawdown(0.0), net_pnl(0.0) {}
+};
+
+/**
+ * @class PerformanceTracker
+ * @brief 增量绩效跟踪：每个权益点/每笔交易 O(1) 更新，随时生成快照
+ *
+ * 收益率矩（Welford）、回撤、下行波动率由 EquityStatistics 维护，
+ * 盈亏比、连续盈亏、持仓时间由 TradeStatistics 维护，
+ * snapshot() 的指标与对同一序列调用 PerformanceAnalyzer::analyze 相同，但不需要重新遍历曲线。
+ *
+ * 实现 ResultSink，可直接设置为回测引擎的输出（BacktestEngine::set_sink）。
+ * 更新与快照由互斥锁保护，监控线程可以在回测/实盘线程写入的同时读取。
+ */
+class PerformanceTracker : public backtest::ResultSink {
+public:
+    explicit PerformanceTracker(double initial_capital = 0.0);
+
+    // 清空统计（可同时修改初始资金）
+    void reset(double initial_capital);
+
+    // 追加一个权益点
+    void update_equity(Timestamp timestamp, double equity);
+    // 追加一笔交易
+    void update_trade(const strategy::Trade& trade);
+
+    // 当前快照
+    PerformanceSnapshot snapshot() const;
+
+    double initial_capital() const;
+
+    // ========= ResultSink =========
+    void on_begin(double initial_capital) override;
+    void on_equity(Timestamp timestamp, double equity) override { update_equity(timestamp, equity); }
+    void on_trade(const strategy::Trade& trade) override { update_trade(trade); }
+
+private:
+    mutable std::mutex mutex_;
+    double initial_capital_;
+    EquityStatistics equity_stats_;
+    TradeStatistics trade_stats_;
+};
+
+} // namespace analysis
+} // namespace quant_crypto
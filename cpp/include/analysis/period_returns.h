@@ -0,0 +1,73 @@
+#pragma once
+
+#include "common/calendar.h"
+#include "common/types.h"
+#include <cstddef>
+#include <vector>
+
+namespace quant_crypto {
+namespace analysis {
+
+// 日历周期收益表（按周期开始时间升序，只包含有权益点的周期）
+struct PeriodReturns {
+    calendar::Period period;
+    std::vector<Timestamp> start;        // 周期开始时间（UTC）
+    std::vector<double> open_equity;     // 期初权益（上一周期末权益；第一个周期为首个权益点）
+    std::vector<double> close_equity;    // 期末权益（周期内最后一个权益点）
+    std::vector<double> returns;         // 周期收益率 = 期末 / 期初 - 1
+
+    explicit PeriodReturns(calendar::Period p = calendar::Period::DAY) : period(p) {}
+
+    size_t size() const { return start.size(); }
+    bool empty() const { return start.empty(); }
+    void clear();
+};
+
+/**
+ * @class PeriodReturnAggregator
+ * @brief 顺序输入权益点，按 UTC 日/周/月/年聚合周期收益
+ *
+ * 周期边界由 calendar::PeriodCursor 缓存，同一周期内的点只做比较与一次赋值，
+ * 因此可以和其他统计放在同一次遍历中处理百万级权益点。
+ * 输入需按时间戳升序。
+ */
+class PeriodReturnAggregator {
+public:
+    explicit PeriodReturnAggregator(calendar::Period period);
+
+    void reset();
+
+    void update(Timestamp timestamp, double equity) {
+        if (cursor_.advance(timestamp)) open_period(equity);
+        table_.close_equity.back() = equity;
+    }
+
+    void update_batch(const Timestamp* timestamps, const double* equity, size_t n) {
+        for (size_t i = 0; i < n; i++) update(timestamps[i], equity[i]);
+    }
+
+    // 计算各周期收益率并返回收益表（最后一个周期可能尚未结束）
+    const PeriodReturns& finish();
+
+private:
+    calendar::PeriodCursor cursor_;
+    PeriodReturns table_;
+
+    void open_period(double equity);
+};
+
+/**
+ * @brief 计算整条权益曲线的周期收益表，O(n)
+ * @param equity_curve 权益曲线
+ * @param timestamps 时间戳（与权益曲线等长，升序）
+ * @param period 日历周期
+ */
+PeriodReturns compute_period_returns(
+    const double* equity_curve,
+    const Timestamp* timestamps,
+    size_t n,
+    calendar::Period period
+);
+
+} // namespace analysis
+} // namespace quant_crypto
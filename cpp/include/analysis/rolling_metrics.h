@@ -0,0 +1,113 @@
+#pragma once
+
+#include "common/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace quant_crypto {
+namespace analysis {
+
+// 滚动窗口指标序列（从第一个完整窗口开始，每个权益点一个值）
+struct RollingMetrics {
+    size_t window_bars;                 // 窗口点数（按点数滚动时）
+    int64_t window_ms;                  // 窗口时长（按时间滚动时）
+    std::vector<Timestamp> timestamps;  // 窗口结束时间
+    std::vector<double> mean_return;    // 窗口内收益率均值
+    std::vector<double> volatility;     // 窗口内收益率标准差
+    std::vector<double> sharpe_ratio;   // 均值/标准差（无风险利率=0）
+    std::vector<double> sortino_ratio;  // 均值/下行波动率
+    std::vector<double> drawdown;       // 相对窗口内最高权益的回撤
+
+    RollingMetrics() : window_bars(0), window_ms(0) {}
+
+    size_t size() const { return timestamps.size(); }
+    bool empty() const { return timestamps.empty(); }
+};
+
+/**
+ * @class RollingStatistics
+ * @brief 滑动窗口统计：每个权益点 O(1) 均摊更新
+ *
+ * 窗口按点数（最近 window_bars 个权益点）或时长（最近 window_ms 毫秒）确定。
+ * 收益率的一阶/二阶矩与下行平方和随窗口加减；为避免长序列上的累积误差，
+ * 每移出一个窗口长度的点后按窗口内数据重新求和一次，均摊仍为 O(1)。
+ * 窗口最高权益用单调队列维护。收益率口径与 EquityStatistics 相同。
+ */
+class RollingStatistics {
+public:
+    /**
+     * @param window_bars 窗口点数（> 0 时按点数滚动）
+     * @param window_ms 窗口时长（window_bars 为0时使用）
+     * @throws std::invalid_argument 两者都为0
+     */
+    RollingStatistics(size_t window_bars, int64_t window_ms);
+
+    void reset();
+
+    /**
+     * @brief 追加一个权益点
+     * @return 窗口是否已满（满之前的指标只覆盖部分窗口）
+     */
+    bool update(Timestamp timestamp, double equity);
+
+    size_t count() const { return points_.size(); }
+    double mean_return() const;
+    double volatility() const;
+    double downside_deviation() const;
+    double sharpe_ratio() const;
+    double sortino_ratio() const;
+    double peak() const { return peaks_.empty() ? 0.0 : peaks_.front().equity; }
+    double drawdown() const;
+
+private:
+    struct Point {
+        uint64_t sequence;
+        Timestamp timestamp;
+        double equity;
+        double ret;       // 相对前一个点的收益率
+        bool has_return;  // 前一个点权益 > 0 时有效
+    };
+    struct Peak {
+        uint64_t sequence;
+        double equity;
+    };
+
+    size_t window_bars_;
+    int64_t window_ms_;
+    std::deque<Point> points_;
+    std::deque<Peak> peaks_;          // 单调递减队列，队首为窗口最高权益
+    uint64_t next_sequence_;
+    Timestamp first_timestamp_;
+    size_t evicted_since_resum_;
+
+    // 窗口内收益率（不含队首点的收益率，其前一个点已移出窗口）
+    size_t return_count_;
+    double return_sum_;
+    double return_sum_sq_;
+    size_t downside_count_;
+    double downside_sum_sq_;
+
+    void add_return(const Point& point, bool add);
+    void evict_front();
+    void resum();
+};
+
+/**
+ * @brief 计算整条权益曲线的滚动指标，O(n)
+ * @param equity_curve 权益曲线
+ * @param timestamps 时间戳（与权益曲线等长）
+ * @param window_bars 窗口点数（> 0 时按点数滚动）
+ * @param window_ms 窗口时长（window_bars 为0时使用）
+ */
+RollingMetrics compute_rolling_metrics(
+    const double* equity_curve,
+    const Timestamp* timestamps,
+    size_t n,
+    size_t window_bars,
+    int64_t window_ms
+);
+
+} // namespace analysis
+} // namespace quant_crypto
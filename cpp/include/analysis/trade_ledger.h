@@ -0,0 +1,125 @@
+#pragma once
+
+#include "common/types.h"
+#include "strategy/strategy_base.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace quant_crypto {
+namespace analysis {
+
+using SymbolId = uint32_t;
+
+// 一次完整的开平仓（一个买入批次与卖出配对的部分）
+struct RoundTrip {
+    SymbolId symbol_id;
+    Timestamp entry_time;
+    Timestamp exit_time;
+    double entry_price;
+    double exit_price;
+    double quantity;
+    double gross_pnl;       // (平仓价 - 开仓价) * 数量
+    double pnl;             // 卖出成交记录的 pnl 按数量分摊（回测引擎记录的是扣除手续费后的盈亏）
+    double mae;             // 最大不利偏移：持仓期间最低价相对开仓价的比例（<= 0）
+    double mfe;             // 最大有利偏移：持仓期间最高价相对开仓价的比例（>= 0）
+
+    RoundTrip()
+        : symbol_id(0), entry_time(0), exit_time(0), entry_price(0.0), exit_price(0.0),
+          quantity(0.0), gross_pnl(0.0), pnl(0.0), mae(0.0), mfe(0.0) {}
+
+    int64_t holding_ms() const { return exit_time - entry_time; }
+};
+
+/**
+ * @class TradeLedger
+ * @brief 交易台账：按交易对的先进先出（FIFO）批次配对开平仓
+ *
+ * 交易对名称在第一次出现时映射为整数 SymbolId，之后按下标访问未平仓批次，
+ * 不再比较字符串。每笔交易只处理被它平掉的批次，整体为 O(交易数)。
+ *   - BUY 新建一个批次
+ *   - SELL 按数量从最早的批次开始平仓（quantity <= 0 表示平掉该交易对全部持仓，
+ *     与回测引擎的卖出记录一致），部分平仓时拆分批次
+ * mark() 输入行情后更新未平仓批次的最高/最低价，平仓时得到 MAE/MFE。
+ */
+class TradeLedger {
+public:
+    /**
+     * @param keep_round_trips 是否保存每次开平仓明细（为false时只保留汇总值，内存与交易数无关）
+     */
+    explicit TradeLedger(bool keep_round_trips = true);
+
+    void reset();
+
+    // 交易对名称 <-> 编号
+    SymbolId symbol_id(const std::string& symbol);
+    const std::string& symbol_name(SymbolId id) const { return symbols_.at(id); }
+    size_t symbol_count() const { return symbols_.size(); }
+
+    // 记录一笔成交
+    void add_trade(const strategy::Trade& trade) { add_trade(symbol_id(trade.symbol), trade); }
+    void add_trade(SymbolId id, const strategy::Trade& trade);
+
+    // 输入行情，更新该交易对未平仓批次的价格极值
+    void mark(SymbolId id, double high, double low);
+    void mark(const OHLCV& bar) { mark(symbol_id(bar.symbol), bar.high, bar.low); }
+
+    /**
+     * @brief 一次遍历按时间合并K线与交易（两者均按时间升序）
+     *
+     * 同一时间戳先用K线更新已有批次，再处理交易：回测引擎在收盘时成交，
+     * 开仓所在K线的价格区间不计入该批次的 MAE/MFE。
+     */
+    void replay(const std::vector<strategy::Trade>& trades, const std::vector<OHLCV>& bars);
+
+    // ========= 结果 =========
+    const std::vector<RoundTrip>& round_trips() const { return round_trips_; }
+    size_t round_trip_count() const { return round_trip_count_; }
+    size_t winning_round_trips() const { return winning_count_; }
+    size_t losing_round_trips() const { return losing_count_; }
+    double total_pnl() const { return pnl_sum_; }
+    double total_gross_pnl() const { return gross_pnl_sum_; }
+    double avg_holding_ms() const;
+    double avg_mae() const;
+    double avg_mfe() const;
+
+    // 未平仓
+    size_t open_lot_count() const { return open_lot_count_; }
+    double open_quantity(SymbolId id) const;
+
+private:
+    // 未平仓批次
+    struct Lot {
+        Timestamp entry_time;
+        double entry_price;
+        double quantity;
+        double high;     // 开仓后的最高价
+        double low;      // 开仓后的最低价
+    };
+
+    bool keep_round_trips_;
+    std::vector<std::string> symbols_;
+    std::unordered_map<std::string, SymbolId> symbol_ids_;
+    SymbolId last_id_;                       // 最近一次查询的编号（连续同一交易对时免哈希）
+    std::vector<std::deque<Lot>> lots_;      // 按 SymbolId 下标
+    size_t open_lot_count_;
+
+    std::vector<RoundTrip> round_trips_;
+    std::vector<RoundTrip> closing_;         // 当前卖出平掉的部分（复用，避免每笔分配）
+
+    size_t round_trip_count_;
+    size_t winning_count_;
+    size_t losing_count_;
+    double pnl_sum_;
+    double gross_pnl_sum_;
+    double holding_ms_sum_;
+    double mae_sum_;
+    double mfe_sum_;
+
+    void close_lots(SymbolId id, const strategy::Trade& trade);
+};
+
+} // namespace analysis
+} // namespace quant_crypto
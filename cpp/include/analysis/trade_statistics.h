@@ -0,0 +1,57 @@
+#pragma once
+
+#include "common/types.h"
+#include "strategy/strategy_base.h"
+#include "analysis/trade_ledger.h"
+
+namespace quant_crypto {
+namespace analysis {
+
+/**
+ * @class TradeStatistics
+ * @brief 交易指标的在线统计（按成交顺序逐笔更新）
+ *
+ * 与 PerformanceAnalyzer 原有批量计算口径一致：
+ *   - 盈亏比 = 平均盈利 / 平均亏损（|pnl| <= 1e-8 的交易不计）
+ *   - 连续盈亏次数只看有盈亏的交易
+ *   - 持仓时间：由 TradeLedger 按交易对先进先出配对，取每次开平仓的平均值
+ * 内存只与未平仓的买入批次有关，可用于流式分析。
+ */
+class TradeStatistics {
+public:
+    TradeStatistics() { reset(); }
+
+    void reset();
+    void update(const strategy::Trade& trade);
+
+    size_t trade_count() const { return trade_count_; }
+    size_t sell_count() const { return sell_count_; }
+    int profit_count() const { return profit_count_; }
+    int loss_count() const { return loss_count_; }
+    double total_profit() const { return total_profit_; }
+    double total_loss() const { return total_loss_; }     // 亏损总额（正数）
+    double profit_loss_ratio() const;
+    int max_consecutive_wins() const { return max_consecutive_wins_; }
+    int max_consecutive_losses() const { return max_consecutive_losses_; }
+    double avg_holding_period() const;   // 天
+    const TradeLedger& ledger() const { return ledger_; }
+
+private:
+    size_t trade_count_;
+    size_t sell_count_;
+
+    double total_profit_;
+    double total_loss_;
+    int profit_count_;
+    int loss_count_;
+
+    int current_wins_;
+    int current_losses_;
+    int max_consecutive_wins_;
+    int max_consecutive_losses_;
+
+    TradeLedger ledger_;    // 开平仓配对（只保留汇总值）
+};
+
+} // namespace analysis
+} // namespace quant_crypto
@@ -1,22 +1,74 @@
 #pragma once
 
 #include "common/types.h"
+#include "common/ohlcv_series.h"
+#include "common/bar_resampler.h"
 #include "strategy/strategy_base.h"
+#include "analysis/equity_statistics.h"
+#include "backtest/order_manager.h"
+#include "backtest/result_sink.h"
+#include "backtest/latency_model.h"
 #include <vector>
+#include <cstddef>
+#include <type_traits>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <iostream>
+#include <utility>
 
 namespace quant_crypto {
 namespace backtest {
 
+// 权益曲线记录模式
+// 无论哪种模式，回撤/收益等统计都在线计算（见 BacktestResult::equity_stats），结果是精确的
+enum class EquityRecordMode {
+    FULL,          // 每个Bar记录一次（默认）
+    EVERY_N_BARS,  // 每N个Bar记录一次（N = record_interval）
+    ON_CHANGE,     // 仅在持仓或权益变化时记录
+    NONE           // 不记录曲线，只保留统计量
+};
+
+// 提前终止条件（在线检查，每个Bar结束时评估；取0表示不启用）
+struct StopConditions {
+    double max_drawdown;          // 回撤超过该比例时终止（如0.3表示30%）
+    double equity_floor;          // 总权益低于该值时终止
+    size_t min_trades;            // 处理 min_trades_bars 根K线后交易次数仍少于该值时终止
+    size_t min_trades_bars;
+
+    StopConditions() : max_drawdown(0.0), equity_floor(0.0), min_trades(0), min_trades_bars(0) {}
+
+    bool enabled() const {
+        return max_drawdown > 0 || equity_floor > 0 || (min_trades > 0 && min_trades_bars > 0);
+    }
+};
+
+// 终止原因
+enum class StopReason {
+    NONE,           // 正常跑完
+    MAX_DRAWDOWN,   // 回撤超限
+    EQUITY_FLOOR,   // 权益低于下限
+    MIN_TRADES      // 交易过少
+};
+
 // 回测参数配置
 struct BacktestConfig {
     double initial_capital;   // 初始资金
     double commission_rate;   // 手续费率
     double slippage_rate;   // 滑点率
+    double position_size;   // 信号/市价开仓时使用的资金比例
+    EquityRecordMode record_mode;   // 权益曲线记录模式
+    size_t record_interval;         // EVERY_N_BARS 模式的采样间隔
+    StopConditions stop;            // 提前终止条件（参数优化时剪枝用）
+    LatencyConfig latency;          // 下单延迟（默认不模拟）
 
     BacktestConfig():
         initial_capital(10000.0),
         commission_rate(0.001),
-        slippage_rate(0.001)
+        slippage_rate(0.001),
+        position_size(0.5),
+        record_mode(EquityRecordMode::FULL),
+        record_interval(1)
     {}
 };
 
@@ -34,41 +86,675 @@ struct BacktestResult{
     // ========  权益曲线数据
     std::vector<double> equity_curve;     // 权益曲线（每个Bar的总权益）
     std::vector<Timestamp> timestamps;     // 时间戳(每个Bar的时间戳)
+    EquityRecordMode record_mode;          // 曲线的记录模式（非FULL时曲线是采样值）
+    analysis::EquityStatistics equity_stats;  // 全部Bar的在线统计（不受记录模式影响）
+
+    StopReason stop_reason;    // 提前终止原因（NONE 表示跑完全部数据）
+    Timestamp stopped_at;      // 终止时所在K线的时间戳
 
     BacktestResult()
         : initial_capital(0), final_capital(0),final_equity(0),
-        total_return(0), total_trades(0), winning_trades(0), losing_trades(0){}
+        total_return(0), total_trades(0), winning_trades(0), losing_trades(0),
+        record_mode(EquityRecordMode::FULL), stop_reason(StopReason::NONE), stopped_at(0){}
+};
+
+/**
+ * @brief 权益曲线记录器
+ *
+ * 每个Bar都更新 equity_stats，再按记录模式决定是否写入 equity_curve/timestamps。
+ * finish() 保证最后一个Bar一定被记录，采样曲线的终点与最终权益一致。
+ * 设置 sink 后被记录的点写入 sink，不保存在 result 中。
+ */
+class EquityRecorder {
+public:
+    EquityRecorder(EquityRecordMode mode, size_t interval);
+
+    // 开始记录：写入初始权益点，并按模式预留空间
+    void begin(BacktestResult& result, Timestamp timestamp, double equity, size_t expected_bars);
+    // 记录一个Bar结束时的权益
+    void record(BacktestResult& result, Timestamp timestamp, double equity, bool position_changed);
+    // 批量记录连续n个Bar（仅第一个Bar可能发生持仓变化），统计量按块更新
+    void record_batch(BacktestResult& result, const Timestamp* timestamps, const double* equity,
+                      size_t n, bool first_changed);
+    // 结束记录：补上未记录的最后一个点
+    void finish(BacktestResult& result);
+    // 继续记录（增量回测）：撤回 finish() 补上的点，采样与完整回测一致
+    // （已写入 sink 的点无法撤回）
+    void reopen(BacktestResult& result);
+    void set_sink(ResultSink* sink) { sink_ = sink; }
+
+private:
+    EquityRecordMode mode_;
+    size_t interval_;
+    size_t bar_index_;
+    bool last_recorded_;
+    Timestamp last_timestamp_;
+    double last_equity_;
+    double last_recorded_equity_;
+    ResultSink* sink_;             // 非空时记录点写入 sink
+    bool finish_pushed_;           // finish() 是否补过点
+    double finish_saved_equity_;   // 补点前的 last_recorded_equity_
+
+    void push(BacktestResult& result, Timestamp timestamp, double equity);
+    // 按记录模式决定是否写入曲线（不更新统计量）
+    void sample(BacktestResult& result, Timestamp timestamp, double equity, bool position_changed);
+};
+
+/**
+ * @brief 回测断点：引擎与策略的完整状态快照
+ *
+ * 包含策略副本（资金、持仓、交易记录、指标状态）、结果累加器、
+ * 权益记录器与挂单簿。快照与引擎互不共享可变状态，可以多次恢复。
+ */
+template <typename Strategy>
+struct BacktestCheckpointT {
+    BacktestConfig config;
+    std::shared_ptr<const Strategy> strategy;
+    BacktestResult result;
+    EquityRecorder recorder;
+    OrderManager order_manager;
+    BarResampler resampler;     // 正在形成的高周期K线
+    LatencyQueue latency;       // 在途的信号与订单请求
+    Timestamp last_timestamp;   // 最后处理的K线时间戳
+    size_t bars_processed;      // 已处理的K线数量
+
+    BacktestCheckpointT()
+        : recorder(EquityRecordMode::FULL, 1), last_timestamp(0), bars_processed(0) {}
 };
 
 // 3. BacktestEngine类
-class BacktestEngine {
+/**
+ * @brief 回测引擎模板
+ *
+ * Strategy 为具体策略类型时，on_bar/generate_signal/on_order_update 以限定名调用，
+ * 编译器可以内联，循环中没有虚函数调用（适合参数扫描等紧密循环）。
+ * 此时 Strategy 应是最终类型：更深一层的子类重写不会被调用。
+ * Strategy 为 StrategyBase 时走虚函数分派，即多态引擎 BacktestEngine，
+ * 用于运行时才确定的策略（如 Python 侧创建的策略）。
+ */
+template <typename Strategy>
+class BacktestEngineT {
 public:
     // 这里加上explicit目的是什么？防止隐式转换
-    explicit BacktestEngine(const BacktestConfig& config);
-    ~BacktestEngine() = default;
+    explicit BacktestEngineT(const BacktestConfig& config);
+    ~BacktestEngineT() = default;
 
     // 公有接口
-    void set_strategy(strategy::StrategyBase* strategy);
-    void set_data(const std::vector<OHLCV>& data);
+    void set_strategy(Strategy* strategy);
+    void set_data(const std::vector<OHLCV>& data);   // 拷贝一份数据
+    void set_data(std::vector<OHLCV>&& data);        // 接管数据，无拷贝
+    void set_data(OHLCVSeries data);                 // 共享只读数据，无拷贝
     void run();
-    BacktestResult get_result() const;
+    /**
+     * @brief 增量回测：只处理时间戳晚于最后已处理K线的新数据
+     *
+     * 可以传入新增的K线，也可以传入包含历史的完整序列（已处理部分被跳过）。
+     * 尚未运行过时等同于 set_data + run。结果与对完整序列调用 run() 一致。
+     * 已因终止条件停止的回测不再继续。
+     */
+    void resume(const OHLCVSeries& new_bars);
+
+    /**
+     * @brief 逐Bar驱动（多策略引擎共用一次数据遍历）
+     *
+     * run() 等价于 start() + 对每根K线 step() + finish()。
+     * step() 在已触发终止条件时不处理K线并返回false。
+     */
+    void start(Timestamp first_timestamp, size_t expected_bars);
+    bool step(const OHLCV& bar);
+    void finish();
+    const BacktestResult& get_result() const;        // 以引用返回，避免拷贝
+    BacktestResult take_result();                    // 移出结果（之后引擎内结果为空）
+
+    // ========= 断点 =========
+    // 保存当前状态（策略需实现 clone()，否则抛出 std::logic_error）
+    BacktestCheckpointT<Strategy> checkpoint() const;
+    // 从断点恢复：引擎改用断点中策略的副本（由引擎持有，见 get_strategy()）
+    void restore(const BacktestCheckpointT<Strategy>& checkpoint);
+    Strategy* get_strategy() const { return strategy_; }
+
+    /**
+     * @brief 设置流式输出（nullptr 取消）
+     *
+     * 设置后权益点与交易在产生时写入 sink，BacktestResult 与策略都不再保存交易和曲线，
+     * 内存占用与回测长度无关；汇总值与 equity_stats 照常计算。
+     */
+    void set_sink(ResultSink* sink);
+    size_t bars_processed() const { return bars_processed_; }
 
 private:
+    static constexpr bool kPolymorphic = std::is_same<Strategy, strategy::StrategyBase>::value;
+
     BacktestConfig config_;
-    strategy::StrategyBase* strategy_;
-    std::vector<OHLCV> data_;
+    Strategy* strategy_;
+    OHLCVSeries data_;    // 共享数据，多个引擎可同时引用同一份K线
     BacktestResult result_;
+    EquityRecorder recorder_;
+    OrderManager order_manager_;   // 挂单簿（限价/止损/止盈）
+    BarResampler resampler_;       // 策略订阅的高周期K线（从基础K线流增量合成）
+    LatencyQueue latency_;         // 在途的信号与订单请求（config.latency 启用时）
+    std::unique_ptr<Strategy> owned_strategy_;   // restore() 创建的策略副本
+    ResultSink* sink_;             // 流式输出（可为空）
+    bool started_;                 // 是否已运行（resume 据此决定是否续跑）
+    Timestamp last_timestamp_;     // 最后处理的K线时间戳
+    size_t bars_processed_;
+
+    // 逐Bar处理 [begin, end) 与汇总结果（run 与 resume 共用）
+    template <typename Iterator>
+    void process_bars(Iterator begin, Iterator end);
+    void finalize();
+    // 检查提前终止条件，触发时写入 result_.stop_reason
+    bool check_stop(const OHLCV& bar);
+    // 记录一笔成交（写入 sink 或保存到结果与策略中）
+    void record_trade(strategy::Trade& trade);
+
+    // 策略回调：具体类型用限定名直接调用，StrategyBase 走虚函数
+    void call_on_bar(const OHLCV& bar);
+    strategy::Signal call_generate_signal();
+    void call_on_order_update(const strategy::Order& order);
+    void call_on_timeframe_bar(Timeframe timeframe, const OHLCV& bar);
 
     // 私有方法  这三个私有方法具体是干什么的
     // 处理交易信号， 执行买入/卖出 操作
     void process_signal(strategy::Signal signal,const OHLCV& bar);
+    // 按给定成交价开仓/平仓并记录交易（quantity<=0 时按默认仓位计算数量）
+    bool execute_buy(const OHLCV& bar, double actual_price, double quantity);
+    bool execute_sell(const OHLCV& bar, double actual_price);
+    // 挂单撮合、接收订单请求、通知策略订单状态
+    void match_orders(const OHLCV& bar);
+    void accept_order_requests(const OHLCV& bar);
+    void accept_order_request(strategy::OrderRequest& request, Timestamp timestamp);
+    // 处理本Bar内到达的在途事件（信号按开盘价成交，订单请求进入挂单簿）
+    void process_arrivals(const OHLCV& bar);
+    void dispatch_order_updates();
     // 计算手续费
     double calculate_commission(double amount);
     // 计算滑点
     double calculate_slippage(double price);
 
 };
+
+// ========== 模板实现 ==========
+
+template <typename Strategy>
+BacktestEngineT<Strategy>::BacktestEngineT(const BacktestConfig& config)
+    : config_(config), strategy_(nullptr),
+      recorder_(config.record_mode, config.record_interval),
+      latency_(config.latency), sink_(nullptr), started_(false), last_timestamp_(0), bars_processed_(0) {
+    // 初始化 result_
+    result_.initial_capital = config_.initial_capital;
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::set_strategy(Strategy* strategy) {
+    strategy_ = strategy;
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::set_data(const std::vector<OHLCV>& data) {
+    data_ = OHLCVSeries(data);
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::set_data(std::vector<OHLCV>&& data) {
+    data_ = OHLCVSeries(std::move(data));
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::set_data(OHLCVSeries data) {
+    data_ = std::move(data);
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::set_sink(ResultSink* sink) {
+    sink_ = sink;
+    recorder_.set_sink(sink);
+}
+
+template <typename Strategy>
+inline void BacktestEngineT<Strategy>::call_on_bar(const OHLCV& bar) {
+    if constexpr (kPolymorphic) {
+        strategy_->on_bar(bar);
+    } else {
+        strategy_->Strategy::on_bar(bar);
+    }
+}
+
+template <typename Strategy>
+inline strategy::Signal BacktestEngineT<Strategy>::call_generate_signal() {
+    if constexpr (kPolymorphic) {
+        return strategy_->generate_signal();
+    } else {
+        return strategy_->Strategy::generate_signal();
+    }
+}
+
+template <typename Strategy>
+inline void BacktestEngineT<Strategy>::call_on_order_update(const strategy::Order& order) {
+    if constexpr (kPolymorphic) {
+        strategy_->on_order_update(order);
+    } else {
+        strategy_->Strategy::on_order_update(order);
+    }
+}
+
+template <typename Strategy>
+inline void BacktestEngineT<Strategy>::call_on_timeframe_bar(Timeframe timeframe, const OHLCV& bar) {
+    if constexpr (kPolymorphic) {
+        strategy_->on_timeframe_bar(timeframe, bar);
+    } else {
+        strategy_->Strategy::on_timeframe_bar(timeframe, bar);
+    }
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::run() {
+    //1. 验证
+    if (!strategy_ || data_.empty()) {
+        std::cerr << "策略或数据为空" << std::endl;
+        return;
+    }
+
+    // 2. 初始化
+    start(data_.front().timestamp, data_.size());
+
+    // 3. 回测循环
+    process_bars(data_.begin(), data_.end());
+    // 4. 汇总结果
+    finish();
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::start(Timestamp first_timestamp, size_t expected_bars) {
+    if (!strategy_) {
+        throw std::logic_error("BacktestEngine::start: 策略为空");
+    }
+
+    // 初始化策略
+    strategy_->on_init(config_.initial_capital);
+
+    // ============ 新增：初始化权益曲线 =========
+    // 重置结果（重复run或take_result之后保证状态干净）
+    result_ = BacktestResult();
+    result_.initial_capital = config_.initial_capital;
+
+    // 记录初始权益
+    if (sink_) sink_->on_begin(config_.initial_capital);
+    recorder_.begin(result_, first_timestamp, config_.initial_capital, expected_bars);
+
+    order_manager_.clear();
+    resampler_.clear();
+    latency_.clear();
+    for (Timeframe timeframe : strategy_->subscribed_timeframes()) {
+        resampler_.subscribe(timeframe);
+    }
+    bars_processed_ = 0;
+    started_ = true;
+}
+
+template <typename Strategy>
+bool BacktestEngineT<Strategy>::step(const OHLCV& bar) {
+    if (result_.stop_reason != StopReason::NONE) return false;
+    process_bars(&bar, &bar + 1);
+    return result_.stop_reason == StopReason::NONE;
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::finish() {
+    recorder_.finish(result_);
+    finalize();
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::resume(const OHLCVSeries& new_bars) {
+    if (!started_) {
+        set_data(new_bars);
+        run();
+        return;
+    }
+    if (!strategy_) {
+        std::cerr << "策略为空" << std::endl;
+        return;
+    }
+
+    // 跳过已处理的K线（按时间戳有序）
+    auto first = std::upper_bound(new_bars.begin(), new_bars.end(), last_timestamp_,
+                                  [](Timestamp ts, const OHLCV& bar) { return ts < bar.timestamp; });
+    if (first == new_bars.end() || result_.stop_reason != StopReason::NONE) return;
+
+    recorder_.reopen(result_);
+    if (sink_) sink_->on_begin(config_.initial_capital);
+    process_bars(first, new_bars.end());
+    finish();
 }
+
+template <typename Strategy>
+template <typename Iterator>
+void BacktestEngineT<Strategy>::process_bars(Iterator begin, Iterator end) {
+    const bool stop_enabled = config_.stop.enabled();
+    for (auto it = begin; it != end; ++it) {
+        const OHLCV& bar = *it;
+        int trades_before = result_.total_trades;
+
+        //3.0 延迟到达的信号/订单（没有在途事件时只比较堆顶）
+        if (latency_.due(bar.timestamp)) {
+            process_arrivals(bar);
+        }
+
+        //3.0.1 用本根K线撮合之前提交的挂单（挂单只能在提交后的Bar成交，无未来函数）
+        if (order_manager_.pending_count() > 0) {
+            match_orders(bar);
+            dispatch_order_updates();
+        }
+
+        //3.1 喂数据给策略
+        call_on_bar(bar);
+
+        //3.1.1 高周期K线收盘（只包含已收盘的基础K线）
+        if (!resampler_.empty()) {
+            resampler_.update(bar, [this](Timeframe timeframe, const OHLCV& closed) {
+                call_on_timeframe_bar(timeframe, closed);
+            });
+        }
+
+        //3.2 生成信号
+        auto signal = call_generate_signal();
+
+        //3.3 处理信号
+        if (signal != strategy::Signal::HOLD && signal != strategy::Signal::NONE) {
+            process_signal(signal, bar);
+        }
+
+        //3.4 接收策略提交/撤销的订单
+        if (strategy_->has_order_requests()) {
+            accept_order_requests(bar);
+        }
+        dispatch_order_updates();
+        // ============ 记录每个Bar结束时的权益 =========
+        // 更新持仓价格（用于计算未实现盈亏）
+        if (strategy_->get_position().quantity > 0) {
+            strategy_->update_position_price(bar.close);
+        }
+
+        // 记录当前总权益（按记录模式采样，统计量每个Bar都更新）
+        double current_equity = strategy_->get_total_equity();
+        recorder_.record(result_, bar.timestamp, current_equity,
+                         result_.total_trades != trades_before);
+        last_timestamp_ = bar.timestamp;
+        bars_processed_++;
+
+        if (stop_enabled && check_stop(bar)) {
+            break;
+        }
+    }
+}
+
+template <typename Strategy>
+bool BacktestEngineT<Strategy>::check_stop(const OHLCV& bar) {
+    const StopConditions& stop = config_.stop;
+    const analysis::EquityStatistics& stats = result_.equity_stats;
+
+    StopReason reason = StopReason::NONE;
+    if (stop.max_drawdown > 0 && stats.max_drawdown() >= stop.max_drawdown) {
+        reason = StopReason::MAX_DRAWDOWN;
+    } else if (stop.equity_floor > 0 && stats.last_equity() < stop.equity_floor) {
+        reason = StopReason::EQUITY_FLOOR;
+    } else if (stop.min_trades > 0 && stop.min_trades_bars > 0 &&
+               bars_processed_ >= stop.min_trades_bars &&
+               static_cast<size_t>(result_.total_trades) < stop.min_trades) {
+        reason = StopReason::MIN_TRADES;
+    }
+
+    if (reason == StopReason::NONE) return false;
+    result_.stop_reason = reason;
+    result_.stopped_at = bar.timestamp;
+    return true;
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::finalize() {
+    result_.final_capital = strategy_->get_capital();
+    result_.final_equity = strategy_->get_total_equity();
+    result_.total_return = strategy_->get_total_return();
+    if (sink_) sink_->on_finish(result_);
 }
 
+template <typename Strategy>
+void BacktestEngineT<Strategy>::record_trade(strategy::Trade& trade) {
+    result_.total_trades++;
+    if (sink_) {
+        sink_->on_trade(trade);
+        return;
+    }
+    strategy_->add_trade(trade);
+    result_.trades.push_back(std::move(trade));
+}
+
+template <typename Strategy>
+BacktestCheckpointT<Strategy> BacktestEngineT<Strategy>::checkpoint() const {
+    if (!strategy_) {
+        throw std::logic_error("BacktestEngine::checkpoint: 策略为空");
+    }
+    std::unique_ptr<strategy::StrategyBase> copy = strategy_->clone();
+    if (!copy) {
+        throw std::logic_error("BacktestEngine::checkpoint: 策略 " + strategy_->get_name() + " 未实现 clone()");
+    }
+
+    BacktestCheckpointT<Strategy> checkpoint;
+    checkpoint.config = config_;
+    checkpoint.strategy.reset(static_cast<Strategy*>(copy.release()));
+    checkpoint.result = result_;
+    checkpoint.recorder = recorder_;
+    checkpoint.order_manager = order_manager_;
+    checkpoint.resampler = resampler_;
+    checkpoint.latency = latency_;
+    checkpoint.last_timestamp = last_timestamp_;
+    checkpoint.bars_processed = bars_processed_;
+    return checkpoint;
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::restore(const BacktestCheckpointT<Strategy>& checkpoint) {
+    if (!checkpoint.strategy) {
+        throw std::invalid_argument("BacktestEngine::restore: 断点中没有策略状态");
+    }
+    std::unique_ptr<strategy::StrategyBase> copy = checkpoint.strategy->clone();
+    owned_strategy_.reset(static_cast<Strategy*>(copy.release()));
+    strategy_ = owned_strategy_.get();
+
+    config_ = checkpoint.config;
+    result_ = checkpoint.result;
+    recorder_ = checkpoint.recorder;
+    recorder_.set_sink(sink_);
+    order_manager_ = checkpoint.order_manager;
+    resampler_ = checkpoint.resampler;
+    latency_ = checkpoint.latency;
+    last_timestamp_ = checkpoint.last_timestamp;
+    bars_processed_ = checkpoint.bars_processed;
+    started_ = true;
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::process_signal(strategy::Signal signal, const OHLCV& bar) {
+    // 启用延迟时信号在收盘时发出，按到达后第一根Bar的开盘价成交
+    if (latency_.enabled()) {
+        latency_.push_signal(signal, bar.timestamp + timeframe_to_milliseconds(bar.timeframe), bar.timeframe);
+        return;
+    }
 
+    if (signal == strategy::Signal::BUY) {
+        // 计算滑点后的实际价格
+        double slippage = calculate_slippage(bar.close);
+        double actual_price = bar.close + slippage;  // 买入时价格上涨
+        execute_buy(bar, actual_price, 0.0);
+    } else if (signal == strategy::Signal::SELL) {
+        // 计算滑点后的实际价格
+        double slippage = calculate_slippage(bar.close);
+        double actual_price = bar.close - slippage;  // 卖出时价格下跌
+        execute_sell(bar, actual_price);
+    }
+}
+
+template <typename Strategy>
+bool BacktestEngineT<Strategy>::execute_buy(const OHLCV& bar, double actual_price, double quantity) {
+    if (strategy_->get_position().has_position() || actual_price <= 0) {
+        return false;
+    }
+
+    if (quantity <= 0) {
+        // 计算买入金额（使用当前资金的一定比例，如50%）
+        double capital = strategy_->get_capital();
+        double buy_amount = capital * config_.position_size;  // 默认50%仓位
+
+        // 计算手续费
+        double commission = calculate_commission(buy_amount);
+
+        // 计算实际能买的数量
+        quantity = (buy_amount - commission) / actual_price;
+    } else if (quantity * actual_price > strategy_->get_capital()) {
+        return false;  // 资金不足
+    }
+
+    // 开仓
+    strategy_->open_position(bar.symbol, quantity, actual_price);
+
+    // 记录交易
+    strategy::Trade trade;
+    trade.timestamp = bar.timestamp;
+    trade.symbol = bar.symbol;
+    trade.signal = strategy::Signal::BUY;
+    trade.price = actual_price;
+    trade.quantity = quantity;
+    trade.pnl = 0;
+    record_trade(trade);
+    return true;
+}
+
+template <typename Strategy>
+bool BacktestEngineT<Strategy>::execute_sell(const OHLCV& bar, double actual_price) {
+    if (!strategy_->get_position().has_position()) {
+        return false;
+    }
+
+    // 保存持仓数量（在平仓前）
+    double position_quantity = strategy_->get_position().quantity;
+
+    // 平仓并获取盈亏
+    double pnl = strategy_->close_position(actual_price);
+
+    // 计算手续费
+    double sell_amount = actual_price * position_quantity;
+    double commission = calculate_commission(sell_amount);
+
+    // 从盈亏中扣除手续费
+    pnl -= commission;
+
+    // 记录交易
+    strategy::Trade trade;
+    trade.timestamp = bar.timestamp;
+    trade.symbol = bar.symbol;
+    trade.signal = strategy::Signal::SELL;
+    trade.price = actual_price;
+    trade.quantity = 0;
+    trade.pnl = pnl;
+    record_trade(trade);
+
+    // 统计胜率
+    if (pnl > 0) {
+        result_.winning_trades++;
+    } else if (pnl < 0) {
+        result_.losing_trades++;
+    }
+    return true;
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::match_orders(const OHLCV& bar) {
+    order_manager_.match_bar(bar, [this, &bar](strategy::Order& order, Price price, bool taker) {
+        // 主动成交（市价/止损）计算滑点，限价单按挂单价成交
+        double actual_price = price;
+        if (taker) {
+            double slippage = calculate_slippage(price);
+            actual_price = (order.side == Side::BUY) ? price + slippage : price - slippage;
+        }
+        bool filled = (order.side == Side::BUY) ? execute_buy(bar, actual_price, order.quantity)
+                                                : execute_sell(bar, actual_price);
+        if (filled) {
+            order.fill_price = actual_price;
+            order.filled_at = bar.timestamp;
+        }
+        return filled;
+    });
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::accept_order_requests(const OHLCV& bar) {
+    Timestamp sent_at = bar.timestamp + timeframe_to_milliseconds(bar.timeframe);
+    for (auto& request : strategy_->take_order_requests()) {
+        if (latency_.enabled()) {
+            latency_.push_request(request, sent_at, bar.timeframe);
+        } else {
+            accept_order_request(request, bar.timestamp);
+        }
+    }
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::accept_order_request(strategy::OrderRequest& request, Timestamp timestamp) {
+    if (request.cancel) {
+        order_manager_.cancel(request.order.id);
+    } else {
+        request.order.created_at = timestamp;
+        order_manager_.submit(request.order);
+    }
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::process_arrivals(const OHLCV& bar) {
+    while (latency_.due(bar.timestamp)) {
+        LatencyEvent event = latency_.pop();
+        if (event.is_request) {
+            accept_order_request(event.request, bar.timestamp);
+        } else if (event.signal == strategy::Signal::BUY) {
+            execute_buy(bar, bar.open + calculate_slippage(bar.open), 0.0);
+        } else if (event.signal == strategy::Signal::SELL) {
+            execute_sell(bar, bar.open - calculate_slippage(bar.open));
+        }
+    }
+}
+
+template <typename Strategy>
+void BacktestEngineT<Strategy>::dispatch_order_updates() {
+    if (!order_manager_.has_updates()) return;
+    for (const auto& order : order_manager_.take_updates()) {
+        call_on_order_update(order);
+    }
+}
+
+template <typename Strategy>
+inline double BacktestEngineT<Strategy>::calculate_commission(double amount) {
+    return amount * config_.commission_rate;
+}
+
+template <typename Strategy>
+inline double BacktestEngineT<Strategy>::calculate_slippage(double price) {
+    return price * config_.slippage_rate;
+}
+
+template <typename Strategy>
+const BacktestResult& BacktestEngineT<Strategy>::get_result() const {
+    return result_;
+}
+
+template <typename Strategy>
+BacktestResult BacktestEngineT<Strategy>::take_result() {
+    return std::move(result_);
+}
+
+// 多态引擎（虚函数分派），在 backtest_engine.cpp 中显式实例化
+using BacktestEngine = BacktestEngineT<strategy::StrategyBase>;
+using BacktestCheckpoint = BacktestCheckpointT<strategy::StrategyBase>;
+extern template class BacktestEngineT<strategy::StrategyBase>;
+
+}
+}
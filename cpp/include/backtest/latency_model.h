@@ -0,0 +1,89 @@
+#pragma once
+
+#include "common/types.h"
+#include "strategy/strategy_base.h"
+#include "strategy/order.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace quant_crypto {
+namespace backtest {
+
+// 下单延迟配置（全部为0时不模拟延迟：信号按当前Bar收盘价立即成交）
+struct LatencyConfig {
+    int64_t fixed_ms;                // 固定延迟（毫秒）
+    int64_t jitter_ms;               // 随机抖动上限：延迟 = fixed_ms + U[0, jitter_ms]
+    std::vector<int64_t> samples_ms; // 实测延迟样本（非空时从中均匀抽样，忽略 fixed/jitter）
+    uint64_t seed;                   // 随机种子（保证回测可复现）
+
+    LatencyConfig() : fixed_ms(0), jitter_ms(0), seed(42) {}
+
+    bool enabled() const { return fixed_ms > 0 || jitter_ms > 0 || !samples_ms.empty(); }
+};
+
+// 延迟队列中的事件：交易信号或订单请求
+struct LatencyEvent {
+    Timestamp sent_at;      // 发出时间（信号所在Bar的收盘时间）
+    Timestamp arrival;      // 到达交易所的时间
+    Timestamp due_at;       // 到达后第一根Bar的开盘时间（>= arrival，该Bar开始处理事件）
+    uint64_t sequence;      // 发出顺序（同时到达时先发先处理）
+    bool is_request;        // true: request 有效；false: signal 有效
+    strategy::Signal signal;
+    strategy::OrderRequest request;
+
+    LatencyEvent()
+        : sent_at(0), arrival(0), due_at(0), sequence(0), is_request(false),
+          signal(strategy::Signal::NONE) {}
+};
+
+/**
+ * @class LatencyQueue
+ * @brief 按到达时间排序的事件队列（最小堆）
+ *
+ * 信号和订单请求在Bar收盘时发出，经过延迟后到达；回测引擎每根Bar只比较堆顶，
+ * 没有在途订单时不产生任何开销，处理k个事件的成本为 O(k log n)。
+ * K线数据无法得知Bar内的成交价，事件由开盘时间不早于到达时间的第一根Bar处理：
+ * 市价信号按该Bar开盘价（加滑点）成交，订单请求从该Bar开始参与撮合。
+ * 例如 1 分钟K线上 300ms 的延迟：第k根收盘（即第k+1根开盘）发出的信号错过第k+1根的开盘价，
+ * 按第k+2根的开盘价成交。
+ */
+class LatencyQueue {
+public:
+    explicit LatencyQueue(const LatencyConfig& config = LatencyConfig());
+
+    bool enabled() const { return enabled_; }
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+
+    // 清空队列并重置随机数（重新回测时调用）
+    void clear();
+
+    /**
+     * @brief 发出交易信号/订单请求
+     * @param sent_at 发出时间
+     * @param timeframe 数据周期（用于确定到达后的第一根Bar）
+     */
+    void push_signal(strategy::Signal signal, Timestamp sent_at, Timeframe timeframe);
+    void push_request(const strategy::OrderRequest& request, Timestamp sent_at, Timeframe timeframe);
+
+    // 堆顶事件是否应在开盘时间为 bar_open 的Bar中处理
+    bool due(Timestamp bar_open) const { return !heap_.empty() && heap_.front().due_at <= bar_open; }
+    // 取出最早到达的事件
+    LatencyEvent pop();
+
+    // 抽样一次延迟（毫秒）
+    int64_t sample_delay();
+
+private:
+    LatencyConfig config_;
+    bool enabled_;
+    std::mt19937_64 rng_;
+    std::vector<LatencyEvent> heap_;
+    uint64_t next_sequence_;
+
+    void push(LatencyEvent event, Timestamp sent_at, Timeframe timeframe);
+};
+
+} // namespace backtest
+} // namespace quant_crypto
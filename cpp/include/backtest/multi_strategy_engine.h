@@ -0,0 +1,61 @@
+#pragma once
+
+#include "common/ohlcv_series.h"
+#include "backtest/backtest_engine.h"
+#include "indicators/indicator_registry.h"
+#include "strategy/strategy_base.h"
+#include <memory>
+#include <vector>
+
+namespace quant_crypto {
+namespace backtest {
+
+/**
+ * @class MultiStrategyEngine
+ * @brief 多策略回测：一次遍历数据，每根K线依次分发给N个策略
+ *
+ * 每个策略有独立的账户、挂单簿与结果（内部各持有一个 BacktestEngine），
+ * 单个策略的结果与单独用 BacktestEngine 回测完全相同。
+ * 外层循环是K线、内层是策略：每根K线只从内存读一次，
+ * 数据访问量为 O(数据量) 而不是 O(数据量 × 策略数)。
+ * 支持共享指标的策略（实现 set_indicator_registry）从同一个 IndicatorRegistry 取值，
+ * 相同的指标每根K线只计算一次。
+ */
+class MultiStrategyEngine {
+public:
+    explicit MultiStrategyEngine(const BacktestConfig& config);
+    // 解除策略对内部指标注册表的引用，策略之后仍可单独回测
+    ~MultiStrategyEngine();
+    // 策略持有 registry_ 的地址，不能复制或移动
+    MultiStrategyEngine(const MultiStrategyEngine&) = delete;
+    MultiStrategyEngine& operator=(const MultiStrategyEngine&) = delete;
+
+    /**
+     * @brief 添加策略（不接管所有权，策略需在本引擎销毁前有效）
+     * @return 策略序号（get_result 使用）
+     */
+    size_t add_strategy(strategy::StrategyBase* strategy);
+    // 使用单独的回测配置（如不同的手续费或仓位比例）
+    size_t add_strategy(strategy::StrategyBase* strategy, const BacktestConfig& config);
+
+    void set_data(OHLCVSeries data) { data_ = std::move(data); }
+    void run();
+
+    size_t size() const { return engines_.size(); }
+    const BacktestResult& get_result(size_t index) const { return engines_.at(index)->get_result(); }
+    std::vector<BacktestResult> take_results();
+    BacktestEngine& engine(size_t index) { return *engines_.at(index); }
+
+    // 共享指标
+    const indicators::IndicatorRegistry& indicators() const { return registry_; }
+
+private:
+    BacktestConfig config_;
+    OHLCVSeries data_;
+    std::vector<std::unique_ptr<BacktestEngine>> engines_;
+    std::vector<strategy::StrategyBase*> strategies_;   // 与 engines_ 一一对应
+    indicators::IndicatorRegistry registry_;
+};
+
+} // namespace backtest
+} // namespace quant_crypto
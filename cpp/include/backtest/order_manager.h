@@ -0,0 +1,105 @@
+#pragma once
+
+#include "common/types.h"
+#include "strategy/order.h"
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace quant_crypto {
+namespace backtest {
+
+/**
+ * @class OrderManager
+ * @brief 回测挂单簿：按K线最高/最低价撮合限价、止损、止盈订单
+ *
+ * 挂单按价格存放在有序结构中，每根Bar只访问被触及的订单，
+ * 检查n个挂单的成本为 O(log n + 成交数)。
+ *
+ * Bar内价格路径假设（确定性）：
+ *   阳线（close >= open）：open -> low -> high -> close
+ *   阴线（close <  open）：open -> high -> low -> close
+ * 开盘价跳空越过的挂单按开盘价成交；其余订单在路径经过其价格时成交，
+ * 同一段路径内按价格经过的先后顺序处理。
+ */
+class OrderManager {
+public:
+    /**
+     * @brief 成交回调
+     * @param order 订单（回调可写入成交价等信息）
+     * @param price 撮合价格（未含滑点）
+     * @param taker 是否为主动成交（市价单/止损触发，回调据此计算滑点）
+     * @return 执行成功返回true，否则订单被拒绝
+     */
+    using FillHandler = std::function<bool(strategy::Order& order, Price price, bool taker)>;
+
+    OrderManager() = default;
+    // 拷贝/移动后重新指向本对象的价格簿（用于回测断点）
+    OrderManager(const OrderManager& other);
+    OrderManager(OrderManager&& other) noexcept;
+    OrderManager& operator=(const OrderManager& other);
+    OrderManager& operator=(OrderManager&& other) noexcept;
+
+    /**
+     * @brief 提交订单
+     * @return 订单参数不合法时返回false（订单状态为REJECTED，记入更新列表）
+     */
+    bool submit(const strategy::Order& order);
+
+    /**
+     * @brief 撤销挂单
+     * @return 订单不存在（已成交/已撤销）时返回false
+     */
+    bool cancel(strategy::OrderId id);
+
+    /**
+     * @brief 用一根K线撮合所有挂单
+     * @param bar K线
+     * @param on_fill 成交回调
+     */
+    void match_bar(const OHLCV& bar, const FillHandler& on_fill);
+
+    // 取走状态发生变化的订单（成交/撤销/拒绝）
+    std::vector<strategy::Order> take_updates();
+    bool has_updates() const { return !updates_.empty(); }
+
+    const strategy::Order* find(strategy::OrderId id) const;
+    size_t pending_count() const { return orders_.size(); }
+    void clear();
+
+private:
+    // 所有价格簿的key都按升序排列；需要降序遍历的簿存放负价格
+    using Book = std::multimap<Price, strategy::OrderId>;
+
+    struct Entry {
+        strategy::Order order;
+        Book* book;              // 所在价格簿（市价单为nullptr）
+        Book::iterator it;
+    };
+
+    Book buy_limits_;    // key = -限价（价格高的优先）
+    Book sell_limits_;   // key =  限价（价格低的优先）
+    Book buy_stops_;     // key =  触发价（上涨时先触及低的）
+    Book sell_stops_;    // key = -触发价（下跌时先触及高的）
+    std::vector<strategy::OrderId> market_orders_;   // 下一根Bar开盘成交
+    std::unordered_map<strategy::OrderId, Entry> orders_;
+    std::unordered_multimap<int64_t, strategy::OrderId> oco_groups_;
+    std::vector<strategy::Order> updates_;
+
+    void relink();
+    void insert_limit(Entry& entry);
+    void insert_stop(Entry& entry);
+    void detach(Entry& entry);
+    void finish(strategy::OrderId id, strategy::OrderStatus status);
+
+    void execute(strategy::OrderId id, Price price, bool taker, const FillHandler& on_fill);
+    void trigger_stop(strategy::OrderId id, Price price, bool taker, const FillHandler& on_fill);
+
+    void match_at_open(Price open, const FillHandler& on_fill);
+    void sweep_up(Price to, const FillHandler& on_fill);
+    void sweep_down(Price to, const FillHandler& on_fill);
+};
+
+} // namespace backtest
+} // namespace quant_crypto
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "common/ohlcv_series.h"
+#include "backtest/backtest_engine.h"
+#include "strategy/strategy_base.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace quant_crypto {
+namespace backtest {
+
+using ParamSet = std::map<std::string, double>;
+
+// 逐级减半优化参数
+struct HalvingOptions {
+    double initial_fraction;   // 第一轮使用的数据比例
+    double keep_fraction;      // 每轮保留的候选比例（数据长度按其倒数增长）
+    size_t min_survivors;      // 每轮至少保留的候选数
+    size_t threads;            // 并行线程数（0 = 硬件线程数）
+
+    HalvingOptions()
+        : initial_fraction(0.1), keep_fraction(0.5), min_survivors(1), threads(0) {}
+};
+
+// 单个候选的优化结果
+struct OptimizationResult {
+    ParamSet params;
+    double score;              // 最后一轮的评分
+    size_t rounds_survived;    // 存活的轮数（跑完全部数据的候选等于总轮数）
+    size_t bars_processed;     // 实际处理的K线数量
+    StopReason stop_reason;    // 被终止条件剪枝时的原因
+    double final_equity;
+    double total_return;
+    int total_trades;
+    double max_drawdown;
+    double sharpe_ratio;
+
+    OptimizationResult()
+        : score(0.0), rounds_survived(0), bars_processed(0), stop_reason(StopReason::NONE),
+          final_equity(0.0), total_return(0.0), total_trades(0), max_drawdown(0.0), sharpe_ratio(0.0) {}
+};
+
+/**
+ * @class SuccessiveHalvingOptimizer
+ * @brief 逐级减半参数优化（Successive Halving）
+ *
+ * 第一轮所有候选只回测前 initial_fraction 的数据，按评分保留前 keep_fraction，
+ * 下一轮数据长度乘以 1/keep_fraction，直到最后一轮跑完全部数据。
+ * 晋级的候选通过 BacktestEngine::resume 只处理新增K线，不重复计算；
+ * 触发 config.stop 终止条件的候选立即淘汰。
+ * 默认参数（10%起步、每轮减半）下总计算量约为全量网格搜索的 1/4，
+ * 配合终止条件剪枝可以更低。
+ */
+class SuccessiveHalvingOptimizer {
+public:
+    using StrategyFactory = std::function<std::unique_ptr<strategy::StrategyBase>(const ParamSet& params)>;
+    using ScoreFunction = std::function<double(const BacktestResult& result)>;
+
+    /**
+     * @param factory 按参数创建策略（多线程调用，需线程安全）
+     * @param config 回测配置（曲线记录模式被强制为 NONE，评分只用统计量）
+     * @param options 优化参数
+     */
+    SuccessiveHalvingOptimizer(StrategyFactory factory,
+                               const BacktestConfig& config,
+                               const HalvingOptions& options = HalvingOptions());
+
+    // 设置评分函数（默认：equity_stats 的夏普比率）
+    void set_score_function(ScoreFunction score);
+
+    /**
+     * @brief 运行优化
+     * @param data K线数据
+     * @param candidates 候选参数
+     * @return 全部候选的结果，按存活轮数、评分降序排列（第一个为最优）
+     */
+    std::vector<OptimizationResult> run(const OHLCVSeries& data,
+                                        const std::vector<ParamSet>& candidates) const;
+
+    // 本次 run() 实际处理的K线总数（所有候选累加，用于评估节省的计算量）
+    size_t last_bars_processed() const { return last_bars_processed_; }
+
+    // MA交叉策略工厂（参数：fast_period / slow_period / position_size）
+    static StrategyFactory ma_cross_factory();
+
+private:
+    StrategyFactory factory_;
+    BacktestConfig config_;
+    HalvingOptions options_;
+    ScoreFunction score_;
+    mutable size_t last_bars_processed_;
+};
+
+} // namespace backtest
+} // namespace quant_crypto
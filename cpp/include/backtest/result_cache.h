@@ -0,0 +1,150 @@
+#pragma once
+
+#include "common/types.h"
+#include "common/ohlcv_series.h"
+#include "backtest/backtest_engine.h"
+#include "analysis/performance_metrics.h"
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace quant_crypto {
+namespace backtest {
+
+/**
+ * @class ContentHasher
+ * @brief 流式内容哈希（FNV-1a 的64位字变体）
+ *
+ * 按8字节字混合而不是逐字节，5000根K线的哈希在几十微秒内完成。
+ * 只用于缓存寻址，不是密码学哈希。
+ */
+class ContentHasher {
+public:
+    ContentHasher() : hash_(kOffsetBasis) {}
+
+    void update_word(uint64_t word) {
+        hash_ ^= word;
+        hash_ *= kPrime;
+    }
+    void update(int64_t value) { update_word(static_cast<uint64_t>(value)); }
+    void update(double value) {
+        uint64_t word;
+        std::memcpy(&word, &value, sizeof(word));
+        update_word(word);
+    }
+    void update(const std::string& value);   // 长度 + 内容
+    void update(const OHLCV& bar);           // 时间戳、交易所、交易对、周期与价格/成交量字段
+
+    uint64_t digest() const { return hash_; }
+
+private:
+    static constexpr uint64_t kOffsetBasis = 14695981039346656037ULL;
+    static constexpr uint64_t kPrime = 1099511628211ULL;
+    uint64_t hash_;
+};
+
+// 缓存键：数据内容 + 策略/参数/配置
+struct BacktestCacheKey {
+    uint64_t data_hash;     // K线内容哈希
+    size_t bar_count;       // K线数量
+    uint64_t params_hash;   // 策略名称、策略参数与回测配置的哈希
+
+    BacktestCacheKey() : data_hash(0), bar_count(0), params_hash(0) {}
+
+    bool operator==(const BacktestCacheKey& other) const {
+        return data_hash == other.data_hash && bar_count == other.bar_count &&
+               params_hash == other.params_hash;
+    }
+    std::string to_string() const;   // 十六进制表示（也用作落盘文件名）
+};
+
+struct BacktestCacheKeyHash {
+    size_t operator()(const BacktestCacheKey& key) const {
+        return static_cast<size_t>(key.data_hash ^ (key.params_hash * 31) ^ key.bar_count);
+    }
+};
+
+// 缓存条目（只读共享，命中时不复制）
+struct CachedBacktest {
+    BacktestCacheKey key;
+    BacktestResult result;
+    analysis::PerformanceMetrics metrics;
+};
+
+// 缓存统计
+struct CacheStats {
+    size_t hits;          // 内存命中
+    size_t disk_hits;     // 落盘命中（已载回内存）
+    size_t misses;
+    size_t evictions;     // 从内存淘汰的条目数
+    size_t spills;        // 淘汰时写入磁盘的条目数
+
+    CacheStats() : hits(0), disk_hits(0), misses(0), evictions(0), spills(0) {}
+};
+
+/**
+ * @class BacktestResultCache
+ * @brief 以内容哈希寻址的回测结果缓存（内存LRU + 可选落盘）
+ *
+ * 相同数据、相同策略参数与配置的回测直接返回缓存的 BacktestResult 与 PerformanceMetrics。
+ * 设置 spill_dir 后，被淘汰的条目写入磁盘，之后命中时再载回内存。
+ * 只做精确匹配；需要在已有结果上追加K线时，由调用方保存引擎断点（checkpoint/resume）。
+ * 所有接口线程安全。
+ */
+class BacktestResultCache {
+public:
+    /**
+     * @param capacity 内存中最多保存的条目数
+     * @param spill_dir 落盘目录（为空则不落盘）
+     */
+    explicit BacktestResultCache(size_t capacity = 64, const std::string& spill_dir = "");
+
+    // ========== 生成缓存键 ==========
+    static uint64_t hash_data(const OHLCVSeries& data);
+    static uint64_t hash_data(const std::vector<OHLCV>& data);
+    static uint64_t hash_params(const std::string& strategy_name,
+                                const std::map<std::string, double>& params,
+                                const BacktestConfig& config);
+    static BacktestCacheKey make_key(const OHLCVSeries& data,
+                                     const std::string& strategy_name,
+                                     const std::map<std::string, double>& params,
+                                     const BacktestConfig& config);
+
+    // ========== 查询与写入 ==========
+    // 精确查找，未命中返回nullptr
+    std::shared_ptr<const CachedBacktest> find(const BacktestCacheKey& key);
+    std::shared_ptr<const CachedBacktest> put(const BacktestCacheKey& key,
+                                              BacktestResult result,
+                                              analysis::PerformanceMetrics metrics);
+
+    void clear();          // 只清空内存，不删除落盘文件
+    size_t size() const;
+    CacheStats stats() const;
+
+private:
+    using Entry = std::shared_ptr<const CachedBacktest>;
+    using LruList = std::list<Entry>;
+
+    size_t capacity_;
+    std::string spill_dir_;
+    mutable std::mutex mutex_;
+    LruList lru_;   // 头部为最近使用
+    std::unordered_map<BacktestCacheKey, LruList::iterator, BacktestCacheKeyHash> index_;
+    CacheStats stats_;
+
+    // 以下方法调用时已持有锁
+    void insert_locked(Entry entry);
+    void touch_locked(LruList::iterator it);
+    std::string spill_path(const BacktestCacheKey& key) const;
+    bool spill(const CachedBacktest& entry) const;
+    Entry load(const BacktestCacheKey& key) const;
+};
+
+} // namespace backtest
+} // namespace quant_crypto
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "common/types.h"
+#include "strategy/strategy_base.h"
+#include "analysis/equity_statistics.h"
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace quant_crypto {
+namespace backtest {
+
+struct BacktestResult;
+
+/**
+ * @class ResultSink
+ * @brief 回测输出接口：权益点与交易在产生时写出，不在内存中累积
+ *
+ * 回测引擎设置 sink 后，BacktestResult 只保留汇总值与在线统计（equity_stats），
+ * equity_curve / timestamps / trades 为空。
+ */
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+
+    virtual void on_begin(double initial_capital) { (void)initial_capital; }
+    virtual void on_equity(Timestamp timestamp, double equity) = 0;
+    virtual void on_trade(const strategy::Trade& trade) = 0;
+    // 回测（或一次 resume）结束时调用，result 中的汇总值已更新
+    virtual void on_finish(const BacktestResult& result) { (void)result; }
+};
+
+// 流式结果文件中的记录类型
+enum class ResultRecordType : uint8_t {
+    EQUITY = 1,    // 时间戳 + 权益
+    TRADE = 2,     // 一笔交易
+    SUMMARY = 3    // 汇总值 + 在线统计（可出现多次，以最后一条为准）
+};
+
+// 汇总记录
+struct ResultSummary {
+    double initial_capital;
+    double final_capital;
+    double final_equity;
+    double total_return;
+    int32_t total_trades;
+    int32_t winning_trades;
+    int32_t losing_trades;
+    analysis::EquityStatistics::State equity_stats;
+};
+
+/**
+ * @class BinaryResultWriter
+ * @brief 带缓冲的二进制结果写入器
+ *
+ * 文件格式（本机字节序）：
+ *   文件头：magic "QCRS"(u32) | version(u32) | initial_capital(f64)
+ *   记录：  type(u8) + 负载
+ *     EQUITY  : timestamp(i64) equity(f64)
+ *     TRADE   : timestamp(i64) signal(i32) price(f64) quantity(f64) pnl(f64)
+ *               symbol_len(u16) symbol
+ *     SUMMARY : initial_capital final_capital final_equity total_return(f64)
+ *               total_trades winning_trades losing_trades(i32)
+ *               EquityStatistics::State 各字段（计数为 u64，其余按声明类型）
+ * 记录按发生顺序交错写入，分析时只需顺序读一遍。内存占用固定为缓冲区大小。
+ */
+class BinaryResultWriter : public ResultSink {
+public:
+    explicit BinaryResultWriter(const std::string& path, size_t buffer_bytes = 1 << 20);
+    ~BinaryResultWriter() override;
+
+    bool is_open() const { return out_.is_open(); }
+    void flush();
+    void close();
+
+    void on_begin(double initial_capital) override;
+    void on_equity(Timestamp timestamp, double equity) override;
+    void on_trade(const strategy::Trade& trade) override;
+    void on_finish(const BacktestResult& result) override;
+
+    size_t equity_count() const { return equity_count_; }
+    size_t trade_count() const { return trade_count_; }
+
+private:
+    std::ofstream out_;
+    std::vector<char> buffer_;
+    size_t used_;
+    bool header_written_;
+    size_t equity_count_;
+    size_t trade_count_;
+
+    template <typename T>
+    void put(const T& value);
+    void put_bytes(const void* data, size_t size);
+};
+
+/**
+ * @class BinaryResultReader
+ * @brief 顺序读取 BinaryResultWriter 写出的文件
+ */
+class BinaryResultReader {
+public:
+    using EquityHandler = std::function<void(Timestamp timestamp, double equity)>;
+    using TradeHandler = std::function<void(const strategy::Trade& trade)>;
+    using SummaryHandler = std::function<void(const ResultSummary& summary)>;
+
+    explicit BinaryResultReader(const std::string& path, size_t buffer_bytes = 1 << 20);
+
+    bool is_open() const { return valid_; }
+    double initial_capital() const { return initial_capital_; }
+
+    /**
+     * @brief 顺序读取全部记录，按类型回调
+     * @return 文件完整读完返回true；遇到截断或未知记录返回false（之前的记录已回调）
+     */
+    bool read_all(const EquityHandler& on_equity,
+                  const TradeHandler& on_trade,
+                  const SummaryHandler& on_summary);
+
+private:
+    std::ifstream in_;
+    std::vector<char> buffer_;
+    size_t pos_;
+    size_t size_;
+    bool valid_;
+    double initial_capital_;
+
+    bool fetch(void* data, size_t size);
+    template <typename T>
+    bool get(T& value) { return fetch(&value, sizeof(T)); }
+};
+
+} // namespace backtest
+} // namespace quant_crypto
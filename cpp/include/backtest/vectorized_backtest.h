@@ -0,0 +1,68 @@
+#pragma once
+
+#include "backtest/backtest_engine.h"
+#include "common/ohlcv_series.h"
+#include <string>
+#include <vector>
+
+namespace quant_crypto {
+namespace backtest {
+
+/**
+ * @class VectorizedBacktest
+ * @brief 向量化回测：输入收盘价与目标持仓数组，直接计算权益、交易与统计
+ *
+ * 目标持仓 > 0 表示持有多头，<= 0 表示空仓。持仓由空变多时在该Bar收盘买入，
+ * 由多变空时在该Bar收盘卖出；成交价、滑点、手续费与仓位比例
+ * 和 BacktestEngine 处理 BUY/SELL 信号的方式完全一致，结果可以直接对比。
+ *
+ * 计算流程：先找出持仓翻转点，只在翻转点上顺序结算交易；
+ * 每段持仓期内权益 = 现金 + 数量 × 收盘价，按块写入并批量更新统计量，
+ * 内层循环没有虚函数调用和跨元素依赖。
+ *
+ * 吞吐量（单核，-O2，持仓每 500 根翻转一次，见 test_vectorized_backtest）：
+ * FULL 约 3000~3600 万 Bar/秒，NONE 约 4500~7700 万 Bar/秒，未达到 1 亿 Bar/秒。
+ * FULL 每根Bar要写入 16 字节曲线（时间戳 + 权益），受内存带宽限制；
+ * NONE 的瓶颈是统计量中每根Bar一次的收益率除法与回撤计算。
+ */
+class VectorizedBacktest {
+public:
+    explicit VectorizedBacktest(const BacktestConfig& config);
+
+    /**
+     * @brief 运行向量化回测
+     * @param closes 收盘价序列
+     * @param target_positions 目标持仓序列（与 closes 等长）
+     * @param timestamps 时间戳序列（与 closes 等长）
+     * @param symbol 交易对（写入交易记录）
+     * @return 回测结果（曲线按 config.record_mode 记录，统计量覆盖全部Bar）
+     */
+    BacktestResult run(
+        const std::vector<double>& closes,
+        const std::vector<double>& target_positions,
+        const std::vector<Timestamp>& timestamps,
+        const std::string& symbol = ""
+    ) const;
+
+    /**
+     * @brief 直接使用K线序列运行（取收盘价与时间戳）
+     */
+    BacktestResult run(
+        const OHLCVSeries& data,
+        const std::vector<double>& target_positions
+    ) const;
+
+private:
+    BacktestConfig config_;
+
+    BacktestResult run_impl(
+        const double* closes,
+        const double* target_positions,
+        const Timestamp* timestamps,
+        size_t n,
+        const std::string& symbol
+    ) const;
+};
+
+} // namespace backtest
+} // namespace quant_crypto
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "common/types.h"
+#include <algorithm>
+#include <vector>
+
+namespace quant_crypto {
+
+/**
+ * @class BarResampler
+ * @brief 从基础周期K线流增量合成高周期K线
+ *
+ * 每输入一根基础K线，更新所有订阅周期正在形成的K线；某个周期的K线收盘时
+ * （基础K线的结束时间到达该周期边界，或数据跳过了边界）通过回调交付一次。
+ * 交付的K线只包含已收盘的基础K线，不存在未来函数；未收盘的K线不会交付。
+ * 只需顺序处理一遍数据，不需要预先重采样。
+ *
+ * 周期边界按 UTC 对齐（与交易所一致）：周线从周一开始，月线按自然月。
+ * 输入需按时间戳升序，订阅周期不能小于基础周期。
+ */
+class BarResampler {
+public:
+    BarResampler() = default;
+
+    // 订阅周期（重复订阅忽略）
+    void subscribe(Timeframe timeframe);
+    // 清空正在形成的K线（保留订阅）
+    void reset();
+    void clear() { states_.clear(); }
+
+    bool empty() const { return states_.empty(); }
+    std::vector<Timeframe> timeframes() const;
+
+    /**
+     * @brief 输入一根基础K线
+     * @param bar 基础K线（bar.timeframe 为基础周期）
+     * @param on_close 收盘回调 on_close(Timeframe, const OHLCV&)，按订阅周期从小到大调用
+     * @throws std::invalid_argument 订阅周期小于基础周期
+     */
+    template <typename Callback>
+    void update(const OHLCV& bar, Callback&& on_close);
+
+    // 正在形成的K线（没有时返回nullptr）
+    const OHLCV* partial(Timeframe timeframe) const;
+
+    /**
+     * @brief 计算时间戳所在周期的起止时间 [start, end)
+     * TICK 的区间长度为0（start == end == timestamp）
+     */
+    static void bucket_bounds(Timeframe timeframe, Timestamp timestamp, Timestamp& start, Timestamp& end);
+
+private:
+    struct State {
+        Timeframe timeframe;
+        bool active;        // 是否有正在形成的K线
+        Timestamp end;      // 当前K线的结束时间
+        OHLCV bar;
+    };
+    std::vector<State> states_;   // 按周期从小到大排列
+
+    static void check_base(Timeframe base, Timeframe target);
+    static void merge(State& state, const OHLCV& bar);
+};
+
+template <typename Callback>
+void BarResampler::update(const OHLCV& bar, Callback&& on_close) {
+    Timestamp base_start, base_end;
+    bucket_bounds(bar.timeframe, bar.timestamp, base_start, base_end);
+
+    for (State& state : states_) {
+        if (state.timeframe == bar.timeframe) {
+            on_close(state.timeframe, bar);
+            continue;
+        }
+        check_base(bar.timeframe, state.timeframe);
+
+        Timestamp start, end;
+        bucket_bounds(state.timeframe, bar.timestamp, start, end);
+
+        // 1. 数据跳过了边界：之前的K线不会再有新数据，直接收盘
+        if (state.active && start != state.bar.timestamp) {
+            state.active = false;
+            on_close(state.timeframe, state.bar);
+        }
+
+        // 2. 合并基础K线
+        if (!state.active) {
+            state.active = true;
+            state.end = end;
+            state.bar = bar;
+            state.bar.timestamp = start;
+            state.bar.timeframe = state.timeframe;
+        } else {
+            merge(state, bar);
+        }
+
+        // 3. 基础K线收盘时间到达周期边界：高周期K线同时收盘
+        if (base_end >= state.end) {
+            state.active = false;
+            on_close(state.timeframe, state.bar);
+        }
+    }
+}
+
+inline void BarResampler::merge(State& state, const OHLCV& bar) {
+    OHLCV& out = state.bar;
+    out.high = std::max(out.high, bar.high);
+    out.low = std::min(out.low, bar.low);
+    out.close = bar.close;
+    out.volume += bar.volume;
+    out.quote_volume += bar.quote_volume;
+    out.trades_count += bar.trades_count;
+    // 质量取最差（GOOD < SUSPICIOUS < BAD < MISSING）
+    if (static_cast<int>(bar.quality) > static_cast<int>(out.quality)) {
+        out.quality = bar.quality;
+    }
+}
+
+} // namespace quant_crypto
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "common/types.h"
+#include <cstdint>
+#include <string>
+
+namespace quant_crypto {
+namespace calendar {
+
+/**
+ * UTC 日历运算（纯整数，不调用 localtime/mktime，无时区与全局状态）
+ *
+ * 日期与天数的互换使用 proleptic Gregorian 算法（0 = 1970-01-01），
+ * 全部为内联函数，可在逐点循环中使用。周从周一开始，与交易所一致。
+ */
+
+const int64_t MS_PER_SECOND = 1000;
+const int64_t MS_PER_MINUTE = 60 * MS_PER_SECOND;
+const int64_t MS_PER_HOUR = 60 * MS_PER_MINUTE;
+const int64_t MS_PER_DAY = 24 * MS_PER_HOUR;
+const int64_t MS_PER_WEEK = 7 * MS_PER_DAY;
+// 年化使用的年长度（365.25天）
+const double DAYS_PER_YEAR = 365.25;
+const double MS_PER_YEAR = DAYS_PER_YEAR * static_cast<double>(MS_PER_DAY);
+
+// 日历周期
+enum class Period {
+    DAY,
+    WEEK,
+    MONTH,
+    YEAR
+};
+
+struct CivilDate {
+    int64_t year;
+    unsigned month;   // 1-12
+    unsigned day;     // 1-31
+};
+
+// 向下取整的除法（时间戳可能为负）
+inline int64_t floor_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+    return q;
+}
+
+// 公历日期 -> 天数
+inline int64_t days_from_civil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2 ? 1 : 0;
+    int64_t era = floor_div(year, 400);
+    unsigned yoe = static_cast<unsigned>(year - era * 400);
+    unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// 天数 -> 公历日期
+inline CivilDate civil_from_days(int64_t days) {
+    days += 719468;
+    int64_t era = floor_div(days, 146097);
+    unsigned doe = static_cast<unsigned>(days - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    CivilDate date;
+    date.day = doy - (153 * mp + 2) / 5 + 1;
+    date.month = mp < 10 ? mp + 3 : mp - 9;
+    date.year = static_cast<int64_t>(yoe) + era * 400 + (date.month <= 2 ? 1 : 0);
+    return date;
+}
+
+inline int64_t day_index(Timestamp timestamp) { return floor_div(timestamp, MS_PER_DAY); }
+inline CivilDate to_civil(Timestamp timestamp) { return civil_from_days(day_index(timestamp)); }
+inline Timestamp from_civil(int64_t year, unsigned month, unsigned day) {
+    return days_from_civil(year, month, day) * MS_PER_DAY;
+}
+
+// 所在日/周/月/年的开始时间
+inline Timestamp day_start(Timestamp timestamp) { return day_index(timestamp) * MS_PER_DAY; }
+
+inline Timestamp week_start(Timestamp timestamp) {
+    // 1970-01-01 是周四，第一个周一是 1970-01-05
+    const int64_t offset = 4 * MS_PER_DAY;
+    return floor_div(timestamp - offset, MS_PER_WEEK) * MS_PER_WEEK + offset;
+}
+
+inline Timestamp month_start(Timestamp timestamp) {
+    CivilDate date = to_civil(timestamp);
+    return from_civil(date.year, date.month, 1);
+}
+
+inline Timestamp year_start(Timestamp timestamp) {
+    return from_civil(to_civil(timestamp).year, 1, 1);
+}
+
+/**
+ * @brief 计算时间戳所在日历周期的起止时间 [start, end)
+ */
+inline void period_bounds(Period period, Timestamp timestamp, Timestamp& start, Timestamp& end) {
+    switch (period) {
+        case Period::DAY:
+            start = day_start(timestamp);
+            end = start + MS_PER_DAY;
+            return;
+        case Period::WEEK:
+            start = week_start(timestamp);
+            end = start + MS_PER_WEEK;
+            return;
+        case Period::MONTH: {
+            CivilDate date = to_civil(timestamp);
+            start = from_civil(date.year, date.month, 1);
+            end = date.month == 12 ? from_civil(date.year + 1, 1, 1) : from_civil(date.year, date.month + 1, 1);
+            return;
+        }
+        case Period::YEAR: {
+            int64_t year = to_civil(timestamp).year;
+            start = from_civil(year, 1, 1);
+            end = from_civil(year + 1, 1, 1);
+            return;
+        }
+    }
+    start = end = timestamp;
+}
+
+/**
+ * @class PeriodCursor
+ * @brief 顺序遍历时间戳时定位所在日历周期
+ *
+ * 缓存当前周期的 [start, end)，时间戳落在其中时只需两次比较，
+ * 跨过边界时才做一次日期换算。对百万级时间戳的单次遍历足够快。
+ */
+class PeriodCursor {
+public:
+    explicit PeriodCursor(Period period) : period_(period), start_(0), end_(0), valid_(false) {}
+
+    /**
+     * @brief 移动到时间戳所在的周期
+     * @return 是否进入了新的周期（第一次调用返回true）
+     */
+    bool advance(Timestamp timestamp) {
+        if (valid_ && timestamp >= start_ && timestamp < end_) return false;
+        period_bounds(period_, timestamp, start_, end_);
+        valid_ = true;
+        return true;
+    }
+
+    void reset() { valid_ = false; }
+
+    Period period() const { return period_; }
+    Timestamp start() const { return start_; }
+    Timestamp end() const { return end_; }
+
+private:
+    Period period_;
+    Timestamp start_;
+    Timestamp end_;
+    bool valid_;
+};
+
+// 时间跨度对应的年数
+inline double years_between(Timestamp start, Timestamp end) {
+    return static_cast<double>(end - start) / MS_PER_YEAR;
+}
+
+// 每年的周期数（用于按K线频率年化；TICK 返回0）
+inline double periods_per_year(Timeframe timeframe) {
+    if (timeframe == Timeframe::MONTH_1) return 12.0;
+    int64_t length = timeframe_to_milliseconds(timeframe);
+    return length > 0 ? MS_PER_YEAR / static_cast<double>(length) : 0.0;
+}
+
+inline std::string period_to_string(Period period) {
+    switch (period) {
+        case Period::DAY: return "day";
+        case Period::WEEK: return "week";
+        case Period::MONTH: return "month";
+        case Period::YEAR: return "year";
+    }
+    return "unknown";
+}
+
+} // namespace calendar
+} // namespace quant_crypto
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "common/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace quant_crypto {
+
+/**
+ * @class OHLCVColumns
+ * @brief 列式K线容器（同一 交易所/交易对/周期 的数据流）
+ *
+ * 每个字段一个连续数组，逐列计算时可以被编译器向量化，
+ * 也不需要为每根K线复制交易对、交易所字符串。
+ */
+struct OHLCVColumns {
+    Symbol symbol;
+    Exchange exchange;
+    Timeframe timeframe;
+
+    std::vector<Timestamp> timestamp;
+    std::vector<Price> open;
+    std::vector<Price> high;
+    std::vector<Price> low;
+    std::vector<Price> close;
+    std::vector<Volume> volume;
+    std::vector<Volume> quote_volume;
+    std::vector<int64_t> trades_count;
+    std::vector<DataQuality> quality;
+
+    OHLCVColumns() : timeframe(Timeframe::MINUTE_1) {}
+
+    size_t size() const { return timestamp.size(); }
+    bool empty() const { return timestamp.empty(); }
+    // 所有数值列长度相同（直接修改各列后可用来检查）
+    bool consistent() const;
+
+    void clear();
+    void reserve(size_t n);
+
+    // 追加一根K线（交易对等字段取第一根K线的值）
+    void push_back(const OHLCV& bar);
+
+    // 用K线数组替换全部内容（复用已分配的内存）
+    void assign(const OHLCV* bars, size_t n);
+
+    // 第 i 行转为 OHLCV
+    OHLCV row(size_t i) const;
+    // 用 OHLCV 覆盖第 i 行的数值字段
+    void set(size_t i, const OHLCV& bar);
+    // 第 i 行的数值字段写入 bar（交易对、交易所、周期不变）
+    void get(size_t i, OHLCV& bar) const;
+    // @throws std::invalid_argument 各列长度不一致
+    std::vector<OHLCV> to_bars() const;
+
+    static OHLCVColumns from_bars(const std::vector<OHLCV>& bars);
+
+    /**
+     * @brief 按掩码原地压缩（保持顺序），所有列只移动一次
+     * @param keep 每行一个字节，非0表示保留
+     * @return 保留的行数
+     * @throws std::invalid_argument 各列长度不一致
+     */
+    size_t compact(const uint8_t* keep);
+};
+
+} // namespace quant_crypto
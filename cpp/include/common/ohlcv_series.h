@@ -0,0 +1,76 @@
+#pragma once
+
+#include "common/types.h"
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+
+namespace quant_crypto {
+
+/**
+ * @class OHLCVSeries
+ * @brief 只读共享K线序列（带所有权的视图）
+ *
+ * 底层数据由 shared_ptr 持有，拷贝 OHLCVSeries 只增加引用计数，
+ * 不复制K线本身。多个回测引擎可以共享同一份内存数据；
+ * slice() 返回子区间视图，同样不复制数据。
+ */
+class OHLCVSeries {
+public:
+    OHLCVSeries() : offset_(0), size_(0) {}
+
+    /**
+     * @brief 接管一份K线数据（传入右值时无拷贝）
+     */
+    explicit OHLCVSeries(std::vector<OHLCV> bars)
+        : bars_(std::make_shared<const std::vector<OHLCV>>(std::move(bars))),
+          offset_(0), size_(bars_->size()) {}
+
+    /**
+     * @brief 共享已有的只读数据
+     */
+    explicit OHLCVSeries(std::shared_ptr<const std::vector<OHLCV>> bars)
+        : bars_(std::move(bars)), offset_(0), size_(bars_ ? bars_->size() : 0) {}
+
+    const OHLCV* begin() const { return size_ ? bars_->data() + offset_ : nullptr; }
+    const OHLCV* end() const { return begin() + size_; }
+    const OHLCV* data() const { return begin(); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const OHLCV& operator[](size_t i) const { return (*bars_)[offset_ + i]; }
+    const OHLCV& front() const { return (*bars_)[offset_]; }
+    const OHLCV& back() const { return (*bars_)[offset_ + size_ - 1]; }
+
+    const OHLCV& at(size_t i) const {
+        if (i >= size_) throw std::out_of_range("OHLCVSeries::at");
+        return (*bars_)[offset_ + i];
+    }
+
+    /**
+     * @brief 获取子区间视图（与原序列共享数据）
+     * @param offset 起始位置
+     * @param count 数量（超出部分自动截断）
+     */
+    OHLCVSeries slice(size_t offset, size_t count) const {
+        OHLCVSeries view;
+        if (offset >= size_) return view;
+        view.bars_ = bars_;
+        view.offset_ = offset_ + offset;
+        view.size_ = std::min(count, size_ - offset);
+        return view;
+    }
+
+    // 底层共享数据（整份，不考虑slice区间）
+    const std::shared_ptr<const std::vector<OHLCV>>& shared() const { return bars_; }
+
+private:
+    std::shared_ptr<const std::vector<OHLCV>> bars_;
+    size_t offset_;
+    size_t size_;
+};
+
+} // namespace quant_crypto
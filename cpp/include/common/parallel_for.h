@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace quant_crypto {
+
+// 线程数：0 表示硬件线程数
+inline size_t resolve_threads(size_t threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    return threads;
+}
+
+/**
+ * @brief 用固定数量的线程处理 [0, count)，按原子下标取任务
+ *
+ * 任务粒度不均时也能自动负载均衡。任一任务抛出异常后其余线程不再领取新任务，
+ * 第一个异常在所有线程结束后重新抛出。
+ */
+template <typename Fn>
+void parallel_for(size_t count, size_t threads, Fn fn) {
+    threads = std::min(threads, count);
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; i++) fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < count && !failed; i = next++) {
+                try {
+                    fn(i);
+                } catch (...) {
+                    if (!failed.exchange(true)) error = std::current_exception();
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    if (error) std::rethrow_exception(error);
+}
+
+} // namespace quant_crypto
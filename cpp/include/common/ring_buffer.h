@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace quant_crypto {
+
+/**
+ * @class RingBuffer
+ * @brief 固定容量的环形缓冲区
+ *
+ * 存储在构造时一次分配，之后 push 不再分配内存；已满时 push 覆盖最旧的元素。
+ * 下标 0 为最旧的元素，size() - 1 为最新的元素。
+ */
+template <typename T>
+class RingBuffer {
+public:
+    /**
+     * @param capacity 容量
+     * @throws std::invalid_argument 容量为0
+     */
+    explicit RingBuffer(size_t capacity) : data_(capacity), head_(0), size_(0) {
+        if (capacity == 0) {
+            throw std::invalid_argument("RingBuffer: 容量必须大于0");
+        }
+    }
+
+    size_t capacity() const { return data_.size(); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == data_.size(); }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    /**
+     * @brief 追加元素，已满时覆盖最旧的元素
+     * @param value 新元素
+     * @param evicted 被覆盖的元素（可为nullptr）
+     * @return 是否有元素被覆盖
+     */
+    bool push(const T& value, T* evicted = nullptr) {
+        size_t tail = head_ + size_;
+        if (tail >= data_.size()) tail -= data_.size();
+        if (size_ < data_.size()) {
+            data_[tail] = value;
+            size_++;
+            return false;
+        }
+        // 已满：tail == head_，覆盖最旧的元素
+        if (evicted) *evicted = data_[head_];
+        data_[head_] = value;
+        head_ = head_ + 1 == data_.size() ? 0 : head_ + 1;
+        return true;
+    }
+
+    const T& operator[](size_t index) const {
+        size_t i = head_ + index;
+        return data_[i >= data_.size() ? i - data_.size() : i];
+    }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    // 按从旧到新的顺序遍历
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        for (size_t i = 0; i < size_; i++) fn((*this)[i]);
+    }
+
+private:
+    std::vector<T> data_;
+    size_t head_;    // 最旧元素的位置
+    size_t size_;
+};
+
+} // namespace quant_crypto
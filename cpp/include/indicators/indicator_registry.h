@@ -0,0 +1,71 @@
+#pragma once
+
+#include "common/types.h"
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace quant_crypto {
+namespace indicators {
+
+/**
+ * @class IndicatorRegistry
+ * @brief 多个策略共享的增量指标
+ *
+ * 策略按（类型, 周期）注册指标，相同的指标只注册一次、每根K线只计算一次。
+ * update() 输入新K线后，所有已注册指标更新到最新值。
+ * 计算方式与 TechnicalIndicators 一致（SMA 按窗口求和、EMA 以SMA为初值），
+ * 结果与单独计算逐位相同。
+ */
+class IndicatorRegistry {
+public:
+    using Handle = size_t;
+
+    enum class Kind {
+        SMA,    // 收盘价简单移动平均
+        EMA     // 收盘价指数移动平均
+    };
+
+    IndicatorRegistry() : max_period_(0), bar_count_(0) {}
+
+    /**
+     * @brief 注册指标（已存在时返回已有句柄）
+     * @throws std::invalid_argument 周期 <= 0
+     */
+    Handle add(Kind kind, int period);
+    Handle sma(int period) { return add(Kind::SMA, period); }
+    Handle ema(int period) { return add(Kind::EMA, period); }
+
+    // 输入一根K线，更新全部指标
+    void update(const OHLCV& bar);
+    // 清空历史（保留已注册的指标）
+    void reset();
+
+    // 指标是否已有值（K线数量达到周期）
+    bool ready(Handle handle) const { return entries_[handle].ready; }
+    // 指标最新值（未就绪时为0）
+    double value(Handle handle) const { return entries_[handle].value; }
+
+    size_t size() const { return entries_.size(); }
+    size_t bar_count() const { return bar_count_; }
+
+private:
+    struct Entry {
+        Kind kind;
+        int period;
+        bool ready;
+        double value;
+        double alpha;        // EMA 平滑系数
+    };
+
+    std::vector<Entry> entries_;
+    std::deque<double> closes_;   // 最近 max_period_ 个收盘价
+    size_t max_period_;
+    size_t bar_count_;
+
+    // 最近 period 个收盘价之和（从新到旧累加，与 calculate_ma 相同）
+    double window_sum(int period) const;
+};
+
+} // namespace indicators
+} // namespace quant_crypto
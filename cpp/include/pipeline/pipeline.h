@@ -0,0 +1,212 @@
+#pragma once
+
+#include "common/types.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace quant_crypto {
+namespace pipeline {
+
+/**
+ * @brief 一个分片：单个 交易所/交易对/周期 的数据流
+ */
+struct ShardInfo {
+    Exchange exchange;
+    Symbol symbol;
+    Timeframe timeframe;
+
+    ShardInfo() : timeframe(Timeframe::MINUTE_1) {}
+    ShardInfo(Exchange exchange, Symbol symbol, Timeframe timeframe)
+        : exchange(std::move(exchange)), symbol(std::move(symbol)), timeframe(timeframe) {}
+};
+
+/**
+ * @brief 在阶段之间传递的一批K线
+ *
+ * 每个分片按批次流过全部阶段，last 为 true 的批次是该分片的最后一批
+ * （可能为空），跨批次保留数据的阶段应在这一批输出剩余数据。
+ */
+struct ShardBatch {
+    const ShardInfo& shard;
+    std::vector<OHLCV> bars;
+    bool last;
+
+    explicit ShardBatch(const ShardInfo& shard) : shard(shard), last(false) {}
+};
+
+/**
+ * @brief 阶段的逐分片状态（跨批次保存）
+ */
+class StageState {
+public:
+    virtual ~StageState() = default;
+};
+
+/**
+ * @class Stage
+ * @brief 流水线阶段
+ *
+ * 阶段对象只保存配置，被所有工作线程共享，process() 必须可以并发调用；
+ * 依赖历史数据的阶段通过 create_state() 为每个分片创建状态，由处理该分片的线程独占。
+ */
+class Stage {
+public:
+    explicit Stage(std::string name) : name_(std::move(name)) {}
+    virtual ~Stage() = default;
+
+    const std::string& name() const { return name_; }
+
+    // 创建分片状态（无状态阶段返回nullptr）
+    virtual std::unique_ptr<StageState> create_state(const ShardInfo& shard) const {
+        (void)shard;
+        return nullptr;
+    }
+
+    /**
+     * @brief 原地处理一批K线：删除、修改或插入均可
+     * @param batch 输入为上游阶段的输出，处理后作为本阶段的输出
+     * @param state create_state() 创建的状态
+     */
+    virtual void process(ShardBatch& batch, StageState* state) const = 0;
+
+private:
+    std::string name_;
+};
+
+/**
+ * @brief 分片数据源：按批读取一个分片
+ */
+class ShardSource {
+public:
+    virtual ~ShardSource() = default;
+
+    /**
+     * @brief 读取下一批
+     * @param bars 输出（调用前已清空），不超过 max_bars 根
+     * @param max_bars 每批上限
+     * @return 之后是否还有数据
+     */
+    virtual bool next(std::vector<OHLCV>& bars, size_t max_bars) = 0;
+};
+
+using SourceFactory = std::function<std::unique_ptr<ShardSource>(const ShardInfo&)>;
+
+/**
+ * @brief 内存数据源：按批返回已加载的K线
+ */
+class VectorSource : public ShardSource {
+public:
+    explicit VectorSource(std::shared_ptr<const std::vector<OHLCV>> bars) : bars_(std::move(bars)), offset_(0) {}
+
+    bool next(std::vector<OHLCV>& bars, size_t max_bars) override;
+
+private:
+    std::shared_ptr<const std::vector<OHLCV>> bars_;
+    size_t offset_;
+};
+
+/**
+ * @brief 单个阶段的统计
+ */
+struct StageStats {
+    std::string name;
+    size_t batches;
+    size_t bars_in;
+    size_t bars_out;
+    double seconds;         // 处理耗时（多个线程的耗时之和）
+
+    StageStats() : batches(0), bars_in(0), bars_out(0), seconds(0.0) {}
+    explicit StageStats(std::string name) : name(std::move(name)), batches(0), bars_in(0), bars_out(0), seconds(0.0) {}
+
+    size_t dropped() const { return bars_in > bars_out ? bars_in - bars_out : 0; }
+    size_t added() const { return bars_out > bars_in ? bars_out - bars_in : 0; }
+    // 每秒处理的K线数（按输入计）
+    double throughput() const { return seconds > 0.0 ? static_cast<double>(bars_in) / seconds : 0.0; }
+
+    void merge(const StageStats& other);
+};
+
+/**
+ * @brief 单个分片的处理结果
+ */
+struct ShardReport {
+    ShardInfo shard;
+    std::vector<StageStats> stages;     // 第0个为 load
+    bool ok;
+    std::string error;                  // 失败时的异常信息
+    double seconds;
+
+    ShardReport() : ok(true), seconds(0.0) {}
+};
+
+/**
+ * @brief 整个流水线的处理结果
+ */
+struct PipelineReport {
+    std::vector<ShardReport> shards;    // 与输入的分片顺序一致
+    std::vector<StageStats> stages;     // 各阶段在所有分片上的汇总，第0个为 load
+    size_t failed;
+    double seconds;                     // 墙钟时间
+
+    PipelineReport() : failed(0), seconds(0.0) {}
+};
+
+/**
+ * @class Pipeline
+ * @brief 按分片并行的数据处理流水线（加载 → 标准化 → 清洗 → 填补 → 存储 等）
+ *
+ * 阶段组成以 load 为根的有向无环图：每个阶段声明上游阶段，只能引用已添加的阶段，
+ * 因此添加顺序即拓扑顺序。有多个上游时输入为各上游输出按声明顺序的拼接；
+ * 一个阶段的输出可以被多个下游使用（最后一个下游直接取走，其余复制）。
+ *
+ * 分片之间没有依赖，由固定数量的线程按原子下标领取，每个分片在一个线程上
+ * 依次流过全部阶段，各阶段之间没有全局同步点。每个分片按 max_batch_bars 分批读取，
+ * 内存占用约为 线程数 × 每批K线数 × 阶段数。
+ * 单个分片失败（抛出异常）只记录在报告中，不影响其他分片。
+ */
+class Pipeline {
+public:
+    /**
+     * @param source 为每个分片创建数据源
+     * @param threads 线程数（0表示硬件线程数）
+     * @param max_batch_bars 每批最多的K线数
+     * @throws std::invalid_argument source 为空或 max_batch_bars 为0
+     */
+    explicit Pipeline(SourceFactory source, size_t threads = 0, size_t max_batch_bars = 100000);
+
+    /**
+     * @brief 添加阶段
+     * @param stage 阶段（名称在流水线内唯一，"load" 保留给数据源）
+     * @param inputs 上游阶段名；为空时接在上一个添加的阶段之后（第一个阶段接在 load 之后）
+     * @throws std::invalid_argument 名称重复或上游不存在
+     */
+    Pipeline& add_stage(std::shared_ptr<Stage> stage, const std::vector<std::string>& inputs = {});
+
+    // 处理全部分片
+    PipelineReport run(const std::vector<ShardInfo>& shards) const;
+
+    // 阶段名（拓扑顺序，含 load）
+    std::vector<std::string> stage_names() const;
+
+    size_t threads() const { return threads_; }
+    size_t max_batch_bars() const { return max_batch_bars_; }
+
+private:
+    struct Node {
+        std::shared_ptr<Stage> stage;
+        std::vector<size_t> inputs;     // 上游节点下标（0 为 load）
+    };
+
+    SourceFactory source_;
+    size_t threads_;
+    size_t max_batch_bars_;
+    std::vector<Node> nodes_;           // 不含 load；节点 i 的下标为 i + 1
+
+    ShardReport run_shard(const ShardInfo& shard) const;
+};
+
+} // namespace pipeline
+} // namespace quant_crypto
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "pipeline/pipeline.h"
+#include "cleaners/data_cleaner.h"
+#include <functional>
+#include <memory>
+
+namespace quant_crypto {
+namespace pipeline {
+
+/**
+ * @brief 标准化：价格/成交量按精度取整，可选统一交易对名称，删除无效K线
+ */
+class NormalizeStage : public Stage {
+public:
+    explicit NormalizeStage(int price_precision = 8, int volume_precision = 8,
+                            bool normalize_symbol = false, bool drop_invalid = true);
+
+    void process(ShardBatch& batch, StageState* state) const override;
+
+private:
+    int price_precision_;
+    int volume_precision_;
+    bool normalize_symbol_;
+    bool drop_invalid_;
+};
+
+/**
+ * @brief 清洗：每个分片一个 CleaningContext，有状态规则的历史跨批次保留
+ */
+class CleanStage : public Stage {
+public:
+    // @throws std::invalid_argument cleaner 为空
+    explicit CleanStage(std::shared_ptr<const cleaners::DataCleaner> cleaner);
+
+    std::unique_ptr<StageState> create_state(const ShardInfo& shard) const override;
+    void process(ShardBatch& batch, StageState* state) const override;
+
+private:
+    std::shared_ptr<const cleaners::DataCleaner> cleaner_;
+};
+
+/**
+ * @brief 去重：批内用 DataCleaner::deduplicate，每批最后一根K线留到下一批，
+ *        因此按时间顺序读取时跨批次的重复也能去除
+ */
+class DedupStage : public Stage {
+public:
+    explicit DedupStage(cleaners::DuplicatePolicy policy = cleaners::DuplicatePolicy::KEEP_FIRST);
+
+    std::unique_ptr<StageState> create_state(const ShardInfo& shard) const override;
+    void process(ShardBatch& batch, StageState* state) const override;
+
+private:
+    cleaners::DuplicatePolicy policy_;
+};
+
+/**
+ * @brief 填补缺失K线：记住上一批的最后一根K线，跨批次的缺口也会被填补
+ */
+class FillStage : public Stage {
+public:
+    explicit FillStage(cleaners::FillMethod method = cleaners::FillMethod::FORWARD, size_t max_gap_bars = 0);
+
+    std::unique_ptr<StageState> create_state(const ShardInfo& shard) const override;
+    void process(ShardBatch& batch, StageState* state) const override;
+
+private:
+    cleaners::FillMethod method_;
+    size_t max_gap_bars_;
+};
+
+/**
+ * @brief 存储：每个分片写一个 CSV 文件，数据原样传给下游
+ *
+ * 文件为 data_dir/交易所_交易对_周期.csv（列与 KlineStorage 相同），
+ * 由分片状态独占一个输出流：第一批时清空重写并写表头，之后追加，最后一批后关闭。
+ * 重复运行会覆盖上次的输出；不同交易所的同名交易对写入不同文件。
+ */
+class StoreStage : public Stage {
+public:
+    // @throws std::runtime_error 无法创建目录
+    explicit StoreStage(const std::string& data_dir);
+
+    std::unique_ptr<StageState> create_state(const ShardInfo& shard) const override;
+    // @throws std::runtime_error 无法打开或写入文件
+    void process(ShardBatch& batch, StageState* state) const override;
+
+    // 分片的输出文件（交易所/交易对中路径不安全的字符替换为 '_'）
+    std::string path_for(const ShardInfo& shard) const;
+
+private:
+    std::string data_dir_;
+};
+
+/**
+ * @brief 自定义阶段：包装一个无状态函数（必须可以并发调用）
+ */
+class FunctionStage : public Stage {
+public:
+    using Function = std::function<void(ShardBatch&)>;
+
+    FunctionStage(std::string name, Function fn);
+
+    void process(ShardBatch& batch, StageState* state) const override;
+
+private:
+    Function fn_;
+};
+
+} // namespace pipeline
+} // namespace quant_crypto
@@ -1,6 +1,7 @@
 #pragma once
 #include "strategy/strategy_base.h"
 #include "indicators/technical_indicators.h"
+#include "indicators/indicator_registry.h"
 #include <deque>
 
 namespace quant_crypto{
@@ -26,6 +27,8 @@ public:
     void on_bar(const OHLCV& bar) override;   // 这个方法具体的作用是什么？
     Signal generate_signal() override;
     std::string get_name() const override;
+    std::unique_ptr<StrategyBase> clone() const override;
+    void set_indicator_registry(indicators::IndicatorRegistry* registry) override;
 
     // 添加getter方法
     double get_fast_ma() const;   // 获取当前快线值
@@ -39,9 +42,15 @@ private:
     std::vector<double> slow_ma_;
     Signal last_signal_;
     OHLCV current_bar_;
+    // 共享指标（为空时自行计算均线）
+    const indicators::IndicatorRegistry* registry_ = nullptr;
+    indicators::IndicatorRegistry::Handle fast_handle_ = 0;
+    indicators::IndicatorRegistry::Handle slow_handle_ = 0;
 
     // 私有方法
     void update_ma();
+    void update_ma_shared();
+    static void push_ma(std::vector<double>& values, double value);
     Signal detect_cross();
 };
 
@@ -0,0 +1,54 @@
+#pragma once
+#include "common/types.h"
+#include <cstdint>
+
+namespace quant_crypto{
+namespace strategy{
+
+using OrderId = int64_t;
+
+// 订单状态
+enum class OrderStatus{
+    PENDING,    // 挂单中
+    FILLED,     // 已成交
+    CANCELLED,  // 已撤销
+    REJECTED    // 被拒绝（资金不足、无持仓可平等）
+};
+
+/**
+ * @brief 回测订单
+ *
+ * 只做多的单持仓模型：
+ *   - BUY 订单开仓，quantity <= 0 时按回测引擎默认仓位比例计算数量
+ *   - SELL 订单平掉全部持仓（quantity 被忽略）
+ * 止损 = SELL + STOP_MARKET，止盈 = SELL + LIMIT。
+ */
+struct Order{
+    OrderId id;
+    Side side;
+    OrderType type;
+    Price price;            // 限价（LIMIT / STOP_LIMIT）
+    Price stop_price;       // 触发价（STOP_MARKET / STOP_LIMIT）
+    double quantity;        // 买入数量
+    int64_t oco_group;      // OCO组（非0时，组内任一订单成交后撤销其余订单）
+    OrderStatus status;
+    bool triggered;         // STOP_LIMIT 是否已触发（触发后按限价单撮合）
+    Timestamp created_at;   // 提交时间（引擎接收订单时所在Bar的时间戳）
+    Timestamp filled_at;    // 成交时间（成交Bar的时间戳）
+    Price fill_price;       // 成交价（已含滑点）
+
+    Order() : id(0), side(Side::UNKNOWN), type(OrderType::UNKNOWN), price(0.0), stop_price(0.0),
+              quantity(0.0), oco_group(0), status(OrderStatus::PENDING), triggered(false),
+              created_at(0), filled_at(0), fill_price(0.0) {}
+};
+
+// 策略发给回测引擎的订单请求（提交或撤销）
+struct OrderRequest{
+    bool cancel;        // true: 撤销 order.id；false: 提交 order
+    Order order;
+
+    OrderRequest() : cancel(false) {}
+};
+
+}
+}
@@ -1,9 +1,12 @@
 #pragma once
 #include "common/types.h"
+#include "strategy/order.h"
 #include<vector>
 #include<string>
+#include<memory>
 
 namespace quant_crypto{
+namespace indicators{ class IndicatorRegistry; }
 namespace strategy{
 
 enum class Signal{
@@ -50,6 +53,21 @@ public:
     virtual Signal generate_signal() = 0;
     virtual std::string get_name() const = 0;
 
+    // 订单状态变化回调（成交/撤销/拒绝），默认不处理
+    virtual void on_order_update(const Order& order) { (void)order; }
+
+    // 订阅周期的K线收盘回调（见 subscribe_timeframe），默认不处理
+    // 在同一根基础K线的 on_bar 之后、generate_signal 之前调用
+    virtual void on_timeframe_bar(Timeframe timeframe, const OHLCV& bar) { (void)timeframe; (void)bar; }
+
+    // 复制完整状态（资金、持仓、交易记录、指标状态），用于回测断点
+    // 默认返回nullptr，表示策略不支持断点
+    virtual std::unique_ptr<StrategyBase> clone() const { return nullptr; }
+
+    // 使用共享指标（多策略引擎在添加策略时调用，nullptr 表示改回自行计算）
+    // 共享指标由调用方在每根K线的 on_bar 之前更新；默认不使用
+    virtual void set_indicator_registry(indicators::IndicatorRegistry* registry) { (void)registry; }
+
     // 设置参数
     // virtual void set_param(const std::string& name, const std::string& value) = 0;
     
@@ -57,19 +75,53 @@ public:
     void on_init(double initial_capital);
     void open_position(const std::string& symbol, double quantity, double price);
     double close_position(double price);    // 返回平仓亏损
-    double get_capital() const;
+    double get_capital() const { return capital_; }
 
-    double get_total_equity() const;      // 获取总权益
+    // 总权益： 资金+持仓市值
+    double get_total_equity() const {
+        double equity = capital_;
+        if (position_.has_position()) {
+            equity += position_.quantity * position_.current_price;
+        }
+        return equity;
+    }
     double get_total_return() const;      // 获取收益率
-    Position get_position() const;        // 获取持仓
-    void update_position_price(double current_price);  // 更新持仓价格
+    const Position& get_position() const { return position_; }   // 获取持仓（引用，不复制）
+
+    // 更新持仓价格
+    void update_position_price(double current_price) {
+        position_.current_price = current_price;
+        if (position_.has_position()) {
+            position_.unrealized_pnl = (current_price - position_.avg_price) * position_.quantity;
+        }
+    }
     void add_trade(const Trade& trade);
+
+    // ========= 订单接口（挂单从下一根Bar开始撮合） =========
+    OrderId submit_order(Side side, OrderType type, double quantity = 0.0,
+                         Price price = 0.0, Price stop_price = 0.0, int64_t oco_group = 0);
+    OrderId buy_limit(Price price, double quantity = 0.0);
+    OrderId buy_stop(Price stop_price, double quantity = 0.0);
+    OrderId stop_loss(Price stop_price, int64_t oco_group = 0);     // 卖出止损（STOP_MARKET）
+    OrderId take_profit(Price price, int64_t oco_group = 0);        // 卖出止盈（LIMIT）
+    void cancel_order(OrderId id);
+    // 取走待处理的订单请求（由回测引擎调用）
+    std::vector<OrderRequest> take_order_requests();
+    bool has_order_requests() const { return !order_requests_.empty(); }
+
+    // ========= 多周期 =========
+    // 订阅高周期K线：回测引擎从基础K线流增量合成，收盘时调用 on_timeframe_bar
+    void subscribe_timeframe(Timeframe timeframe);
+    const std::vector<Timeframe>& subscribed_timeframes() const { return timeframes_; }
     
 protected:
     Position position_;
     double capital_;
     double initial_capital_;
     std::vector<Trade> trades_;
+    std::vector<OrderRequest> order_requests_;
+    OrderId next_order_id_ = 1;
+    std::vector<Timeframe> timeframes_;
 
 };
 }
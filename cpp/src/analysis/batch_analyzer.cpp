@@ -0,0 +1,62 @@
+#include "analysis/batch_analyzer.h"
+#include "common/parallel_for.h"
+#include <stdexcept>
+#include <string>
+
+namespace quant_crypto {
+namespace analysis {
+
+BatchAnalyzer::BatchAnalyzer(size_t threads, const AnalyzeOptions& options)
+    : threads_(resolve_threads(threads)), options_(options) {}
+
+AnalyzeOptions BatchAnalyzer::default_options() {
+    AnalyzeOptions options;
+    options.keep_equity_curve = false;
+    options.keep_drawdown_curve = false;
+    options.keep_period_returns = false;
+    options.keep_drawdown_episodes = true;
+    return options;
+}
+
+MetricsTable BatchAnalyzer::analyze(const std::vector<backtest::BacktestResult>& results) const {
+    MetricsTable table(results.size());
+    parallel_for(results.size(), threads_, [&](size_t i) {
+        PerformanceAnalyzer analyzer;
+        table.set_row(i, analyzer.analyze(results[i], options_));
+    });
+    return table;
+}
+
+MetricsTable BatchAnalyzer::analyze(const std::vector<std::vector<double>>& equity_curves,
+                                    const std::vector<std::vector<Timestamp>>& timestamps,
+                                    const std::vector<std::vector<strategy::Trade>>& trades,
+                                    double initial_capital) const {
+    size_t n = equity_curves.size();
+    bool shared_timestamps = timestamps.size() == 1;
+    if (!shared_timestamps && timestamps.size() != n) {
+        throw std::invalid_argument("BatchAnalyzer: timestamps 个数必须为1或与权益曲线相同");
+    }
+    if (!trades.empty() && trades.size() != n) {
+        throw std::invalid_argument("BatchAnalyzer: trades 个数必须为0或与权益曲线相同");
+    }
+    for (size_t i = 0; i < n; i++) {
+        const std::vector<Timestamp>& ts = shared_timestamps ? timestamps[0] : timestamps[i];
+        if (equity_curves[i].size() != ts.size()) {
+            throw std::invalid_argument("BatchAnalyzer: 第 " + std::to_string(i) +
+                                        " 条权益曲线与时间戳长度不一致");
+        }
+    }
+
+    const std::vector<strategy::Trade> no_trades;
+    MetricsTable table(n);
+    parallel_for(n, threads_, [&](size_t i) {
+        const std::vector<Timestamp>& ts = shared_timestamps ? timestamps[0] : timestamps[i];
+        PerformanceAnalyzer analyzer;
+        table.set_row(i, analyzer.analyze(equity_curves[i], ts, trades.empty() ? no_trades : trades[i],
+                                          initial_capital, options_));
+    });
+    return table;
+}
+
+} // namespace analysis
+} // namespace quant_crypto
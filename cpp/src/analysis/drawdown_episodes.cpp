@@ -0,0 +1,104 @@
+#include "analysis/drawdown_episodes.h"
+#include <algorithm>
+#include <utility>
+
+namespace quant_crypto {
+namespace analysis {
+
+DrawdownEpisodeTracker::DrawdownEpisodeTracker(double min_depth)
+    : min_depth_(min_depth) {
+    reset();
+}
+
+void DrawdownEpisodeTracker::reset() {
+    count_ = 0;
+    first_time_ = 0;
+    last_time_ = 0;
+    peak_ = 0.0;
+    peak_time_ = 0;
+    peak_index_ = 0;
+    in_drawdown_ = false;
+    trough_ = 0.0;
+    trough_time_ = 0;
+    trough_index_ = 0;
+    episodes_.clear();
+    under_water_ms_ = 0;
+    duration_sum_ms_ = 0;
+    max_duration_ms_ = 0;
+    max_recovery_ms_ = 0;
+    depth_sum_ = 0.0;
+}
+
+DrawdownEpisode DrawdownEpisodeTracker::current_episode(Timestamp end_time, size_t end_index, bool recovered) const {
+    DrawdownEpisode episode;
+    episode.start_time = peak_time_;
+    episode.trough_time = trough_time_;
+    episode.end_time = end_time;
+    episode.start_index = peak_index_;
+    episode.trough_index = trough_index_;
+    episode.end_index = end_index;
+    episode.peak_equity = peak_;
+    episode.trough_equity = trough_;
+    episode.depth = peak_ > 0 ? (peak_ - trough_) / peak_ : 0.0;
+    episode.recovered = recovered;
+    return episode;
+}
+
+void DrawdownEpisodeTracker::close_episode(Timestamp end_time, size_t end_index, bool recovered) {
+    DrawdownEpisode episode = current_episode(end_time, end_index, recovered);
+    in_drawdown_ = false;
+
+    under_water_ms_ += episode.duration_ms();
+    if (episode.depth < min_depth_) return;
+
+    duration_sum_ms_ += episode.duration_ms();
+    max_duration_ms_ = std::max(max_duration_ms_, episode.duration_ms());
+    if (recovered) max_recovery_ms_ = std::max(max_recovery_ms_, episode.recovery_ms());
+    depth_sum_ += episode.depth;
+    episodes_.push_back(episode);
+}
+
+DrawdownReport DrawdownEpisodeTracker::finish() {
+    DrawdownReport report;
+    report.episodes = std::move(episodes_);
+    episodes_.clear();
+    report.under_water_ms = under_water_ms_;
+    report.max_duration_ms = max_duration_ms_;
+    report.max_recovery_ms = max_recovery_ms_;
+    int64_t duration_sum = duration_sum_ms_;
+    double depth_sum = depth_sum_;
+
+    // 尚未恢复的回撤持续到最后一个点
+    if (in_drawdown_) {
+        DrawdownEpisode open = current_episode(last_time_, count_ - 1, false);
+        report.under_water_ms += open.duration_ms();
+        if (open.depth >= min_depth_) {
+            duration_sum += open.duration_ms();
+            report.max_duration_ms = std::max(report.max_duration_ms, open.duration_ms());
+            depth_sum += open.depth;
+            report.episodes.push_back(open);
+        }
+    }
+
+    report.episode_count = report.episodes.size();
+    report.total_ms = count_ > 0 ? last_time_ - first_time_ : 0;
+    if (report.episode_count > 0) {
+        report.avg_duration_ms = static_cast<double>(duration_sum) / static_cast<double>(report.episode_count);
+        report.avg_depth = depth_sum / static_cast<double>(report.episode_count);
+    }
+    return report;
+}
+
+DrawdownReport compute_drawdown_episodes(
+    const double* equity_curve,
+    const Timestamp* timestamps,
+    size_t n,
+    double min_depth
+) {
+    DrawdownEpisodeTracker tracker(min_depth);
+    tracker.update_batch(timestamps, equity_curve, n);
+    return tracker.finish();
+}
+
+} // namespace analysis
+} // namespace quant_crypto
@@ -0,0 +1,166 @@
+#include "analysis/equity_statistics.h"
+#include <cmath>
+#include <algorithm>
+
+namespace quant_crypto {
+namespace analysis {
+
+void EquityStatistics::reset() {
+    count_ = 0;
+    first_timestamp_ = 0;
+    last_timestamp_ = 0;
+    first_equity_ = 0.0;
+    last_equity_ = 0.0;
+    peak_ = 0.0;
+    max_drawdown_ = 0.0;
+    return_count_ = 0;
+    return_mean_ = 0.0;
+    return_m2_ = 0.0;
+    downside_count_ = 0;
+    downside_sum_sq_ = 0.0;
+}
+
+void EquityStatistics::update_batch(const Timestamp* timestamps, const double* equity, size_t n) {
+    if (n == 0) return;
+    size_t start = 0;
+    if (count_ == 0) {
+        update(timestamps[0], equity[0]);
+        start = 1;
+    }
+
+    constexpr size_t BLOCK = 1024;
+    double returns[BLOCK];
+
+    for (size_t begin = start; begin < n; begin += BLOCK) {
+        size_t m = std::min(BLOCK, n - begin);
+        double prev = last_equity_;
+
+        // 前值 <= 0 时收益率需要跳过，退回逐点计算
+        bool all_positive = prev > 0;
+        for (size_t j = 0; j + 1 < m; j++) {
+            all_positive &= equity[begin + j] > 0;
+        }
+        if (!all_positive) {
+            for (size_t j = 0; j < m; j++) {
+                update(timestamps[begin + j], equity[begin + j]);
+            }
+            continue;
+        }
+
+        // 1. 收益率（无跨元素依赖）
+        returns[0] = (equity[begin] - prev) / prev;
+        for (size_t j = 1; j < m; j++) {
+            returns[j] = (equity[begin + j] - equity[begin + j - 1]) / equity[begin + j - 1];
+        }
+
+        // 2. 块内均值、偏差平方和、下行平方和（4路累加，便于向量化）
+        constexpr size_t LANES = 4;
+        double sum[LANES] = {0.0, 0.0, 0.0, 0.0};
+        for (size_t j = 0; j < m; j++) {
+            sum[j % LANES] += returns[j];
+        }
+        double block_mean = (sum[0] + sum[1] + sum[2] + sum[3]) / static_cast<double>(m);
+
+        double m2[LANES] = {0.0, 0.0, 0.0, 0.0};
+        double down[LANES] = {0.0, 0.0, 0.0, 0.0};
+        size_t down_count = 0;
+        for (size_t j = 0; j < m; j++) {
+            double r = returns[j];
+            double diff = r - block_mean;
+            m2[j % LANES] += diff * diff;
+            bool negative = r < 0.0;
+            down[j % LANES] += negative ? r * r : 0.0;
+            down_count += negative ? 1 : 0;
+        }
+        double block_m2 = m2[0] + m2[1] + m2[2] + m2[3];
+        double down_sq = down[0] + down[1] + down[2] + down[3];
+
+        // 3. 合并到全局矩（Chan 并行方差公式）
+        double total = static_cast<double>(return_count_ + m);
+        double delta = block_mean - return_mean_;
+        return_m2_ += block_m2 + delta * delta * static_cast<double>(return_count_) * static_cast<double>(m) / total;
+        return_mean_ += delta * static_cast<double>(m) / total;
+        return_count_ += m;
+        downside_count_ += down_count;
+        downside_sum_sq_ += down_sq;
+
+        // 4. 峰值与最大回撤
+        double peak = peak_;
+        double max_dd = max_drawdown_;
+        for (size_t j = 0; j < m; j++) {
+            double e = equity[begin + j];
+            peak = std::max(peak, e);
+            max_dd = std::max(max_dd, peak > 0.0 ? (peak - e) / peak : 0.0);
+        }
+        peak_ = peak;
+        max_drawdown_ = max_dd;
+
+        last_equity_ = equity[begin + m - 1];
+        last_timestamp_ = timestamps[begin + m - 1];
+        count_ += m;
+    }
+}
+
+EquityStatistics::State EquityStatistics::state() const {
+    State state;
+    state.count = count_;
+    state.first_timestamp = first_timestamp_;
+    state.last_timestamp = last_timestamp_;
+    state.first_equity = first_equity_;
+    state.last_equity = last_equity_;
+    state.peak = peak_;
+    state.max_drawdown = max_drawdown_;
+    state.return_count = return_count_;
+    state.return_mean = return_mean_;
+    state.return_m2 = return_m2_;
+    state.downside_count = downside_count_;
+    state.downside_sum_sq = downside_sum_sq_;
+    return state;
+}
+
+void EquityStatistics::restore(const State& state) {
+    count_ = state.count;
+    first_timestamp_ = state.first_timestamp;
+    last_timestamp_ = state.last_timestamp;
+    first_equity_ = state.first_equity;
+    last_equity_ = state.last_equity;
+    peak_ = state.peak;
+    max_drawdown_ = state.max_drawdown;
+    return_count_ = state.return_count;
+    return_mean_ = state.return_mean;
+    return_m2_ = state.return_m2;
+    downside_count_ = state.downside_count;
+    downside_sum_sq_ = state.downside_sum_sq;
+}
+
+double EquityStatistics::current_drawdown() const {
+    if (count_ == 0 || peak_ == 0.0) return 0.0;
+    return (peak_ - last_equity_) / peak_;
+}
+
+double EquityStatistics::volatility() const {
+    if (return_count_ < 2) return 0.0;
+    return std::sqrt(return_m2_ / static_cast<double>(return_count_));
+}
+
+double EquityStatistics::downside_deviation() const {
+    if (downside_count_ == 0) return 0.0;
+    return std::sqrt(downside_sum_sq_ / static_cast<double>(downside_count_));
+}
+
+double EquityStatistics::sharpe_ratio() const {
+    if (return_count_ < 2) return 0.0;
+    double vol = volatility();
+    if (vol == 0.0) return 0.0;
+    return return_mean_ / vol;
+}
+
+double EquityStatistics::sortino_ratio() const {
+    if (return_count_ == 0) return 0.0;
+    double downside = downside_deviation();
+    if (downside == 0.0) return 0.0;
+    return return_mean_ / downside;
+}
+
+} // namespace analysis
+} // namespace quant_crypto
@@ -0,0 +1,119 @@
+#include "analysis/metrics_table.h"
+#include "common/calendar.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace quant_crypto {
+namespace analysis {
+
+namespace {
+
+const char* const METRIC_NAMES[METRIC_COUNT] = {
+    "annualized_return",
+    "cumulative_return",
+    "max_drawdown",
+    "sharpe_ratio",
+    "sortino_ratio",
+    "calmar_ratio",
+    "volatility",
+    "downside_deviation",
+    "profit_loss_ratio",
+    "max_consecutive_wins",
+    "max_consecutive_losses",
+    "avg_holding_period",
+    "trade_frequency_per_year",
+    "max_drawdown_days",
+    "under_water_ratio",
+};
+
+// 行号比较：NaN 总在最后，值相等时（包括两个都是 NaN）按行号
+struct RowLess {
+    const std::vector<double>& values;
+    bool descending;
+
+    bool operator()(size_t a, size_t b) const {
+        double x = values[a];
+        double y = values[b];
+        bool x_nan = std::isnan(x);
+        bool y_nan = std::isnan(y);
+        if (x_nan != y_nan) return y_nan;
+        if (!x_nan && x != y) return descending ? x > y : x < y;
+        return a < b;
+    }
+};
+
+} // namespace
+
+MetricsTable::MetricsTable(size_t rows)
+    : rows_(rows), columns_(METRIC_COUNT, std::vector<double>(rows, 0.0)) {}
+
+void MetricsTable::set_row(size_t row, const PerformanceMetrics& metrics) {
+    column(Metric::ANNUALIZED_RETURN)[row] = metrics.annualized_return;
+    column(Metric::CUMULATIVE_RETURN)[row] = metrics.cumulative_return;
+    column(Metric::MAX_DRAWDOWN)[row] = metrics.max_drawdown;
+    column(Metric::SHARPE_RATIO)[row] = metrics.sharpe_ratio;
+    column(Metric::SORTINO_RATIO)[row] = metrics.sortino_ratio;
+    column(Metric::CALMAR_RATIO)[row] = metrics.calmar_ratio;
+    column(Metric::VOLATILITY)[row] = metrics.volatility;
+    column(Metric::DOWNSIDE_DEVIATION)[row] = metrics.downside_deviation;
+    column(Metric::PROFIT_LOSS_RATIO)[row] = metrics.profit_loss_ratio;
+    column(Metric::MAX_CONSECUTIVE_WINS)[row] = metrics.max_consecutive_wins;
+    column(Metric::MAX_CONSECUTIVE_LOSSES)[row] = metrics.max_consecutive_losses;
+    column(Metric::AVG_HOLDING_PERIOD)[row] = metrics.avg_holding_period;
+    column(Metric::TRADE_FREQUENCY)[row] = metrics.trade_frequency_per_year;
+    column(Metric::MAX_DRAWDOWN_DAYS)[row] =
+        static_cast<double>(metrics.drawdowns.max_duration_ms) / static_cast<double>(calendar::MS_PER_DAY);
+    column(Metric::UNDER_WATER_RATIO)[row] = metrics.drawdowns.under_water_ratio();
+}
+
+std::vector<size_t> MetricsTable::top_k(Metric metric, size_t k, bool descending) const {
+    std::vector<size_t> rows(rows_);
+    for (size_t i = 0; i < rows_; i++) rows[i] = i;
+    k = std::min(k, rows_);
+    std::partial_sort(rows.begin(), rows.begin() + k, rows.end(), RowLess{column(metric), descending});
+    rows.resize(k);
+    return rows;
+}
+
+std::vector<size_t> MetricsTable::argsort(Metric metric, bool descending) const {
+    std::vector<size_t> rows(rows_);
+    for (size_t i = 0; i < rows_; i++) rows[i] = i;
+    // 比较器在值相等时按行号，std::sort 的结果即稳定
+    std::sort(rows.begin(), rows.end(), RowLess{column(metric), descending});
+    return rows;
+}
+
+std::vector<size_t> MetricsTable::filter(Metric metric, double min_value, double max_value) const {
+    const std::vector<double>& values = column(metric);
+    std::vector<size_t> rows;
+    for (size_t i = 0; i < rows_; i++) {
+        if (values[i] >= min_value && values[i] <= max_value) rows.push_back(i);
+    }
+    return rows;
+}
+
+MetricsTable MetricsTable::select(const std::vector<size_t>& rows) const {
+    MetricsTable table(rows.size());
+    for (size_t c = 0; c < METRIC_COUNT; c++) {
+        const std::vector<double>& from = columns_[c];
+        std::vector<double>& to = table.columns_[c];
+        for (size_t i = 0; i < rows.size(); i++) to[i] = from.at(rows[i]);
+    }
+    return table;
+}
+
+std::string MetricsTable::metric_name(Metric metric) {
+    size_t index = static_cast<size_t>(metric);
+    return index < METRIC_COUNT ? METRIC_NAMES[index] : "unknown";
+}
+
+Metric MetricsTable::metric_from_string(const std::string& name) {
+    for (size_t i = 0; i < METRIC_COUNT; i++) {
+        if (name == METRIC_NAMES[i]) return static_cast<Metric>(i);
+    }
+    throw std::invalid_argument("MetricsTable: 未知的指标 " + name);
+}
+
+} // namespace analysis
+} // namespace quant_crypto
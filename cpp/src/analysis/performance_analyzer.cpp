@@ -1,121 +1,330 @@
 #include "analysis/performance_analyzer.h"
+#include "backtest/result_sink.h"
+#include "common/calendar.h"
 #include <algorithm>
 #include <cmath>
+#include <iostream>
 #include <limits>
-#include <numeric>
+#include <memory>
 #include <vector>
 
 namespace quant_crypto {
 namespace analysis{
 
+namespace {
+
+/**
+ * 权益点的单次扫描：按块更新统计量（块内可向量化），回撤曲线、回撤区间、周期收益
+ * 与滚动指标在同一块仍在缓存中时处理。analyze 直接按块传入数组，
+ * analyze_stream 读文件时攒满一块再传入，两者按同一选项、同一口径计算。
+ */
+class EquityScanner {
+public:
+    static constexpr size_t BLOCK = 4096;
+
+    // expected 为预计的点数（未知时为0），只用于预留曲线空间
+    EquityScanner(PerformanceMetrics& metrics, EquityStatistics& stats,
+                  const AnalyzeOptions& options, size_t expected)
+        : metrics_(metrics), stats_(stats), options_(options),
+          daily_(calendar::Period::DAY), weekly_(calendar::Period::WEEK),
+          monthly_(calendar::Period::MONTH), episodes_(options.min_drawdown_depth) {
+        if (options_.keep_equity_curve) metrics_.equity_curve.reserve(expected);
+        if (options_.keep_drawdown_curve) metrics_.drawdown_curve.reserve(expected);
+        if (options_.rolling_enabled()) {
+            rolling_.reset(new RollingStatistics(options_.rolling_window_bars, options_.rolling_window_ms));
+            metrics_.rolling.window_bars = options_.rolling_window_bars;
+            metrics_.rolling.window_ms = options_.rolling_window_bars > 0 ? 0 : options_.rolling_window_ms;
+        }
+    }
+
+    void add(const Timestamp* timestamps, const double* equity, size_t m) {
+        if (m == 0) return;
+        double peak = stats_.count() == 0 ? equity[0] : stats_.peak();
+        stats_.update_batch(timestamps, equity, m);
+
+        if (options_.keep_equity_curve) {
+            metrics_.equity_curve.insert(metrics_.equity_curve.end(), equity, equity + m);
+        }
+        if (options_.keep_drawdown_curve) {
+            // 回撤以起点为初始峰值，与 EquityStatistics 一致；峰值 <= 0 时回撤无意义，记为0
+            for (size_t i = 0; i < m; i++) {
+                peak = std::max(peak, equity[i]);
+                metrics_.drawdown_curve.push_back(peak > 0.0 ? (peak - equity[i]) / peak : 0.0);
+            }
+        }
+        if (options_.keep_period_returns) {
+            daily_.update_batch(timestamps, equity, m);
+            weekly_.update_batch(timestamps, equity, m);
+            monthly_.update_batch(timestamps, equity, m);
+        }
+        if (options_.keep_drawdown_episodes) {
+            episodes_.update_batch(timestamps, equity, m);
+        }
+        if (rolling_) {
+            RollingMetrics& out = metrics_.rolling;
+            for (size_t i = 0; i < m; i++) {
+                if (!rolling_->update(timestamps[i], equity[i])) continue;
+                out.timestamps.push_back(timestamps[i]);
+                out.mean_return.push_back(rolling_->mean_return());
+                out.volatility.push_back(rolling_->volatility());
+                out.sharpe_ratio.push_back(rolling_->sharpe_ratio());
+                out.sortino_ratio.push_back(rolling_->sortino_ratio());
+                out.drawdown.push_back(rolling_->drawdown());
+            }
+        }
+    }
+
+    void finish() {
+        if (options_.keep_period_returns) {
+            metrics_.daily_returns = daily_.finish();
+            metrics_.weekly_returns = weekly_.finish();
+            metrics_.monthly_returns = monthly_.finish();
+        }
+        if (options_.keep_drawdown_episodes) {
+            metrics_.drawdowns = episodes_.finish();
+        }
+    }
+
+private:
+    PerformanceMetrics& metrics_;
+    EquityStatistics& stats_;
+    const AnalyzeOptions& options_;
+    PeriodReturnAggregator daily_;
+    PeriodReturnAggregator weekly_;
+    PeriodReturnAggregator monthly_;
+    DrawdownEpisodeTracker episodes_;
+    std::unique_ptr<RollingStatistics> rolling_;
+};
+
+constexpr size_t EquityScanner::BLOCK;
+
+} // namespace
+
 
 PerformanceMetrics PerformanceAnalyzer::analyze(
     const std::vector<double>& equity_curve,
     const std::vector<Timestamp>& timestamps,
     const std::vector<strategy::Trade>& trades,
-    double initial_captial
+    double initial_captial,
+    const AnalyzeOptions& options
 ){
-    PerformanceMetrics metrics;
-
     // 参数验证
-    if (equity_curve.empty() || timestamps.empty() || 
-        equity_curve.size() != timestamps.size()) {
+    if (equity_curve.size() != timestamps.size()) {
+        return PerformanceMetrics();  // 返回空指标
+    }
+    return analyze(equity_curve.data(), timestamps.data(), equity_curve.size(),
+                   trades, initial_captial, options);
+}
+
+PerformanceMetrics PerformanceAnalyzer::analyze(
+    const double* equity_curve,
+    const Timestamp* timestamps,
+    size_t n,
+    const std::vector<strategy::Trade>& trades,
+    double initial_captial,
+    const AnalyzeOptions& options
+){
+    PerformanceMetrics metrics;
+    if (n == 0) {
         return metrics;  // 返回空指标
     }
 
+    // ========== 1. 单次遍历：收益/风险统计与曲线 ==========
+    EquityStatistics stats;
+    scan_equity(metrics, stats, equity_curve, timestamps, n, options);
+
+    // ========== 2. 计算收益与风险指标 ==========
+    fill_equity_metrics(metrics, stats, initial_captial, options.periods_per_year);
 
-    // 保存权益曲线
-    metrics.equity_curve = equity_curve;
-    
-    // 计算收益率序列
-    std::vector<double> returns = calculate_returns(equity_curve);
-    
-    // ========== 1. 计算收益指标 ==========
-    double final_capital = equity_curve.back();
-    metrics.cumulative_return = calculate_cumlative_return(initial_captial, final_capital);
-    metrics.annualized_return = calculate_annualized_return(
-        initial_captial, 
-        final_capital, 
-        timestamps.front(), 
-        timestamps.back()
-    );
-    
-    // ========== 2. 计算风险指标 ==========
-    metrics.max_drawdown = calculate_max_drawdown(equity_curve);
-    metrics.volatility = calculate_volatility(returns);
-    metrics.downside_deviation = calculate_downside_deviation(returns);
-    metrics.sharpe_ratio = calculate_sharpe_ratio(returns);
-    metrics.sortino_ratio = calculate_sortino_ratio(returns);
-    metrics.calmar_ratio = calculate_calmar_ratio(
-        metrics.annualized_return, 
-        metrics.max_drawdown
-    );
-    
-    // 计算并保存回撤曲线
-    metrics.drawdown_curve = calculate_drawdown_curve(equity_curve);
-    
     // ========== 3. 计算交易指标 ==========
-    metrics.profit_loss_ratio = calculate_profit_loss_ratio(trades);
-    
-    auto [max_wins, max_losses] = calculate_max_consecutive(trades);
-    metrics.max_consecutive_wins = max_wins;
-    metrics.max_consecutive_losses = max_losses;
-    
-    metrics.avg_holding_period = calculate_avg_holding_period(trades);
-    
-    // 只统计卖出交易（平仓）的次数
-    int sell_count = 0;
-    for (const auto& trade : trades) {
-        if (trade.signal == strategy::Signal::SELL) {
-            sell_count++;
-        }
+    fill_trade_metrics(metrics, trades, timestamps[0], timestamps[n - 1]);
+
+    return metrics;
+}
+
+
+PerformanceMetrics PerformanceAnalyzer::analyze(const backtest::BacktestResult& result,
+                                                const AnalyzeOptions& options) {
+    PerformanceMetrics metrics;
+
+    const EquityStatistics& stats = result.equity_stats;
+    if (stats.count() == 0) {
+        return metrics;  // 返回空指标
     }
-    metrics.trade_frequency_per_year = calculate_trade_frequency(
-        sell_count,
-        timestamps.front(),
-        timestamps.back()
-    );
-    
+
+    // 保存（可能是采样的）权益曲线，并据此计算回撤曲线
+    if (!result.equity_curve.empty() && result.equity_curve.size() == result.timestamps.size()) {
+        EquityStatistics curve_stats;
+        scan_equity(metrics, curve_stats, result.equity_curve.data(), result.timestamps.data(),
+                    result.equity_curve.size(), options);
+    }
+
+    // 收益与风险指标来自覆盖全部Bar的在线统计
+    fill_equity_metrics(metrics, stats, result.initial_capital, options.periods_per_year);
+
+    fill_trade_metrics(metrics, result.trades, stats.first_timestamp(), stats.last_timestamp());
+
     return metrics;
 }
 
+PerformanceMetrics PerformanceAnalyzer::analyze_stream(const std::string& path, const AnalyzeOptions& options) {
+    PerformanceMetrics metrics;
 
-// 辅助方法： 计算收益率序列
-std::vector<double> PerformanceAnalyzer::calculate_returns(
-    const std::vector<double>& equity_curve) {
-// ========= 辅助方法：计算收益率序列 =========
-    std::vector<double> returns;
-    if(equity_curve.size()<2) return returns;
-    
-    returns.reserve(equity_curve.size()-1);
+    backtest::BinaryResultReader reader(path);
+    if (!reader.is_open()) {
+        return metrics;  // 返回空指标
+    }
 
-    for(size_t i=1;i<equity_curve.size();i++){
-        if(equity_curve[i-1]>0){
-            double ret = (equity_curve[i]-equity_curve[i-1])/equity_curve[i-1];
-            returns.push_back(ret);
+    // 单次顺序遍历：权益点攒满一块后与 analyze 走同一扫描逻辑，交易更新交易统计
+    EquityStatistics stream_stats;
+    EquityScanner scanner(metrics, stream_stats, options, 0);
+    TradeStatistics trade_stats;
+    EquityStatistics::State summary_stats{};
+    bool has_summary = false;
+
+    std::vector<Timestamp> block_timestamps;
+    std::vector<double> block_equity;
+    block_timestamps.reserve(EquityScanner::BLOCK);
+    block_equity.reserve(EquityScanner::BLOCK);
+    auto flush_block = [&]() {
+        scanner.add(block_timestamps.data(), block_equity.data(), block_equity.size());
+        block_timestamps.clear();
+        block_equity.clear();
+    };
+
+    bool complete = reader.read_all(
+        [&](Timestamp timestamp, double equity) {
+            block_timestamps.push_back(timestamp);
+            block_equity.push_back(equity);
+            if (block_equity.size() == EquityScanner::BLOCK) flush_block();
+        },
+        [&](const strategy::Trade& trade) {
+            trade_stats.update(trade);
+        },
+        [&](const backtest::ResultSummary& summary) {
+            summary_stats = summary.equity_stats;
+            has_summary = true;
         }
+    );
+    if (!complete) {
+        std::cerr << "[PerformanceAnalyzer] 结果文件不完整，按已读取部分计算: " << path << std::endl;
+    }
+    flush_block();
+    scanner.finish();
+
+    // 有汇总记录时使用覆盖全部Bar的在线统计（文件中的权益点可能是采样的）
+    EquityStatistics stats;
+    if (has_summary) {
+        stats.restore(summary_stats);
+    } else {
+        stats = stream_stats;
+    }
+    if (stats.count() == 0) {
+        return metrics;
     }
-    return returns;
+
+    fill_equity_metrics(metrics, stats, reader.initial_capital(), options.periods_per_year);
+    fill_trade_metrics(metrics, trade_stats, stats.first_timestamp(), stats.last_timestamp());
+    return metrics;
 }
 
-// =========== 辅助方法：计算回撤曲线  ===========
-std::vector<double> PerformanceAnalyzer::calculate_drawdown_curve(
-    const std::vector<double>& equity_curve
-){
-    std::vector<double> drawdown_curve;
-    if(equity_curve.empty()) return drawdown_curve;
+PerformanceMetrics PerformanceAnalyzer::summarize(
+    const EquityStatistics& equity_stats,
+    const TradeStatistics& trade_stats,
+    double initial_captial
+) {
+    PerformanceMetrics metrics;
+    if (equity_stats.count() == 0) {
+        return metrics;  // 返回空指标
+    }
+    fill_equity_metrics(metrics, equity_stats, initial_captial);
+    fill_trade_metrics(metrics, trade_stats, equity_stats.first_timestamp(), equity_stats.last_timestamp());
+    return metrics;
+}
 
-    drawdown_curve.reserve(equity_curve.size());
-    double peak = equity_curve[0];
+void PerformanceAnalyzer::scan_equity(
+    PerformanceMetrics& metrics,
+    EquityStatistics& stats,
+    const double* equity_curve,
+    const Timestamp* timestamps,
+    size_t n,
+    const AnalyzeOptions& options
+) {
+    EquityScanner scanner(metrics, stats, options, n);
+    for (size_t begin = 0; begin < n; begin += EquityScanner::BLOCK) {
+        scanner.add(timestamps + begin, equity_curve + begin, std::min(EquityScanner::BLOCK, n - begin));
+    }
+    scanner.finish();
+}
+
+void PerformanceAnalyzer::fill_equity_metrics(
+    PerformanceMetrics& metrics,
+    const EquityStatistics& stats,
+    double initial_captial,
+    double periods_per_year
+) {
+    double final_capital = stats.last_equity();
+    metrics.cumulative_return = calculate_cumlative_return(initial_captial, final_capital);
+    metrics.annualized_return = calculate_annualized_return(
+        initial_captial,
+        final_capital,
+        stats.first_timestamp(),
+        stats.last_timestamp()
+    );
+
+    // 每年收益率个数：未指定时按平均K线间隔推断
+    if (periods_per_year <= 0.0) {
+        double years = calendar::years_between(stats.first_timestamp(), stats.last_timestamp());
+        if (years > 0.0) periods_per_year = static_cast<double>(stats.return_count()) / years;
+    }
+    metrics.periods_per_year = periods_per_year;
+    // 收益率独立同分布假设下，波动率按 sqrt(每年周期数) 放大，均值按每年周期数放大
+    double scale = periods_per_year > 0.0 ? std::sqrt(periods_per_year) : 1.0;
+
+    metrics.max_drawdown = stats.max_drawdown();
+    metrics.volatility = stats.volatility() * scale;
+    metrics.downside_deviation = stats.downside_deviation() * scale;
+    metrics.sharpe_ratio = stats.sharpe_ratio() * scale;
+    metrics.sortino_ratio = stats.sortino_ratio() * scale;
+    metrics.calmar_ratio = calculate_calmar_ratio(
+        metrics.annualized_return,
+        metrics.max_drawdown
+    );
+}
 
-    for(double equity : equity_curve){
-        if(equity>peak) peak = equity;
-        double drawdown = (peak-equity)/peak;
-        drawdown_curve.push_back(drawdown);
+void PerformanceAnalyzer::fill_trade_metrics(
+    PerformanceMetrics& metrics,
+    const std::vector<strategy::Trade>& trades,
+    Timestamp start_time,
+    Timestamp end_time
+) {
+    TradeStatistics stats;
+    for (const auto& trade : trades) {
+        stats.update(trade);
     }
-    return drawdown_curve;
+    fill_trade_metrics(metrics, stats, start_time, end_time);
 }
 
+void PerformanceAnalyzer::fill_trade_metrics(
+    PerformanceMetrics& metrics,
+    const TradeStatistics& stats,
+    Timestamp start_time,
+    Timestamp end_time
+) {
+    metrics.profit_loss_ratio = stats.profit_loss_ratio();
+    metrics.max_consecutive_wins = stats.max_consecutive_wins();
+    metrics.max_consecutive_losses = stats.max_consecutive_losses();
+    metrics.avg_holding_period = stats.avg_holding_period();
+
+    // 只统计卖出交易（平仓）的次数
+    metrics.trade_frequency_per_year = calculate_trade_frequency(
+        static_cast<int>(stats.sell_count()),
+        start_time,
+        end_time
+    );
+}
+
+
 //============= 收益指标： 年化收益率 =============
 double PerformanceAnalyzer::calculate_annualized_return(
     double initial_captial,
@@ -130,14 +339,8 @@ double PerformanceAnalyzer::calculate_annualized_return(
     // 计算总收益率
     double total_return = (final_captial - initial_captial) / initial_captial;
     
-    // 计算时间跨度（秒）
-    int64_t time_span_seconds = end_time - start_time;
-    if (time_span_seconds <= 0) {
-        return 0.0;
-    }
-    // 转换为年数（假设1年 = 365.25天 = 365.25 * 24 * 3600秒）
-    const double SECONDS_PER_YEAR = 365.25 * 24 * 3600;
-    double years = static_cast<double>(time_span_seconds) / SECONDS_PER_YEAR;
+    // 时间跨度（毫秒时间戳）转换为年数（1年 = 365.25天）
+    double years = calendar::years_between(start_time, end_time);
     
     if (years <= 0) {
         return 0.0;
@@ -160,136 +363,6 @@ double PerformanceAnalyzer::calculate_cumlative_return(
     return (final_captial - initial_captial) / initial_captial;
 }
 
-// ==========  最大回撤 ================
-double PerformanceAnalyzer::calculate_max_drawdown(
-    const std::vector<double>& equity_curve
-) {
-    if (equity_curve.empty()) {
-        return 0.0;
-    }
-    
-    // 使用回撤曲线，找出最大值
-    std::vector<double> drawdown_curve = calculate_drawdown_curve(equity_curve);
-    
-    if (drawdown_curve.empty()) {
-        return 0.0;
-    }
-    
-    // 找出回撤曲线中的最大值
-    auto max_it = std::max_element(drawdown_curve.begin(), drawdown_curve.end());
-    return *max_it;
-}
-
-// ========== 风险指标：波动率（标准差） ==========
-double PerformanceAnalyzer::calculate_volatility(
-    const std::vector<double>& returns
-) {
-    if (returns.size() < 2) {
-        return 0.0;
-    }
-    // 计算平均收益率
-    double mean = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    // 计算方差
-    double variance = 0.0;
-    for (double ret : returns) {
-        double diff = ret - mean;
-        variance += diff * diff;
-    }
-    variance /= returns.size();
-    
-    // 标准差 = sqrt(方差)
-    double std_dev = std::sqrt(variance);
-    return std_dev;
-}
-
-// ========== 风险指标：下行波动率 ==========
-double PerformanceAnalyzer::calculate_downside_deviation(
-    const std::vector<double>& returns
-) {
-    if (returns.empty()) {
-        return 0.0;
-    }
-    
-    // 只考虑负收益率（下行）
-    std::vector<double> downside_returns;
-    for (double ret : returns) {
-        if (ret < 0.0) {
-            downside_returns.push_back(ret);
-        }
-    }
-    
-    if (downside_returns.empty()) {
-        return 0.0;
-    }
-    
-    // 计算下行收益率的平均值
-    double mean = std::accumulate(downside_returns.begin(), downside_returns.end(), 0.0) 
-                  / downside_returns.size();
-    
-    // 计算下行方差（相对于0，而不是平均值）
-    double variance = 0.0;
-    for (double ret : downside_returns) {
-        variance += ret * ret;  // 相对于0的偏差
-    }
-    variance /= downside_returns.size();
-    
-    // 下行标准差
-    return std::sqrt(variance);
-}
-
-// ========== 风险指标：夏普比率 ==========
-double PerformanceAnalyzer::calculate_sharpe_ratio(
-    const std::vector<double>& returns
-) {
-    if (returns.size() < 2) {
-        return 0.0;
-    }
-    
-    // 计算平均收益率
-    double mean_return = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    
-    // 计算波动率
-    double volatility = calculate_volatility(returns);
-    
-    if (volatility == 0.0) {
-        return 0.0;
-    }
-    
-    // 夏普比率 = (平均收益率 - 无风险利率) / 波动率
-    // 这里假设无风险利率为0（加密货币市场）
-    double sharpe = mean_return / volatility;
-    
-    // 年化夏普比率（假设日收益率）
-    // 年化 = 日夏普 * sqrt(252)
-    // 这里先返回原始值，后续可以根据Bar频率调整
-    return sharpe;
-}
-
-// ========== 风险指标：索提诺比率 ==========
-double PerformanceAnalyzer::calculate_sortino_ratio(
-    const std::vector<double>& returns
-) {
-    if (returns.empty()) {
-        return 0.0;
-    }
-    
-    // 计算平均收益率
-    double mean_return = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    
-    // 计算下行波动率
-    double downside_dev = calculate_downside_deviation(returns);
-    
-    if (downside_dev == 0.0) {
-        return 0.0;
-    }
-    
-    // 索提诺比率 = (平均收益率 - 无风险利率) / 下行波动率
-    // 这里假设无风险利率为0
-    double sortino = mean_return / downside_dev;
-    
-    return sortino;
-}
-
 // ========== 风险指标：卡玛比率 ==========
 double PerformanceAnalyzer::calculate_calmar_ratio(
     double annualized_return,
@@ -303,127 +376,6 @@ double PerformanceAnalyzer::calculate_calmar_ratio(
     return annualized_return / max_drawdown;
 }
 
-// ========== 交易指标：盈亏比 ==========
-double PerformanceAnalyzer::calculate_profit_loss_ratio(
-    const std::vector<strategy::Trade>& trades
-) {
-    if (trades.empty()) {
-        return 0.0;
-    }
-    
-    // 浮点数比较的误差范围
-    const double EPSILON = 1e-8;
-    
-    double total_profit = 0.0;
-    double total_loss = 0.0;
-    int profit_count = 0;
-    int loss_count = 0;
-    
-    // 遍历所有交易，统计盈利和亏损
-    for (const auto& trade : trades) {
-        // 只统计平仓交易（有盈亏的交易）
-        // 使用 EPSILON 判断 pnl 是否为 0
-        if (std::abs(trade.pnl) > EPSILON) {
-            if (trade.pnl > EPSILON) {  // 盈利
-                total_profit += trade.pnl;
-                profit_count++;
-            } else if (trade.pnl < -EPSILON) {  // 亏损
-                total_loss += std::abs(trade.pnl);
-                loss_count++;
-            }
-        }
-    }
-    
-    // 如果没有盈利或亏损，返回0
-    if (profit_count == 0 || loss_count == 0) {
-        return 0.0;
-    }
-    
-    // 计算平均盈利和平均亏损
-    double avg_profit = total_profit / profit_count;
-    double avg_loss = total_loss / loss_count;
-    
-    if (avg_loss < EPSILON) {
-        return 0.0;
-    }
-    
-    // 盈亏比 = 平均盈利 / 平均亏损
-    return avg_profit / avg_loss;
-}
-
-// ========== 交易指标：最大连续盈利/亏损次数 ==========
-std::pair<int, int> PerformanceAnalyzer::calculate_max_consecutive(
-    const std::vector<strategy::Trade>& trades
-) {
-    const double EPSILON = 1e-8;
-    
-    int max_consecutive_wins = 0;
-    int max_consecutive_losses = 0;
-    
-    int current_wins = 0;
-    int current_losses = 0;
-    
-    // 遍历所有交易，统计连续盈利和亏损
-    for (const auto& trade : trades) {
-        // 只统计平仓交易（有盈亏的交易）
-        if (std::abs(trade.pnl) > EPSILON) {
-            if (trade.pnl > EPSILON) {  // 盈利
-                // 重置亏损计数，增加盈利计数
-                current_losses = 0;
-                current_wins++;
-                max_consecutive_wins = std::max(max_consecutive_wins, current_wins);
-            } else if (trade.pnl < -EPSILON) {  // 亏损
-                // 重置盈利计数，增加亏损计数
-                current_wins = 0;
-                current_losses++;
-                max_consecutive_losses = std::max(max_consecutive_losses, current_losses);
-            }
-        }
-    }
-    
-    return std::make_pair(max_consecutive_wins, max_consecutive_losses);
-}
-
-// ========== 交易指标：平均持仓时间 ==========
-double PerformanceAnalyzer::calculate_avg_holding_period(
-    const std::vector<strategy::Trade>& trades
-) {
-    if (trades.size() < 2) {
-        return 0.0;
-    }
-    
-    // 需要配对买入和卖出交易来计算持仓时间
-    // 简化处理：假设trades是按时间顺序排列的，且买入和卖出成对出现
-    std::vector<double> holding_periods;
-    
-    for (size_t i = 0; i < trades.size(); i++) {
-        if (trades[i].signal == strategy::Signal::BUY) {
-            // 找到对应的卖出交易
-            for (size_t j = i + 1; j < trades.size(); j++) {
-                if (trades[j].signal == strategy::Signal::SELL && 
-                    trades[j].symbol == trades[i].symbol) {
-                    // 计算持仓时间（毫秒）
-                    int64_t holding_ms = trades[j].timestamp - trades[i].timestamp;
-                    if (holding_ms > 0) {
-                        // 转换为天数（1天 = 24小时 * 3600秒 * 1000毫秒）
-                        double holding_days = static_cast<double>(holding_ms) / (24.0 * 3600.0 * 1000.0);
-                        holding_periods.push_back(holding_days);
-                    }
-                    break;  // 找到配对的卖出交易后退出内层循环
-                }
-            }
-        }
-    }
-    
-    if (holding_periods.empty()) {
-        return 0.0;
-    }
-    
-    // 计算平均持仓时间
-    double sum = std::accumulate(holding_periods.begin(), holding_periods.end(), 0.0);
-    return sum / holding_periods.size();
-}
-
 // ========== 交易指标：交易频率 ==========
 double PerformanceAnalyzer::calculate_trade_frequency(
     int total_trades,
@@ -434,15 +386,8 @@ double PerformanceAnalyzer::calculate_trade_frequency(
         return 0.0;
     }
     
-    // 计算时间跨度（秒）
-    int64_t time_span_seconds = end_time - start_time;
-    if (time_span_seconds <= 0) {
-        return 0.0;
-    }
-    
-    // 转换为年数
-    const double SECONDS_PER_YEAR = 365.25 * 24 * 3600;
-    double years = static_cast<double>(time_span_seconds) / SECONDS_PER_YEAR;
+    // 时间跨度（毫秒时间戳）转换为年数
+    double years = calendar::years_between(start_time, end_time);
     
     const double EPSILON = 1e-8;
     if (years < EPSILON) {
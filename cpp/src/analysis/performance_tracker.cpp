@@ -0,0 +1,61 @@
+#include "analysis/performance_tracker.h"
+#include "analysis/performance_analyzer.h"
+
+namespace quant_crypto {
+namespace analysis {
+
+PerformanceTracker::PerformanceTracker(double initial_capital)
+    : initial_capital_(initial_capital) {}
+
+void PerformanceTracker::reset(double initial_capital) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    initial_capital_ = initial_capital;
+    equity_stats_.reset();
+    trade_stats_.reset();
+}
+
+void PerformanceTracker::on_begin(double initial_capital) {
+    // resume 时引擎会再次调用 on_begin，已有数据时保留统计
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (equity_stats_.count() == 0 && trade_stats_.trade_count() == 0) {
+        initial_capital_ = initial_capital;
+    }
+}
+
+void PerformanceTracker::update_equity(Timestamp timestamp, double equity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    equity_stats_.update(timestamp, equity);
+}
+
+void PerformanceTracker::update_trade(const strategy::Trade& trade) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    trade_stats_.update(trade);
+}
+
+double PerformanceTracker::initial_capital() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return initial_capital_;
+}
+
+PerformanceSnapshot PerformanceTracker::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 只读取统计量，不遍历任何历史数据
+    PerformanceSnapshot snapshot;
+    snapshot.points = equity_stats_.count();
+    snapshot.trades = trade_stats_.trade_count();
+    snapshot.net_pnl = trade_stats_.total_profit() - trade_stats_.total_loss();
+    if (equity_stats_.count() > 0) {
+        snapshot.timestamp = equity_stats_.last_timestamp();
+        snapshot.equity = equity_stats_.last_equity();
+        snapshot.peak_equity = equity_stats_.peak();
+        snapshot.current_drawdown = equity_stats_.current_drawdown();
+    }
+
+    PerformanceAnalyzer analyzer;
+    snapshot.metrics = analyzer.summarize(equity_stats_, trade_stats_, initial_capital_);
+    return snapshot;
+}
+
+} // namespace analysis
+} // namespace quant_crypto
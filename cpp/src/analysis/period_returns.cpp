@@ -0,0 +1,51 @@
+#include "analysis/period_returns.h"
+
+namespace quant_crypto {
+namespace analysis {
+
+void PeriodReturns::clear() {
+    start.clear();
+    open_equity.clear();
+    close_equity.clear();
+    returns.clear();
+}
+
+PeriodReturnAggregator::PeriodReturnAggregator(calendar::Period period)
+    : cursor_(period), table_(period) {}
+
+void PeriodReturnAggregator::reset() {
+    cursor_.reset();
+    table_.clear();
+}
+
+void PeriodReturnAggregator::open_period(double equity) {
+    // 期初权益取上一周期末权益，使各周期收益连乘等于总收益
+    double open = table_.close_equity.empty() ? equity : table_.close_equity.back();
+    table_.start.push_back(cursor_.start());
+    table_.open_equity.push_back(open);
+    table_.close_equity.push_back(equity);
+}
+
+const PeriodReturns& PeriodReturnAggregator::finish() {
+    size_t n = table_.size();
+    table_.returns.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        double open = table_.open_equity[i];
+        table_.returns[i] = open > 0 ? table_.close_equity[i] / open - 1.0 : 0.0;
+    }
+    return table_;
+}
+
+PeriodReturns compute_period_returns(
+    const double* equity_curve,
+    const Timestamp* timestamps,
+    size_t n,
+    calendar::Period period
+) {
+    PeriodReturnAggregator aggregator(period);
+    aggregator.update_batch(timestamps, equity_curve, n);
+    return aggregator.finish();
+}
+
+} // namespace analysis
+} // namespace quant_crypto
@@ -0,0 +1,168 @@
+#include "analysis/rolling_metrics.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace quant_crypto {
+namespace analysis {
+
+RollingStatistics::RollingStatistics(size_t window_bars, int64_t window_ms)
+    : window_bars_(window_bars), window_ms_(window_ms) {
+    if (window_bars_ == 0 && window_ms_ <= 0) {
+        throw std::invalid_argument("RollingStatistics: 窗口点数或时长必须大于0");
+    }
+    reset();
+}
+
+void RollingStatistics::reset() {
+    points_.clear();
+    peaks_.clear();
+    next_sequence_ = 0;
+    first_timestamp_ = 0;
+    evicted_since_resum_ = 0;
+    return_count_ = 0;
+    return_sum_ = 0.0;
+    return_sum_sq_ = 0.0;
+    downside_count_ = 0;
+    downside_sum_sq_ = 0.0;
+}
+
+void RollingStatistics::add_return(const Point& point, bool add) {
+    if (!point.has_return) return;
+    double r = point.ret;
+    if (add) {
+        return_count_++;
+        return_sum_ += r;
+        return_sum_sq_ += r * r;
+        if (r < 0.0) {
+            downside_count_++;
+            downside_sum_sq_ += r * r;
+        }
+    } else {
+        return_count_--;
+        return_sum_ -= r;
+        return_sum_sq_ -= r * r;
+        if (r < 0.0) {
+            downside_count_--;
+            downside_sum_sq_ -= r * r;
+        }
+    }
+}
+
+void RollingStatistics::evict_front() {
+    uint64_t sequence = points_.front().sequence;
+    points_.pop_front();
+    // 新的队首点的前一个点已不在窗口内，它的收益率移出统计
+    if (!points_.empty()) add_return(points_.front(), false);
+    if (!peaks_.empty() && peaks_.front().sequence <= sequence) peaks_.pop_front();
+    evicted_since_resum_++;
+}
+
+void RollingStatistics::resum() {
+    return_count_ = 0;
+    return_sum_ = 0.0;
+    return_sum_sq_ = 0.0;
+    downside_count_ = 0;
+    downside_sum_sq_ = 0.0;
+    for (size_t i = 1; i < points_.size(); i++) add_return(points_[i], true);
+    evicted_since_resum_ = 0;
+}
+
+bool RollingStatistics::update(Timestamp timestamp, double equity) {
+    Point point;
+    point.sequence = next_sequence_++;
+    point.timestamp = timestamp;
+    point.equity = equity;
+    point.has_return = !points_.empty() && points_.back().equity > 0;
+    point.ret = point.has_return ? (equity - points_.back().equity) / points_.back().equity : 0.0;
+    if (points_.empty() && point.sequence == 0) first_timestamp_ = timestamp;
+
+    if (!points_.empty()) add_return(point, true);
+    points_.push_back(point);
+
+    // 单调队列：比新点低的历史高点不可能再成为窗口最高点
+    while (!peaks_.empty() && peaks_.back().equity <= equity) peaks_.pop_back();
+    peaks_.push_back(Peak{point.sequence, equity});
+
+    // 移出窗口外的点
+    bool full;
+    if (window_bars_ > 0) {
+        while (points_.size() > window_bars_) evict_front();
+        full = points_.size() == window_bars_;
+    } else {
+        while (points_.size() > 1 && points_.front().timestamp < timestamp - window_ms_) evict_front();
+        full = timestamp - first_timestamp_ >= window_ms_;
+    }
+
+    // 每移出一个窗口长度的点重新求和，消除加减累积的舍入误差
+    if (evicted_since_resum_ >= points_.size()) resum();
+    return full;
+}
+
+double RollingStatistics::mean_return() const {
+    if (return_count_ == 0) return 0.0;
+    return return_sum_ / static_cast<double>(return_count_);
+}
+
+double RollingStatistics::volatility() const {
+    if (return_count_ < 2) return 0.0;
+    double mean = mean_return();
+    double variance = return_sum_sq_ / static_cast<double>(return_count_) - mean * mean;
+    return variance > 0.0 ? std::sqrt(variance) : 0.0;
+}
+
+double RollingStatistics::downside_deviation() const {
+    if (downside_count_ == 0) return 0.0;
+    return std::sqrt(downside_sum_sq_ / static_cast<double>(downside_count_));
+}
+
+double RollingStatistics::sharpe_ratio() const {
+    double vol = volatility();
+    if (vol == 0.0) return 0.0;
+    return mean_return() / vol;
+}
+
+double RollingStatistics::sortino_ratio() const {
+    double downside = downside_deviation();
+    if (downside == 0.0) return 0.0;
+    return mean_return() / downside;
+}
+
+double RollingStatistics::drawdown() const {
+    if (points_.empty() || peak() == 0.0) return 0.0;
+    return (peak() - points_.back().equity) / peak();
+}
+
+RollingMetrics compute_rolling_metrics(
+    const double* equity_curve,
+    const Timestamp* timestamps,
+    size_t n,
+    size_t window_bars,
+    int64_t window_ms
+) {
+    RollingMetrics rolling;
+    rolling.window_bars = window_bars;
+    rolling.window_ms = window_bars > 0 ? 0 : window_ms;
+
+    RollingStatistics stats(window_bars, window_ms);
+    size_t reserve = window_bars > 0 && n >= window_bars ? n - window_bars + 1 : n;
+    rolling.timestamps.reserve(reserve);
+    rolling.mean_return.reserve(reserve);
+    rolling.volatility.reserve(reserve);
+    rolling.sharpe_ratio.reserve(reserve);
+    rolling.sortino_ratio.reserve(reserve);
+    rolling.drawdown.reserve(reserve);
+
+    for (size_t i = 0; i < n; i++) {
+        if (!stats.update(timestamps[i], equity_curve[i])) continue;
+        rolling.timestamps.push_back(timestamps[i]);
+        rolling.mean_return.push_back(stats.mean_return());
+        rolling.volatility.push_back(stats.volatility());
+        rolling.sharpe_ratio.push_back(stats.sharpe_ratio());
+        rolling.sortino_ratio.push_back(stats.sortino_ratio());
+        rolling.drawdown.push_back(stats.drawdown());
+    }
+    return rolling;
+}
+
+} // namespace analysis
+} // namespace quant_crypto
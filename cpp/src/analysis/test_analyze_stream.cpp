@@ -0,0 +1,232 @@
+/**
+ * @file test_analyze_stream.cpp
+ * @brief 流式结果文件测试（离线）：BinaryResultWriter 写出 → analyze_stream 与内存中 analyze 一致
+ */
+
+#include "analysis/performance_analyzer.h"
+#include "backtest/backtest_engine.h"
+#include "backtest/result_sink.h"
+#include "strategy/ma_cross_strategy.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::analysis;
+using namespace quant_crypto::backtest;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static std::vector<OHLCV> make_bars(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    std::vector<OHLCV> bars;
+    double price = 100.0;
+    for (size_t i = 0; i < n; i++) {
+        OHLCV bar;
+        bar.timestamp = static_cast<Timestamp>(i) * 3600000;   // 1 小时K线，跨越多个日/周/月
+        bar.symbol = "BTCUSDT";
+        bar.timeframe = Timeframe::HOUR_1;
+        bar.open = price;
+        bar.close = price * std::exp(noise(rng));
+        bar.high = std::max(bar.open, bar.close) * 1.002;
+        bar.low = std::min(bar.open, bar.close) * 0.998;
+        bar.volume = 1.0;
+        price = bar.close;
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+static AnalyzeOptions all_options() {
+    AnalyzeOptions options;
+    options.keep_equity_curve = true;
+    options.keep_drawdown_curve = true;
+    options.keep_period_returns = true;
+    options.keep_drawdown_episodes = true;
+    options.min_drawdown_depth = 0.01;
+    options.rolling_window_bars = 200;
+    return options;
+}
+
+// 两边使用同一份在线统计与交易序列，标量指标应逐位相同
+static bool same_scalars(const PerformanceMetrics& a, const PerformanceMetrics& b) {
+    return a.annualized_return == b.annualized_return && a.cumulative_return == b.cumulative_return &&
+           a.max_drawdown == b.max_drawdown && a.volatility == b.volatility &&
+           a.downside_deviation == b.downside_deviation && a.sharpe_ratio == b.sharpe_ratio &&
+           a.sortino_ratio == b.sortino_ratio && a.calmar_ratio == b.calmar_ratio &&
+           a.periods_per_year == b.periods_per_year && a.profit_loss_ratio == b.profit_loss_ratio &&
+           a.max_consecutive_wins == b.max_consecutive_wins &&
+           a.max_consecutive_losses == b.max_consecutive_losses &&
+           a.avg_holding_period == b.avg_holding_period &&
+           a.trade_frequency_per_year == b.trade_frequency_per_year;
+}
+
+static bool same_periods(const PeriodReturns& a, const PeriodReturns& b) {
+    return a.start == b.start && a.open_equity == b.open_equity && a.close_equity == b.close_equity &&
+           a.returns == b.returns;
+}
+
+static bool same_extras(const PerformanceMetrics& a, const PerformanceMetrics& b) {
+    return a.equity_curve == b.equity_curve && a.drawdown_curve == b.drawdown_curve &&
+           same_periods(a.daily_returns, b.daily_returns) && same_periods(a.weekly_returns, b.weekly_returns) &&
+           same_periods(a.monthly_returns, b.monthly_returns) &&
+           a.drawdowns.episode_count == b.drawdowns.episode_count &&
+           a.drawdowns.under_water_ms == b.drawdowns.under_water_ms &&
+           a.drawdowns.max_duration_ms == b.drawdowns.max_duration_ms &&
+           a.rolling.timestamps == b.rolling.timestamps && a.rolling.sharpe_ratio == b.rolling.sharpe_ratio &&
+           a.rolling.drawdown == b.rolling.drawdown && a.rolling.window_bars == b.rolling.window_bars;
+}
+
+// 运行一次回测；path 非空时写入流式结果文件
+static BacktestResult run(const OHLCVSeries& data, EquityRecordMode mode, const std::string& path) {
+    BacktestConfig config;
+    config.record_mode = mode;
+    config.record_interval = 10;
+    strategy::MACrossStrategy strategy;
+    BacktestEngine engine(config);
+    engine.set_strategy(&strategy);
+    engine.set_data(data);
+    if (path.empty()) {
+        engine.run();
+        return engine.take_result();
+    }
+    BinaryResultWriter writer(path);
+    engine.set_sink(&writer);
+    engine.run();
+    writer.close();
+    return engine.take_result();
+}
+
+int main() {
+    std::cout << "========== 流式结果文件测试 ==========\n" << std::endl;
+
+    OHLCVSeries data(make_bars(20000, 5));   // 约 2.3 年，跨过 4096 点的分块边界
+    const std::string path = "test_analyze_stream.bin";
+    PerformanceAnalyzer analyzer;
+
+    // 1. FULL：写出 → analyze_stream 与内存中 analyze 一致（指标、曲线、周期收益、回撤区间、滚动指标）
+    {
+        BacktestResult in_memory = run(data, EquityRecordMode::FULL, "");
+        BacktestResult streamed = run(data, EquityRecordMode::FULL, path);
+        AnalyzeOptions options = all_options();
+        PerformanceMetrics expected = analyzer.analyze(in_memory, options);
+        PerformanceMetrics got = analyzer.analyze_stream(path, options);
+
+        check(in_memory.total_trades > 10 && streamed.equity_curve.empty() && streamed.trades.empty(),
+              "FULL：写入 sink 时结果中不保存曲线与交易");
+        check(same_scalars(got, expected), "FULL：标量指标一致");
+        check(!expected.daily_returns.empty() && !expected.monthly_returns.empty() &&
+              expected.drawdowns.episode_count > 0 && !expected.rolling.empty(),
+              "FULL：周期收益、回撤区间、滚动指标均已计算");
+        check(same_extras(got, expected), "FULL：曲线、周期收益、回撤区间与滚动指标一致");
+
+        AnalyzeOptions periods_only = options;
+        periods_only.periods_per_year = 365.0 * 24.0;
+        check(analyzer.analyze_stream(path, periods_only).sharpe_ratio ==
+              analyzer.analyze(in_memory, periods_only).sharpe_ratio &&
+              analyzer.analyze_stream(path, periods_only).periods_per_year == 365.0 * 24.0,
+              "periods_per_year 选项对 analyze_stream 生效");
+
+        AnalyzeOptions none;
+        none.keep_equity_curve = false;
+        none.keep_drawdown_curve = false;
+        none.keep_period_returns = false;
+        none.keep_drawdown_episodes = false;
+        PerformanceMetrics bare = analyzer.analyze_stream(path, none);
+        check(same_scalars(bare, expected) && bare.equity_curve.empty() && bare.drawdown_curve.empty() &&
+              bare.daily_returns.empty() && bare.drawdowns.episode_count == 0 && bare.rolling.empty(),
+              "关闭全部附加输出：只有标量指标");
+    }
+
+    // 2. 汇总记录逐字段往返
+    {
+        BacktestResult streamed = run(data, EquityRecordMode::NONE, path);
+        BinaryResultReader reader(path);
+        ResultSummary summary{};
+        size_t equity_points = 0;
+        bool complete = reader.read_all(
+            [&](Timestamp, double) { equity_points++; },
+            nullptr,
+            [&](const ResultSummary& s) { summary = s; });
+        EquityStatistics restored;
+        restored.restore(summary.equity_stats);
+        check(complete && equity_points == 0, "NONE：文件中没有权益点");
+        check(summary.initial_capital == streamed.initial_capital && summary.final_equity == streamed.final_equity &&
+              summary.final_capital == streamed.final_capital && summary.total_return == streamed.total_return &&
+              summary.total_trades == streamed.total_trades && summary.winning_trades == streamed.winning_trades &&
+              summary.losing_trades == streamed.losing_trades, "汇总记录：汇总值往返一致");
+        check(restored.count() == streamed.equity_stats.count() &&
+              restored.max_drawdown() == streamed.equity_stats.max_drawdown() &&
+              restored.sharpe_ratio() == streamed.equity_stats.sharpe_ratio() &&
+              restored.last_timestamp() == streamed.equity_stats.last_timestamp(),
+              "汇总记录：在线统计往返一致");
+        BacktestResult in_memory = run(data, EquityRecordMode::NONE, "");
+        check(same_scalars(analyzer.analyze_stream(path, all_options()),
+                           analyzer.analyze(in_memory, all_options())),
+              "NONE：收益与风险指标取自汇总记录，交易指标取自文件中的交易");
+    }
+
+    // 3. 采样记录：指标覆盖全部Bar，曲线为采样点
+    {
+        BacktestResult in_memory = run(data, EquityRecordMode::EVERY_N_BARS, "");
+        run(data, EquityRecordMode::EVERY_N_BARS, path);
+        PerformanceMetrics expected = analyzer.analyze(in_memory, all_options());
+        PerformanceMetrics got = analyzer.analyze_stream(path, all_options());
+        check(same_scalars(got, expected) && same_extras(got, expected) &&
+              got.equity_curve.size() < data.size(), "EVERY_N_BARS：与内存中 analyze 一致");
+    }
+
+    // 4. 没有汇总记录（回测中断）：按文件中的权益点计算，与按数组 analyze 一致
+    {
+        BacktestResult in_memory = run(data, EquityRecordMode::FULL, "");
+        run(data, EquityRecordMode::FULL, path);
+        const uintmax_t summary_bytes = 1 + 4 * 8 + 3 * 4 + 12 * 8;
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - summary_bytes);
+
+        PerformanceMetrics expected = analyzer.analyze(in_memory.equity_curve, in_memory.timestamps,
+                                                       in_memory.trades, in_memory.initial_capital, all_options());
+        PerformanceMetrics got = analyzer.analyze_stream(path, all_options());
+        check(same_extras(got, expected) && got.max_drawdown == expected.max_drawdown &&
+              std::abs(got.sharpe_ratio - expected.sharpe_ratio) < 1e-12 &&
+              got.cumulative_return == expected.cumulative_return,
+              "无汇总记录：按权益点计算，与 analyze(曲线) 一致");
+    }
+
+    // 5. 峰值 <= 0：回撤记为0，不产生 inf/NaN
+    {
+        {
+            BinaryResultWriter writer(path);
+            writer.on_begin(100.0);
+            const double equity[] = {-50.0, -80.0, -20.0, -60.0};
+            for (int i = 0; i < 4; i++) writer.on_equity(i * 60000, equity[i]);
+        }
+        PerformanceMetrics got = analyzer.analyze_stream(path, all_options());
+        bool finite = std::isfinite(got.max_drawdown);
+        for (double dd : got.drawdown_curve) finite = finite && std::isfinite(dd);
+        check(finite && got.drawdown_curve.size() == 4 && got.max_drawdown == 0.0,
+              "峰值 <= 0：回撤曲线与最大回撤有限");
+    }
+
+    // 6. 文件不存在：返回空指标
+    {
+        PerformanceMetrics got = analyzer.analyze_stream("does_not_exist.bin", all_options());
+        check(got.equity_curve.empty() && got.sharpe_ratio == 0.0, "文件不存在：返回空指标");
+    }
+
+    std::remove(path.c_str());
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
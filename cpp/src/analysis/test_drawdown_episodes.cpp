@@ -0,0 +1,168 @@
+/**
+ * @file test_drawdown_episodes.cpp
+ * @brief 回撤区间测试（离线）：手工权益曲线上每次回撤的起止/谷底与水下时间，
+ *        最小深度过滤，随机曲线与逐点暴力计算一致
+ */
+
+#include "analysis/drawdown_episodes.h"
+#include "analysis/performance_analyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::analysis;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static bool near(double a, double b) {
+    return std::abs(a - b) <= 1e-12 * std::max(1.0, std::abs(b));
+}
+
+static const Timestamp HOUR = 3600000;
+
+static bool same_bounds(const DrawdownEpisode& e, size_t start, size_t trough, size_t end,
+                        const std::vector<Timestamp>& timestamps, bool recovered) {
+    return e.start_index == start && e.trough_index == trough && e.end_index == end &&
+           e.start_time == timestamps[start] && e.trough_time == timestamps[trough] &&
+           e.end_time == timestamps[end] && e.recovered == recovered;
+}
+
+int main() {
+    std::cout << "========== 回撤区间测试 ==========\n" << std::endl;
+
+    // 手工曲线（时间单位：小时，间隔不等）
+    //   A：1 点峰值 110 → 3 点谷底 88（-20%）→ 5 点回到 110（等于峰值即恢复）
+    //   B：6 点峰值 120 → 7 点 119 → 8 点 121 恢复
+    //   C：9 点与峰值 121 持平（成为新的起点，13 小时）→ 12 点谷底 90.75（-25%）→ 结束时未恢复
+    const std::vector<double> equity = {100.0, 110.0, 99.0, 88.0, 105.0, 110.0, 120.0,
+                                        119.0, 121.0, 121.0, 96.8, 108.9, 90.75, 100.0};
+    const std::vector<int64_t> hours = {0, 1, 2, 4, 5, 8, 9, 10, 12, 13, 15, 18, 20, 24};
+    std::vector<Timestamp> timestamps;
+    for (int64_t h : hours) timestamps.push_back(h * HOUR);
+    const size_t n = equity.size();
+
+    // 1. 不过滤：三次回撤的起点、谷底、终点与时长
+    {
+        DrawdownReport report = compute_drawdown_episodes(equity.data(), timestamps.data(), n);
+        check(report.episode_count == 3 && report.episodes.size() == 3, "识别出 3 次回撤");
+        if (report.episodes.size() == 3) {
+            const DrawdownEpisode& a = report.episodes[0];
+            const DrawdownEpisode& b = report.episodes[1];
+            const DrawdownEpisode& c = report.episodes[2];
+            check(same_bounds(a, 1, 3, 5, timestamps, true) && a.peak_equity == 110.0 && a.trough_equity == 88.0 &&
+                  near(a.depth, 0.2) && a.duration_ms() == 7 * HOUR && a.decline_ms() == 3 * HOUR &&
+                  a.recovery_ms() == 4 * HOUR,
+                  "A：第 1 ~ 5 点，谷底第 3 点，深度 20%，水下 7 小时（下跌 3 + 恢复 4）");
+            check(same_bounds(b, 6, 7, 8, timestamps, true) && near(b.depth, 1.0 / 120.0) &&
+                  b.duration_ms() == 3 * HOUR && b.recovery_ms() == 2 * HOUR,
+                  "B：第 6 ~ 8 点，超过峰值即恢复，水下 3 小时");
+            check(same_bounds(c, 9, 12, 13, timestamps, false) && c.peak_equity == 121.0 &&
+                  near(c.depth, 0.25) && c.duration_ms() == 11 * HOUR,
+                  "C：从与峰值持平的第 9 点开始，未恢复，以最后一点结束，水下 11 小时");
+        }
+        check(report.under_water_ms == 21 * HOUR && report.total_ms == 24 * HOUR &&
+              near(report.under_water_ratio(), 21.0 / 24.0), "水下时间 21 小时（7 + 3 + 11），占 24 小时的 7/8");
+        check(report.max_duration_ms == 11 * HOUR && near(report.avg_duration_ms, 7.0 * HOUR) &&
+              report.max_recovery_ms == 4 * HOUR && near(report.avg_depth, (0.2 + 1.0 / 120.0 + 0.25) / 3.0),
+              "最长水下 11 小时，平均 7 小时，最长恢复 4 小时（未恢复的 C 不计），平均深度");
+    }
+
+    // 2. 最小深度 5%：B 只计入水下时间，不保存明细、不参与平均
+    {
+        DrawdownReport report = compute_drawdown_episodes(equity.data(), timestamps.data(), n, 0.05);
+        check(report.episode_count == 2 && report.episodes[0].start_index == 1 && report.episodes[1].start_index == 9,
+              "保留 A 与 C");
+        check(report.under_water_ms == 21 * HOUR && near(report.avg_duration_ms, 9.0 * HOUR) &&
+              report.max_recovery_ms == 4 * HOUR && near(report.avg_depth, 0.225),
+              "水下时间仍为 21 小时，平均时长 9 小时，平均深度 22.5%");
+    }
+
+    // 3. 逐点 update 与结束于峰值：最后一点恢复时没有未结束的回撤
+    {
+        DrawdownEpisodeTracker tracker;
+        for (size_t i = 0; i < 9; i++) tracker.update(timestamps[i], equity[i]);
+        check(!tracker.in_drawdown(), "第 8 点创新高后不在回撤中");
+        DrawdownReport report = tracker.finish();
+        check(report.episode_count == 2 && report.episodes.back().recovered && report.under_water_ms == 10 * HOUR &&
+              report.total_ms == 12 * HOUR, "前 9 个点：A、B 均已恢复，水下 10 小时");
+
+        tracker.reset();
+        tracker.update(0, 100.0);
+        DrawdownReport single = tracker.finish();
+        check(single.episode_count == 0 && single.under_water_ms == 0 && single.under_water_ratio() == 0.0,
+              "reset 后只有一个点：没有回撤，水下占比为 0");
+    }
+
+    // 4. PerformanceAnalyzer 开启 keep_drawdown_episodes：结果相同
+    {
+        AnalyzeOptions options;
+        options.keep_drawdown_episodes = true;
+        PerformanceAnalyzer analyzer;
+        PerformanceMetrics metrics = analyzer.analyze(equity, timestamps, {}, equity[0], options);
+        const DrawdownReport& report = metrics.drawdowns;
+        bool same = report.episode_count == 3 && report.under_water_ms == 21 * HOUR;
+        for (size_t k = 0; same && k < report.episodes.size(); k++) {
+            same = report.episodes[k].start_index == (k == 0 ? 1u : k == 1 ? 6u : 9u);
+        }
+        check(same && near(metrics.max_drawdown, 0.25), "analyze 的回撤区间与直接计算相同，最大回撤 25%");
+    }
+
+    // 5. 随机曲线：与逐点暴力计算一致
+    {
+        std::mt19937 rng(11);
+        std::normal_distribution<double> noise(0.0, 0.01);
+        std::uniform_int_distribution<int> gap(1, 4);
+        const size_t m = 50000;
+        std::vector<double> curve(m);
+        std::vector<Timestamp> ts(m);
+        double value = 1000.0;
+        for (size_t i = 0; i < m; i++) {
+            value *= std::exp(noise(rng));
+            curve[i] = std::round(value * 100.0) / 100.0;  // 取整到分，制造与峰值持平的点
+            ts[i] = i == 0 ? 0 : ts[i - 1] + gap(rng) * 60000;
+        }
+        DrawdownReport report = compute_drawdown_episodes(curve.data(), ts.data(), m);
+
+        // 暴力：区间 [i, i+1] 任一端低于当时的峰值即计入水下
+        std::vector<double> peak(m);
+        for (size_t i = 0; i < m; i++) peak[i] = i == 0 ? curve[0] : std::max(peak[i - 1], curve[i]);
+        int64_t under_water = 0;
+        double max_depth = 0.0;
+        for (size_t i = 0; i < m; i++) {
+            max_depth = std::max(max_depth, (peak[i] - curve[i]) / peak[i]);
+            if (i + 1 < m && (curve[i] < peak[i] || curve[i + 1] < peak[i + 1])) under_water += ts[i + 1] - ts[i];
+        }
+
+        bool bounds_ok = report.episode_count > 10;
+        double deepest = 0.0;
+        for (size_t k = 0; bounds_ok && k < report.episodes.size(); k++) {
+            const DrawdownEpisode& e = report.episodes[k];
+            bounds_ok = curve[e.start_index] == e.peak_equity && peak[e.start_index] == e.peak_equity &&
+                        curve[e.trough_index] == e.trough_equity &&
+                        (k == 0 || report.episodes[k - 1].end_index <= e.start_index);
+            for (size_t i = e.start_index + 1; bounds_ok && i < e.end_index; i++) {
+                bounds_ok = curve[i] < e.peak_equity && curve[i] >= e.trough_equity;
+            }
+            bounds_ok = bounds_ok && (e.recovered ? curve[e.end_index] >= e.peak_equity
+                                                  : e.end_index == m - 1 && curve[m - 1] < e.peak_equity);
+            deepest = std::max(deepest, e.depth);
+        }
+        check(bounds_ok, std::to_string(report.episode_count) +
+                         " 次回撤：起点为峰值，区间内均低于峰值且不低于谷底，终点恢复或为最后一点");
+        check(report.under_water_ms == under_water && near(deepest, max_depth) && report.total_ms == ts[m - 1],
+              "水下时间与最深回撤与暴力计算一致");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
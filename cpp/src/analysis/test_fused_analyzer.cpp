@@ -0,0 +1,173 @@
+/**
+ * @file test_fused_analyzer.cpp
+ * @brief 单遍权益分析测试（离线）：固定曲线上的夏普、索提诺、波动率、最大回撤与已知值一致，
+ *        随机曲线上与逐项公式的多遍计算一致
+ */
+
+#include "analysis/performance_analyzer.h"
+#include "common/calendar.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::analysis;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static bool near(double a, double b, double tolerance = 1e-12) {
+    return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+}
+
+static const Timestamp DAY = 86400000;
+
+/**
+ * @brief 逐项公式（多遍）：先算收益率数组，再分别求均值、总体标准差、下行偏差与最大回撤
+ */
+struct BaselineMetrics {
+    double volatility = 0.0;
+    double downside_deviation = 0.0;
+    double sharpe_ratio = 0.0;
+    double sortino_ratio = 0.0;
+    double max_drawdown = 0.0;
+    std::vector<double> drawdown_curve;
+};
+
+static BaselineMetrics baseline(const std::vector<double>& equity, double periods_per_year) {
+    BaselineMetrics m;
+    std::vector<double> returns;
+    for (size_t i = 1; i < equity.size(); i++) returns.push_back((equity[i] - equity[i - 1]) / equity[i - 1]);
+
+    double mean = 0.0;
+    for (double r : returns) mean += r;
+    mean /= returns.size();
+    double var = 0.0, down_sq = 0.0;
+    size_t down_count = 0;
+    for (double r : returns) {
+        var += (r - mean) * (r - mean);
+        if (r < 0.0) {
+            down_sq += r * r;
+            down_count++;
+        }
+    }
+    double vol = std::sqrt(var / returns.size());
+    double down = down_count == 0 ? 0.0 : std::sqrt(down_sq / down_count);
+    double scale = std::sqrt(periods_per_year);
+    m.volatility = vol * scale;
+    m.downside_deviation = down * scale;
+    m.sharpe_ratio = vol == 0.0 ? 0.0 : mean / vol * scale;
+    m.sortino_ratio = down == 0.0 ? 0.0 : mean / down * scale;
+
+    double peak = equity[0];
+    for (double e : equity) {
+        peak = std::max(peak, e);
+        double dd = (peak - e) / peak;
+        m.drawdown_curve.push_back(dd);
+        m.max_drawdown = std::max(m.max_drawdown, dd);
+    }
+    return m;
+}
+
+int main() {
+    std::cout << "========== 单遍权益分析测试 ==========\n" << std::endl;
+
+    PerformanceAnalyzer analyzer;
+
+    // 固定曲线：收益率 +10%、-10%、0、+20%
+    const std::vector<double> equity = {100.0, 110.0, 99.0, 99.0, 118.8};
+    std::vector<Timestamp> timestamps;
+    for (size_t i = 0; i < equity.size(); i++) timestamps.push_back(static_cast<Timestamp>(i) * DAY);
+
+    // 1. 已知值（periods_per_year = 1，不缩放）
+    {
+        // 均值 0.05；总体方差 (0.05² + 0.15² + 0.05² + 0.15²) / 4 = 0.0125；下行只有 -0.1
+        const double vol = std::sqrt(0.0125);
+        AnalyzeOptions options;
+        options.periods_per_year = 1.0;
+        PerformanceMetrics m = analyzer.analyze(equity, timestamps, {}, 100.0, options);
+        check(near(m.volatility, vol), "波动率 = sqrt(0.0125)");
+        check(near(m.downside_deviation, 0.1), "下行偏差 = 0.1");
+        check(near(m.sharpe_ratio, 0.05 / vol), "夏普 = 0.05 / sqrt(0.0125)");
+        check(near(m.sortino_ratio, 0.5), "索提诺 = 0.05 / 0.1");
+        check(near(m.max_drawdown, 0.1), "最大回撤 = (110 - 99) / 110");
+        check(m.drawdown_curve.size() == 5 && near(m.drawdown_curve[0], 0.0) && near(m.drawdown_curve[1], 0.0) &&
+              near(m.drawdown_curve[2], 0.1) && near(m.drawdown_curve[3], 0.1) && near(m.drawdown_curve[4], 0.0),
+              "回撤曲线 = {0, 0, 0.1, 0.1, 0}");
+        check(near(m.cumulative_return, 0.188), "累计收益 = 18.8%");
+
+        const double years = 4.0 * DAY / calendar::MS_PER_YEAR;
+        const double annualized = std::pow(1.188, 1.0 / years) - 1.0;
+        check(near(m.annualized_return, annualized) && near(m.calmar_ratio, annualized / 0.1),
+              "年化收益与卡尔玛按时间跨度计算");
+    }
+
+    // 2. 年化：按 sqrt(periods_per_year) 缩放；为0时按时间戳推断（4 个收益率 / 4 天）
+    {
+        AnalyzeOptions options;
+        options.periods_per_year = 365.0;
+        PerformanceMetrics m = analyzer.analyze(equity, timestamps, {}, 100.0, options);
+        const double scale = std::sqrt(365.0);
+        check(near(m.volatility, std::sqrt(0.0125) * scale) && near(m.sortino_ratio, 0.5 * scale) &&
+              near(m.downside_deviation, 0.1 * scale) && near(m.max_drawdown, 0.1),
+              "periods_per_year = 365：波动率、下行偏差、索提诺乘以 sqrt(365)，回撤不变");
+
+        PerformanceMetrics inferred = analyzer.analyze(equity, timestamps, {}, 100.0, AnalyzeOptions());
+        const double expected_periods = 4.0 / (4.0 * DAY / calendar::MS_PER_YEAR);
+        check(near(inferred.periods_per_year, expected_periods) &&
+              near(inferred.sortino_ratio, 0.5 * std::sqrt(expected_periods)),
+              "periods_per_year = 0：按收益率个数 / 年数推断");
+    }
+
+    // 3. 随机曲线：单遍结果与逐项公式的多遍计算一致
+    {
+        std::mt19937 rng(17);
+        std::normal_distribution<double> noise(0.0, 0.01);
+        std::vector<double> curve;
+        std::vector<Timestamp> ts;
+        double value = 10000.0;
+        for (size_t i = 0; i < 50000; i++) {
+            curve.push_back(value);
+            ts.push_back(static_cast<Timestamp>(i) * 3600000);
+            value *= std::exp(noise(rng));
+        }
+        AnalyzeOptions options;
+        options.periods_per_year = 365.0 * 24.0;
+        PerformanceMetrics m = analyzer.analyze(curve, ts, {}, 10000.0, options);
+        BaselineMetrics expected = baseline(curve, options.periods_per_year);
+        check(near(m.volatility, expected.volatility, 1e-10) &&
+              near(m.downside_deviation, expected.downside_deviation, 1e-10) &&
+              near(m.sharpe_ratio, expected.sharpe_ratio, 1e-9) &&
+              near(m.sortino_ratio, expected.sortino_ratio, 1e-9),
+              "随机曲线：波动率、下行偏差、夏普、索提诺与逐项公式一致");
+        check(m.max_drawdown == expected.max_drawdown && m.drawdown_curve == expected.drawdown_curve,
+              "随机曲线：最大回撤与回撤曲线逐位一致");
+    }
+
+    // 4. 默认选项：只保存权益/回撤曲线，周期收益与回撤区间不计算
+    {
+        PerformanceMetrics m = analyzer.analyze(equity, timestamps, {}, 100.0, AnalyzeOptions());
+        check(m.equity_curve == equity && m.drawdown_curve.size() == equity.size(), "默认：保存权益与回撤曲线");
+        check(m.daily_returns.empty() && m.weekly_returns.empty() && m.monthly_returns.empty() &&
+              m.drawdowns.episode_count == 0 && m.rolling.empty(),
+              "默认：周期收益、回撤区间与滚动指标为空");
+
+        AnalyzeOptions extras;
+        extras.keep_period_returns = true;
+        extras.keep_drawdown_episodes = true;
+        PerformanceMetrics full = analyzer.analyze(equity, timestamps, {}, 100.0, extras);
+        check(full.daily_returns.size() == 5 && full.drawdowns.episode_count == 1,
+              "显式开启：计算日收益与回撤区间");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file test_metrics_table.cpp
+ * @brief 指标表测试（离线）：top_k/argsort 的顺序（含同值与 NaN）、筛选与子表，
+ *        BatchAnalyzer 的行与逐条分析一致、与线程数无关
+ */
+
+#include "analysis/batch_analyzer.h"
+#include "analysis/metrics_table.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::analysis;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+/**
+ * @brief 对照实现：稳定排序，NaN 放在最后，其余按值（相等时保持行号顺序）
+ */
+static std::vector<size_t> reference_order(const std::vector<double>& values, bool descending) {
+    std::vector<size_t> rows(values.size());
+    for (size_t i = 0; i < rows.size(); i++) rows[i] = i;
+    std::stable_sort(rows.begin(), rows.end(), [&](size_t a, size_t b) {
+        bool a_nan = std::isnan(values[a]);
+        bool b_nan = std::isnan(values[b]);
+        if (a_nan || b_nan) return !a_nan && b_nan;
+        return descending ? values[a] > values[b] : values[a] < values[b];
+    });
+    return rows;
+}
+
+static std::vector<size_t> prefix(const std::vector<size_t>& rows, size_t k) {
+    return std::vector<size_t>(rows.begin(), rows.begin() + std::min(k, rows.size()));
+}
+
+int main() {
+    std::cout << "========== 指标表测试 ==========\n" << std::endl;
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    // 1. 手工列：同值按行号，NaN 在任何方向都排在最后
+    {
+        MetricsTable table(8);
+        table.column(Metric::SHARPE_RATIO) = {1.5, nan, 2.0, 1.5, -0.5, 2.0, nan, 1.5};
+        check(table.top_k(Metric::SHARPE_RATIO, 4) == std::vector<size_t>({2, 5, 0, 3}),
+              "降序前 4：2.0（第 2、5 行）、1.5（第 0、3 行），同值按行号");
+        check(table.top_k(Metric::SHARPE_RATIO, 3, false) == std::vector<size_t>({4, 0, 3}),
+              "升序前 3：-0.5、1.5（第 0、3 行）");
+        check(table.argsort(Metric::SHARPE_RATIO) == std::vector<size_t>({2, 5, 0, 3, 7, 4, 1, 6}) &&
+              table.argsort(Metric::SHARPE_RATIO, false) == std::vector<size_t>({4, 0, 3, 7, 2, 5, 1, 6}),
+              "argsort 两个方向：NaN（第 1、6 行）都在最后");
+        check(table.top_k(Metric::SHARPE_RATIO, 100) == table.argsort(Metric::SHARPE_RATIO) &&
+              table.top_k(Metric::SHARPE_RATIO, 0).empty(), "k 超过行数时返回全部，k = 0 返回空");
+        check(table.filter(Metric::SHARPE_RATIO, 1.5, 2.0) == std::vector<size_t>({0, 2, 3, 5, 7}),
+              "filter 闭区间 [1.5, 2.0]，不含 NaN，按行号升序");
+
+        MetricsTable sub = table.select({5, 4, 5});
+        check(sub.size() == 3 && sub.value(Metric::SHARPE_RATIO, 0) == 2.0 &&
+              sub.value(Metric::SHARPE_RATIO, 1) == -0.5 && sub.value(Metric::SHARPE_RATIO, 2) == 2.0 &&
+              sub.top_k(Metric::SHARPE_RATIO, 2) == std::vector<size_t>({0, 2}),
+              "select 允许重复与乱序，子表的行号从 0 重新编号");
+    }
+
+    // 2. 大量同值的随机列：各个 k 与方向都等于稳定排序的前缀
+    {
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<int> level(-20, 20);
+        std::uniform_int_distribution<int> percent(0, 99);
+        const size_t n = 5000;
+        MetricsTable table(n);
+        std::vector<double>& values = table.column(Metric::CALMAR_RATIO);
+        for (size_t i = 0; i < n; i++) values[i] = percent(rng) < 3 ? nan : level(rng) * 0.25;
+
+        bool ok = true;
+        for (bool descending : {true, false}) {
+            std::vector<size_t> expected = reference_order(values, descending);
+            ok = ok && table.argsort(Metric::CALMAR_RATIO, descending) == expected;
+            for (size_t k : {size_t(1), size_t(10), size_t(137), size_t(4900), n}) {
+                ok = ok && table.top_k(Metric::CALMAR_RATIO, k, descending) == prefix(expected, k);
+            }
+        }
+        check(ok, "5000 行、41 个取值、约 3% NaN：top_k 与 argsort 都等于稳定排序的前缀");
+    }
+
+    // 3. 指标名
+    {
+        bool names_ok = true;
+        for (size_t i = 0; i < METRIC_COUNT; i++) {
+            Metric metric = static_cast<Metric>(i);
+            names_ok = names_ok && MetricsTable::metric_from_string(MetricsTable::metric_name(metric)) == metric;
+        }
+        bool threw = false;
+        try {
+            MetricsTable::metric_from_string("no_such_metric");
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        check(names_ok && threw, "指标名往返一致，未知名称抛出 invalid_argument");
+    }
+
+    // 4. BatchAnalyzer：每行与单独分析相同；重复的曲线在 top_k 中按行号排列
+    {
+        const size_t curves = 30, points = 2000;
+        std::vector<std::vector<double>> equity(curves);
+        std::vector<Timestamp> timestamps(points);
+        for (size_t i = 0; i < points; i++) timestamps[i] = static_cast<Timestamp>(i) * 3600000;
+        for (size_t c = 0; c < curves; c++) {
+            // 每 3 条曲线用同一个种子：第 c、c+10、c+20 条完全相同
+            std::mt19937 rng(static_cast<unsigned>(c % 10));
+            std::normal_distribution<double> noise(0.0002 * (c % 10) - 0.001, 0.01);
+            double value = 10000.0;
+            for (size_t i = 0; i < points; i++) {
+                value *= std::exp(noise(rng));
+                equity[c].push_back(value);
+            }
+        }
+
+        MetricsTable table = BatchAnalyzer(4).analyze(equity, {timestamps}, {}, 10000.0);
+        bool rows_ok = table.size() == curves;
+        for (size_t c = 0; rows_ok && c < curves; c++) {
+            PerformanceAnalyzer analyzer;
+            PerformanceMetrics metrics =
+                analyzer.analyze(equity[c], timestamps, {}, 10000.0, BatchAnalyzer::default_options());
+            rows_ok = table.value(Metric::SHARPE_RATIO, c) == metrics.sharpe_ratio &&
+                      table.value(Metric::MAX_DRAWDOWN, c) == metrics.max_drawdown &&
+                      table.value(Metric::UNDER_WATER_RATIO, c) == metrics.drawdowns.under_water_ratio();
+        }
+        check(rows_ok, "30 条曲线：每行与 PerformanceAnalyzer 单独分析相同");
+
+        std::vector<size_t> best = table.top_k(Metric::SHARPE_RATIO, 6);
+        size_t seed = best.empty() ? 0 : best[0] % 10;
+        check(best.size() == 6 && best[0] == seed && best[1] == seed + 10 && best[2] == seed + 20 &&
+              best == prefix(reference_order(table.column(Metric::SHARPE_RATIO), true), 6),
+              "夏普前 6：三条相同曲线并列第一，按行号 " + std::to_string(seed) + "、" +
+              std::to_string(seed + 10) + "、" + std::to_string(seed + 20) + " 排列");
+        check(table.top_k(Metric::MAX_DRAWDOWN, 6, false) ==
+              prefix(reference_order(table.column(Metric::MAX_DRAWDOWN), false), 6),
+              "最大回撤升序前 6 与稳定排序一致");
+
+        MetricsTable serial = BatchAnalyzer(1).analyze(equity, {timestamps}, {}, 10000.0);
+        bool same = true;
+        for (size_t m = 0; m < METRIC_COUNT; m++) {
+            Metric metric = static_cast<Metric>(m);
+            same = same && serial.column(metric) == table.column(metric);
+        }
+        check(same, "1 线程与 4 线程的指标表逐位相同");
+
+        bool threw = false;
+        try {
+            BatchAnalyzer(2).analyze(equity, {timestamps, timestamps}, {}, 10000.0);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        check(threw, "时间戳个数既不为 1 也不等于曲线数：抛出 invalid_argument");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file test_performance_tracker.cpp
+ * @brief 增量绩效跟踪测试（离线）：已知权益序列上的实时指标、与 PerformanceAnalyzer 一致、
+ *        作为回测引擎输出、并发读写
+ */
+
+#include "analysis/performance_tracker.h"
+#include "analysis/performance_analyzer.h"
+#include "backtest/backtest_engine.h"
+#include "common/calendar.h"
+#include "strategy/ma_cross_strategy.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::analysis;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static bool near(double a, double b, double tolerance = 1e-12) {
+    return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+}
+
+static const Timestamp DAY = 86400000;
+
+static strategy::Trade make_trade(Timestamp ts, strategy::Signal signal, double price, double pnl) {
+    strategy::Trade trade;
+    trade.timestamp = ts;
+    trade.symbol = "BTCUSDT";
+    trade.signal = signal;
+    trade.price = price;
+    trade.quantity = 1.0;
+    trade.pnl = pnl;
+    return trade;
+}
+
+int main() {
+    std::cout << "========== 增量绩效跟踪测试 ==========\n" << std::endl;
+
+    // 日线权益：收益率 +10%、-10%、0、+20%
+    const std::vector<double> equity = {100.0, 110.0, 99.0, 99.0, 118.8};
+    std::vector<Timestamp> timestamps;
+    for (size_t i = 0; i < equity.size(); i++) timestamps.push_back(static_cast<Timestamp>(i) * DAY);
+    // 第0天买入、第2天卖出亏 11，第2天再买入、第4天卖出盈 19.8
+    const std::vector<strategy::Trade> trades = {
+        make_trade(0, strategy::Signal::BUY, 100.0, 0.0),
+        make_trade(2 * DAY, strategy::Signal::SELL, 89.0, -11.0),
+        make_trade(2 * DAY, strategy::Signal::BUY, 89.0, 0.0),
+        make_trade(4 * DAY, strategy::Signal::SELL, 108.8, 19.8),
+    };
+
+    // 1. 逐点快照：权益、峰值、当前回撤
+    {
+        PerformanceTracker tracker(100.0);
+        const double peaks[] = {100.0, 110.0, 110.0, 110.0, 118.8};
+        const double drawdowns[] = {0.0, 0.0, 0.1, 0.1, 0.0};
+        bool live = true;
+        for (size_t i = 0; i < equity.size(); i++) {
+            tracker.update_equity(timestamps[i], equity[i]);
+            PerformanceSnapshot s = tracker.snapshot();
+            live = live && s.points == i + 1 && s.timestamp == timestamps[i] && s.equity == equity[i] &&
+                   near(s.peak_equity, peaks[i]) && near(s.current_drawdown, drawdowns[i]);
+        }
+        check(live, "每个权益点后：点数、时间戳、权益、峰值、当前回撤");
+
+        PerformanceSnapshot s = tracker.snapshot();
+        // 4 个收益率跨 4 天：每年 365.25 个周期
+        const double scale = std::sqrt(4.0 / (4.0 * DAY / calendar::MS_PER_YEAR));
+        check(near(s.metrics.volatility, std::sqrt(0.0125) * scale) &&
+              near(s.metrics.sharpe_ratio, 0.05 / std::sqrt(0.0125) * scale) &&
+              near(s.metrics.sortino_ratio, 0.5 * scale) && near(s.metrics.max_drawdown, 0.1) &&
+              near(s.metrics.cumulative_return, 0.188),
+              "最终快照：波动率、夏普、索提诺、最大回撤、累计收益为已知值");
+        check(s.metrics.equity_curve.empty() && s.metrics.drawdown_curve.empty(), "快照不含曲线");
+    }
+
+    // 2. 交易：已实现盈亏、盈亏比、连续盈亏、持仓时间；与 analyze 同一序列一致
+    {
+        PerformanceTracker tracker(100.0);
+        for (size_t i = 0; i < equity.size(); i++) tracker.update_equity(timestamps[i], equity[i]);
+        for (size_t i = 0; i < 2; i++) tracker.update_trade(trades[i]);
+        PerformanceSnapshot half = tracker.snapshot();
+        check(half.trades == 2 && near(half.net_pnl, -11.0) && half.metrics.max_consecutive_losses == 1 &&
+              half.metrics.max_consecutive_wins == 0, "第一笔平仓后：净盈亏 -11，连续亏损 1");
+
+        for (size_t i = 2; i < trades.size(); i++) tracker.update_trade(trades[i]);
+        PerformanceSnapshot s = tracker.snapshot();
+        check(s.trades == 4 && near(s.net_pnl, 8.8) && near(s.metrics.profit_loss_ratio, 19.8 / 11.0) &&
+              s.metrics.max_consecutive_wins == 1 && s.metrics.max_consecutive_losses == 1 &&
+              near(s.metrics.avg_holding_period, 2.0),
+              "全部交易后：净盈亏 8.8，盈亏比 1.8，平均持仓 2 天");
+
+        PerformanceAnalyzer analyzer;
+        PerformanceMetrics expected = analyzer.analyze(equity, timestamps, trades, 100.0);
+        check(s.metrics.sharpe_ratio == expected.sharpe_ratio && s.metrics.sortino_ratio == expected.sortino_ratio &&
+              s.metrics.max_drawdown == expected.max_drawdown &&
+              s.metrics.annualized_return == expected.annualized_return &&
+              s.metrics.profit_loss_ratio == expected.profit_loss_ratio &&
+              s.metrics.avg_holding_period == expected.avg_holding_period,
+              "快照指标与 PerformanceAnalyzer::analyze 相同");
+    }
+
+    // 3. 作为回测引擎的输出：快照与回测结果的分析一致；resume 时再次 on_begin 不清空
+    {
+        std::mt19937 rng(4);
+        std::normal_distribution<double> noise(0.0, 0.01);
+        std::vector<OHLCV> bars;
+        double price = 100.0;
+        for (size_t i = 0; i < 5000; i++) {
+            OHLCV bar;
+            bar.timestamp = static_cast<Timestamp>(i) * 3600000;
+            bar.symbol = "BTCUSDT";
+            bar.open = price;
+            bar.close = price * std::exp(noise(rng));
+            bar.high = std::max(bar.open, bar.close) * 1.002;
+            bar.low = std::min(bar.open, bar.close) * 0.998;
+            bar.volume = 1.0;
+            price = bar.close;
+            bars.push_back(bar);
+        }
+        backtest::BacktestConfig config;
+        PerformanceTracker tracker;
+        strategy::MACrossStrategy tracked;
+        backtest::BacktestEngine engine(config);
+        engine.set_strategy(&tracked);
+        engine.set_data(OHLCVSeries(bars));
+        engine.set_sink(&tracker);
+        engine.run();
+
+        // 写入 sink 时结果中不保存曲线与交易，用不带 sink 的同一回测作对照
+        strategy::MACrossStrategy plain;
+        backtest::BacktestEngine reference(config);
+        reference.set_strategy(&plain);
+        reference.set_data(OHLCVSeries(bars));
+        reference.run();
+        backtest::BacktestResult result = reference.take_result();
+
+        PerformanceSnapshot s = tracker.snapshot();
+        PerformanceAnalyzer analyzer;
+        PerformanceMetrics expected = analyzer.analyze(result);
+        check(tracker.initial_capital() == config.initial_capital && s.equity == result.final_equity &&
+              s.trades == result.trades.size() && s.trades > 10 &&
+              s.metrics.sharpe_ratio == expected.sharpe_ratio && s.metrics.max_drawdown == expected.max_drawdown &&
+              s.metrics.profit_loss_ratio == expected.profit_loss_ratio,
+              "BacktestEngine::set_sink：快照与 analyze(回测结果) 一致");
+
+        tracker.on_begin(12345.0);
+        check(tracker.initial_capital() == config.initial_capital && tracker.snapshot().points == s.points,
+              "已有数据时再次 on_begin：保留统计与初始资金");
+        tracker.reset(500.0);
+        check(tracker.initial_capital() == 500.0 && tracker.snapshot().points == 0, "reset：清空统计，修改初始资金");
+    }
+
+    // 4. 并发：写线程逐点更新，读线程的快照始终对应某个已写入的前缀
+    {
+        const size_t n = 200000;
+        PerformanceTracker tracker(100.0);
+        std::atomic<bool> done(false);
+        std::thread writer([&]() {
+            for (size_t i = 0; i < n; i++) tracker.update_equity(static_cast<Timestamp>(i) * 1000, 100.0 + i % 50);
+            done = true;
+        });
+        bool consistent = true;
+        size_t last_points = 0, reads = 0;
+        while (!done || reads == 0) {
+            PerformanceSnapshot s = tracker.snapshot();
+            reads++;
+            if (s.points == 0) continue;
+            size_t i = s.points - 1;
+            consistent = consistent && s.points >= last_points && s.timestamp == static_cast<Timestamp>(i) * 1000 &&
+                         s.equity == 100.0 + i % 50;
+            last_points = s.points;
+        }
+        writer.join();
+        check(consistent && tracker.snapshot().points == n, "并发读写：快照的点数单调，时间戳与权益属于同一个点");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
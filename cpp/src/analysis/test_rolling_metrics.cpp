@@ -0,0 +1,176 @@
+/**
+ * @file test_rolling_metrics.cpp
+ * @brief 滚动指标测试（离线）：按点数/按时长的滑动窗口与逐窗口暴力计算一致
+ */
+
+#include "analysis/rolling_metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::analysis;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static bool near(double a, double b, double tolerance) {
+    return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+}
+
+struct WindowValues {
+    double mean = 0.0;
+    double volatility = 0.0;
+    double sharpe = 0.0;
+    double sortino = 0.0;
+    double drawdown = 0.0;
+};
+
+/**
+ * @brief 暴力计算窗口 [first, last] 的指标（两遍求方差）
+ *
+ * 收益率只取窗口内相邻两点，前一个点权益 <= 0 时跳过，与 EquityStatistics 相同。
+ */
+static WindowValues brute_force(const std::vector<double>& equity, size_t first, size_t last) {
+    std::vector<double> returns;
+    for (size_t j = first + 1; j <= last; j++) {
+        if (equity[j - 1] > 0) returns.push_back((equity[j] - equity[j - 1]) / equity[j - 1]);
+    }
+    WindowValues v;
+    if (!returns.empty()) {
+        for (double r : returns) v.mean += r;
+        v.mean /= returns.size();
+    }
+    if (returns.size() >= 2) {
+        double var = 0.0;
+        for (double r : returns) var += (r - v.mean) * (r - v.mean);
+        v.volatility = std::sqrt(var / returns.size());
+    }
+    double down_sq = 0.0;
+    size_t down_count = 0;
+    for (double r : returns) {
+        if (r < 0.0) {
+            down_sq += r * r;
+            down_count++;
+        }
+    }
+    double downside = down_count == 0 ? 0.0 : std::sqrt(down_sq / down_count);
+    v.sharpe = v.volatility == 0.0 ? 0.0 : v.mean / v.volatility;
+    v.sortino = downside == 0.0 ? 0.0 : v.mean / downside;
+    double peak = *std::max_element(equity.begin() + first, equity.begin() + last + 1);
+    v.drawdown = peak == 0.0 ? 0.0 : (peak - equity[last]) / peak;
+    return v;
+}
+
+// 第 k 个输出与暴力计算一致：均值/波动率按绝对误差，比率按相对误差 1e-9，回撤逐位相同
+static bool matches(const RollingMetrics& rolling, size_t k, const WindowValues& v) {
+    return std::abs(rolling.mean_return[k] - v.mean) < 1e-12 &&
+           std::abs(rolling.volatility[k] - v.volatility) < 1e-10 &&
+           near(rolling.sharpe_ratio[k], v.sharpe, 1e-9) && near(rolling.sortino_ratio[k], v.sortino, 1e-9) &&
+           rolling.drawdown[k] == v.drawdown;
+}
+
+int main() {
+    std::cout << "========== 滚动指标测试 ==========\n" << std::endl;
+
+    // 随机游走权益，中间一段权益 <= 0（该段之后的收益率按口径跳过）
+    const size_t n = 20000;
+    std::mt19937 rng(3);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    std::uniform_int_distribution<int> gap(1, 5);
+    std::vector<double> equity(n);
+    std::vector<Timestamp> regular(n), irregular(n);
+    double value = 10000.0;
+    Timestamp ts = 0;
+    for (size_t i = 0; i < n; i++) {
+        value *= std::exp(noise(rng));
+        equity[i] = value;
+        regular[i] = static_cast<Timestamp>(i) * 60000;
+        irregular[i] = ts;
+        ts += gap(rng) * 60000;
+    }
+    for (size_t i = 9000; i < 9005; i++) equity[i] = i % 2 == 0 ? 0.0 : -10.0;
+
+    // 1. 按点数：第一个完整窗口开始每个点一个值，与暴力计算一致
+    for (size_t window : {size_t(2), size_t(30), size_t(500)}) {
+        RollingMetrics rolling = compute_rolling_metrics(equity.data(), regular.data(), n, window, 0);
+        bool ok = rolling.size() == n - window + 1 && rolling.window_bars == window && rolling.window_ms == 0;
+        for (size_t k = 0; ok && k < rolling.size(); k++) {
+            size_t last = k + window - 1;
+            ok = rolling.timestamps[k] == regular[last] && matches(rolling, k, brute_force(equity, last + 1 - window, last));
+        }
+        check(ok, "按点数（窗口 " + std::to_string(window) + "）：" + std::to_string(n - window + 1) +
+                  " 个值与暴力计算一致（含非正权益段）");
+    }
+
+    // 2. 按时长：窗口为 [t - window_ms, t]，首个点之后满 window_ms 开始输出
+    for (int64_t minutes : {int64_t(10), int64_t(240)}) {
+        const int64_t window_ms = minutes * 60000;
+        RollingMetrics rolling = compute_rolling_metrics(equity.data(), irregular.data(), n, 0, window_ms);
+        size_t first_full = 0;
+        while (irregular[first_full] - irregular[0] < window_ms) first_full++;
+        bool ok = rolling.size() == n - first_full && rolling.window_ms == window_ms;
+        size_t first = 0;
+        for (size_t last = first_full; ok && last < n; last++) {
+            while (irregular[first] < irregular[last] - window_ms) first++;
+            size_t k = last - first_full;
+            ok = rolling.timestamps[k] == irregular[last] && matches(rolling, k, brute_force(equity, first, last));
+        }
+        check(ok, "按时长（" + std::to_string(minutes) + " 分钟，时间戳间隔不等）：与暴力计算一致");
+    }
+
+    // 3. 长序列上加减累积误差：重新求和后误差不随长度增长
+    {
+        const size_t long_n = 2000000;
+        const size_t window = 50;
+        RollingStatistics stats(window, 0);
+        std::vector<double> tail;
+        double v = 100.0;
+        std::normal_distribution<double> big(0.0, 0.05);
+        for (size_t i = 0; i < long_n; i++) {
+            v *= std::exp(big(rng));
+            stats.update(static_cast<Timestamp>(i), v);
+            if (i + window >= long_n) tail.push_back(v);
+        }
+        WindowValues expected = brute_force(tail, 0, tail.size() - 1);
+        check(std::abs(stats.mean_return() - expected.mean) < 1e-12 &&
+              std::abs(stats.volatility() - expected.volatility) < 1e-10 &&
+              stats.drawdown() == expected.drawdown && stats.count() == window,
+              "200 万个点后：最后一个窗口的均值与波动率误差 < 1e-10");
+    }
+
+    // 4. 窗口未满、reset 与参数校验
+    {
+        RollingStatistics stats(3, 0);
+        bool full1 = stats.update(0, 100.0);
+        bool full2 = stats.update(1, 110.0);
+        bool full3 = stats.update(2, 99.0);
+        check(!full1 && !full2 && full3 && std::abs(stats.drawdown() - 0.1) < 1e-12 && stats.peak() == 110.0,
+              "窗口 3：第 3 个点开始满，回撤相对窗口最高 110");
+        stats.update(3, 99.0);
+        stats.update(4, 99.0);
+        check(stats.peak() == 99.0 && stats.drawdown() == 0.0, "最高点移出窗口后，峰值更新为窗口内最高");
+        stats.reset();
+        check(stats.count() == 0 && stats.mean_return() == 0.0 && !stats.update(10, 1.0), "reset 后重新计数");
+
+        bool threw = false;
+        try {
+            RollingStatistics bad(0, 0);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        check(threw, "窗口点数与时长都为0：抛出 invalid_argument");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
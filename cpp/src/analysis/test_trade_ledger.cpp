@@ -0,0 +1,171 @@
+/**
+ * @file test_trade_ledger.cpp
+ * @brief 交易台账测试（离线）：FIFO 配对与盈亏分摊、MAE/MFE、持仓时间、多交易对隔离
+ */
+
+#include "analysis/trade_ledger.h"
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::analysis;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static bool near(double a, double b) {
+    return std::abs(a - b) < 1e-9;
+}
+
+static const Timestamp MINUTE = 60000;
+
+static strategy::Trade make_trade(const std::string& symbol, Timestamp ts, strategy::Signal signal,
+                                  double price, double quantity, double pnl = 0.0) {
+    strategy::Trade trade;
+    trade.timestamp = ts;
+    trade.symbol = symbol;
+    trade.signal = signal;
+    trade.price = price;
+    trade.quantity = quantity;
+    trade.pnl = pnl;
+    return trade;
+}
+
+static OHLCV make_bar(const std::string& symbol, Timestamp ts, double high, double low) {
+    OHLCV bar;
+    bar.timestamp = ts;
+    bar.symbol = symbol;
+    bar.high = high;
+    bar.low = low;
+    bar.open = bar.close = (high + low) / 2.0;
+    return bar;
+}
+
+// BUY 2@100、BUY 3@110，SELL 4@120（pnl 60），再全部平仓 @90（pnl -20）
+static std::vector<strategy::Trade> fifo_trades() {
+    using strategy::Signal;
+    return {
+        make_trade("BTCUSDT", 0, Signal::BUY, 100.0, 2.0),
+        make_trade("BTCUSDT", 1 * MINUTE, Signal::BUY, 110.0, 3.0),
+        make_trade("BTCUSDT", 3 * MINUTE, Signal::SELL, 120.0, 4.0, 60.0),
+        make_trade("BTCUSDT", 4 * MINUTE, Signal::SELL, 90.0, 0.0, -20.0),
+    };
+}
+
+int main() {
+    std::cout << "========== 交易台账测试 ==========\n" << std::endl;
+
+    // 1. FIFO：先平最早的批次，部分平仓拆分批次，卖出 pnl 按数量分摊
+    {
+        TradeLedger ledger;
+        std::vector<strategy::Trade> trades = fifo_trades();
+        for (size_t i = 0; i < 3; i++) ledger.add_trade(trades[i]);
+        SymbolId btc = ledger.symbol_id("BTCUSDT");
+        check(ledger.open_lot_count() == 1 && near(ledger.open_quantity(btc), 1.0),
+              "SELL 4：平掉第一批 2 与第二批的 2，剩余 1");
+
+        ledger.add_trade(trades[3]);
+        const std::vector<RoundTrip>& trips = ledger.round_trips();
+        check(trips.size() == 3, "共 3 次开平仓");
+        if (trips.size() == 3) {
+            check(near(trips[0].entry_price, 100.0) && near(trips[0].quantity, 2.0) &&
+                  near(trips[0].gross_pnl, 40.0) && near(trips[0].pnl, 30.0),
+                  "第1次：2@100 → 120，毛利 40，分摊 pnl 60×2/4 = 30");
+            check(near(trips[1].entry_price, 110.0) && near(trips[1].quantity, 2.0) &&
+                  near(trips[1].gross_pnl, 20.0) && near(trips[1].pnl, 30.0),
+                  "第2次：2@110 → 120，毛利 20，分摊 pnl 30");
+            check(near(trips[2].entry_price, 110.0) && near(trips[2].quantity, 1.0) &&
+                  near(trips[2].exit_price, 90.0) && near(trips[2].gross_pnl, -20.0) && near(trips[2].pnl, -20.0),
+                  "第3次：quantity = 0 全部平仓，剩余 1@110 → 90");
+            check(trips[0].holding_ms() == 3 * MINUTE && trips[1].holding_ms() == 2 * MINUTE &&
+                  trips[2].holding_ms() == 3 * MINUTE, "持仓时间按开仓批次计算：3、2、3 分钟");
+        }
+        check(ledger.round_trip_count() == 3 && ledger.winning_round_trips() == 2 &&
+              ledger.losing_round_trips() == 1, "盈利 2 次，亏损 1 次");
+        check(near(ledger.total_pnl(), 40.0) && near(ledger.total_gross_pnl(), 40.0),
+              "总 pnl 等于卖出记录之和，总毛利 40");
+        check(near(ledger.avg_holding_ms(), 8.0 * MINUTE / 3.0), "平均持仓时间 8/3 分钟");
+        check(ledger.open_lot_count() == 0 && near(ledger.open_quantity(btc), 0.0), "全部平仓后没有未平仓批次");
+    }
+
+    // 2. MAE/MFE：开仓所在K线的价格区间不计入，平仓所在K线计入，平仓价参与极值
+    {
+        using strategy::Signal;
+        std::vector<OHLCV> bars = {
+            make_bar("BTCUSDT", 0, 150.0, 50.0),            // 开仓所在K线，不计入
+            make_bar("BTCUSDT", 1 * MINUTE, 112.0, 97.0),
+            make_bar("BTCUSDT", 2 * MINUTE, 108.0, 90.0),
+            make_bar("BTCUSDT", 3 * MINUTE, 109.0, 96.0),   // 平仓所在K线
+            make_bar("BTCUSDT", 4 * MINUTE, 200.0, 10.0),   // 平仓之后，不计入
+        };
+        std::vector<strategy::Trade> trades = {
+            make_trade("BTCUSDT", 0, Signal::BUY, 100.0, 1.0),
+            make_trade("BTCUSDT", 3 * MINUTE, Signal::SELL, 105.0, 1.0, 5.0),
+        };
+        TradeLedger ledger;
+        ledger.replay(trades, bars);
+        check(ledger.round_trips().size() == 1 && near(ledger.round_trips()[0].mae, -0.10) &&
+              near(ledger.round_trips()[0].mfe, 0.12), "replay：MAE = (90-100)/100，MFE = (112-100)/100");
+
+        // 持仓期间价格没有低于开仓价：MAE 取平仓价与开仓价中较低者，不为正
+        TradeLedger up;
+        SymbolId id = up.symbol_id("BTCUSDT");
+        up.add_trade(make_trade("BTCUSDT", 0, Signal::BUY, 100.0, 1.0));
+        up.mark(id, 120.0, 101.0);
+        up.add_trade(make_trade("BTCUSDT", MINUTE, Signal::SELL, 130.0, 1.0, 30.0));
+        check(near(up.round_trips()[0].mae, 0.0) && near(up.round_trips()[0].mfe, 0.30),
+              "只涨不跌：MAE = 0，MFE 取平仓价 130");
+        check(near(up.avg_mae(), 0.0) && near(up.avg_mfe(), 0.30), "平均 MAE/MFE");
+    }
+
+    // 3. 多交易对：批次与价格极值互不影响；没有持仓的卖出被忽略
+    {
+        using strategy::Signal;
+        TradeLedger ledger;
+        SymbolId btc = ledger.symbol_id("BTCUSDT");
+        SymbolId eth = ledger.symbol_id("ETHUSDT");
+        check(btc != eth && ledger.symbol_name(eth) == "ETHUSDT" && ledger.symbol_id("BTCUSDT") == btc,
+              "交易对名称与编号一一对应");
+
+        ledger.add_trade(make_trade("ETHUSDT", 0, Signal::SELL, 10.0, 1.0, 1.0));
+        check(ledger.round_trip_count() == 0, "没有持仓的卖出被忽略");
+
+        ledger.add_trade(make_trade("BTCUSDT", 0, Signal::BUY, 100.0, 1.0));
+        ledger.add_trade(make_trade("ETHUSDT", 0, Signal::BUY, 10.0, 5.0));
+        ledger.mark(eth, 20.0, 5.0);
+        ledger.add_trade(make_trade("BTCUSDT", MINUTE, Signal::SELL, 101.0, 0.0, 1.0));
+        check(ledger.round_trip_count() == 1 && near(ledger.round_trips()[0].quantity, 1.0) &&
+              near(ledger.round_trips()[0].mae, 0.0) && near(ledger.round_trips()[0].mfe, 0.01),
+              "BTC 全部平仓只平 BTC 批次，ETH 的行情不影响 BTC 的 MAE/MFE");
+        check(ledger.open_lot_count() == 1 && near(ledger.open_quantity(eth), 5.0), "ETH 批次仍未平仓");
+    }
+
+    // 4. 不保存明细：汇总值与保存明细时相同
+    {
+        TradeLedger detailed;
+        TradeLedger summary_only(false);
+        for (const auto& trade : fifo_trades()) {
+            detailed.add_trade(trade);
+            summary_only.add_trade(trade);
+        }
+        check(summary_only.round_trips().empty() && summary_only.round_trip_count() == detailed.round_trip_count() &&
+              summary_only.total_pnl() == detailed.total_pnl() &&
+              summary_only.avg_holding_ms() == detailed.avg_holding_ms() &&
+              summary_only.winning_round_trips() == detailed.winning_round_trips(),
+              "keep_round_trips = false：不保存明细，汇总值相同");
+
+        detailed.reset();
+        check(detailed.round_trip_count() == 0 && detailed.symbol_count() == 0 && detailed.round_trips().empty(),
+              "reset 清空全部状态");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
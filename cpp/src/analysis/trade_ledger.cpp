@@ -0,0 +1,165 @@
+#include "analysis/trade_ledger.h"
+#include <algorithm>
+
+namespace quant_crypto {
+namespace analysis {
+
+namespace {
+// 浮点数比较的误差范围（与 PerformanceAnalyzer 一致）
+const double EPSILON = 1e-8;
+}
+
+TradeLedger::TradeLedger(bool keep_round_trips)
+    : keep_round_trips_(keep_round_trips) {
+    reset();
+}
+
+void TradeLedger::reset() {
+    symbols_.clear();
+    symbol_ids_.clear();
+    last_id_ = 0;
+    lots_.clear();
+    open_lot_count_ = 0;
+    round_trips_.clear();
+    closing_.clear();
+    round_trip_count_ = 0;
+    winning_count_ = 0;
+    losing_count_ = 0;
+    pnl_sum_ = 0.0;
+    gross_pnl_sum_ = 0.0;
+    holding_ms_sum_ = 0.0;
+    mae_sum_ = 0.0;
+    mfe_sum_ = 0.0;
+}
+
+SymbolId TradeLedger::symbol_id(const std::string& symbol) {
+    if (last_id_ < symbols_.size() && symbols_[last_id_] == symbol) return last_id_;
+
+    auto it = symbol_ids_.find(symbol);
+    if (it != symbol_ids_.end()) {
+        last_id_ = it->second;
+        return last_id_;
+    }
+    SymbolId id = static_cast<SymbolId>(symbols_.size());
+    symbols_.push_back(symbol);
+    symbol_ids_.emplace(symbol, id);
+    lots_.emplace_back();
+    last_id_ = id;
+    return id;
+}
+
+void TradeLedger::add_trade(SymbolId id, const strategy::Trade& trade) {
+    if (trade.signal == strategy::Signal::BUY) {
+        Lot lot;
+        lot.entry_time = trade.timestamp;
+        lot.entry_price = trade.price;
+        lot.quantity = trade.quantity;
+        lot.high = trade.price;
+        lot.low = trade.price;
+        lots_[id].push_back(lot);
+        open_lot_count_++;
+    } else if (trade.signal == strategy::Signal::SELL) {
+        close_lots(id, trade);
+    }
+}
+
+void TradeLedger::close_lots(SymbolId id, const strategy::Trade& trade) {
+    std::deque<Lot>& lots = lots_[id];
+    if (lots.empty()) return;
+
+    // 1. 从最早的批次开始平仓（quantity <= 0 表示全部平仓）
+    bool close_all = trade.quantity <= 0;
+    double remaining = trade.quantity;
+    double closed_quantity = 0.0;
+    closing_.clear();
+    while (!lots.empty() && (close_all || remaining > EPSILON)) {
+        Lot& lot = lots.front();
+        double take = close_all ? lot.quantity : std::min(lot.quantity, remaining);
+
+        RoundTrip trip;
+        trip.symbol_id = id;
+        trip.entry_time = lot.entry_time;
+        trip.exit_time = trade.timestamp;
+        trip.entry_price = lot.entry_price;
+        trip.exit_price = trade.price;
+        trip.quantity = take;
+        trip.gross_pnl = (trade.price - lot.entry_price) * take;
+        if (lot.entry_price > 0) {
+            trip.mae = (std::min(lot.low, trade.price) - lot.entry_price) / lot.entry_price;
+            trip.mfe = (std::max(lot.high, trade.price) - lot.entry_price) / lot.entry_price;
+        }
+        closing_.push_back(trip);
+
+        closed_quantity += take;
+        remaining -= take;
+        lot.quantity -= take;
+        if (lot.quantity <= EPSILON) {
+            lots.pop_front();
+            open_lot_count_--;
+        }
+    }
+
+    // 2. 卖出记录的 pnl 按数量分摊（数量均为0时平均分摊）
+    for (RoundTrip& trip : closing_) {
+        double share = closed_quantity > EPSILON ? trip.quantity / closed_quantity
+                                                 : 1.0 / static_cast<double>(closing_.size());
+        trip.pnl = trade.pnl * share;
+
+        round_trip_count_++;
+        if (trip.pnl > EPSILON) {
+            winning_count_++;
+        } else if (trip.pnl < -EPSILON) {
+            losing_count_++;
+        }
+        pnl_sum_ += trip.pnl;
+        gross_pnl_sum_ += trip.gross_pnl;
+        holding_ms_sum_ += static_cast<double>(trip.holding_ms());
+        mae_sum_ += trip.mae;
+        mfe_sum_ += trip.mfe;
+        if (keep_round_trips_) round_trips_.push_back(trip);
+    }
+}
+
+void TradeLedger::mark(SymbolId id, double high, double low) {
+    if (id >= lots_.size()) return;
+    for (Lot& lot : lots_[id]) {
+        if (high > lot.high) lot.high = high;
+        if (low < lot.low) lot.low = low;
+    }
+}
+
+void TradeLedger::replay(const std::vector<strategy::Trade>& trades, const std::vector<OHLCV>& bars) {
+    size_t b = 0;
+    for (const auto& trade : trades) {
+        while (b < bars.size() && bars[b].timestamp <= trade.timestamp) {
+            mark(bars[b]);
+            b++;
+        }
+        add_trade(trade);
+    }
+}
+
+double TradeLedger::avg_holding_ms() const {
+    if (round_trip_count_ == 0) return 0.0;
+    return holding_ms_sum_ / static_cast<double>(round_trip_count_);
+}
+
+double TradeLedger::avg_mae() const {
+    if (round_trip_count_ == 0) return 0.0;
+    return mae_sum_ / static_cast<double>(round_trip_count_);
+}
+
+double TradeLedger::avg_mfe() const {
+    if (round_trip_count_ == 0) return 0.0;
+    return mfe_sum_ / static_cast<double>(round_trip_count_);
+}
+
+double TradeLedger::open_quantity(SymbolId id) const {
+    if (id >= lots_.size()) return 0.0;
+    double quantity = 0.0;
+    for (const Lot& lot : lots_[id]) quantity += lot.quantity;
+    return quantity;
+}
+
+} // namespace analysis
+} // namespace quant_crypto
@@ -0,0 +1,66 @@
+#include "analysis/trade_statistics.h"
+#include "common/calendar.h"
+#include <algorithm>
+#include <cmath>
+
+namespace quant_crypto {
+namespace analysis {
+
+namespace {
+// 浮点数比较的误差范围（与 PerformanceAnalyzer 一致）
+const double EPSILON = 1e-8;
+}
+
+void TradeStatistics::reset() {
+    trade_count_ = 0;
+    sell_count_ = 0;
+    total_profit_ = 0.0;
+    total_loss_ = 0.0;
+    profit_count_ = 0;
+    loss_count_ = 0;
+    current_wins_ = 0;
+    current_losses_ = 0;
+    max_consecutive_wins_ = 0;
+    max_consecutive_losses_ = 0;
+    ledger_ = TradeLedger(false);
+}
+
+void TradeStatistics::update(const strategy::Trade& trade) {
+    trade_count_++;
+
+    // 1. 盈亏与连续盈亏（只统计有盈亏的交易）
+    if (trade.pnl > EPSILON) {
+        total_profit_ += trade.pnl;
+        profit_count_++;
+        current_losses_ = 0;
+        current_wins_++;
+        max_consecutive_wins_ = std::max(max_consecutive_wins_, current_wins_);
+    } else if (trade.pnl < -EPSILON) {
+        total_loss_ += std::abs(trade.pnl);
+        loss_count_++;
+        current_wins_ = 0;
+        current_losses_++;
+        max_consecutive_losses_ = std::max(max_consecutive_losses_, current_losses_);
+    }
+
+    // 2. 持仓时间：先进先出配对开平仓
+    if (trade.signal == strategy::Signal::SELL) {
+        sell_count_++;
+    }
+    ledger_.add_trade(trade);
+}
+
+double TradeStatistics::profit_loss_ratio() const {
+    if (profit_count_ == 0 || loss_count_ == 0) return 0.0;
+    double avg_profit = total_profit_ / profit_count_;
+    double avg_loss = total_loss_ / loss_count_;
+    if (avg_loss < EPSILON) return 0.0;
+    return avg_profit / avg_loss;
+}
+
+double TradeStatistics::avg_holding_period() const {
+    return ledger_.avg_holding_ms() / static_cast<double>(calendar::MS_PER_DAY);
+}
+
+} // namespace analysis
+} // namespace quant_crypto
@@ -0,0 +1,84 @@
+#include "backtest/latency_model.h"
+#include "common/bar_resampler.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace quant_crypto {
+namespace backtest {
+
+namespace {
+// std::push_heap 默认是最大堆，比较取反得到按到达时间的最小堆
+struct LaterEvent {
+    bool operator()(const LatencyEvent& a, const LatencyEvent& b) const {
+        if (a.due_at != b.due_at) return a.due_at > b.due_at;
+        if (a.arrival != b.arrival) return a.arrival > b.arrival;
+        return a.sequence > b.sequence;
+    }
+};
+}
+
+LatencyQueue::LatencyQueue(const LatencyConfig& config)
+    : config_(config), enabled_(config.enabled()), rng_(config.seed), next_sequence_(0) {
+    if (config_.fixed_ms < 0 || config_.jitter_ms < 0) {
+        throw std::invalid_argument("LatencyQueue: 延迟不能为负");
+    }
+    for (int64_t sample : config_.samples_ms) {
+        if (sample < 0) throw std::invalid_argument("LatencyQueue: 延迟样本不能为负");
+    }
+}
+
+void LatencyQueue::clear() {
+    heap_.clear();
+    rng_.seed(config_.seed);
+    next_sequence_ = 0;
+}
+
+int64_t LatencyQueue::sample_delay() {
+    if (!config_.samples_ms.empty()) {
+        std::uniform_int_distribution<size_t> pick(0, config_.samples_ms.size() - 1);
+        return config_.samples_ms[pick(rng_)];
+    }
+    if (config_.jitter_ms > 0) {
+        std::uniform_int_distribution<int64_t> jitter(0, config_.jitter_ms);
+        return config_.fixed_ms + jitter(rng_);
+    }
+    return config_.fixed_ms;
+}
+
+void LatencyQueue::push(LatencyEvent event, Timestamp sent_at, Timeframe timeframe) {
+    event.sent_at = sent_at;
+    event.arrival = sent_at + sample_delay();
+    event.sequence = next_sequence_++;
+
+    // 到达时间向上取整到Bar的开盘时间：落在Bar内部的事件错过了该Bar的开盘价，由下一根Bar处理
+    Timestamp bar_start, bar_end;
+    BarResampler::bucket_bounds(timeframe, event.arrival, bar_start, bar_end);
+    event.due_at = bar_start < event.arrival ? bar_end : bar_start;
+
+    heap_.push_back(std::move(event));
+    std::push_heap(heap_.begin(), heap_.end(), LaterEvent());
+}
+
+void LatencyQueue::push_signal(strategy::Signal signal, Timestamp sent_at, Timeframe timeframe) {
+    LatencyEvent event;
+    event.is_request = false;
+    event.signal = signal;
+    push(std::move(event), sent_at, timeframe);
+}
+
+void LatencyQueue::push_request(const strategy::OrderRequest& request, Timestamp sent_at, Timeframe timeframe) {
+    LatencyEvent event;
+    event.is_request = true;
+    event.request = request;
+    push(std::move(event), sent_at, timeframe);
+}
+
+LatencyEvent LatencyQueue::pop() {
+    std::pop_heap(heap_.begin(), heap_.end(), LaterEvent());
+    LatencyEvent event = std::move(heap_.back());
+    heap_.pop_back();
+    return event;
+}
+
+} // namespace backtest
+} // namespace quant_crypto
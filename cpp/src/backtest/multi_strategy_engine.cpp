@@ -0,0 +1,76 @@
+#include "backtest/multi_strategy_engine.h"
+#include <iostream>
+#include <stdexcept>
+
+namespace quant_crypto {
+namespace backtest {
+
+MultiStrategyEngine::MultiStrategyEngine(const BacktestConfig& config)
+    : config_(config) {}
+
+MultiStrategyEngine::~MultiStrategyEngine() {
+    for (auto* strategy : strategies_) strategy->set_indicator_registry(nullptr);
+}
+
+size_t MultiStrategyEngine::add_strategy(strategy::StrategyBase* strategy) {
+    return add_strategy(strategy, config_);
+}
+
+size_t MultiStrategyEngine::add_strategy(strategy::StrategyBase* strategy, const BacktestConfig& config) {
+    if (!strategy) {
+        throw std::invalid_argument("MultiStrategyEngine: 策略为空");
+    }
+    // 指标注册必须在开始更新前完成，reset() 后才能注册新指标
+    registry_.reset();
+    strategy->set_indicator_registry(&registry_);
+
+    auto engine = std::make_unique<BacktestEngine>(config);
+    engine->set_strategy(strategy);
+    engines_.push_back(std::move(engine));
+    strategies_.push_back(strategy);
+    return engines_.size() - 1;
+}
+
+void MultiStrategyEngine::run() {
+    if (engines_.empty() || data_.empty()) {
+        std::cerr << "策略或数据为空" << std::endl;
+        return;
+    }
+
+    // 1. 初始化所有策略
+    registry_.reset();
+    for (auto& engine : engines_) {
+        engine->start(data_.front().timestamp, data_.size());
+    }
+
+    // 2. 外层K线、内层策略：共享指标每根K线更新一次
+    std::vector<BacktestEngine*> active;
+    active.reserve(engines_.size());
+    for (auto& engine : engines_) active.push_back(engine.get());
+
+    for (const OHLCV& bar : data_) {
+        registry_.update(bar);
+        size_t alive = 0;
+        for (BacktestEngine* engine : active) {
+            // 触发终止条件的策略不再参与后续K线
+            if (engine->step(bar)) active[alive++] = engine;
+        }
+        active.resize(alive);
+        if (active.empty()) break;
+    }
+
+    // 3. 汇总结果
+    for (auto& engine : engines_) {
+        engine->finish();
+    }
+}
+
+std::vector<BacktestResult> MultiStrategyEngine::take_results() {
+    std::vector<BacktestResult> results;
+    results.reserve(engines_.size());
+    for (auto& engine : engines_) results.push_back(engine->take_result());
+    return results;
+}
+
+} // namespace backtest
+} // namespace quant_crypto
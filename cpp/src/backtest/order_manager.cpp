@@ -0,0 +1,304 @@
+#include "backtest/order_manager.h"
+#include <utility>
+
+namespace quant_crypto {
+namespace backtest {
+
+OrderManager::OrderManager(const OrderManager& other) {
+    *this = other;
+}
+
+OrderManager::OrderManager(OrderManager&& other) noexcept {
+    *this = std::move(other);
+}
+
+OrderManager& OrderManager::operator=(const OrderManager& other) {
+    if (this != &other) {
+        buy_limits_ = other.buy_limits_;
+        sell_limits_ = other.sell_limits_;
+        buy_stops_ = other.buy_stops_;
+        sell_stops_ = other.sell_stops_;
+        market_orders_ = other.market_orders_;
+        orders_ = other.orders_;
+        oco_groups_ = other.oco_groups_;
+        updates_ = other.updates_;
+        relink();
+    }
+    return *this;
+}
+
+OrderManager& OrderManager::operator=(OrderManager&& other) noexcept {
+    if (this != &other) {
+        buy_limits_ = std::move(other.buy_limits_);
+        sell_limits_ = std::move(other.sell_limits_);
+        buy_stops_ = std::move(other.buy_stops_);
+        sell_stops_ = std::move(other.sell_stops_);
+        market_orders_ = std::move(other.market_orders_);
+        orders_ = std::move(other.orders_);
+        oco_groups_ = std::move(other.oco_groups_);
+        updates_ = std::move(other.updates_);
+        relink();
+    }
+    return *this;
+}
+
+bool OrderManager::submit(const strategy::Order& order) {
+    bool valid = (order.side == Side::BUY || order.side == Side::SELL);
+    switch (order.type) {
+        case OrderType::MARKET:
+            break;
+        case OrderType::LIMIT:
+            valid = valid && order.price > 0;
+            break;
+        case OrderType::STOP_MARKET:
+            valid = valid && order.stop_price > 0;
+            break;
+        case OrderType::STOP_LIMIT:
+            valid = valid && order.stop_price > 0 && order.price > 0;
+            break;
+        default:
+            valid = false;
+            break;
+    }
+    if (!valid || orders_.count(order.id) > 0) {
+        strategy::Order rejected = order;
+        rejected.status = strategy::OrderStatus::REJECTED;
+        updates_.push_back(rejected);
+        return false;
+    }
+
+    Entry& entry = orders_[order.id];
+    entry.order = order;
+    entry.order.status = strategy::OrderStatus::PENDING;
+    entry.order.triggered = false;
+    entry.book = nullptr;
+
+    if (order.type == OrderType::MARKET) {
+        market_orders_.push_back(order.id);
+    } else if (order.type == OrderType::LIMIT) {
+        insert_limit(entry);
+    } else {
+        insert_stop(entry);
+    }
+
+    if (order.oco_group != 0) {
+        oco_groups_.emplace(order.oco_group, order.id);
+    }
+    return true;
+}
+
+bool OrderManager::cancel(strategy::OrderId id) {
+    if (orders_.find(id) == orders_.end()) return false;
+    finish(id, strategy::OrderStatus::CANCELLED);
+    return true;
+}
+
+void OrderManager::match_bar(const OHLCV& bar, const FillHandler& on_fill) {
+    if (orders_.empty()) return;
+
+    // 1. 市价单：按开盘价成交（市价单已撤销的直接跳过）
+    std::vector<strategy::OrderId> markets;
+    markets.swap(market_orders_);
+    for (strategy::OrderId id : markets) {
+        execute(id, bar.open, true, on_fill);
+    }
+
+    // 2. 开盘跳空越过的挂单
+    match_at_open(bar.open, on_fill);
+
+    // 3. 按Bar内路径依次扫描
+    if (bar.close >= bar.open) {
+        sweep_down(bar.low, on_fill);
+        sweep_up(bar.high, on_fill);
+        sweep_down(bar.close, on_fill);
+    } else {
+        sweep_up(bar.high, on_fill);
+        sweep_down(bar.low, on_fill);
+        sweep_up(bar.close, on_fill);
+    }
+}
+
+std::vector<strategy::Order> OrderManager::take_updates() {
+    std::vector<strategy::Order> updates;
+    updates.swap(updates_);
+    return updates;
+}
+
+const strategy::Order* OrderManager::find(strategy::OrderId id) const {
+    auto it = orders_.find(id);
+    return it == orders_.end() ? nullptr : &it->second.order;
+}
+
+void OrderManager::clear() {
+    buy_limits_.clear();
+    sell_limits_.clear();
+    buy_stops_.clear();
+    sell_stops_.clear();
+    market_orders_.clear();
+    orders_.clear();
+    oco_groups_.clear();
+    updates_.clear();
+}
+
+// ========== 价格簿维护 ==========
+
+void OrderManager::relink() {
+    // Entry 中保存的是价格簿指针和迭代器，拷贝后需指向本对象的价格簿
+    for (Book* book : {&buy_limits_, &sell_limits_, &buy_stops_, &sell_stops_}) {
+        for (auto it = book->begin(); it != book->end(); ++it) {
+            Entry& entry = orders_[it->second];
+            entry.book = book;
+            entry.it = it;
+        }
+    }
+}
+
+void OrderManager::insert_limit(Entry& entry) {
+    const strategy::Order& order = entry.order;
+    if (order.side == Side::BUY) {
+        entry.book = &buy_limits_;
+        entry.it = buy_limits_.emplace(-order.price, order.id);
+    } else {
+        entry.book = &sell_limits_;
+        entry.it = sell_limits_.emplace(order.price, order.id);
+    }
+}
+
+void OrderManager::insert_stop(Entry& entry) {
+    const strategy::Order& order = entry.order;
+    if (order.side == Side::BUY) {
+        entry.book = &buy_stops_;
+        entry.it = buy_stops_.emplace(order.stop_price, order.id);
+    } else {
+        entry.book = &sell_stops_;
+        entry.it = sell_stops_.emplace(-order.stop_price, order.id);
+    }
+}
+
+void OrderManager::detach(Entry& entry) {
+    if (entry.book) {
+        entry.book->erase(entry.it);
+        entry.book = nullptr;
+    }
+}
+
+void OrderManager::finish(strategy::OrderId id, strategy::OrderStatus status) {
+    auto it = orders_.find(id);
+    if (it == orders_.end()) return;
+
+    Entry& entry = it->second;
+    detach(entry);
+    entry.order.status = status;
+    updates_.push_back(entry.order);
+
+    if (entry.order.oco_group != 0) {
+        auto range = oco_groups_.equal_range(entry.order.oco_group);
+        for (auto g = range.first; g != range.second; ++g) {
+            if (g->second == id) {
+                oco_groups_.erase(g);
+                break;
+            }
+        }
+    }
+    orders_.erase(it);
+}
+
+// ========== 撮合 ==========
+
+void OrderManager::execute(strategy::OrderId id, Price price, bool taker, const FillHandler& on_fill) {
+    auto it = orders_.find(id);
+    if (it == orders_.end()) return;
+
+    Entry& entry = it->second;
+    detach(entry);
+    bool filled = on_fill(entry.order, price, taker);
+    int64_t group = entry.order.oco_group;
+    finish(id, filled ? strategy::OrderStatus::FILLED : strategy::OrderStatus::REJECTED);
+
+    // OCO：一个成交，同组其余订单撤销
+    if (filled && group != 0) {
+        std::vector<strategy::OrderId> siblings;
+        auto range = oco_groups_.equal_range(group);
+        for (auto g = range.first; g != range.second; ++g) {
+            siblings.push_back(g->second);
+        }
+        for (strategy::OrderId sibling : siblings) {
+            finish(sibling, strategy::OrderStatus::CANCELLED);
+        }
+    }
+}
+
+void OrderManager::trigger_stop(strategy::OrderId id, Price price, bool taker, const FillHandler& on_fill) {
+    auto it = orders_.find(id);
+    if (it == orders_.end()) return;
+
+    Entry& entry = it->second;
+    if (entry.order.type == OrderType::STOP_MARKET) {
+        execute(id, price, taker, on_fill);
+        return;
+    }
+
+    // STOP_LIMIT：触发后转为限价单，触发价已满足限价则立即成交
+    detach(entry);
+    entry.order.triggered = true;
+    bool marketable = (entry.order.side == Side::BUY) ? price <= entry.order.price
+                                                      : price >= entry.order.price;
+    if (marketable) {
+        execute(id, price, false, on_fill);
+    } else {
+        insert_limit(entry);
+    }
+}
+
+void OrderManager::match_at_open(Price open, const FillHandler& on_fill) {
+    // 先处理卖出（平仓），再处理买入（开仓）
+    while (!sell_stops_.empty() && sell_stops_.begin()->first <= -open) {
+        trigger_stop(sell_stops_.begin()->second, open, true, on_fill);
+    }
+    while (!sell_limits_.empty() && sell_limits_.begin()->first <= open) {
+        execute(sell_limits_.begin()->second, open, false, on_fill);
+    }
+    while (!buy_limits_.empty() && buy_limits_.begin()->first <= -open) {
+        execute(buy_limits_.begin()->second, open, false, on_fill);
+    }
+    while (!buy_stops_.empty() && buy_stops_.begin()->first <= open) {
+        trigger_stop(buy_stops_.begin()->second, open, true, on_fill);
+    }
+}
+
+void OrderManager::sweep_up(Price to, const FillHandler& on_fill) {
+    // 价格上涨：触及卖出限价（止盈）和买入止损
+    while (true) {
+        bool has_limit = !sell_limits_.empty() && sell_limits_.begin()->first <= to;
+        bool has_stop = !buy_stops_.empty() && buy_stops_.begin()->first <= to;
+        if (!has_limit && !has_stop) break;
+
+        if (has_limit && (!has_stop || sell_limits_.begin()->first <= buy_stops_.begin()->first)) {
+            auto front = *sell_limits_.begin();
+            execute(front.second, front.first, false, on_fill);
+        } else {
+            auto front = *buy_stops_.begin();
+            trigger_stop(front.second, front.first, true, on_fill);
+        }
+    }
+}
+
+void OrderManager::sweep_down(Price to, const FillHandler& on_fill) {
+    // 价格下跌：触及买入限价和卖出止损（key为负价格）
+    while (true) {
+        bool has_limit = !buy_limits_.empty() && buy_limits_.begin()->first <= -to;
+        bool has_stop = !sell_stops_.empty() && sell_stops_.begin()->first <= -to;
+        if (!has_limit && !has_stop) break;
+
+        if (has_stop && (!has_limit || sell_stops_.begin()->first <= buy_limits_.begin()->first)) {
+            auto front = *sell_stops_.begin();
+            trigger_stop(front.second, -front.first, true, on_fill);
+        } else {
+            auto front = *buy_limits_.begin();
+            execute(front.second, -front.first, false, on_fill);
+        }
+    }
+}
+
+} // namespace backtest
+} // namespace quant_crypto
@@ -0,0 +1,168 @@
+#include "backtest/parameter_optimizer.h"
+#include "strategy/ma_cross_strategy.h"
+#include "common/parallel_for.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace quant_crypto {
+namespace backtest {
+
+namespace {
+
+// 候选的运行状态
+struct Trial {
+    size_t index;
+    std::unique_ptr<strategy::StrategyBase> strategy;
+    std::unique_ptr<BacktestEngine> engine;
+    OptimizationResult summary;
+};
+
+// 每轮使用的数据长度：从 n * initial_fraction 开始按 growth 增长，最后一轮为 n
+std::vector<size_t> round_lengths(size_t n, double initial_fraction, double growth) {
+    std::vector<size_t> lengths;
+    double length = std::max(1.0, std::ceil(static_cast<double>(n) * initial_fraction));
+    while (length < static_cast<double>(n)) {
+        lengths.push_back(static_cast<size_t>(length));
+        length = std::ceil(length * growth);
+    }
+    lengths.push_back(n);
+    return lengths;
+}
+
+void fill_summary(OptimizationResult& summary, const BacktestEngine& engine) {
+    const BacktestResult& result = engine.get_result();
+    summary.bars_processed = engine.bars_processed();
+    summary.stop_reason = result.stop_reason;
+    summary.final_equity = result.final_equity;
+    summary.total_return = result.total_return;
+    summary.total_trades = result.total_trades;
+    summary.max_drawdown = result.equity_stats.max_drawdown();
+    summary.sharpe_ratio = result.equity_stats.sharpe_ratio();
+}
+
+} // namespace
+
+SuccessiveHalvingOptimizer::SuccessiveHalvingOptimizer(StrategyFactory factory,
+                                                       const BacktestConfig& config,
+                                                       const HalvingOptions& options)
+    : factory_(std::move(factory)), config_(config), options_(options), last_bars_processed_(0) {
+    if (!factory_) {
+        throw std::invalid_argument("SuccessiveHalvingOptimizer: 策略工厂为空");
+    }
+    if (options_.initial_fraction <= 0.0 || options_.initial_fraction > 1.0) {
+        throw std::invalid_argument("SuccessiveHalvingOptimizer: initial_fraction 必须在 (0, 1] 之间");
+    }
+    if (options_.keep_fraction <= 0.0 || options_.keep_fraction >= 1.0) {
+        throw std::invalid_argument("SuccessiveHalvingOptimizer: keep_fraction 必须在 (0, 1) 之间");
+    }
+    // 评分只需要统计量，不保存曲线
+    config_.record_mode = EquityRecordMode::NONE;
+    score_ = [](const BacktestResult& result) { return result.equity_stats.sharpe_ratio(); };
+}
+
+void SuccessiveHalvingOptimizer::set_score_function(ScoreFunction score) {
+    if (score) score_ = std::move(score);
+}
+
+std::vector<OptimizationResult> SuccessiveHalvingOptimizer::run(const OHLCVSeries& data,
+                                                                const std::vector<ParamSet>& candidates) const {
+    last_bars_processed_ = 0;
+    if (data.empty() || candidates.empty()) return {};
+
+    size_t threads = resolve_threads(options_.threads);
+
+    // 1. 创建全部候选
+    std::vector<Trial> trials(candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++) {
+        trials[i].index = i;
+        trials[i].summary.params = candidates[i];
+        trials[i].strategy = factory_(candidates[i]);
+        if (!trials[i].strategy) {
+            throw std::invalid_argument("SuccessiveHalvingOptimizer: 策略工厂返回空指针");
+        }
+        trials[i].engine = std::make_unique<BacktestEngine>(config_);
+        trials[i].engine->set_strategy(trials[i].strategy.get());
+    }
+
+    // 2. 逐轮回测、评分、淘汰
+    std::vector<size_t> lengths = round_lengths(data.size(), options_.initial_fraction,
+                                                1.0 / options_.keep_fraction);
+    std::vector<Trial*> active;
+    for (auto& trial : trials) active.push_back(&trial);
+
+    for (size_t round = 0; round < lengths.size() && !active.empty(); round++) {
+        OHLCVSeries segment = data.slice(0, lengths[round]);
+
+        // 2.1 晋级候选只处理本轮新增的K线
+        parallel_for(active.size(), threads, [&](size_t i) {
+            Trial& trial = *active[i];
+            trial.engine->resume(segment);
+            fill_summary(trial.summary, *trial.engine);
+            double score = score_(trial.engine->get_result());
+            trial.summary.score = std::isnan(score) ? -std::numeric_limits<double>::infinity() : score;
+        });
+
+        // 2.2 触发终止条件的候选直接淘汰
+        std::vector<Trial*> alive;
+        for (Trial* trial : active) {
+            if (trial->summary.stop_reason == StopReason::NONE) {
+                trial->summary.rounds_survived = round + 1;
+                alive.push_back(trial);
+            }
+        }
+
+        // 2.3 非最后一轮：保留评分最高的一部分
+        if (round + 1 < lengths.size()) {
+            size_t keep = static_cast<size_t>(std::ceil(alive.size() * options_.keep_fraction));
+            keep = std::min(alive.size(), std::max(keep, options_.min_survivors));
+            std::partial_sort(alive.begin(), alive.begin() + keep, alive.end(),
+                              [](const Trial* a, const Trial* b) {
+                                  if (a->summary.score != b->summary.score) return a->summary.score > b->summary.score;
+                                  return a->index < b->index;
+                              });
+            alive.resize(keep);
+        }
+
+        // 淘汰的候选释放引擎与策略
+        for (Trial* trial : active) {
+            if (std::find(alive.begin(), alive.end(), trial) == alive.end()) {
+                trial->engine.reset();
+                trial->strategy.reset();
+            }
+        }
+        active.swap(alive);
+    }
+
+    // 3. 汇总：存活轮数多的在前，同轮按评分
+    std::vector<OptimizationResult> results;
+    results.reserve(trials.size());
+    for (auto& trial : trials) {
+        last_bars_processed_ += trial.summary.bars_processed;
+        results.push_back(std::move(trial.summary));
+    }
+    std::stable_sort(results.begin(), results.end(),
+                     [](const OptimizationResult& a, const OptimizationResult& b) {
+                         if (a.rounds_survived != b.rounds_survived) return a.rounds_survived > b.rounds_survived;
+                         return a.score > b.score;
+                     });
+    return results;
+}
+
+SuccessiveHalvingOptimizer::StrategyFactory SuccessiveHalvingOptimizer::ma_cross_factory() {
+    return [](const ParamSet& params) -> std::unique_ptr<strategy::StrategyBase> {
+        strategy::MACrossConfig config;
+        auto get = [&params](const char* name, double fallback) {
+            auto it = params.find(name);
+            return it == params.end() ? fallback : it->second;
+        };
+        config.fast_period = static_cast<int>(get("fast_period", config.fast_period));
+        config.slow_period = static_cast<int>(get("slow_period", config.slow_period));
+        config.position_size = get("position_size", config.position_size);
+        return std::make_unique<strategy::MACrossStrategy>(config);
+    };
+}
+
+} // namespace backtest
+} // namespace quant_crypto
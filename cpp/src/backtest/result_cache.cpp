@@ -0,0 +1,504 @@
+#include "backtest/result_cache.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace quant_crypto {
+namespace backtest {
+
+namespace {
+
+// 回测口径或文件格式变化时递增，旧缓存自动失效
+constexpr int64_t kCacheVersion = 6;
+constexpr uint32_t kSpillMagic = 0x54424351;   // "QCBT"
+
+// ========== 二进制读写（仅本机使用，不考虑字节序） ==========
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::ofstream& out) : out_(out) {}
+
+    template <typename T>
+    void write(const T& value) {
+        out_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void write_string(const std::string& value) {
+        write<uint64_t>(value.size());
+        out_.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+    template <typename T>
+    void write_vector(const std::vector<T>& values) {
+        write<uint64_t>(values.size());
+        out_.write(reinterpret_cast<const char*>(values.data()),
+                   static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+private:
+    std::ofstream& out_;
+};
+
+class BinaryReader {
+public:
+    explicit BinaryReader(std::ifstream& in) : in_(in) {}
+
+    template <typename T>
+    T read() {
+        T value{};
+        in_.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+    std::string read_string() {
+        uint64_t size = read<uint64_t>();
+        std::string value(in_ ? size : 0, '\0');
+        in_.read(&value[0], static_cast<std::streamsize>(value.size()));
+        return value;
+    }
+    template <typename T>
+    std::vector<T> read_vector() {
+        uint64_t size = read<uint64_t>();
+        std::vector<T> values(in_ ? size : 0);
+        in_.read(reinterpret_cast<char*>(values.data()),
+                 static_cast<std::streamsize>(values.size() * sizeof(T)));
+        return values;
+    }
+    bool ok() const { return static_cast<bool>(in_); }
+
+private:
+    std::ifstream& in_;
+};
+
+void write_period_returns(BinaryWriter& writer, const analysis::PeriodReturns& table) {
+    writer.write(static_cast<int32_t>(table.period));
+    writer.write_vector(table.start);
+    writer.write_vector(table.open_equity);
+    writer.write_vector(table.close_equity);
+    writer.write_vector(table.returns);
+}
+
+void read_period_returns(BinaryReader& reader, analysis::PeriodReturns& table) {
+    table.period = static_cast<calendar::Period>(reader.read<int32_t>());
+    table.start = reader.read_vector<Timestamp>();
+    table.open_equity = reader.read_vector<double>();
+    table.close_equity = reader.read_vector<double>();
+    table.returns = reader.read_vector<double>();
+}
+
+void write_drawdowns(BinaryWriter& writer, const analysis::DrawdownReport& report) {
+    writer.write<uint64_t>(report.episodes.size());
+    for (const auto& episode : report.episodes) {
+        writer.write(episode.start_time);
+        writer.write(episode.trough_time);
+        writer.write(episode.end_time);
+        writer.write<uint64_t>(episode.start_index);
+        writer.write<uint64_t>(episode.trough_index);
+        writer.write<uint64_t>(episode.end_index);
+        writer.write(episode.peak_equity);
+        writer.write(episode.trough_equity);
+        writer.write(episode.depth);
+        writer.write<uint8_t>(episode.recovered ? 1 : 0);
+    }
+    writer.write<uint64_t>(report.episode_count);
+    writer.write(report.max_duration_ms);
+    writer.write(report.avg_duration_ms);
+    writer.write(report.max_recovery_ms);
+    writer.write(report.avg_depth);
+    writer.write(report.under_water_ms);
+    writer.write(report.total_ms);
+}
+
+void read_drawdowns(BinaryReader& reader, analysis::DrawdownReport& report) {
+    uint64_t episode_count = reader.read<uint64_t>();
+    report.episodes.clear();
+    for (uint64_t i = 0; i < episode_count && reader.ok(); i++) {
+        analysis::DrawdownEpisode episode;
+        episode.start_time = reader.read<Timestamp>();
+        episode.trough_time = reader.read<Timestamp>();
+        episode.end_time = reader.read<Timestamp>();
+        episode.start_index = reader.read<uint64_t>();
+        episode.trough_index = reader.read<uint64_t>();
+        episode.end_index = reader.read<uint64_t>();
+        episode.peak_equity = reader.read<double>();
+        episode.trough_equity = reader.read<double>();
+        episode.depth = reader.read<double>();
+        episode.recovered = reader.read<uint8_t>() != 0;
+        report.episodes.push_back(episode);
+    }
+    report.episode_count = reader.read<uint64_t>();
+    report.max_duration_ms = reader.read<int64_t>();
+    report.avg_duration_ms = reader.read<double>();
+    report.max_recovery_ms = reader.read<int64_t>();
+    report.avg_depth = reader.read<double>();
+    report.under_water_ms = reader.read<int64_t>();
+    report.total_ms = reader.read<int64_t>();
+}
+
+void write_rolling(BinaryWriter& writer, const analysis::RollingMetrics& rolling) {
+    writer.write<uint64_t>(rolling.window_bars);
+    writer.write(rolling.window_ms);
+    writer.write_vector(rolling.timestamps);
+    writer.write_vector(rolling.mean_return);
+    writer.write_vector(rolling.volatility);
+    writer.write_vector(rolling.sharpe_ratio);
+    writer.write_vector(rolling.sortino_ratio);
+    writer.write_vector(rolling.drawdown);
+}
+
+void read_rolling(BinaryReader& reader, analysis::RollingMetrics& rolling) {
+    rolling.window_bars = reader.read<uint64_t>();
+    rolling.window_ms = reader.read<int64_t>();
+    rolling.timestamps = reader.read_vector<Timestamp>();
+    rolling.mean_return = reader.read_vector<double>();
+    rolling.volatility = reader.read_vector<double>();
+    rolling.sharpe_ratio = reader.read_vector<double>();
+    rolling.sortino_ratio = reader.read_vector<double>();
+    rolling.drawdown = reader.read_vector<double>();
+}
+
+void write_metrics(BinaryWriter& writer, const analysis::PerformanceMetrics& metrics) {
+    writer.write(metrics.annualized_return);
+    writer.write(metrics.cumulative_return);
+    writer.write(metrics.max_drawdown);
+    writer.write(metrics.sharpe_ratio);
+    writer.write(metrics.sortino_ratio);
+    writer.write(metrics.calmar_ratio);
+    writer.write(metrics.volatility);
+    writer.write(metrics.downside_deviation);
+    writer.write(metrics.periods_per_year);
+    writer.write(metrics.profit_loss_ratio);
+    writer.write(metrics.max_consecutive_wins);
+    writer.write(metrics.max_consecutive_losses);
+    writer.write(metrics.avg_holding_period);
+    writer.write(metrics.trade_frequency_per_year);
+    writer.write_vector(metrics.equity_curve);
+    writer.write_vector(metrics.drawdown_curve);
+    write_drawdowns(writer, metrics.drawdowns);
+    write_rolling(writer, metrics.rolling);
+    write_period_returns(writer, metrics.daily_returns);
+    write_period_returns(writer, metrics.weekly_returns);
+    write_period_returns(writer, metrics.monthly_returns);
+}
+
+void read_metrics(BinaryReader& reader, analysis::PerformanceMetrics& metrics) {
+    metrics.annualized_return = reader.read<double>();
+    metrics.cumulative_return = reader.read<double>();
+    metrics.max_drawdown = reader.read<double>();
+    metrics.sharpe_ratio = reader.read<double>();
+    metrics.sortino_ratio = reader.read<double>();
+    metrics.calmar_ratio = reader.read<double>();
+    metrics.volatility = reader.read<double>();
+    metrics.downside_deviation = reader.read<double>();
+    metrics.periods_per_year = reader.read<double>();
+    metrics.profit_loss_ratio = reader.read<double>();
+    metrics.max_consecutive_wins = reader.read<int>();
+    metrics.max_consecutive_losses = reader.read<int>();
+    metrics.avg_holding_period = reader.read<double>();
+    metrics.trade_frequency_per_year = reader.read<double>();
+    metrics.equity_curve = reader.read_vector<double>();
+    metrics.drawdown_curve = reader.read_vector<double>();
+    read_drawdowns(reader, metrics.drawdowns);
+    read_rolling(reader, metrics.rolling);
+    read_period_returns(reader, metrics.daily_returns);
+    read_period_returns(reader, metrics.weekly_returns);
+    read_period_returns(reader, metrics.monthly_returns);
+}
+
+void write_result(BinaryWriter& writer, const BacktestResult& result) {
+    writer.write(result.initial_capital);
+    writer.write(result.final_capital);
+    writer.write(result.final_equity);
+    writer.write(result.total_return);
+    writer.write(result.total_trades);
+    writer.write(result.winning_trades);
+    writer.write(result.losing_trades);
+
+    writer.write<uint64_t>(result.trades.size());
+    for (const auto& trade : result.trades) {
+        writer.write(trade.timestamp);
+        writer.write_string(trade.symbol);
+        writer.write(static_cast<int32_t>(trade.signal));
+        writer.write(trade.price);
+        writer.write(trade.quantity);
+        writer.write(trade.pnl);
+    }
+
+    writer.write_vector(result.equity_curve);
+    writer.write_vector(result.timestamps);
+    writer.write(static_cast<int32_t>(result.record_mode));
+    writer.write(result.equity_stats.state());
+    writer.write(static_cast<int32_t>(result.stop_reason));
+    writer.write(result.stopped_at);
+}
+
+void read_result(BinaryReader& reader, BacktestResult& result) {
+    result.initial_capital = reader.read<double>();
+    result.final_capital = reader.read<double>();
+    result.final_equity = reader.read<double>();
+    result.total_return = reader.read<double>();
+    result.total_trades = reader.read<int>();
+    result.winning_trades = reader.read<int>();
+    result.losing_trades = reader.read<int>();
+
+    uint64_t trade_count = reader.read<uint64_t>();
+    for (uint64_t i = 0; i < trade_count && reader.ok(); i++) {
+        strategy::Trade trade;
+        trade.timestamp = reader.read<Timestamp>();
+        trade.symbol = reader.read_string();
+        trade.signal = static_cast<strategy::Signal>(reader.read<int32_t>());
+        trade.price = reader.read<double>();
+        trade.quantity = reader.read<double>();
+        trade.pnl = reader.read<double>();
+        result.trades.push_back(std::move(trade));
+    }
+
+    result.equity_curve = reader.read_vector<double>();
+    result.timestamps = reader.read_vector<Timestamp>();
+    result.record_mode = static_cast<EquityRecordMode>(reader.read<int32_t>());
+    result.equity_stats.restore(reader.read<analysis::EquityStatistics::State>());
+    result.stop_reason = static_cast<StopReason>(reader.read<int32_t>());
+    result.stopped_at = reader.read<Timestamp>();
+}
+
+template <typename Iterator>
+uint64_t hash_bars(Iterator begin, Iterator end) {
+    ContentHasher hasher;
+    for (auto it = begin; it != end; ++it) {
+        hasher.update(*it);
+    }
+    return hasher.digest();
+}
+
+} // namespace
+
+// ========== ContentHasher ==========
+
+void ContentHasher::update(const std::string& value) {
+    update_word(value.size());
+    size_t i = 0;
+    for (; i + 8 <= value.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, value.data() + i, sizeof(word));
+        update_word(word);
+    }
+    if (i < value.size()) {
+        uint64_t word = 0;
+        std::memcpy(&word, value.data() + i, value.size() - i);
+        update_word(word);
+    }
+}
+
+void ContentHasher::update(const OHLCV& bar) {
+    update(bar.timestamp);
+    update(bar.exchange);
+    update(bar.symbol);
+    update(static_cast<int64_t>(bar.timeframe));
+    update(bar.open);
+    update(bar.high);
+    update(bar.low);
+    update(bar.close);
+    update(bar.volume);
+}
+
+std::string BacktestCacheKey::to_string() const {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%016llx_%016llx_%zu",
+                  static_cast<unsigned long long>(params_hash),
+                  static_cast<unsigned long long>(data_hash), bar_count);
+    return buffer;
+}
+
+// ========== BacktestResultCache ==========
+
+BacktestResultCache::BacktestResultCache(size_t capacity, const std::string& spill_dir)
+    : capacity_(capacity == 0 ? 1 : capacity), spill_dir_(spill_dir) {
+    if (!spill_dir_.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(spill_dir_, ec);
+        if (ec) {
+            std::cerr << "[BacktestResultCache] 创建落盘目录失败: " << spill_dir_
+                      << " (" << ec.message() << ")，已关闭落盘" << std::endl;
+            spill_dir_.clear();
+        }
+    }
+}
+
+uint64_t BacktestResultCache::hash_data(const OHLCVSeries& data) {
+    return hash_bars(data.begin(), data.end());
+}
+
+uint64_t BacktestResultCache::hash_data(const std::vector<OHLCV>& data) {
+    return hash_bars(data.begin(), data.end());
+}
+
+uint64_t BacktestResultCache::hash_params(const std::string& strategy_name,
+                                          const std::map<std::string, double>& params,
+                                          const BacktestConfig& config) {
+    ContentHasher hasher;
+    hasher.update(kCacheVersion);
+    hasher.update(strategy_name);
+    // std::map 按参数名有序，哈希与插入顺序无关
+    for (const auto& param : params) {
+        hasher.update(param.first);
+        hasher.update(param.second);
+    }
+    hasher.update(config.initial_capital);
+    hasher.update(config.commission_rate);
+    hasher.update(config.slippage_rate);
+    hasher.update(config.position_size);
+    hasher.update(static_cast<int64_t>(config.record_mode));
+    hasher.update(static_cast<int64_t>(config.record_interval));
+    hasher.update(config.stop.max_drawdown);
+    hasher.update(config.stop.equity_floor);
+    hasher.update(static_cast<int64_t>(config.stop.min_trades));
+    hasher.update(static_cast<int64_t>(config.stop.min_trades_bars));
+    hasher.update(config.latency.fixed_ms);
+    hasher.update(config.latency.jitter_ms);
+    hasher.update(static_cast<int64_t>(config.latency.seed));
+    hasher.update(static_cast<int64_t>(config.latency.samples_ms.size()));
+    for (int64_t sample : config.latency.samples_ms) hasher.update(sample);
+    return hasher.digest();
+}
+
+BacktestCacheKey BacktestResultCache::make_key(const OHLCVSeries& data,
+                                               const std::string& strategy_name,
+                                               const std::map<std::string, double>& params,
+                                               const BacktestConfig& config) {
+    BacktestCacheKey key;
+    key.data_hash = hash_data(data);
+    key.bar_count = data.size();
+    key.params_hash = hash_params(strategy_name, params, config);
+    return key;
+}
+
+std::shared_ptr<const CachedBacktest> BacktestResultCache::find(const BacktestCacheKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        touch_locked(it->second);
+        stats_.hits++;
+        return *it->second;
+    }
+
+    if (!spill_dir_.empty()) {
+        Entry entry = load(key);
+        if (entry) {
+            insert_locked(entry);
+            stats_.disk_hits++;
+            return entry;
+        }
+    }
+    stats_.misses++;
+    return nullptr;
+}
+
+std::shared_ptr<const CachedBacktest> BacktestResultCache::put(const BacktestCacheKey& key,
+                                                               BacktestResult result,
+                                                               analysis::PerformanceMetrics metrics) {
+    auto entry = std::make_shared<CachedBacktest>();
+    entry->key = key;
+    entry->result = std::move(result);
+    entry->metrics = std::move(metrics);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+    insert_locked(entry);
+    return entry;
+}
+
+void BacktestResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+}
+
+size_t BacktestResultCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+CacheStats BacktestResultCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void BacktestResultCache::insert_locked(Entry entry) {
+    BacktestCacheKey key = entry->key;
+    lru_.push_front(std::move(entry));
+    index_[key] = lru_.begin();
+
+    // 超出容量：淘汰最久未使用的条目（可选写入磁盘）
+    while (lru_.size() > capacity_) {
+        const Entry& victim = lru_.back();
+        if (!spill_dir_.empty() && spill(*victim)) {
+            stats_.spills++;
+        }
+        index_.erase(victim->key);
+        lru_.pop_back();
+        stats_.evictions++;
+    }
+}
+
+void BacktestResultCache::touch_locked(LruList::iterator it) {
+    lru_.splice(lru_.begin(), lru_, it);
+}
+
+std::string BacktestResultCache::spill_path(const BacktestCacheKey& key) const {
+    return (std::filesystem::path(spill_dir_) / (key.to_string() + ".bin")).string();
+}
+
+bool BacktestResultCache::spill(const CachedBacktest& entry) const {
+    std::string path = spill_path(entry.key);
+    if (std::filesystem::exists(path)) return true;   // 内容寻址：同名文件内容相同
+
+    // 先写临时文件再改名，避免读到写了一半的文件
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "[BacktestResultCache] 无法写入: " << tmp_path << std::endl;
+            return false;
+        }
+        BinaryWriter writer(out);
+        writer.write(kSpillMagic);
+        writer.write(kCacheVersion);
+        writer.write(entry.key.data_hash);
+        writer.write<uint64_t>(entry.key.bar_count);
+        writer.write(entry.key.params_hash);
+        write_result(writer, entry.result);
+        write_metrics(writer, entry.metrics);
+        if (!out) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    return !ec;
+}
+
+BacktestResultCache::Entry BacktestResultCache::load(const BacktestCacheKey& key) const {
+    std::ifstream in(spill_path(key), std::ios::binary);
+    if (!in.is_open()) return nullptr;
+
+    BinaryReader reader(in);
+    if (reader.read<uint32_t>() != kSpillMagic || reader.read<int64_t>() != kCacheVersion) {
+        return nullptr;
+    }
+    auto entry = std::make_shared<CachedBacktest>();
+    entry->key.data_hash = reader.read<uint64_t>();
+    entry->key.bar_count = reader.read<uint64_t>();
+    entry->key.params_hash = reader.read<uint64_t>();
+    if (!(entry->key == key)) return nullptr;
+
+    read_result(reader, entry->result);
+    read_metrics(reader, entry->metrics);
+    if (!reader.ok()) {
+        std::cerr << "[BacktestResultCache] 缓存文件损坏: " << spill_path(key) << std::endl;
+        return nullptr;
+    }
+    return entry;
+}
+
+} // namespace backtest
+} // namespace quant_crypto
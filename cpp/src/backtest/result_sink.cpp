@@ -0,0 +1,211 @@
+#include "backtest/result_sink.h"
+#include "backtest/backtest_engine.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace quant_crypto {
+namespace backtest {
+
+namespace {
+constexpr uint32_t kStreamMagic = 0x53524351;   // "QCRS"
+constexpr uint32_t kStreamVersion = 2;   // 2: SUMMARY 逐字段写入（不含结构体填充字节）
+}
+
+// ========== BinaryResultWriter ==========
+
+BinaryResultWriter::BinaryResultWriter(const std::string& path, size_t buffer_bytes)
+    : out_(path, std::ios::binary | std::ios::trunc),
+      buffer_(std::max<size_t>(buffer_bytes, 4096)), used_(0), header_written_(false),
+      equity_count_(0), trade_count_(0) {
+    if (!out_.is_open()) {
+        std::cerr << "[BinaryResultWriter] 无法打开文件: " << path << std::endl;
+    }
+}
+
+BinaryResultWriter::~BinaryResultWriter() {
+    close();
+}
+
+void BinaryResultWriter::flush() {
+    if (used_ > 0 && out_.is_open()) {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+    }
+    used_ = 0;
+    if (out_.is_open()) out_.flush();
+}
+
+void BinaryResultWriter::close() {
+    if (!out_.is_open()) return;
+    flush();
+    out_.close();
+}
+
+void BinaryResultWriter::put_bytes(const void* data, size_t size) {
+    if (used_ + size > buffer_.size()) {
+        flush();
+        if (size > buffer_.size()) {
+            out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            return;
+        }
+    }
+    std::memcpy(buffer_.data() + used_, data, size);
+    used_ += size;
+}
+
+template <typename T>
+void BinaryResultWriter::put(const T& value) {
+    put_bytes(&value, sizeof(T));
+}
+
+void BinaryResultWriter::on_begin(double initial_capital) {
+    // resume 时会再次调用，文件头只写一次
+    if (header_written_) return;
+    put(kStreamMagic);
+    put(kStreamVersion);
+    put(initial_capital);
+    header_written_ = true;
+}
+
+void BinaryResultWriter::on_equity(Timestamp timestamp, double equity) {
+    put(static_cast<uint8_t>(ResultRecordType::EQUITY));
+    put(timestamp);
+    put(equity);
+    equity_count_++;
+}
+
+void BinaryResultWriter::on_trade(const strategy::Trade& trade) {
+    uint16_t symbol_len = static_cast<uint16_t>(std::min<size_t>(trade.symbol.size(), UINT16_MAX));
+    put(static_cast<uint8_t>(ResultRecordType::TRADE));
+    put(trade.timestamp);
+    put(static_cast<int32_t>(trade.signal));
+    put(trade.price);
+    put(trade.quantity);
+    put(trade.pnl);
+    put(symbol_len);
+    put_bytes(trade.symbol.data(), symbol_len);
+    trade_count_++;
+}
+
+void BinaryResultWriter::on_finish(const BacktestResult& result) {
+    // 逐字段写入：文件内容与结构体布局无关，也不会写出未初始化的填充字节
+    const analysis::EquityStatistics::State stats = result.equity_stats.state();
+    put(static_cast<uint8_t>(ResultRecordType::SUMMARY));
+    put(result.initial_capital);
+    put(result.final_capital);
+    put(result.final_equity);
+    put(result.total_return);
+    put(static_cast<int32_t>(result.total_trades));
+    put(static_cast<int32_t>(result.winning_trades));
+    put(static_cast<int32_t>(result.losing_trades));
+    put(static_cast<uint64_t>(stats.count));
+    put(stats.first_timestamp);
+    put(stats.last_timestamp);
+    put(stats.first_equity);
+    put(stats.last_equity);
+    put(stats.peak);
+    put(stats.max_drawdown);
+    put(static_cast<uint64_t>(stats.return_count));
+    put(stats.return_mean);
+    put(stats.return_m2);
+    put(static_cast<uint64_t>(stats.downside_count));
+    put(stats.downside_sum_sq);
+    flush();
+}
+
+// ========== BinaryResultReader ==========
+
+BinaryResultReader::BinaryResultReader(const std::string& path, size_t buffer_bytes)
+    : in_(path, std::ios::binary), buffer_(std::max<size_t>(buffer_bytes, 4096)),
+      pos_(0), size_(0), valid_(false), initial_capital_(0.0) {
+    if (!in_.is_open()) {
+        std::cerr << "[BinaryResultReader] 无法打开文件: " << path << std::endl;
+        return;
+    }
+    uint32_t magic = 0, version = 0;
+    if (!get(magic) || !get(version) || !get(initial_capital_) ||
+        magic != kStreamMagic || version != kStreamVersion) {
+        std::cerr << "[BinaryResultReader] 文件格式不正确: " << path << std::endl;
+        return;
+    }
+    valid_ = true;
+}
+
+bool BinaryResultReader::fetch(void* data, size_t size) {
+    char* dst = static_cast<char*>(data);
+    while (size > 0) {
+        if (pos_ == size_) {
+            in_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            size_ = static_cast<size_t>(in_.gcount());
+            pos_ = 0;
+            if (size_ == 0) return false;
+        }
+        size_t n = std::min(size, size_ - pos_);
+        std::memcpy(dst, buffer_.data() + pos_, n);
+        pos_ += n;
+        dst += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool BinaryResultReader::read_all(const EquityHandler& on_equity,
+                                  const TradeHandler& on_trade,
+                                  const SummaryHandler& on_summary) {
+    if (!valid_) return false;
+
+    uint8_t type = 0;
+    while (get(type)) {
+        switch (static_cast<ResultRecordType>(type)) {
+            case ResultRecordType::EQUITY: {
+                Timestamp timestamp;
+                double equity;
+                if (!get(timestamp) || !get(equity)) return false;
+                if (on_equity) on_equity(timestamp, equity);
+                break;
+            }
+            case ResultRecordType::TRADE: {
+                strategy::Trade trade;
+                int32_t signal;
+                uint16_t symbol_len;
+                if (!get(trade.timestamp) || !get(signal) || !get(trade.price) ||
+                    !get(trade.quantity) || !get(trade.pnl) || !get(symbol_len)) {
+                    return false;
+                }
+                trade.signal = static_cast<strategy::Signal>(signal);
+                trade.symbol.resize(symbol_len);
+                if (symbol_len > 0 && !fetch(&trade.symbol[0], symbol_len)) return false;
+                if (on_trade) on_trade(trade);
+                break;
+            }
+            case ResultRecordType::SUMMARY: {
+                ResultSummary summary{};
+                analysis::EquityStatistics::State& stats = summary.equity_stats;
+                uint64_t count, return_count, downside_count;
+                if (!get(summary.initial_capital) || !get(summary.final_capital) ||
+                    !get(summary.final_equity) || !get(summary.total_return) ||
+                    !get(summary.total_trades) || !get(summary.winning_trades) ||
+                    !get(summary.losing_trades) || !get(count) ||
+                    !get(stats.first_timestamp) || !get(stats.last_timestamp) ||
+                    !get(stats.first_equity) || !get(stats.last_equity) ||
+                    !get(stats.peak) || !get(stats.max_drawdown) || !get(return_count) ||
+                    !get(stats.return_mean) || !get(stats.return_m2) || !get(downside_count) ||
+                    !get(stats.downside_sum_sq)) {
+                    return false;
+                }
+                stats.count = static_cast<size_t>(count);
+                stats.return_count = static_cast<size_t>(return_count);
+                stats.downside_count = static_cast<size_t>(downside_count);
+                if (on_summary) on_summary(summary);
+                break;
+            }
+            default:
+                std::cerr << "[BinaryResultReader] 未知记录类型: " << static_cast<int>(type) << std::endl;
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace backtest
+} // namespace quant_crypto
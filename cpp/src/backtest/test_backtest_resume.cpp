@@ -0,0 +1,223 @@
+/**
+ * @file test_backtest_resume.cpp
+ * @brief 增量回测与断点测试（离线）：run == 分段 resume == checkpoint → restore → resume
+ */
+
+#include "backtest/backtest_engine.h"
+#include "strategy/ma_cross_strategy.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::backtest;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+/**
+ * @brief 测试策略：每 7 根K线挂限价买单，成交后挂 OCO 止损/止盈；
+ *        同时订阅 5 分钟K线，断点需要保存挂单簿与正在形成的高周期K线
+ */
+class BracketStrategy : public strategy::StrategyBase {
+public:
+    BracketStrategy() { subscribe_timeframe(Timeframe::MINUTE_5); }
+
+    void on_bar(const OHLCV& bar) override {
+        last_close_ = bar.close;
+        bars_++;
+        if (position_.has_position()) update_position_price(bar.close);
+    }
+
+    void on_timeframe_bar(Timeframe timeframe, const OHLCV& bar) override {
+        (void)timeframe;
+        trend_up_ = bar.close >= bar.open;
+    }
+
+    strategy::Signal generate_signal() override {
+        if (bars_ % 7 == 0 && trend_up_ && !position_.has_position()) buy_limit(last_close_ * 0.995);
+        return strategy::Signal::NONE;
+    }
+
+    void on_order_update(const strategy::Order& order) override {
+        if (order.status == strategy::OrderStatus::FILLED && order.side == Side::BUY) {
+            stop_loss(order.fill_price * 0.98, 1);
+            take_profit(order.fill_price * 1.02, 1);
+        }
+    }
+
+    std::string get_name() const override { return "Bracket"; }
+    std::unique_ptr<StrategyBase> clone() const override { return std::make_unique<BracketStrategy>(*this); }
+
+private:
+    double last_close_ = 0.0;
+    size_t bars_ = 0;
+    bool trend_up_ = true;
+};
+
+// 没有实现 clone() 的策略
+class NoCloneStrategy : public strategy::StrategyBase {
+public:
+    void on_bar(const OHLCV& bar) override { (void)bar; }
+    strategy::Signal generate_signal() override { return strategy::Signal::NONE; }
+    std::string get_name() const override { return "NoClone"; }
+};
+
+static std::vector<OHLCV> make_bars(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    std::vector<OHLCV> bars;
+    double price = 100.0;
+    for (size_t i = 0; i < n; i++) {
+        OHLCV bar;
+        bar.timestamp = static_cast<Timestamp>(i) * 60000;
+        bar.symbol = "BTCUSDT";
+        bar.open = price;
+        bar.close = price * std::exp(noise(rng));
+        bar.high = std::max(bar.open, bar.close) * 1.002;
+        bar.low = std::min(bar.open, bar.close) * 0.998;
+        bar.volume = 1.0;
+        price = bar.close;
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+static bool same_result(const BacktestResult& a, const BacktestResult& b) {
+    if (a.trades.size() != b.trades.size()) return false;
+    for (size_t i = 0; i < a.trades.size(); i++) {
+        const auto& x = a.trades[i];
+        const auto& y = b.trades[i];
+        if (x.timestamp != y.timestamp || x.signal != y.signal || x.price != y.price ||
+            x.quantity != y.quantity || x.pnl != y.pnl) {
+            return false;
+        }
+    }
+    return a.equity_curve == b.equity_curve && a.timestamps == b.timestamps &&
+           a.final_equity == b.final_equity && a.final_capital == b.final_capital &&
+           a.total_trades == b.total_trades && a.winning_trades == b.winning_trades &&
+           a.stop_reason == b.stop_reason && a.stopped_at == b.stopped_at &&
+           a.equity_stats.count() == b.equity_stats.count() &&
+           a.equity_stats.max_drawdown() == b.equity_stats.max_drawdown() &&
+           std::abs(a.equity_stats.sharpe_ratio() - b.equity_stats.sharpe_ratio()) < 1e-12;
+}
+
+/**
+ * @brief 同一配置下比较三种方式：
+ *        完整 run；分段 resume（含重叠输入）；分段中途 checkpoint，再用新引擎 restore 后 resume
+ */
+template <typename S>
+static void compare_modes(const OHLCVSeries& all, const BacktestConfig& config, const std::string& label) {
+    S full_strategy;
+    BacktestEngine full(config);
+    full.set_strategy(&full_strategy);
+    full.set_data(all);
+    full.run();
+
+    // 3001 不在 5 分钟边界上，断点时高周期K线正在形成
+    S resumed_strategy;
+    BacktestEngine resumed(config);
+    resumed.set_strategy(&resumed_strategy);
+    resumed.resume(all.slice(0, 2000));
+    resumed.resume(all.slice(0, 3001));                        // 含已处理的历史
+    BacktestCheckpoint checkpoint = resumed.checkpoint();
+    resumed.resume(all.slice(3001, all.size() - 3001));        // 只有新K线
+
+    BacktestEngine restored(config);
+    restored.restore(checkpoint);
+    restored.resume(all);
+
+    // 同一断点可以多次恢复
+    BacktestEngine restored_again(config);
+    restored_again.restore(checkpoint);
+    restored_again.resume(all);
+
+    const BacktestResult& expected = full.get_result();
+    check(expected.total_trades > 0, label + "：产生了交易");
+    check(same_result(resumed.get_result(), expected) && resumed.bars_processed() == all.size(),
+          label + "：分段 resume 与完整 run 一致");
+    check(same_result(restored.get_result(), expected) && restored.bars_processed() == all.size(),
+          label + "：checkpoint → restore → resume 与完整 run 一致");
+    check(same_result(restored_again.get_result(), expected), label + "：同一断点再次恢复结果相同");
+}
+
+int main() {
+    std::cout << "========== 增量回测与断点测试 ==========\n" << std::endl;
+
+    OHLCVSeries all(make_bars(5000, 42));
+
+    const std::vector<std::pair<EquityRecordMode, std::string>> modes = {
+        {EquityRecordMode::FULL, "FULL"},
+        {EquityRecordMode::EVERY_N_BARS, "EVERY_N_BARS"},
+        {EquityRecordMode::ON_CHANGE, "ON_CHANGE"},
+        {EquityRecordMode::NONE, "NONE"},
+    };
+    for (const auto& mode : modes) {
+        BacktestConfig config;
+        config.record_mode = mode.first;
+        config.record_interval = 7;
+        compare_modes<strategy::MACrossStrategy>(all, config, mode.second + " / MACross");
+        compare_modes<BracketStrategy>(all, config, mode.second + " / Bracket");
+    }
+
+    // 下单延迟：断点时可能有在途的订单请求
+    {
+        BacktestConfig config;
+        config.latency.fixed_ms = 30000;
+        config.latency.jitter_ms = 60000;
+        compare_modes<strategy::MACrossStrategy>(all, config, "下单延迟 / MACross");
+        compare_modes<BracketStrategy>(all, config, "下单延迟 / Bracket");
+    }
+
+    // 已触发终止条件的回测不再继续
+    {
+        BacktestConfig config;
+        config.stop.max_drawdown = 0.02;
+        strategy::MACrossStrategy full_strategy;
+        BacktestEngine full(config);
+        full.set_strategy(&full_strategy);
+        full.set_data(all);
+        full.run();
+
+        strategy::MACrossStrategy resumed_strategy;
+        BacktestEngine resumed(config);
+        resumed.set_strategy(&resumed_strategy);
+        resumed.resume(all.slice(0, 2500));
+        size_t processed = resumed.bars_processed();
+        resumed.resume(all);
+
+        check(full.get_result().stop_reason != StopReason::NONE &&
+              full.get_result().stopped_at < all[2499].timestamp, "终止条件：完整回测在第一段内提前终止");
+        check(same_result(resumed.get_result(), full.get_result()), "终止条件：分段 resume 与完整 run 一致");
+        check(resumed.bars_processed() == processed, "终止条件：终止后 resume 不再处理新K线");
+    }
+
+    // 策略未实现 clone() 时不能保存断点
+    {
+        NoCloneStrategy strategy;
+        BacktestEngine engine(BacktestConfig{});
+        engine.set_strategy(&strategy);
+        engine.resume(all.slice(0, 100));
+        bool threw = false;
+        try {
+            engine.checkpoint();
+        } catch (const std::logic_error&) {
+            threw = true;
+        }
+        check(threw, "未实现 clone() 的策略：checkpoint 抛出 logic_error");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
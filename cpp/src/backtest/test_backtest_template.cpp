@@ -0,0 +1,217 @@
+/**
+ * @file test_backtest_template.cpp
+ * @brief 静态分派回测引擎测试（离线）：BacktestEngineT<具体策略> 与多态引擎结果一致
+ */
+
+#include "backtest/backtest_engine.h"
+#include "strategy/ma_cross_strategy.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::backtest;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+/**
+ * @brief 最终类型的测试策略：用到全部回调（高周期K线、订单更新）
+ *        以及限价单、OCO 止损/止盈和信号平仓
+ */
+class BracketStrategy final : public strategy::StrategyBase {
+public:
+    BracketStrategy() { subscribe_timeframe(Timeframe::MINUTE_5); }
+
+    void on_bar(const OHLCV& bar) override {
+        last_close_ = bar.close;
+        bars_++;
+        if (position_.has_position()) update_position_price(bar.close);
+    }
+
+    void on_timeframe_bar(Timeframe timeframe, const OHLCV& bar) override {
+        (void)timeframe;
+        trend_up_ = bar.close >= bar.open;
+    }
+
+    strategy::Signal generate_signal() override {
+        if (!position_.has_position()) {
+            if (bars_ % 7 == 0 && trend_up_) buy_limit(last_close_ * 0.995);
+            return strategy::Signal::NONE;
+        }
+        // 高周期转跌时直接按信号平仓
+        return trend_up_ ? strategy::Signal::HOLD : strategy::Signal::SELL;
+    }
+
+    void on_order_update(const strategy::Order& order) override {
+        if (order.status == strategy::OrderStatus::FILLED && order.side == Side::BUY) {
+            stop_loss(order.fill_price * 0.98, 1);
+            take_profit(order.fill_price * 1.02, 1);
+        }
+        updates_++;
+    }
+
+    std::string get_name() const override { return "Bracket"; }
+    std::unique_ptr<StrategyBase> clone() const override { return std::make_unique<BracketStrategy>(*this); }
+
+    size_t updates() const { return updates_; }
+
+private:
+    double last_close_ = 0.0;
+    size_t bars_ = 0;
+    size_t updates_ = 0;
+    bool trend_up_ = true;
+};
+
+static std::vector<OHLCV> make_bars(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    std::vector<OHLCV> bars;
+    double price = 100.0;
+    for (size_t i = 0; i < n; i++) {
+        OHLCV bar;
+        bar.timestamp = static_cast<Timestamp>(i) * 60000;
+        bar.symbol = "BTCUSDT";
+        bar.open = price;
+        bar.close = price * std::exp(noise(rng));
+        bar.high = std::max(bar.open, bar.close) * 1.002;
+        bar.low = std::min(bar.open, bar.close) * 0.998;
+        bar.volume = 1.0;
+        price = bar.close;
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+// 两个引擎执行相同的浮点运算，结果应逐位相同
+static bool same_result(const BacktestResult& a, const BacktestResult& b) {
+    if (a.trades.size() != b.trades.size()) return false;
+    for (size_t i = 0; i < a.trades.size(); i++) {
+        const auto& x = a.trades[i];
+        const auto& y = b.trades[i];
+        if (x.timestamp != y.timestamp || x.signal != y.signal || x.price != y.price ||
+            x.quantity != y.quantity || x.pnl != y.pnl) {
+            return false;
+        }
+    }
+    return a.equity_curve == b.equity_curve && a.timestamps == b.timestamps &&
+           a.final_equity == b.final_equity && a.final_capital == b.final_capital &&
+           a.total_return == b.total_return && a.total_trades == b.total_trades &&
+           a.winning_trades == b.winning_trades && a.losing_trades == b.losing_trades &&
+           a.stop_reason == b.stop_reason && a.stopped_at == b.stopped_at &&
+           a.equity_stats.count() == b.equity_stats.count() &&
+           a.equity_stats.max_drawdown() == b.equity_stats.max_drawdown() &&
+           a.equity_stats.sharpe_ratio() == b.equity_stats.sharpe_ratio();
+}
+
+template <typename S>
+static BacktestResult run_polymorphic(const OHLCVSeries& data, const BacktestConfig& config) {
+    S strategy;
+    BacktestEngine engine(config);
+    engine.set_strategy(&strategy);
+    engine.set_data(data);
+    engine.run();
+    return engine.take_result();
+}
+
+template <typename S>
+static BacktestResult run_static(const OHLCVSeries& data, const BacktestConfig& config) {
+    S strategy;
+    BacktestEngineT<S> engine(config);
+    engine.set_strategy(&strategy);
+    engine.set_data(data);
+    engine.run();
+    return engine.take_result();
+}
+
+template <typename S>
+static void compare(const OHLCVSeries& data, const BacktestConfig& config, const std::string& label) {
+    BacktestResult polymorphic = run_polymorphic<S>(data, config);
+    BacktestResult statically = run_static<S>(data, config);
+    check(polymorphic.total_trades > 0 && same_result(polymorphic, statically),
+          label + "：静态分派与多态引擎结果一致");
+}
+
+int main() {
+    std::cout << "========== 静态分派回测引擎测试 ==========\n" << std::endl;
+
+    OHLCVSeries data(make_bars(5000, 7));
+
+    const std::vector<std::pair<EquityRecordMode, std::string>> modes = {
+        {EquityRecordMode::FULL, "FULL"},
+        {EquityRecordMode::EVERY_N_BARS, "EVERY_N_BARS"},
+        {EquityRecordMode::ON_CHANGE, "ON_CHANGE"},
+        {EquityRecordMode::NONE, "NONE"},
+    };
+    for (const auto& mode : modes) {
+        BacktestConfig config;
+        config.record_mode = mode.first;
+        config.record_interval = 5;
+        compare<strategy::MACrossStrategy>(data, config, mode.second + " / MACross");
+        compare<BracketStrategy>(data, config, mode.second + " / Bracket");
+    }
+
+    // 下单延迟与提前终止
+    {
+        BacktestConfig config;
+        config.latency.fixed_ms = 30000;
+        config.latency.jitter_ms = 60000;
+        compare<strategy::MACrossStrategy>(data, config, "下单延迟 / MACross");
+        compare<BracketStrategy>(data, config, "下单延迟 / Bracket");
+
+        BacktestConfig stopping;
+        stopping.stop.max_drawdown = 0.02;
+        BacktestResult polymorphic = run_polymorphic<strategy::MACrossStrategy>(data, stopping);
+        BacktestResult statically = run_static<strategy::MACrossStrategy>(data, stopping);
+        check(polymorphic.stop_reason != StopReason::NONE && same_result(polymorphic, statically),
+              "提前终止：终止位置与结果一致");
+    }
+
+    // 订单更新回调：静态分派同样调用到具体策略
+    {
+        BacktestConfig config;
+        BracketStrategy polymorphic_strategy;
+        BacktestEngine polymorphic(config);
+        polymorphic.set_strategy(&polymorphic_strategy);
+        polymorphic.set_data(data);
+        polymorphic.run();
+
+        BracketStrategy static_strategy;
+        BacktestEngineT<BracketStrategy> statically(config);
+        statically.set_strategy(&static_strategy);
+        statically.set_data(data);
+        statically.run();
+        check(static_strategy.updates() > 0 && static_strategy.updates() == polymorphic_strategy.updates(),
+              "订单更新：回调次数一致");
+    }
+
+    // 模板引擎的断点与增量回测
+    {
+        BacktestConfig config;
+        BacktestResult expected = run_static<strategy::MACrossStrategy>(data, config);
+
+        strategy::MACrossStrategy strategy;
+        BacktestEngineT<strategy::MACrossStrategy> engine(config);
+        engine.set_strategy(&strategy);
+        engine.resume(data.slice(0, 2503));
+        BacktestCheckpointT<strategy::MACrossStrategy> checkpoint = engine.checkpoint();
+
+        BacktestEngineT<strategy::MACrossStrategy> restored(config);
+        restored.restore(checkpoint);
+        restored.resume(data);
+        check(same_result(restored.get_result(), expected), "断点：BacktestEngineT 恢复后续跑与完整回测一致");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
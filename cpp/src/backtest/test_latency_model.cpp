@@ -0,0 +1,172 @@
+/**
+ * @file test_latency_model.cpp
+ * @brief 下单延迟测试（离线）：成交所在的Bar与成交价
+ */
+
+#include "backtest/backtest_engine.h"
+#include "backtest/latency_model.h"
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::backtest;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static const int64_t MINUTE = 60000;
+
+/**
+ * @brief 按脚本发出信号：signals[i] 在第 i 根K线收盘时发出；
+ *        limit_at 处挂一张限价买单
+ */
+class ScriptedStrategy : public strategy::StrategyBase {
+public:
+    ScriptedStrategy(std::map<size_t, strategy::Signal> signals, size_t limit_at = SIZE_MAX, double limit_price = 0.0)
+        : signals_(std::move(signals)), limit_at_(limit_at), limit_price_(limit_price) {}
+
+    void on_bar(const OHLCV& bar) override {
+        (void)bar;
+        index_++;
+    }
+
+    strategy::Signal generate_signal() override {
+        size_t i = index_ - 1;
+        if (i == limit_at_) buy_limit(limit_price_);
+        auto it = signals_.find(i);
+        return it == signals_.end() ? strategy::Signal::NONE : it->second;
+    }
+
+    std::string get_name() const override { return "Scripted"; }
+
+private:
+    std::map<size_t, strategy::Signal> signals_;
+    size_t limit_at_;
+    double limit_price_;
+    size_t index_ = 0;
+};
+
+// 第 i 根K线开盘价 100 + i，收盘价 100 + i + 0.5，便于从成交价认出所在的Bar
+static std::vector<OHLCV> make_bars(size_t n) {
+    std::vector<OHLCV> bars;
+    for (size_t i = 0; i < n; i++) {
+        OHLCV bar;
+        bar.timestamp = static_cast<Timestamp>(i) * MINUTE;
+        bar.symbol = "BTCUSDT";
+        bar.timeframe = Timeframe::MINUTE_1;
+        bar.open = 100.0 + i;
+        bar.close = bar.open + 0.5;
+        bar.high = bar.close + 0.2;
+        bar.low = bar.open - 0.2;
+        bar.volume = 1.0;
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+static BacktestResult run(const std::vector<OHLCV>& bars, const BacktestConfig& config, ScriptedStrategy& strategy) {
+    BacktestEngine engine(config);
+    engine.set_strategy(&strategy);
+    engine.set_data(OHLCVSeries(bars));
+    engine.run();
+    return engine.take_result();
+}
+
+static bool near(double a, double b) {
+    return std::abs(a - b) < 1e-9;
+}
+
+int main() {
+    std::cout << "========== 下单延迟测试 ==========\n" << std::endl;
+
+    std::vector<OHLCV> bars = make_bars(20);
+    const size_t k = 5;
+
+    // 1. 到达时间向上取整到Bar的开盘时间
+    {
+        LatencyConfig config;
+        config.fixed_ms = 300;
+        LatencyQueue queue(config);
+        Timestamp sent_at = (k + 1) * MINUTE;   // 第k根收盘 = 第k+1根开盘
+        queue.push_signal(strategy::Signal::BUY, sent_at, Timeframe::MINUTE_1);
+        check(!queue.due((k + 1) * MINUTE), "300ms：第k+1根开盘时尚未到达");
+        check(queue.due((k + 2) * MINUTE), "300ms：第k+2根开盘时处理");
+        LatencyEvent event = queue.pop();
+        check(event.arrival == sent_at + 300 && event.due_at == (k + 2) * MINUTE, "300ms：due_at >= arrival");
+
+        LatencyConfig exact;
+        exact.samples_ms = {MINUTE};
+        LatencyQueue on_boundary(exact);
+        on_boundary.push_signal(strategy::Signal::BUY, sent_at, Timeframe::MINUTE_1);
+        check(on_boundary.due((k + 2) * MINUTE) && on_boundary.pop().due_at == (k + 2) * MINUTE,
+              "恰好在开盘时到达：由该Bar处理");
+    }
+
+    // 2. 市价信号：300ms 延迟按第k+2根开盘价成交，不是第k+1根
+    {
+        BacktestConfig config;
+        config.slippage_rate = 0.001;
+        config.latency.fixed_ms = 300;
+        ScriptedStrategy strategy({{k, strategy::Signal::BUY}, {k + 5, strategy::Signal::SELL}});
+        BacktestResult result = run(bars, config, strategy);
+        check(result.trades.size() == 2, "市价信号：买入和卖出各成交一次");
+        if (result.trades.size() == 2) {
+            check(result.trades[0].timestamp == bars[k + 2].timestamp &&
+                  near(result.trades[0].price, bars[k + 2].open * 1.001),
+                  "市价信号：买入按第k+2根开盘价（加滑点）成交");
+            check(result.trades[1].timestamp == bars[k + 7].timestamp &&
+                  near(result.trades[1].price, bars[k + 7].open * 0.999),
+                  "市价信号：卖出按第k+7根开盘价（减滑点）成交");
+        }
+    }
+
+    // 3. 延迟跨过多根Bar
+    {
+        BacktestConfig config;
+        config.slippage_rate = 0.0;
+        config.latency.samples_ms = {2 * MINUTE + 1};
+        ScriptedStrategy strategy({{k, strategy::Signal::BUY}});
+        BacktestResult result = run(bars, config, strategy);
+        check(result.trades.size() == 1 && result.trades[0].timestamp == bars[k + 4].timestamp &&
+              near(result.trades[0].price, bars[k + 4].open), "2分钟+1ms：按第k+4根开盘价成交");
+    }
+
+    // 4. 未启用延迟：按信号所在Bar的收盘价成交
+    {
+        BacktestConfig config;
+        config.slippage_rate = 0.0;
+        ScriptedStrategy strategy({{k, strategy::Signal::BUY}});
+        BacktestResult result = run(bars, config, strategy);
+        check(result.trades.size() == 1 && result.trades[0].timestamp == bars[k].timestamp &&
+              near(result.trades[0].price, bars[k].close), "无延迟：按第k根收盘价成交");
+    }
+
+    // 5. 订单请求：第k+1根的价格区间覆盖限价，但订单在该Bar开盘后才到达，不参与该Bar的撮合
+    {
+        BacktestConfig config;
+        config.latency.fixed_ms = 300;
+        double limit = bars[k + 1].low + 0.1;   // 第k+1根可成交，第k+2根最低价更高
+        ScriptedStrategy delayed({}, k, limit);
+        BacktestResult result = run(bars, config, delayed);
+        check(result.trades.empty(), "限价单：第k+1根开盘后才到达，错过该Bar，之后价格不再触及");
+
+        BacktestConfig immediate;
+        ScriptedStrategy direct({}, k, limit);
+        BacktestResult direct_result = run(bars, immediate, direct);
+        check(direct_result.trades.size() == 1 && direct_result.trades[0].timestamp == bars[k + 1].timestamp,
+              "限价单：无延迟时在第k+1根成交");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
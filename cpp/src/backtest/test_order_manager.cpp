@@ -0,0 +1,176 @@
+/**
+ * @file test_order_manager.cpp
+ * @brief 挂单簿撮合测试（离线，使用构造的K线）
+ */
+
+#include "backtest/order_manager.h"
+#include "backtest/backtest_engine.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::backtest;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static OHLCV make_bar(Timestamp ts, Price open, Price high, Price low, Price close) {
+    OHLCV bar;
+    bar.timestamp = ts;
+    bar.symbol = "BTCUSDT";
+    bar.open = open;
+    bar.high = high;
+    bar.low = low;
+    bar.close = close;
+    return bar;
+}
+
+static strategy::Order make_order(strategy::OrderId id, Side side, OrderType type,
+                                  Price price, Price stop_price = 0.0, int64_t oco = 0) {
+    strategy::Order order;
+    order.id = id;
+    order.side = side;
+    order.type = type;
+    order.price = price;
+    order.stop_price = stop_price;
+    order.oco_group = oco;
+    return order;
+}
+
+struct FillRecord {
+    strategy::OrderId id;
+    Price price;
+};
+
+/**
+ * @brief 测试策略：第一根Bar市价买入，成交后挂止损与止盈（OCO）
+ */
+class BracketStrategy : public strategy::StrategyBase {
+public:
+    void on_bar(const OHLCV& bar) override { (void)bar; }
+    strategy::Signal generate_signal() override {
+        if (!submitted_) {
+            submit_order(Side::BUY, OrderType::MARKET);
+            submitted_ = true;
+        }
+        return strategy::Signal::NONE;
+    }
+    std::string get_name() const override { return "Bracket"; }
+
+    void on_order_update(const strategy::Order& order) override {
+        if (order.status == strategy::OrderStatus::FILLED && order.side == Side::BUY) {
+            stop_loss(order.fill_price * 0.95, 1);
+            take_profit(order.fill_price * 1.10, 1);
+        }
+        updates.push_back(order);
+    }
+
+    std::vector<strategy::Order> updates;
+
+private:
+    bool submitted_ = false;
+};
+
+int main() {
+    std::cout << "========== 挂单簿撮合测试 ==========\n" << std::endl;
+
+    std::vector<FillRecord> fills;
+    auto on_fill = [&fills](strategy::Order& order, Price price, bool taker) {
+        (void)taker;
+        fills.push_back({order.id, price});
+        return true;
+    };
+
+    // 1. 阳线路径 open -> low -> high -> close：先成交买入限价，再成交卖出限价
+    {
+        OrderManager book;
+        fills.clear();
+        book.submit(make_order(1, Side::SELL, OrderType::LIMIT, 108.0));
+        book.submit(make_order(2, Side::BUY, OrderType::LIMIT, 96.0));
+        book.match_bar(make_bar(0, 100, 110, 95, 105), on_fill);
+        check(fills.size() == 2 && fills[0].id == 2 && fills[0].price == 96.0 &&
+              fills[1].id == 1 && fills[1].price == 108.0, "阳线：先触及低点再触及高点");
+    }
+
+    // 2. 阴线路径 open -> high -> low -> close：止盈先成交，OCO撤销止损
+    {
+        OrderManager book;
+        fills.clear();
+        book.submit(make_order(1, Side::SELL, OrderType::STOP_MARKET, 0.0, 92.0, 7));
+        book.submit(make_order(2, Side::SELL, OrderType::LIMIT, 108.0, 0.0, 7));
+        book.match_bar(make_bar(0, 100, 110, 90, 95), on_fill);
+        auto updates = book.take_updates();
+        check(fills.size() == 1 && fills[0].id == 2 && fills[0].price == 108.0,
+              "阴线：先触及高点的止盈成交");
+        check(updates.size() == 2 && updates[1].id == 1 &&
+              updates[1].status == strategy::OrderStatus::CANCELLED, "OCO：同组止损被撤销");
+        check(book.pending_count() == 0, "OCO后无剩余挂单");
+    }
+
+    // 3. 开盘跳空：越过的限价单按开盘价成交
+    {
+        OrderManager book;
+        fills.clear();
+        book.submit(make_order(1, Side::BUY, OrderType::LIMIT, 105.0));
+        book.match_bar(make_bar(0, 100, 101, 99, 100.5), on_fill);
+        check(fills.size() == 1 && fills[0].price == 100.0, "跳空：按开盘价成交");
+    }
+
+    // 4. 止损限价：触发后转为限价单，回落到限价时成交
+    {
+        OrderManager book;
+        fills.clear();
+        book.submit(make_order(1, Side::BUY, OrderType::STOP_LIMIT, 102.0, 104.0));
+        book.match_bar(make_bar(0, 100, 110, 98, 101), on_fill);
+        check(fills.size() == 1 && fills[0].price == 102.0, "止损限价：触发后按限价成交");
+    }
+
+    // 5. 撤单
+    {
+        OrderManager book;
+        fills.clear();
+        book.submit(make_order(1, Side::BUY, OrderType::LIMIT, 96.0));
+        check(book.cancel(1) && !book.cancel(1), "撤单只生效一次");
+        book.match_bar(make_bar(0, 100, 110, 95, 105), on_fill);
+        check(fills.empty(), "已撤订单不再成交");
+    }
+
+    // 6. 非法订单被拒绝
+    {
+        OrderManager book;
+        check(!book.submit(make_order(1, Side::BUY, OrderType::LIMIT, 0.0)), "限价为0的订单被拒绝");
+    }
+
+    // 7. 回测引擎：市价开仓 + OCO止损止盈
+    {
+        std::vector<OHLCV> data;
+        data.push_back(make_bar(0, 100, 101, 99, 100));
+        data.push_back(make_bar(1, 100, 102, 99, 101));      // 开盘市价买入
+        data.push_back(make_bar(2, 101, 102, 90, 91));       // 跌破止损
+        data.push_back(make_bar(3, 91, 130, 90, 125));       // 止盈已被撤销，不应成交
+
+        BacktestConfig config;
+        config.slippage_rate = 0.0;
+        config.commission_rate = 0.0;
+        BacktestEngine engine(config);
+        BracketStrategy strategy;
+        engine.set_strategy(&strategy);
+        engine.set_data(std::move(data));
+        engine.run();
+
+        const auto& result = engine.get_result();
+        check(result.trades.size() == 2, "引擎：一次开仓一次止损");
+        check(result.trades.size() == 2 && result.trades[0].price == 100.0 &&
+              result.trades[1].price == 95.0, "引擎：开盘价买入，止损价卖出");
+        check(!strategy.get_position().has_position(), "引擎：止损后无持仓");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+/**
+ * @file test_result_cache.cpp
+ * @brief 回测结果缓存测试（离线）：缓存键的稳定性与敏感性、LRU 淘汰、落盘与载回
+ */
+
+#include "backtest/result_cache.h"
+#include "analysis/performance_analyzer.h"
+#include "strategy/ma_cross_strategy.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::backtest;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static std::vector<OHLCV> make_bars(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    std::vector<OHLCV> bars;
+    double price = 100.0;
+    for (size_t i = 0; i < n; i++) {
+        OHLCV bar;
+        bar.timestamp = static_cast<Timestamp>(i) * 3600000;
+        bar.symbol = "BTCUSDT";
+        bar.exchange = "binance";
+        bar.timeframe = Timeframe::HOUR_1;
+        bar.open = price;
+        bar.close = price * std::exp(noise(rng));
+        bar.high = std::max(bar.open, bar.close) * 1.002;
+        bar.low = std::min(bar.open, bar.close) * 0.998;
+        bar.volume = 1.0;
+        price = bar.close;
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+static const std::map<std::string, double> kParams = {{"fast_period", 5}, {"slow_period", 20}};
+
+static BacktestCacheKey key_for(const std::vector<OHLCV>& bars, const BacktestConfig& config = BacktestConfig(),
+                                const std::map<std::string, double>& params = kParams,
+                                const std::string& name = "ma_cross") {
+    return BacktestResultCache::make_key(OHLCVSeries(bars), name, params, config);
+}
+
+// 空结果条目（只关心缓存行为时使用）
+static std::shared_ptr<const CachedBacktest> put_empty(BacktestResultCache& cache, const BacktestCacheKey& key) {
+    return cache.put(key, BacktestResult(), analysis::PerformanceMetrics());
+}
+
+static bool same_periods(const analysis::PeriodReturns& a, const analysis::PeriodReturns& b) {
+    return a.period == b.period && a.start == b.start && a.open_equity == b.open_equity &&
+           a.close_equity == b.close_equity && a.returns == b.returns;
+}
+
+static bool same_drawdowns(const analysis::DrawdownReport& a, const analysis::DrawdownReport& b) {
+    if (a.episodes.size() != b.episodes.size()) return false;
+    for (size_t i = 0; i < a.episodes.size(); i++) {
+        const auto& x = a.episodes[i];
+        const auto& y = b.episodes[i];
+        if (x.start_time != y.start_time || x.trough_time != y.trough_time || x.end_time != y.end_time ||
+            x.start_index != y.start_index || x.trough_index != y.trough_index || x.end_index != y.end_index ||
+            x.peak_equity != y.peak_equity || x.trough_equity != y.trough_equity || x.depth != y.depth ||
+            x.recovered != y.recovered) {
+            return false;
+        }
+    }
+    return a.episode_count == b.episode_count && a.max_duration_ms == b.max_duration_ms &&
+           a.avg_duration_ms == b.avg_duration_ms && a.max_recovery_ms == b.max_recovery_ms &&
+           a.avg_depth == b.avg_depth && a.under_water_ms == b.under_water_ms && a.total_ms == b.total_ms;
+}
+
+static bool same_rolling(const analysis::RollingMetrics& a, const analysis::RollingMetrics& b) {
+    return a.window_bars == b.window_bars && a.window_ms == b.window_ms && a.timestamps == b.timestamps &&
+           a.mean_return == b.mean_return && a.volatility == b.volatility && a.sharpe_ratio == b.sharpe_ratio &&
+           a.sortino_ratio == b.sortino_ratio && a.drawdown == b.drawdown;
+}
+
+static bool same_result(const BacktestResult& a, const BacktestResult& b) {
+    if (a.trades.size() != b.trades.size()) return false;
+    for (size_t i = 0; i < a.trades.size(); i++) {
+        const auto& x = a.trades[i];
+        const auto& y = b.trades[i];
+        if (x.timestamp != y.timestamp || x.symbol != y.symbol || x.signal != y.signal ||
+            x.price != y.price || x.quantity != y.quantity || x.pnl != y.pnl) {
+            return false;
+        }
+    }
+    return a.initial_capital == b.initial_capital && a.final_capital == b.final_capital &&
+           a.final_equity == b.final_equity && a.total_return == b.total_return &&
+           a.total_trades == b.total_trades && a.winning_trades == b.winning_trades &&
+           a.losing_trades == b.losing_trades && a.equity_curve == b.equity_curve &&
+           a.timestamps == b.timestamps && a.record_mode == b.record_mode &&
+           a.equity_stats.count() == b.equity_stats.count() &&
+           a.equity_stats.max_drawdown() == b.equity_stats.max_drawdown() &&
+           a.equity_stats.sharpe_ratio() == b.equity_stats.sharpe_ratio() &&
+           a.stop_reason == b.stop_reason && a.stopped_at == b.stopped_at;
+}
+
+static bool same_metrics(const analysis::PerformanceMetrics& a, const analysis::PerformanceMetrics& b) {
+    return a.annualized_return == b.annualized_return && a.cumulative_return == b.cumulative_return &&
+           a.max_drawdown == b.max_drawdown && a.sharpe_ratio == b.sharpe_ratio &&
+           a.sortino_ratio == b.sortino_ratio && a.calmar_ratio == b.calmar_ratio &&
+           a.volatility == b.volatility && a.downside_deviation == b.downside_deviation &&
+           a.periods_per_year == b.periods_per_year && a.profit_loss_ratio == b.profit_loss_ratio &&
+           a.max_consecutive_wins == b.max_consecutive_wins &&
+           a.max_consecutive_losses == b.max_consecutive_losses &&
+           a.avg_holding_period == b.avg_holding_period &&
+           a.trade_frequency_per_year == b.trade_frequency_per_year &&
+           a.equity_curve == b.equity_curve && a.drawdown_curve == b.drawdown_curve;
+}
+
+int main() {
+    std::cout << "========== 回测结果缓存测试 ==========\n" << std::endl;
+
+    const std::vector<OHLCV> bars = make_bars(3000, 1);
+
+    // 1. 缓存键的稳定性
+    {
+        BacktestCacheKey a = key_for(bars);
+        BacktestCacheKey b = key_for(make_bars(3000, 1));
+        check(a == b && a.to_string() == b.to_string(), "稳定性：相同内容得到相同的键");
+        check(BacktestResultCache::hash_data(bars) == BacktestResultCache::hash_data(OHLCVSeries(bars)),
+              "稳定性：vector 与 OHLCVSeries 的数据哈希相同");
+
+        std::map<std::string, double> reordered;
+        reordered["slow_period"] = 20;
+        reordered["fast_period"] = 5;
+        check(key_for(bars, BacktestConfig(), reordered) == a, "稳定性：与参数插入顺序无关");
+        check(a.bar_count == bars.size(), "稳定性：键中记录K线数量");
+    }
+
+    // 2. 缓存键的敏感性：任一字段变化都得到不同的键
+    {
+        const BacktestCacheKey base = key_for(bars);
+        struct Mutation {
+            std::string name;
+            void (*apply)(OHLCV&);
+        };
+        const std::vector<Mutation> mutations = {
+            {"时间戳", [](OHLCV& bar) { bar.timestamp += 1; }},
+            {"交易所", [](OHLCV& bar) { bar.exchange = "okx"; }},
+            {"交易对", [](OHLCV& bar) { bar.symbol = "ETHUSDT"; }},
+            {"周期", [](OHLCV& bar) { bar.timeframe = Timeframe::MINUTE_1; }},
+            {"开盘价", [](OHLCV& bar) { bar.open += 1e-9; }},
+            {"最高价", [](OHLCV& bar) { bar.high += 1e-9; }},
+            {"最低价", [](OHLCV& bar) { bar.low -= 1e-9; }},
+            {"收盘价", [](OHLCV& bar) { bar.close += 1e-9; }},
+            {"成交量", [](OHLCV& bar) { bar.volume += 1.0; }},
+        };
+        for (const auto& mutation : mutations) {
+            std::vector<OHLCV> changed = bars;
+            mutation.apply(changed[1500]);
+            BacktestCacheKey key = key_for(changed);
+            check(key.data_hash != base.data_hash && key.params_hash == base.params_hash,
+                  "敏感性：一根K线的" + mutation.name + "不同");
+        }
+        std::vector<OHLCV> shorter(bars.begin(), bars.end() - 1);
+        check(!(key_for(shorter) == base), "敏感性：K线数量不同");
+
+        std::map<std::string, double> params = kParams;
+        params["slow_period"] = 21;
+        check(key_for(bars, BacktestConfig(), params).params_hash != base.params_hash, "敏感性：策略参数不同");
+        check(key_for(bars, BacktestConfig(), kParams, "other").params_hash != base.params_hash,
+              "敏感性：策略名称不同");
+
+        BacktestConfig commission;
+        commission.commission_rate = 0.0011;
+        BacktestConfig mode;
+        mode.record_mode = EquityRecordMode::NONE;
+        BacktestConfig stop;
+        stop.stop.max_drawdown = 0.2;
+        BacktestConfig latency;
+        latency.latency.samples_ms = {100};
+        check(key_for(bars, commission).params_hash != base.params_hash &&
+              key_for(bars, mode).params_hash != base.params_hash &&
+              key_for(bars, stop).params_hash != base.params_hash &&
+              key_for(bars, latency).params_hash != base.params_hash,
+              "敏感性：手续费、记录模式、终止条件、延迟配置不同");
+    }
+
+    // 3. LRU 淘汰
+    {
+        BacktestResultCache cache(3);
+        std::vector<BacktestCacheKey> keys;
+        for (unsigned seed = 10; seed < 14; seed++) keys.push_back(key_for(make_bars(100, seed)));
+
+        auto first = put_empty(cache, keys[0]);
+        put_empty(cache, keys[1]);
+        put_empty(cache, keys[2]);
+        check(cache.find(keys[0]) == first, "LRU：命中返回同一条目（不复制）");
+        put_empty(cache, keys[3]);   // 最久未用的是 keys[1]
+
+        check(cache.size() == 3, "LRU：条目数不超过容量");
+        check(cache.find(keys[1]) == nullptr, "LRU：淘汰最久未使用的条目");
+        check(cache.find(keys[0]) != nullptr && cache.find(keys[2]) != nullptr && cache.find(keys[3]) != nullptr,
+              "LRU：最近使用过的条目保留");
+        CacheStats stats = cache.stats();
+        check(stats.evictions == 1 && stats.misses == 1 && stats.hits == 4 && stats.spills == 0,
+              "LRU：命中、未命中与淘汰计数");
+
+        // 重复写入同一个键只保留一份
+        put_empty(cache, keys[3]);
+        check(cache.size() == 3 && cache.stats().evictions == 1, "LRU：重复写入同一个键不产生淘汰");
+
+        cache.clear();
+        check(cache.size() == 0 && cache.find(keys[0]) == nullptr, "clear：清空内存");
+    }
+
+    // 4. 落盘与载回：结果与指标（含周期收益、回撤区间、滚动指标）逐位一致
+    {
+        const std::filesystem::path dir = std::filesystem::temp_directory_path() / "test_result_cache";
+        std::filesystem::remove_all(dir);
+
+        BacktestConfig config;
+        strategy::MACrossStrategy strategy;
+        BacktestEngine engine(config);
+        engine.set_strategy(&strategy);
+        engine.set_data(OHLCVSeries(bars));
+        engine.run();
+        BacktestResult result = engine.take_result();
+
+        analysis::AnalyzeOptions options;
+        options.keep_period_returns = true;
+        options.keep_drawdown_episodes = true;
+        options.min_drawdown_depth = 0.01;
+        options.rolling_window_bars = 100;
+        analysis::PerformanceAnalyzer analyzer;
+        analysis::PerformanceMetrics metrics = analyzer.analyze(result, options);
+
+        BacktestCacheKey key = key_for(bars, config);
+        BacktestCacheKey other = key_for(make_bars(100, 99), config);
+        {
+            BacktestResultCache cache(1, dir.string());
+            cache.put(key, result, metrics);
+            put_empty(cache, other);   // 淘汰 key 并写入磁盘
+            check(cache.stats().spills == 1 && std::filesystem::exists(dir / (key.to_string() + ".bin")),
+                  "落盘：淘汰的条目写入磁盘");
+        }
+
+        // 新的缓存实例（模拟进程重启）从磁盘载回
+        BacktestResultCache cache(4, dir.string());
+        auto loaded = cache.find(key);
+        check(loaded != nullptr && cache.stats().disk_hits == 1, "载回：命中落盘条目");
+        check(result.total_trades > 0 && !metrics.daily_returns.empty() && !metrics.weekly_returns.empty() &&
+              !metrics.monthly_returns.empty() && !metrics.drawdowns.episodes.empty() && !metrics.rolling.empty(),
+              "载回：测试数据包含交易、周期收益、回撤区间与滚动指标");
+        if (loaded) {
+            check(loaded->key == key && same_result(loaded->result, result), "载回：回测结果一致");
+            check(same_metrics(loaded->metrics, metrics), "载回：标量指标与曲线一致");
+            check(same_periods(loaded->metrics.daily_returns, metrics.daily_returns) &&
+                  same_periods(loaded->metrics.weekly_returns, metrics.weekly_returns) &&
+                  same_periods(loaded->metrics.monthly_returns, metrics.monthly_returns),
+                  "载回：日/周/月收益表一致");
+            check(same_drawdowns(loaded->metrics.drawdowns, metrics.drawdowns), "载回：回撤区间一致");
+            check(same_rolling(loaded->metrics.rolling, metrics.rolling), "载回：滚动指标一致");
+        }
+        check(cache.find(key) == loaded && cache.stats().hits == 1, "载回后：再次查找为内存命中");
+
+        // 损坏的文件不会被当作命中
+        BacktestCacheKey broken = other;
+        std::filesystem::path broken_path = dir / (broken.to_string() + ".bin");
+        {
+            BacktestResultCache spiller(1, dir.string());
+            spiller.put(broken, result, metrics);
+            put_empty(spiller, key_for(make_bars(100, 98), config));
+        }
+        std::filesystem::resize_file(broken_path, std::filesystem::file_size(broken_path) / 2);
+        BacktestResultCache fresh(4, dir.string());
+        check(fresh.find(broken) == nullptr && fresh.stats().misses == 1, "损坏的落盘文件：按未命中处理");
+
+        std::filesystem::remove_all(dir);
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file test_successive_halving.cpp
+ * @brief 逐级减半优化测试（离线）：固定数据与参数网格，每轮的存活候选与逐轮全新回测的淘汰结果一致，
+ *        终止条件剪枝、处理的K线数与线程数无关
+ */
+
+#include "backtest/parameter_optimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::backtest;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static std::vector<OHLCV> make_bars(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    std::vector<OHLCV> bars;
+    double price = 100.0;
+    for (size_t i = 0; i < n; i++) {
+        OHLCV bar;
+        bar.timestamp = static_cast<Timestamp>(i) * 3600000;
+        bar.symbol = "BTCUSDT";
+        bar.open = price;
+        bar.close = price * std::exp(noise(rng) + 0.0002 * std::sin(i / 300.0));
+        bar.high = std::max(bar.open, bar.close) * 1.002;
+        bar.low = std::min(bar.open, bar.close) * 0.998;
+        bar.volume = 1.0;
+        price = bar.close;
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+static std::vector<ParamSet> make_grid() {
+    std::vector<ParamSet> grid;
+    for (double fast : {3.0, 5.0, 8.0, 10.0}) {
+        for (double slow : {20.0, 30.0, 40.0, 60.0}) {
+            grid.push_back({{"fast_period", fast}, {"slow_period", slow}});
+        }
+    }
+    return grid;
+}
+
+struct Expected {
+    std::vector<std::vector<size_t>> survivors;   // 每轮跑完且未被终止的候选下标（升序，淘汰之前）
+    std::vector<size_t> rounds;                   // 每个候选存活的轮数
+    std::vector<double> scores;                   // 每个候选最后一轮的评分
+};
+
+/**
+ * @brief 对照实现：每轮对存活候选在前 L 根K线上重新回测（不使用 resume），
+ *        触发终止条件的淘汰，其余按评分（同分按下标）保留前 keep_fraction
+ */
+static Expected simulate(const OHLCVSeries& data, const std::vector<ParamSet>& grid, BacktestConfig config,
+                         const std::vector<size_t>& lengths, const HalvingOptions& options) {
+    config.record_mode = EquityRecordMode::NONE;
+    auto factory = SuccessiveHalvingOptimizer::ma_cross_factory();
+    Expected expected;
+    expected.rounds.assign(grid.size(), 0);
+    expected.scores.assign(grid.size(), 0.0);
+    std::vector<size_t> active(grid.size());
+    for (size_t i = 0; i < grid.size(); i++) active[i] = i;
+
+    for (size_t round = 0; round < lengths.size(); round++) {
+        std::vector<size_t> alive;
+        for (size_t i : active) {
+            auto strategy = factory(grid[i]);
+            BacktestEngine engine(config);
+            engine.set_strategy(strategy.get());
+            engine.set_data(data.slice(0, lengths[round]));
+            engine.run();
+            expected.scores[i] = engine.get_result().equity_stats.sharpe_ratio();
+            if (engine.get_result().stop_reason == StopReason::NONE) {
+                expected.rounds[i] = round + 1;
+                alive.push_back(i);
+            }
+        }
+        std::vector<size_t> finished = alive;
+        std::sort(finished.begin(), finished.end());
+        expected.survivors.push_back(finished);
+        if (round + 1 < lengths.size()) {
+            size_t keep = static_cast<size_t>(std::ceil(alive.size() * options.keep_fraction));
+            keep = std::min(alive.size(), std::max(keep, options.min_survivors));
+            std::sort(alive.begin(), alive.end(), [&](size_t a, size_t b) {
+                if (expected.scores[a] != expected.scores[b]) return expected.scores[a] > expected.scores[b];
+                return a < b;
+            });
+            alive.resize(keep);
+        }
+        active = alive;
+    }
+    return expected;
+}
+
+// 优化结果中跑完第 round 轮的候选下标（存活轮数 >= round，升序）
+static std::vector<size_t> survivors_of(const std::vector<OptimizationResult>& results,
+                                        const std::vector<ParamSet>& grid, size_t round) {
+    std::vector<size_t> indices;
+    for (const auto& r : results) {
+        if (r.rounds_survived < round) continue;
+        indices.push_back(static_cast<size_t>(std::find(grid.begin(), grid.end(), r.params) - grid.begin()));
+    }
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+int main() {
+    std::cout << "========== 逐级减半优化测试 ==========\n" << std::endl;
+
+    OHLCVSeries data(make_bars(8000, 7));
+    const std::vector<ParamSet> grid = make_grid();
+    // 8000 根、12.5% 起步、每轮减半：1000 → 2000 → 4000 → 8000
+    const std::vector<size_t> lengths = {1000, 2000, 4000, 8000};
+
+    HalvingOptions options;
+    options.initial_fraction = 0.125;
+    options.keep_fraction = 0.5;
+    options.threads = 4;
+
+    // 1. 每轮参与的候选：16 → 8 → 4 → 2，与逐轮全新回测的淘汰结果一致
+    {
+        BacktestConfig config;
+        SuccessiveHalvingOptimizer optimizer(SuccessiveHalvingOptimizer::ma_cross_factory(), config, options);
+        std::vector<OptimizationResult> results = optimizer.run(data, grid);
+        Expected expected = simulate(data, grid, config, lengths, options);
+
+        check(results.size() == grid.size(), "返回全部 16 个候选");
+        const size_t counts[] = {16, 8, 4, 2};
+        for (size_t round = 1; round <= lengths.size(); round++) {
+            std::vector<size_t> got = survivors_of(results, grid, round);
+            check(got.size() == counts[round - 1] && got == expected.survivors[round - 1],
+                  "第 " + std::to_string(round) + " 轮（" + std::to_string(lengths[round - 1]) + " 根）跑完 " +
+                  std::to_string(counts[round - 1]) + " 个候选，与对照实现相同");
+        }
+
+        bool scores_ok = true, bars_ok = true, order_ok = true;
+        size_t total_bars = 0;
+        for (size_t k = 0; k < results.size(); k++) {
+            const OptimizationResult& r = results[k];
+            size_t i = static_cast<size_t>(std::find(grid.begin(), grid.end(), r.params) - grid.begin());
+            scores_ok = scores_ok && r.rounds_survived == expected.rounds[i] && r.score == expected.scores[i];
+            bars_ok = bars_ok && r.bars_processed == lengths[r.rounds_survived - 1];
+            total_bars += r.bars_processed;
+            if (k > 0) {
+                const OptimizationResult& prev = results[k - 1];
+                order_ok = order_ok && (prev.rounds_survived > r.rounds_survived ||
+                                        (prev.rounds_survived == r.rounds_survived && prev.score >= r.score));
+            }
+        }
+        check(scores_ok, "resume 逐轮续跑的评分与在同样长度上全新回测逐位相同");
+        check(bars_ok && total_bars == optimizer.last_bars_processed() &&
+              total_bars == 8 * 1000 + 4 * 2000 + 2 * 4000 + 2 * 8000,
+              "处理的K线数：淘汰的候选停在所在轮的长度，合计 40000（全量网格为 128000）");
+        check(order_ok && results[0].rounds_survived == 4, "结果按存活轮数、评分降序，第一个为最优");
+
+        HalvingOptions single = options;
+        single.threads = 1;
+        std::vector<OptimizationResult> serial =
+            SuccessiveHalvingOptimizer(SuccessiveHalvingOptimizer::ma_cross_factory(), config, single).run(data, grid);
+        bool same = serial.size() == results.size();
+        for (size_t k = 0; same && k < serial.size(); k++) {
+            same = serial[k].params == results[k].params && serial[k].score == results[k].score &&
+                   serial[k].rounds_survived == results[k].rounds_survived;
+        }
+        check(same, "1 线程与 4 线程结果相同");
+    }
+
+    // 2. 终止条件：回撤超限的候选立即淘汰，不占用保留名额
+    {
+        BacktestConfig config;
+        config.stop.max_drawdown = 0.2;
+        SuccessiveHalvingOptimizer optimizer(SuccessiveHalvingOptimizer::ma_cross_factory(), config, options);
+        std::vector<OptimizationResult> results = optimizer.run(data, grid);
+        Expected expected = simulate(data, grid, config, lengths, options);
+
+        size_t stopped = 0;
+        for (const auto& r : results) {
+            if (r.stop_reason == StopReason::MAX_DRAWDOWN) stopped++;
+        }
+        bool same = stopped > 0 && stopped < grid.size();
+        for (size_t round = 1; round <= lengths.size(); round++) {
+            same = same && survivors_of(results, grid, round) == expected.survivors[round - 1];
+        }
+        check(same, "max_drawdown 剪枝：" + std::to_string(stopped) + " 个候选被终止，每轮存活与对照实现相同");
+    }
+
+    // 3. min_survivors 与参数校验
+    {
+        BacktestConfig config;
+        HalvingOptions keep_four = options;
+        keep_four.min_survivors = 4;
+        std::vector<OptimizationResult> results =
+            SuccessiveHalvingOptimizer(SuccessiveHalvingOptimizer::ma_cross_factory(), config, keep_four).run(data, grid);
+        check(survivors_of(results, grid, 3).size() == 4 && survivors_of(results, grid, 4).size() == 4,
+              "min_survivors = 4：第 3、4 轮各有 4 个候选（不再减半到 2 个）");
+
+        bool threw = false;
+        try {
+            HalvingOptions bad;
+            bad.keep_fraction = 1.0;
+            SuccessiveHalvingOptimizer(SuccessiveHalvingOptimizer::ma_cross_factory(), config, bad);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        check(threw, "keep_fraction = 1：抛出 invalid_argument");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file test_vectorized_backtest.cpp
+ * @brief 向量化回测测试（离线）：与 BacktestEngine 运行 MA 交叉策略的结果一致，
+ *        EquityStatistics::update_batch 与逐点 update 一致，并输出单核吞吐量
+ */
+
+#include "backtest/vectorized_backtest.h"
+#include "analysis/equity_statistics.h"
+#include "strategy/ma_cross_strategy.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::backtest;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static std::vector<OHLCV> make_bars(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    std::vector<OHLCV> bars;
+    double price = 100.0;
+    for (size_t i = 0; i < n; i++) {
+        OHLCV bar;
+        bar.timestamp = static_cast<Timestamp>(i) * 60000;
+        bar.symbol = "BTCUSDT";
+        bar.open = price;
+        bar.close = price * std::exp(noise(rng));
+        bar.high = std::max(bar.open, bar.close) * 1.002;
+        bar.low = std::min(bar.open, bar.close) * 0.998;
+        bar.volume = 1.0;
+        price = bar.close;
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+// 与 TechnicalIndicators::calculate_ma 相同的求和顺序，保证均线逐位相同
+static double sma(const std::vector<double>& closes, size_t i, int period) {
+    double sum = 0.0;
+    for (int j = 0; j < period; j++) sum += closes[i - j];
+    return sum / period;
+}
+
+/**
+ * @brief MACrossStrategy 的等价目标持仓：金叉后持有，死叉后空仓
+ */
+static std::vector<double> ma_cross_targets(const std::vector<double>& closes, const strategy::MACrossConfig& config) {
+    std::vector<double> targets(closes.size(), 0.0);
+    const size_t slow = static_cast<size_t>(config.slow_period);
+    bool held = false;
+    for (size_t i = 0; i < closes.size(); i++) {
+        if (i >= slow) {
+            double fast_prev = sma(closes, i - 1, config.fast_period);
+            double fast_curr = sma(closes, i, config.fast_period);
+            double slow_prev = sma(closes, i - 1, config.slow_period);
+            double slow_curr = sma(closes, i, config.slow_period);
+            if (fast_prev <= slow_prev && fast_curr > slow_curr) held = true;
+            if (fast_prev >= slow_prev && fast_curr < slow_curr) held = false;
+        }
+        targets[i] = held ? 1.0 : 0.0;
+    }
+    return targets;
+}
+
+// 成交价、数量、盈亏与权益曲线逐位相同；统计量允许批量合并带来的舍入差异
+static bool same_result(const BacktestResult& a, const BacktestResult& b) {
+    if (a.trades.size() != b.trades.size()) return false;
+    for (size_t i = 0; i < a.trades.size(); i++) {
+        const auto& x = a.trades[i];
+        const auto& y = b.trades[i];
+        if (x.timestamp != y.timestamp || x.signal != y.signal || x.price != y.price ||
+            x.quantity != y.quantity || x.pnl != y.pnl) {
+            return false;
+        }
+    }
+    return a.equity_curve == b.equity_curve && a.timestamps == b.timestamps &&
+           a.final_equity == b.final_equity && a.final_capital == b.final_capital &&
+           a.total_return == b.total_return && a.total_trades == b.total_trades &&
+           a.winning_trades == b.winning_trades && a.losing_trades == b.losing_trades &&
+           a.equity_stats.count() == b.equity_stats.count() &&
+           a.equity_stats.max_drawdown() == b.equity_stats.max_drawdown() &&
+           std::abs(a.equity_stats.sharpe_ratio() - b.equity_stats.sharpe_ratio()) < 1e-9;
+}
+
+static bool near(double a, double b, double tolerance) {
+    return std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+}
+
+static bool same_statistics(const analysis::EquityStatistics& a, const analysis::EquityStatistics& b, double tolerance) {
+    return a.count() == b.count() && a.return_count() == b.return_count() &&
+           a.first_timestamp() == b.first_timestamp() && a.last_timestamp() == b.last_timestamp() &&
+           a.last_equity() == b.last_equity() && a.peak() == b.peak() &&
+           a.max_drawdown() == b.max_drawdown() &&
+           near(a.mean_return(), b.mean_return(), tolerance) &&
+           near(a.volatility(), b.volatility(), tolerance) &&
+           near(a.downside_deviation(), b.downside_deviation(), tolerance) &&
+           near(a.sharpe_ratio(), b.sharpe_ratio(), tolerance) &&
+           near(a.sortino_ratio(), b.sortino_ratio(), tolerance);
+}
+
+int main() {
+    std::cout << "========== 向量化回测测试 ==========\n" << std::endl;
+
+    // 1. 与事件驱动引擎运行 MACrossStrategy 的结果一致（含手续费与滑点）
+    {
+        OHLCVSeries data(make_bars(20000, 3));
+        std::vector<double> closes;
+        for (size_t i = 0; i < data.size(); i++) closes.push_back(data[i].close);
+        strategy::MACrossConfig ma_config;
+        std::vector<double> targets = ma_cross_targets(closes, ma_config);
+
+        const std::vector<std::pair<EquityRecordMode, std::string>> modes = {
+            {EquityRecordMode::FULL, "FULL"},
+            {EquityRecordMode::NONE, "NONE"},
+        };
+        for (const auto& mode : modes) {
+            BacktestConfig config;
+            config.commission_rate = 0.002;
+            config.slippage_rate = 0.0005;
+            config.record_mode = mode.first;
+
+            strategy::MACrossStrategy strategy(ma_config);
+            BacktestEngine engine(config);
+            engine.set_strategy(&strategy);
+            engine.set_data(data);
+            engine.run();
+            const BacktestResult& expected = engine.get_result();
+
+            BacktestResult vectorized = VectorizedBacktest(config).run(data, targets);
+            check(expected.total_trades > 20 && expected.winning_trades > 0 && expected.losing_trades > 0,
+                  mode.second + "：事件驱动引擎产生了盈利和亏损交易");
+            check(same_result(vectorized, expected), mode.second + "：交易、权益曲线与统计量与 BacktestEngine 一致");
+        }
+        BacktestConfig full;
+        full.record_mode = EquityRecordMode::FULL;
+        check(VectorizedBacktest(full).run(data, targets).equity_curve.size() == data.size() + 1,
+              "FULL：初始资金加每根K线一个权益点");
+    }
+
+    // 2. 输入校验与空输入
+    {
+        BacktestConfig config;
+        VectorizedBacktest backtest(config);
+        bool threw = false;
+        try {
+            backtest.run({1.0, 2.0}, {1.0}, {0, 1});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        check(threw, "长度不一致：抛出 invalid_argument");
+        BacktestResult empty = backtest.run({}, {}, {});
+        check(empty.total_trades == 0 && empty.equity_curve.empty(), "空输入：没有交易和权益点");
+    }
+
+    // 3. update_batch（分块矩 + Chan 合并）与逐点 update 一致
+    {
+        const size_t n = 100000;
+        std::mt19937 rng(9);
+        std::normal_distribution<double> noise(0.0, 0.002);
+        std::vector<Timestamp> timestamps(n);
+        std::vector<double> equity(n);
+        double value = 10000.0;
+        for (size_t i = 0; i < n; i++) {
+            timestamps[i] = static_cast<Timestamp>(i) * 60000;
+            value *= std::exp(noise(rng));
+            equity[i] = value;
+        }
+        // 一段非正权益：对应的块退回逐点计算
+        for (size_t i = 50000; i < 50010; i++) equity[i] = i % 2 == 0 ? 0.0 : -5.0;
+
+        analysis::EquityStatistics expected;
+        for (size_t i = 0; i < n; i++) expected.update(timestamps[i], equity[i]);
+
+        // 相对误差上限：10 万个收益率的分块求和与逐点 Welford 的舍入差异远小于此
+        const double tolerance = 1e-10;
+        for (size_t batch : {size_t(1), size_t(7), size_t(1024), size_t(5000), n}) {
+            analysis::EquityStatistics batched;
+            for (size_t begin = 0; begin < n; begin += batch) {
+                batched.update_batch(timestamps.data() + begin, equity.data() + begin, std::min(batch, n - begin));
+            }
+            check(same_statistics(batched, expected, tolerance),
+                  "update_batch（每批 " + std::to_string(batch) + " 点）与逐点 update 一致（相对误差 ≤ 1e-10）");
+        }
+    }
+
+    // 4. 吞吐量（单核，只输出不断言；持仓每 500 根K线翻转一次）
+    {
+        const size_t n = 10000000;
+        std::mt19937 rng(1);
+        std::normal_distribution<double> noise(0.0, 0.001);
+        std::vector<double> closes(n);
+        std::vector<double> targets(n);
+        std::vector<Timestamp> timestamps(n);
+        double price = 100.0;
+        for (size_t i = 0; i < n; i++) {
+            price *= std::exp(noise(rng));
+            closes[i] = price;
+            timestamps[i] = static_cast<Timestamp>(i) * 60000;
+            targets[i] = (i / 500) % 2 == 0 ? 1.0 : 0.0;
+        }
+        for (EquityRecordMode mode : {EquityRecordMode::FULL, EquityRecordMode::NONE}) {
+            BacktestConfig config;
+            config.record_mode = mode;
+            VectorizedBacktest backtest(config);
+            auto start = std::chrono::steady_clock::now();
+            BacktestResult result = backtest.run(closes, targets, timestamps);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "   吞吐量（" << (mode == EquityRecordMode::FULL ? "FULL" : "NONE") << "）: "
+                      << static_cast<long long>(n / seconds / 1e6) << "M Bar/秒，交易 "
+                      << result.total_trades << " 笔" << std::endl;
+        }
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include "backtest/vectorized_backtest.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace quant_crypto {
+namespace backtest {
+
+VectorizedBacktest::VectorizedBacktest(const BacktestConfig& config)
+    : config_(config) {}
+
+BacktestResult VectorizedBacktest::run(
+    const std::vector<double>& closes,
+    const std::vector<double>& target_positions,
+    const std::vector<Timestamp>& timestamps,
+    const std::string& symbol
+) const {
+    if (closes.size() != target_positions.size() || closes.size() != timestamps.size()) {
+        throw std::invalid_argument("VectorizedBacktest: closes/target_positions/timestamps 长度不一致");
+    }
+    return run_impl(closes.data(), target_positions.data(), timestamps.data(), closes.size(), symbol);
+}
+
+BacktestResult VectorizedBacktest::run(
+    const OHLCVSeries& data,
+    const std::vector<double>& target_positions
+) const {
+    if (data.size() != target_positions.size()) {
+        throw std::invalid_argument("VectorizedBacktest: data/target_positions 长度不一致");
+    }
+    std::vector<double> closes(data.size());
+    std::vector<Timestamp> timestamps(data.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        closes[i] = data[i].close;
+        timestamps[i] = data[i].timestamp;
+    }
+    std::string symbol = data.empty() ? "" : data.front().symbol;
+    return run_impl(closes.data(), target_positions.data(), timestamps.data(), data.size(), symbol);
+}
+
+BacktestResult VectorizedBacktest::run_impl(
+    const double* closes,
+    const double* target_positions,
+    const Timestamp* timestamps,
+    size_t n,
+    const std::string& symbol
+) const {
+    BacktestResult result;
+    result.initial_capital = config_.initial_capital;
+    if (n == 0) return result;
+
+    EquityRecorder recorder(config_.record_mode, config_.record_interval);
+    recorder.begin(result, timestamps[0], config_.initial_capital, n);
+
+    // 1. 找出持仓翻转点（只有这些Bar需要结算交易）
+    std::vector<size_t> flips;
+    bool held = false;
+    for (size_t i = 0; i < n; i++) {
+        bool want = target_positions[i] > 0;
+        if (want != held) {
+            flips.push_back(i);
+            held = want;
+        }
+    }
+
+    // 2. 逐段结算：翻转点上成交，段内批量计算权益
+    constexpr size_t CHUNK = 4096;
+    std::vector<double> equity(std::min(n, CHUNK));
+
+    double capital = config_.initial_capital;
+    double quantity = 0.0;
+    double avg_price = 0.0;
+
+    size_t next_flip = 0;
+    size_t seg_start = 0;
+    while (seg_start < n) {
+        bool changed = false;
+        if (next_flip < flips.size() && flips[next_flip] == seg_start) {
+            // 与 BacktestEngine::process_signal 相同的成交口径
+            double close = closes[seg_start];
+            strategy::Trade trade;
+            trade.timestamp = timestamps[seg_start];
+            trade.symbol = symbol;
+            if (quantity == 0.0) {
+                double actual_price = close + close * config_.slippage_rate;
+                double buy_amount = capital * config_.position_size;
+                double commission = buy_amount * config_.commission_rate;
+                quantity = (buy_amount - commission) / actual_price;
+                avg_price = actual_price;
+                capital -= quantity * actual_price;
+
+                trade.signal = strategy::Signal::BUY;
+                trade.price = actual_price;
+                trade.quantity = quantity;
+                trade.pnl = 0;
+            } else {
+                double actual_price = close - close * config_.slippage_rate;
+                double pnl = (actual_price - avg_price) * quantity;
+                capital += actual_price * quantity;
+                double commission = actual_price * quantity * config_.commission_rate;
+                pnl -= commission;
+                quantity = 0.0;
+                avg_price = 0.0;
+
+                trade.signal = strategy::Signal::SELL;
+                trade.price = actual_price;
+                trade.quantity = 0;
+                trade.pnl = pnl;
+                if (pnl > 0) {
+                    result.winning_trades++;
+                } else if (pnl < 0) {
+                    result.losing_trades++;
+                }
+            }
+            result.trades.push_back(trade);
+            result.total_trades++;
+            changed = true;
+            next_flip++;
+        }
+
+        size_t seg_end = next_flip < flips.size() ? flips[next_flip] : n;
+
+        // 段内权益 = 现金 + 数量 × 收盘价（空仓时数量为0）
+        for (size_t begin = seg_start; begin < seg_end; begin += CHUNK) {
+            size_t m = std::min(CHUNK, seg_end - begin);
+            const double* close = closes + begin;
+            double* out = equity.data();
+            for (size_t j = 0; j < m; j++) {
+                out[j] = capital + quantity * close[j];
+            }
+            recorder.record_batch(result, timestamps + begin, out, m, changed && begin == seg_start);
+        }
+        seg_start = seg_end;
+    }
+    recorder.finish(result);
+
+    // 3. 汇总结果
+    result.final_capital = capital;
+    result.final_equity = capital + quantity * closes[n - 1];
+    result.total_return = (result.final_equity - config_.initial_capital) / config_.initial_capital * 100.0;
+    return result;
+}
+
+} // namespace backtest
+} // namespace quant_crypto
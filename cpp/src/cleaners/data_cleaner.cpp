@@ -1,8 +1,8 @@
 #include "cleaners/data_cleaner.h"
 #include <algorithm>
 #include <cmath>
-#include <unordered_set>
-#include <numeric>
+#include <stdexcept>
+#include <string_view>
 
 namespace quant_crypto {
 namespace cleaners {
@@ -13,31 +13,187 @@ DataCleaner::DataCleaner() {
     add_rule(std::make_shared<OHLCRelationRule>());
 }
 
+void CleaningContext::reset() {
+    for (auto& state : states_) {
+        if (state) state->reset();
+    }
+}
+
 void DataCleaner::add_rule(std::shared_ptr<CleaningRule> rule) {
     rules_.push_back(rule);
 }
 
+CleaningContext DataCleaner::create_context() const {
+    CleaningContext context;
+    prepare(context);
+    return context;
+}
+
+void DataCleaner::prepare(CleaningContext& context) const {
+    // 上下文创建后新增的规则在这里补上状态
+    while (context.states_.size() < rules_.size()) {
+        context.states_.push_back(rules_[context.states_.size()]->create_state());
+    }
+}
+
+bool DataCleaner::apply_rules(OHLCV& data, CleaningContext& context) const {
+    for (size_t i = 0; i < rules_.size(); i++) {
+        if (!rules_[i]->apply(data, context.states_[i].get())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DataCleaner::StreamContext& DataCleaner::stream_context(const Exchange& exchange, const Symbol& symbol,
+                                                       Timeframe timeframe) const {
+    int tf = static_cast<int>(timeframe);
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    // 用引用元组查找，命中时不构造字符串
+    auto it = streams_.find(std::tie(exchange, symbol, tf));
+    if (it == streams_.end()) {
+        it = streams_.emplace(StreamKey(exchange, symbol, tf), std::make_unique<StreamContext>()).first;
+    }
+    return *it->second;
+}
+
+void DataCleaner::reset_streams() {
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    streams_.clear();
+}
+
+size_t DataCleaner::stream_count() const {
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    return streams_.size();
+}
+
 DataQuality DataCleaner::clean_ohlcv(OHLCV& data) const {
-    for (const auto& rule : rules_) {
-        if (!rule->apply(data)) {
-            return DataQuality::BAD;
+    StreamContext& stream = stream_context(data.exchange, data.symbol, data.timeframe);
+    std::lock_guard<std::mutex> lock(stream.mutex);
+    return clean_ohlcv(data, stream.context);
+}
+
+DataQuality DataCleaner::clean_ohlcv(OHLCV& data, CleaningContext& context) const {
+    prepare(context);
+    return apply_rules(data, context) ? DataQuality::GOOD : DataQuality::BAD;
+}
+
+bool DataCleaner::mask_columns(OHLCVColumns& columns, CleaningContext& context,
+                               uint8_t* keep, uint8_t* suspicious) const {
+    size_t n = columns.size();
+    bool columnar = true;
+    std::fill(keep, keep + n, static_cast<uint8_t>(1));
+    std::fill(suspicious, suspicious + n, static_cast<uint8_t>(0));
+
+    for (size_t r = 0; r < rules_.size(); r++) {
+        const CleaningRule& rule = *rules_[r];
+        RuleState* state = context.states_[r].get();
+        if (rule.apply_columns(columns, keep, suspicious, state)) continue;
+
+        // 不支持列式计算的规则：逐行调用，规则对K线的修改写回列
+        columnar = false;
+        for (size_t i = 0; i < n; i++) {
+            if (!keep[i]) continue;
+            if (suspicious[i]) columns.quality[i] = DataQuality::SUSPICIOUS;
+            OHLCV bar = columns.row(i);
+            if (!rule.apply(bar, state)) {
+                keep[i] = 0;
+                continue;
+            }
+            columns.set(i, bar);
         }
     }
-    return DataQuality::GOOD;
 
+    for (size_t i = 0; i < n; i++) {
+        if (suspicious[i]) columns.quality[i] = DataQuality::SUSPICIOUS;
+    }
+    return columnar;
+}
+
+std::vector<uint8_t> DataCleaner::validity_mask(OHLCVColumns& columns, CleaningContext& context) const {
+    // 规则按 size() 逐列读写，各列长度必须相同
+    if (!columns.consistent()) {
+        throw std::invalid_argument("DataCleaner: 各列长度不一致");
+    }
+    prepare(context);
+    std::vector<uint8_t> keep(columns.size());
+    std::vector<uint8_t> suspicious(columns.size());
+    mask_columns(columns, context, keep.data(), suspicious.data());
+    return keep;
+}
+
+size_t DataCleaner::clean_columns(OHLCVColumns& columns, CleaningContext& context) const {
+    std::vector<uint8_t> keep = validity_mask(columns, context);
+    return columns.compact(keep.data());
+}
+
+size_t DataCleaner::clean_columns(OHLCVColumns& columns) const {
+    StreamContext& stream = stream_context(columns.exchange, columns.symbol, columns.timeframe);
+    std::lock_guard<std::mutex> lock(stream.mutex);
+    return clean_columns(columns, stream.context);
+}
+
+void DataCleaner::clean_rows(const OHLCV* rows, size_t n, CleaningContext& context,
+                             std::vector<OHLCV>& cleaned_data) const {
+    prepare(context);
+
+    // 分块转为列式，块内数据留在缓存中
+    const size_t CHUNK = 16384;
+    OHLCVColumns columns;
+    std::vector<uint8_t> keep;
+    std::vector<uint8_t> suspicious;
+    for (size_t begin = 0; begin < n; begin += CHUNK) {
+        size_t m = std::min(CHUNK, n - begin);
+        columns.assign(rows + begin, m);
+        keep.resize(m);
+        suspicious.resize(m);
+        // 规则都支持列式计算时，保留的K线直接从输入复制，只需改写质量标志；
+        // 否则规则可能修改了数值字段，从列写回（交易对等字段仍取自输入行，
+        // 输入可能混有多个数据流，列只记录了块内第一根K线的）
+        bool columnar = mask_columns(columns, context, keep.data(), suspicious.data());
+
+        for (size_t i = 0; i < m; i++) {
+            if (!keep[i]) continue;
+            cleaned_data.push_back(rows[begin + i]);
+            if (columnar) {
+                cleaned_data.back().quality = columns.quality[i];
+            } else {
+                columns.get(i, cleaned_data.back());
+            }
+        }
+    }
 }
 
 std::vector<OHLCV> DataCleaner::clean_ohlcv_batch(const std::vector<OHLCV>& data_list) const {
     std::vector<OHLCV> cleaned_data;
     cleaned_data.reserve(data_list.size());
-    
-    for (auto data : data_list) {
-        DataQuality quality = clean_ohlcv(data);
-        if (quality == DataQuality::GOOD) {
-            cleaned_data.push_back(data);
+
+    // 按连续属于同一数据流的区间处理，每个区间只查找、锁定一次上下文
+    size_t begin = 0;
+    while (begin < data_list.size()) {
+        const OHLCV& first = data_list[begin];
+        size_t end = begin + 1;
+        while (end < data_list.size() &&
+               data_list[end].timeframe == first.timeframe &&
+               data_list[end].symbol == first.symbol &&
+               data_list[end].exchange == first.exchange) {
+            end++;
         }
+
+        StreamContext& stream = stream_context(first.exchange, first.symbol, first.timeframe);
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        clean_rows(data_list.data() + begin, end - begin, stream.context, cleaned_data);
+        begin = end;
     }
-    
+
+    return cleaned_data;
+}
+
+std::vector<OHLCV> DataCleaner::clean_ohlcv_batch(const std::vector<OHLCV>& data_list,
+                                                  CleaningContext& context) const {
+    std::vector<OHLCV> cleaned_data;
+    cleaned_data.reserve(data_list.size());
+    clean_rows(data_list.data(), data_list.size(), context, cleaned_data);
     return cleaned_data;
 }
 
@@ -81,19 +237,121 @@ bool DataCleaner::is_timestamp_continuous(
 }
 
 std::vector<OHLCV> DataCleaner::deduplicate(const std::vector<OHLCV>& data_list) {
+    return deduplicate(data_list, DuplicatePolicy::KEEP_FIRST);
+}
+
+namespace {
+
+const uint32_t EMPTY_ROW = UINT32_MAX;
+
+/**
+ * 开放寻址（线性探测）哈希表：(数据流编号, 时间戳) -> 输出行号
+ * 容量为2的幂且不少于元素数的2倍，槽位16字节，不存在删除操作。
+ */
+class DuplicateIndex {
+public:
+    explicit DuplicateIndex(size_t rows) {
+        size_t capacity = 16;
+        while (capacity < rows * 2) capacity <<= 1;
+        slots_.resize(capacity);
+        mask_ = capacity - 1;
+    }
+
+    // 查找键，不存在时以 row 插入；返回已有的行号或 EMPTY_ROW
+    uint32_t find_or_insert(uint32_t stream, Timestamp timestamp, uint32_t row) {
+        size_t i = hash(stream, timestamp) & mask_;
+        while (true) {
+            Slot& slot = slots_[i];
+            if (slot.row == EMPTY_ROW) {
+                slot.timestamp = timestamp;
+                slot.stream = stream;
+                slot.row = row;
+                return EMPTY_ROW;
+            }
+            if (slot.timestamp == timestamp && slot.stream == stream) return slot.row;
+            i = (i + 1) & mask_;
+        }
+    }
+
+private:
+    struct Slot {
+        Timestamp timestamp = 0;
+        uint32_t stream = 0;
+        uint32_t row = EMPTY_ROW;
+    };
+
+    // splitmix64 的混合函数：相邻时间戳也能均匀分布
+    static size_t hash(uint32_t stream, Timestamp timestamp) {
+        uint64_t x = static_cast<uint64_t>(timestamp) ^ (static_cast<uint64_t>(stream) << 48);
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return static_cast<size_t>(x ^ (x >> 31));
+    }
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+};
+
+} // namespace
+
+std::vector<OHLCV> DataCleaner::deduplicate(const std::vector<OHLCV>& data_list, DuplicatePolicy policy) {
+    size_t n = data_list.size();
+    if (n >= EMPTY_ROW) {
+        throw std::length_error("DataCleaner: 去重数据过多");
+    }
+
+    // 交易所/交易对 -> 编号；连续的K线通常属于同一数据流，先与上一行比较
+    std::map<std::pair<std::string_view, std::string_view>, uint32_t> stream_ids;
+    std::vector<uint32_t> streams(n);
+    std::vector<Timestamp> last_timestamp;
+    bool sorted = true;
+    for (size_t i = 0; i < n; i++) {
+        const OHLCV& data = data_list[i];
+        uint32_t id;
+        if (i > 0 && data.exchange == data_list[i - 1].exchange && data.symbol == data_list[i - 1].symbol) {
+            id = streams[i - 1];
+        } else {
+            auto inserted = stream_ids.emplace(std::make_pair(std::string_view(data.exchange),
+                                                              std::string_view(data.symbol)),
+                                               static_cast<uint32_t>(stream_ids.size()));
+            id = inserted.first->second;
+            if (inserted.second) last_timestamp.push_back(data.timestamp);
+        }
+        streams[i] = id;
+        sorted = sorted && data.timestamp >= last_timestamp[id];
+        last_timestamp[id] = data.timestamp;
+    }
+
     std::vector<OHLCV> result;
-    std::unordered_set<std::string> seen;
-    
-    for (const auto& data : data_list) {
-        std::string key = std::to_string(data.timestamp) + "_" + 
-                         data.symbol + "_" + data.exchange;
-        
-        if (seen.find(key) == seen.end()) {
-            seen.insert(key);
-            result.push_back(data);
+    result.reserve(n);
+    auto keep = [&](size_t i, uint32_t existing) {
+        if (existing == EMPTY_ROW) {
+            result.push_back(data_list[i]);
+        } else if (policy == DuplicatePolicy::KEEP_LAST) {
+            result[existing] = data_list[i];
+        }
+    };
+
+    if (sorted) {
+        // 流内时间戳非递减：重复行在流内相邻，只需记住每个流上一行的输出位置
+        std::vector<uint32_t> last_row(stream_ids.size(), EMPTY_ROW);
+        for (size_t i = 0; i < n; i++) {
+            uint32_t id = streams[i];
+            uint32_t previous = last_row[id];
+            bool duplicate = previous != EMPTY_ROW && result[previous].timestamp == data_list[i].timestamp;
+            keep(i, duplicate ? previous : EMPTY_ROW);
+            if (!duplicate) last_row[id] = static_cast<uint32_t>(result.size() - 1);
+        }
+    } else {
+        DuplicateIndex index(n);
+        for (size_t i = 0; i < n; i++) {
+            uint32_t existing = index.find_or_insert(streams[i], data_list[i].timestamp,
+                                                     static_cast<uint32_t>(result.size()));
+            keep(i, existing);
         }
     }
-    
+
     return result;
 }
 
@@ -101,17 +359,107 @@ std::vector<OHLCV> DataCleaner::fill_missing(
     const std::vector<OHLCV>& data_list,
     Timeframe timeframe,
     const std::string& method) {
-    
-    if (data_list.empty()) return data_list;
-    
-    std::vector<OHLCV> result = data_list;
+    return fill_missing(data_list, timeframe, fill_method_from_string(method));
+}
+
+FillMethod DataCleaner::fill_method_from_string(const std::string& method) {
+    if (method == "forward") return FillMethod::FORWARD;
+    if (method == "backward") return FillMethod::BACKWARD;
+    if (method == "interpolate") return FillMethod::INTERPOLATE;
+    throw std::invalid_argument("DataCleaner: 未知的填补方法 " + method);
+}
+
+GapReport DataCleaner::find_gaps(
+    const std::vector<OHLCV>& data_list,
+    Timeframe timeframe,
+    size_t max_gap_bars) {
+
     int64_t interval = timeframe_to_milliseconds(timeframe);
-    
-    // 简单的前向填充
-    if (method == "forward") {
-        // TODO: 实现前向填充逻辑
+    if (interval <= 0) {
+        throw std::invalid_argument("DataCleaner: 无效的时间周期");
     }
-    
+
+    GapReport report;
+    for (size_t i = 1; i < data_list.size(); i++) {
+        int64_t delta = data_list[i].timestamp - data_list[i - 1].timestamp;
+        if (delta <= interval) continue;
+
+        // 按周期四舍五入，时间戳的少量抖动不会产生缺口
+        size_t missing = static_cast<size_t>((delta + interval / 2) / interval) - 1;
+        if (missing == 0) continue;
+
+        DataGap gap;
+        gap.start = data_list[i - 1].timestamp;
+        gap.end = data_list[i].timestamp;
+        gap.index = i;
+        gap.missing_bars = missing;
+        gap.filled = max_gap_bars == 0 || missing <= max_gap_bars;
+
+        report.missing_bars += missing;
+        if (gap.filled) report.filled_bars += missing;
+        report.max_gap_ms = std::max(report.max_gap_ms, delta);
+        report.gaps.push_back(gap);
+    }
+    return report;
+}
+
+namespace {
+
+// 在 before 与 after 之间追加 count 根缺失K线
+void append_missing_bars(std::vector<OHLCV>& out, const OHLCV& before, const OHLCV& after,
+                         size_t count, int64_t interval, Timeframe timeframe, FillMethod method) {
+    OHLCV bar = before;
+    bar.timeframe = timeframe;
+    bar.volume = 0.0;
+    bar.quote_volume = 0.0;
+    bar.trades_count = 0;
+    bar.quality = DataQuality::MISSING;
+
+    Price from = method == FillMethod::BACKWARD ? after.open : before.close;
+    Price step = method == FillMethod::INTERPOLATE
+        ? (after.open - before.close) / static_cast<double>(count + 1)
+        : 0.0;
+
+    // 插值时每根K线的开盘价接上一根的收盘价，保持价格连续
+    Price open = from;
+    for (size_t k = 1; k <= count; k++) {
+        Price close = from + step * static_cast<double>(k);
+        bar.timestamp = before.timestamp + static_cast<int64_t>(k) * interval;
+        bar.open = open;
+        bar.close = close;
+        bar.high = std::max(open, close);
+        bar.low = std::min(open, close);
+        out.push_back(bar);
+        open = close;
+    }
+}
+
+} // namespace
+
+std::vector<OHLCV> DataCleaner::fill_missing(
+    const std::vector<OHLCV>& data_list,
+    Timeframe timeframe,
+    FillMethod method,
+    GapReport* report,
+    size_t max_gap_bars) {
+
+    GapReport gaps = find_gaps(data_list, timeframe, max_gap_bars);
+    int64_t interval = timeframe_to_milliseconds(timeframe);
+
+    // 输出大小已知，一次分配；数据按缺口分段整体复制
+    std::vector<OHLCV> result;
+    result.reserve(data_list.size() + gaps.filled_bars);
+    size_t copied = 0;
+    for (const DataGap& gap : gaps.gaps) {
+        if (!gap.filled) continue;
+        result.insert(result.end(), data_list.begin() + copied, data_list.begin() + gap.index);
+        append_missing_bars(result, data_list[gap.index - 1], data_list[gap.index],
+                            gap.missing_bars, interval, timeframe, method);
+        copied = gap.index;
+    }
+    result.insert(result.end(), data_list.begin() + copied, data_list.end());
+
+    if (report) *report = std::move(gaps);
     return result;
 }
 
@@ -121,28 +469,140 @@ bool PriceValidityRule::apply(OHLCV& data) const {
     return data.open > 0 && data.high > 0 && data.low > 0 && data.close > 0;
 }
 
+bool PriceValidityRule::apply_columns(const OHLCVColumns& columns, uint8_t* keep, uint8_t* suspicious,
+                                      RuleState* state) const {
+    (void)suspicious;
+    (void)state;
+    const Price* open = columns.open.data();
+    const Price* high = columns.high.data();
+    const Price* low = columns.low.data();
+    const Price* close = columns.close.data();
+    size_t n = columns.size();
+    // 按位与代替短路求值，循环无分支，可向量化
+    for (size_t i = 0; i < n; i++) {
+        keep[i] &= static_cast<uint8_t>((open[i] > 0) & (high[i] > 0) & (low[i] > 0) & (close[i] > 0));
+    }
+    return true;
+}
+
+namespace {
+
+struct PriceJumpState : public RuleState {
+    Price last_close = 0.0;
+    void reset() override { last_close = 0.0; }
+};
+
+struct VolumeAnomalyState : public RuleState {
+    RingBuffer<Volume> history;
+    double sum = 0.0;
+    size_t evicted = 0;     // 上次重新求和后移出的个数
+
+    explicit VolumeAnomalyState(size_t window) : history(window) {}
+
+    void reset() override {
+        history.clear();
+        sum = 0.0;
+        evicted = 0;
+    }
+
+    void push(Volume volume) {
+        Volume old;
+        if (history.push(volume, &old)) {
+            sum -= old;
+            evicted++;
+        }
+        sum += volume;
+        // 每移出一个窗口长度的数据重新求和，消除加减累积的舍入误差
+        if (evicted >= history.capacity()) {
+            sum = 0.0;
+            history.for_each([this](Volume v) { sum += v; });
+            evicted = 0;
+        }
+    }
+};
+
+} // namespace
+
 bool PriceJumpRule::apply(OHLCV& data) const {
-    if (last_close_ > 0) {
-        if (DataCleaner::detect_price_jump(data.close, last_close_, threshold_)) {
+    (void)data;
+    return true;
+}
+
+std::unique_ptr<RuleState> PriceJumpRule::create_state() const {
+    return std::make_unique<PriceJumpState>();
+}
+
+bool PriceJumpRule::apply(OHLCV& data, RuleState* state) const {
+    if (!state) return apply(data);
+    PriceJumpState& s = static_cast<PriceJumpState&>(*state);
+    if (s.last_close > 0) {
+        if (DataCleaner::detect_price_jump(data.close, s.last_close, threshold_)) {
             data.quality = DataQuality::SUSPICIOUS;
         }
     }
-    last_close_ = data.close;
+    s.last_close = data.close;
     return true;
 }
 
-bool VolumeAnomalyRule::apply(OHLCV& data) const {
-    volume_history_.push_back(data.volume);
-    
-    if (volume_history_.size() > HISTORY_SIZE) {
-        volume_history_.erase(volume_history_.begin());
+bool PriceJumpRule::apply_columns(const OHLCVColumns& columns, uint8_t* keep, uint8_t* suspicious,
+                                  RuleState* state) const {
+    if (!state) return false;
+    PriceJumpState& s = static_cast<PriceJumpState&>(*state);
+    size_t n = columns.size();
+    if (n == 0) return true;
+    const Price* close = columns.close.data();
+
+    size_t kept = 0;
+    for (size_t i = 0; i < n; i++) kept += keep[i];
+
+    if (kept == n) {
+        // 全部保留（历史数据的常见情况）：前一根K线就是 i - 1，逐元素比较可向量化
+        if (s.last_close > 0 && DataCleaner::detect_price_jump(close[0], s.last_close, threshold_)) {
+            suspicious[0] = 1;
+        }
+        for (size_t i = 1; i < n; i++) {
+            Price previous = close[i - 1];
+            suspicious[i] |= static_cast<uint8_t>(
+                (previous > 0) & (std::abs((close[i] - previous) / previous) > threshold_));
+        }
+        s.last_close = close[n - 1];
+        return true;
     }
-    
-    if (volume_history_.size() >= 10) {
-        double avg_volume = std::accumulate(volume_history_.begin(), 
-                                           volume_history_.end(), 0.0) / 
-                           volume_history_.size();
-        
+
+    // 有被剔除的K线：只与前一根保留的K线比较
+    for (size_t i = 0; i < n; i++) {
+        if (!keep[i]) continue;
+        if (s.last_close > 0 && DataCleaner::detect_price_jump(close[i], s.last_close, threshold_)) {
+            suspicious[i] = 1;
+        }
+        s.last_close = close[i];
+    }
+    return true;
+}
+
+VolumeAnomalyRule::VolumeAnomalyRule(double threshold, size_t window, size_t min_samples)
+    : threshold_(threshold), window_(window), min_samples_(min_samples) {
+    if (window_ == 0) {
+        throw std::invalid_argument("VolumeAnomalyRule: window 必须大于0");
+    }
+}
+
+bool VolumeAnomalyRule::apply(OHLCV& data) const {
+    (void)data;
+    return true;
+}
+
+std::unique_ptr<RuleState> VolumeAnomalyRule::create_state() const {
+    return std::make_unique<VolumeAnomalyState>(window_);
+}
+
+bool VolumeAnomalyRule::apply(OHLCV& data, RuleState* state) const {
+    if (!state) return apply(data);
+    VolumeAnomalyState& s = static_cast<VolumeAnomalyState&>(*state);
+    s.push(data.volume);
+
+    if (s.history.size() >= min_samples_) {
+        double avg_volume = s.sum / static_cast<double>(s.history.size());
         if (DataCleaner::detect_volume_anomaly(data.volume, avg_volume, threshold_)) {
             data.quality = DataQuality::SUSPICIOUS;
         }
@@ -151,6 +611,109 @@ bool VolumeAnomalyRule::apply(OHLCV& data) const {
     return true;
 }
 
+bool VolumeAnomalyRule::apply_columns(const OHLCVColumns& columns, uint8_t* keep, uint8_t* suspicious,
+                                      RuleState* state) const {
+    if (!state) return false;
+    VolumeAnomalyState& s = static_cast<VolumeAnomalyState&>(*state);
+    const Volume* volume = columns.volume.data();
+    size_t n = columns.size();
+    // 滑动和依赖前一根K线，逐行计算，每行 O(1)
+    for (size_t i = 0; i < n; i++) {
+        if (!keep[i]) continue;
+        s.push(volume[i]);
+        if (s.history.size() >= min_samples_) {
+            double avg_volume = s.sum / static_cast<double>(s.history.size());
+            if (DataCleaner::detect_volume_anomaly(volume[i], avg_volume, threshold_)) {
+                suspicious[i] = 1;
+            }
+        }
+    }
+    return true;
+}
+
+namespace {
+
+// 正态分布下 MAD 与标准差的换算系数
+const double MAD_TO_SIGMA = 1.4826;
+
+struct RobustOutlierState : public RuleState {
+    RollingMedian window;
+    Price last_close = 0.0;
+
+    explicit RobustOutlierState(size_t size) : window(size) {}
+
+    void reset() override {
+        window.clear();
+        last_close = 0.0;
+    }
+};
+
+} // namespace
+
+RobustOutlierRule::RobustOutlierRule(OutlierTarget target, size_t window, double threshold, size_t min_samples)
+    : target_(target), window_(window), threshold_(threshold), min_samples_(min_samples) {
+    if (window_ == 0) {
+        throw std::invalid_argument("RobustOutlierRule: window 必须大于0");
+    }
+}
+
+bool RobustOutlierRule::apply(OHLCV& data) const {
+    (void)data;
+    return true;
+}
+
+std::unique_ptr<RuleState> RobustOutlierRule::create_state() const {
+    return std::make_unique<RobustOutlierState>(window_);
+}
+
+bool RobustOutlierRule::observe(RuleState& state, Price close, Volume volume) const {
+    RobustOutlierState& s = static_cast<RobustOutlierState&>(state);
+
+    double value;
+    if (target_ == OutlierTarget::LOG_RETURN) {
+        if (!(close > 0)) return false;
+        Price previous = s.last_close;
+        s.last_close = close;
+        if (previous <= 0) return false;
+        value = std::log(close / previous);
+    } else {
+        value = volume;
+    }
+    if (!std::isfinite(value)) return false;
+
+    // 先用不含当前值的窗口判断，再放入窗口
+    bool outlier = false;
+    if (s.window.size() >= min_samples_) {
+        double deviation = std::abs(value - s.window.median());
+        double scale = MAD_TO_SIGMA * s.window.mad();
+        outlier = scale > 0 && deviation > threshold_ * scale;
+    }
+    s.window.push(value);
+    return outlier;
+}
+
+bool RobustOutlierRule::apply(OHLCV& data, RuleState* state) const {
+    if (!state) return apply(data);
+    if (observe(*state, data.close, data.volume)) {
+        data.quality = DataQuality::SUSPICIOUS;
+    }
+    return true;
+}
+
+bool RobustOutlierRule::apply_columns(const OHLCVColumns& columns, uint8_t* keep, uint8_t* suspicious,
+                                      RuleState* state) const {
+    if (!state) return false;
+    const Price* close = columns.close.data();
+    const Volume* volume = columns.volume.data();
+    size_t n = columns.size();
+    // 窗口依赖之前保留的K线，逐行计算
+    for (size_t i = 0; i < n; i++) {
+        if (!keep[i]) continue;
+        suspicious[i] |= static_cast<uint8_t>(observe(*state, close[i], volume[i]));
+    }
+    return true;
+}
+
 bool OHLCRelationRule::apply(OHLCV& data) const {
     // 验证OHLC关系
     if (data.high < data.low) return false;
@@ -159,6 +722,23 @@ bool OHLCRelationRule::apply(OHLCV& data) const {
     return true;
 }
 
+bool OHLCRelationRule::apply_columns(const OHLCVColumns& columns, uint8_t* keep, uint8_t* suspicious,
+                                     RuleState* state) const {
+    (void)suspicious;
+    (void)state;
+    const Price* open = columns.open.data();
+    const Price* high = columns.high.data();
+    const Price* low = columns.low.data();
+    const Price* close = columns.close.data();
+    size_t n = columns.size();
+    // 与 apply 的判断相同（含 NaN 的处理），取反后按位与
+    for (size_t i = 0; i < n; i++) {
+        uint8_t bad = static_cast<uint8_t>((high[i] < low[i]) | (high[i] < open[i]) | (high[i] < close[i]) |
+                                           (low[i] > open[i]) | (low[i] > close[i]));
+        keep[i] &= static_cast<uint8_t>(bad ^ 1);
+    }
+    return true;
+}
+
 } // namespace cleaners
 } // namespace quant_crypto
-
@@ -0,0 +1,215 @@
+/**
+ * @file test_clean_columns.cpp
+ * @brief 列式批量清洗测试（离线）：clean_ohlcv_batch / clean_columns 与逐根清洗结果一致
+ */
+
+#include "cleaners/data_cleaner.h"
+#include "common/ohlcv_columns.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::cleaners;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+/**
+ * @brief 不支持列式计算的规则：成交量截断到上限，trades_count 为 7 的K线删除
+ *        （规则会修改K线，迫使清洗器逐行调用并从列写回）
+ */
+class ClampVolumeRule : public CleaningRule {
+public:
+    bool apply(OHLCV& data) const override {
+        if (data.volume > 500.0) data.volume = 500.0;
+        return data.trades_count != 7;
+    }
+    std::string get_name() const override { return "ClampVolumeRule"; }
+};
+
+/**
+ * @brief 随机K线：无效价格、OHLC关系错误、价格跳变、成交量尖峰各占约1%
+ */
+static std::vector<OHLCV> make_bars(size_t n, unsigned seed, const std::string& symbol = "BTCUSDT") {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<OHLCV> bars;
+    double price = 100.0;
+    for (size_t i = 0; i < n; i++) {
+        OHLCV bar;
+        bar.symbol = symbol;
+        bar.exchange = "binance";
+        bar.timestamp = static_cast<Timestamp>(i) * 60000;
+        price *= u(rng) < 0.01 ? 1.6 : 1.0 + 0.01 * (u(rng) - 0.5);
+        bar.open = price;
+        bar.close = price * (1.0 + 0.001 * (u(rng) - 0.5));
+        bar.high = std::max(bar.open, bar.close) * 1.001;
+        bar.low = std::min(bar.open, bar.close) * 0.999;
+        bar.volume = u(rng) < 0.01 ? 1000.0 : 10.0 * u(rng);
+        bar.trades_count = static_cast<int64_t>(u(rng) * 10);
+
+        double dirty = u(rng);
+        if (dirty < 0.01) {
+            bar.close = -1.0;
+        } else if (dirty < 0.015) {
+            bar.open = NAN;
+        } else if (dirty < 0.02) {
+            bar.low = 0.0;
+        } else if (dirty < 0.03) {
+            bar.high = bar.low * 0.5;
+        }
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+static std::shared_ptr<DataCleaner> make_cleaner(bool custom) {
+    auto cleaner = std::make_shared<DataCleaner>();
+    cleaner->add_rule(std::make_shared<PriceJumpRule>(0.3));
+    if (custom) cleaner->add_rule(std::make_shared<ClampVolumeRule>());
+    cleaner->add_rule(std::make_shared<VolumeAnomalyRule>(5.0));
+    return cleaner;
+}
+
+// 参照：逐根调用 clean_ohlcv，保留通过的K线
+static std::vector<OHLCV> clean_per_bar(const DataCleaner& cleaner, const std::vector<OHLCV>& bars) {
+    CleaningContext context = cleaner.create_context();
+    std::vector<OHLCV> kept;
+    for (OHLCV bar : bars) {
+        if (cleaner.clean_ohlcv(bar, context) == DataQuality::GOOD) kept.push_back(bar);
+    }
+    return kept;
+}
+
+static bool same_bars(const std::vector<OHLCV>& a, const std::vector<OHLCV>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].timestamp != b[i].timestamp || a[i].symbol != b[i].symbol ||
+            a[i].exchange != b[i].exchange || a[i].timeframe != b[i].timeframe ||
+            a[i].open != b[i].open || a[i].high != b[i].high || a[i].low != b[i].low ||
+            a[i].close != b[i].close || a[i].volume != b[i].volume ||
+            a[i].trades_count != b[i].trades_count || a[i].quality != b[i].quality) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static size_t count_quality(const std::vector<OHLCV>& bars, DataQuality quality) {
+    return static_cast<size_t>(std::count_if(bars.begin(), bars.end(),
+                                             [&](const OHLCV& bar) { return bar.quality == quality; }));
+}
+
+int main() {
+    std::cout << "========== 列式批量清洗测试 ==========\n" << std::endl;
+
+    // 1. 三种方式结果一致（跨过 16384 行的分块边界）；custom 为 true 时走逐行回退路径
+    for (bool custom : {false, true}) {
+        std::string label = custom ? "含自定义规则：" : "内置规则：";
+        auto cleaner = make_cleaner(custom);
+        std::vector<OHLCV> bars = make_bars(40000, custom ? 11 : 7);
+        std::vector<OHLCV> expected = clean_per_bar(*cleaner, bars);
+
+        CleaningContext batch_context = cleaner->create_context();
+        std::vector<OHLCV> batch = cleaner->clean_ohlcv_batch(bars, batch_context);
+
+        OHLCVColumns columns = OHLCVColumns::from_bars(bars);
+        CleaningContext columns_context = cleaner->create_context();
+        size_t kept = cleaner->clean_columns(columns, columns_context);
+
+        check(expected.size() < bars.size() && count_quality(expected, DataQuality::SUSPICIOUS) > 0,
+              label + "测试数据包含被删除和可疑的K线");
+        check(same_bars(batch, expected), label + "clean_ohlcv_batch 与逐根清洗一致");
+        check(kept == expected.size() && same_bars(columns.to_bars(), expected),
+              label + "clean_columns 与逐根清洗一致");
+    }
+
+    // 2. 分两批清洗时，有状态规则的历史跨批次保留
+    {
+        auto cleaner = make_cleaner(false);
+        std::vector<OHLCV> bars = make_bars(5000, 5);
+        std::vector<OHLCV> expected = clean_per_bar(*cleaner, bars);
+
+        CleaningContext context = cleaner->create_context();
+        std::vector<OHLCV> first(bars.begin(), bars.begin() + 2500);
+        std::vector<OHLCV> second(bars.begin() + 2500, bars.end());
+        std::vector<OHLCV> got = cleaner->clean_ohlcv_batch(first, context);
+        std::vector<OHLCV> rest = cleaner->clean_ohlcv_batch(second, context);
+        got.insert(got.end(), rest.begin(), rest.end());
+        check(same_bars(got, expected), "分批清洗与一次清洗一致");
+    }
+
+    // 3. 内部上下文按数据流区分：两个交易对分段交替
+    {
+        auto cleaner = make_cleaner(true);
+        std::vector<OHLCV> btc = make_bars(3000, 21, "BTCUSDT");
+        std::vector<OHLCV> eth = make_bars(3000, 22, "ETHUSDT");
+        std::vector<OHLCV> mixed;
+        for (size_t begin = 0; begin < 3000; begin += 500) {
+            mixed.insert(mixed.end(), btc.begin() + begin, btc.begin() + begin + 500);
+            mixed.insert(mixed.end(), eth.begin() + begin, eth.begin() + begin + 500);
+        }
+
+        auto reference = make_cleaner(true);
+        std::vector<OHLCV> expected;
+        for (OHLCV bar : mixed) {
+            if (reference->clean_ohlcv(bar) == DataQuality::GOOD) expected.push_back(bar);
+        }
+        check(same_bars(cleaner->clean_ohlcv_batch(mixed), expected), "多个数据流：与逐根清洗一致");
+        check(cleaner->stream_count() == 2, "多个数据流：每个交易对一个上下文");
+    }
+
+    // 4. 混合数据流共用一个上下文时，回退路径保留每根K线自己的交易对
+    {
+        auto cleaner = make_cleaner(true);
+        std::vector<OHLCV> bars = make_bars(1000, 31);
+        for (size_t i = 0; i < bars.size(); i += 2) {
+            bars[i].symbol = "ETHUSDT";
+            bars[i].exchange = "okx";
+            bars[i].timeframe = Timeframe::HOUR_1;
+        }
+        CleaningContext context = cleaner->create_context();
+        check(same_bars(cleaner->clean_ohlcv_batch(bars, context), clean_per_bar(*cleaner, bars)),
+              "混合数据流：交易对、交易所、周期取自各自的输入行");
+    }
+
+    // 5. 各列长度不一致时拒绝
+    {
+        auto cleaner = make_cleaner(false);
+        OHLCVColumns columns = OHLCVColumns::from_bars(make_bars(100, 41));
+        columns.volume.pop_back();
+        CleaningContext context = cleaner->create_context();
+        int threw = 0;
+        try {
+            cleaner->validity_mask(columns, context);
+        } catch (const std::invalid_argument&) {
+            threw++;
+        }
+        try {
+            cleaner->clean_columns(columns, context);
+        } catch (const std::invalid_argument&) {
+            threw++;
+        }
+        std::vector<uint8_t> keep(100, 1);
+        try {
+            columns.compact(keep.data());
+        } catch (const std::invalid_argument&) {
+            threw++;
+        }
+        check(threw == 3, "列长度不一致：validity_mask / clean_columns / compact 抛出 invalid_argument");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file test_cleaning_context.cpp
+ * @brief 逐流清洗上下文测试（离线）：两个交易对交错输入时，每个交易对的清洗结果
+ *        与单独清洗该交易对相同（内部上下文、调用者持有的上下文、批量、多线程）
+ */
+
+#include "cleaners/data_cleaner.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::cleaners;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+/**
+ * @brief 随机K线：约 1% 价格跳变、1% 成交量尖峰
+ * @param price 起始价格（两个交易对的价格相差很大，共用历史时几乎每根都是跳变）
+ */
+static std::vector<OHLCV> make_bars(size_t n, unsigned seed, const std::string& symbol, double price) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<OHLCV> bars;
+    for (size_t i = 0; i < n; i++) {
+        OHLCV bar;
+        bar.symbol = symbol;
+        bar.exchange = "binance";
+        bar.timestamp = static_cast<Timestamp>(i) * 60000;
+        price *= u(rng) < 0.01 ? 1.6 : 1.0 + 0.01 * (u(rng) - 0.5);
+        bar.open = price;
+        bar.close = price * (1.0 + 0.001 * (u(rng) - 0.5));
+        bar.high = std::max(bar.open, bar.close) * 1.001;
+        bar.low = std::min(bar.open, bar.close) * 0.999;
+        bar.volume = (u(rng) < 0.01 ? 100.0 : 1.0) * (symbol == "BTCUSDT" ? 5.0 : 400.0) * (0.5 + u(rng));
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+// 全部内置有状态规则
+static std::unique_ptr<DataCleaner> make_cleaner() {
+    std::unique_ptr<DataCleaner> cleaner(new DataCleaner());
+    cleaner->add_rule(std::make_shared<PriceValidityRule>());
+    cleaner->add_rule(std::make_shared<PriceJumpRule>(0.3));
+    cleaner->add_rule(std::make_shared<VolumeAnomalyRule>(5.0, 50, 10));
+    cleaner->add_rule(std::make_shared<RobustOutlierRule>(OutlierTarget::LOG_RETURN, 60, 5.0, 20));
+    cleaner->add_rule(std::make_shared<RobustOutlierRule>(OutlierTarget::VOLUME, 60, 5.0, 20));
+    return cleaner;
+}
+
+// 清洗结果：被删除时为 BAD，保留时为规则标记后的质量（可疑的K线保留并标记为 SUSPICIOUS）
+static DataQuality outcome(DataQuality returned, const OHLCV& bar) {
+    return returned == DataQuality::GOOD ? bar.quality : returned;
+}
+
+// 参照：新的清洗器、新的上下文，只清洗这一个交易对
+static std::vector<DataQuality> clean_alone(const std::vector<OHLCV>& bars) {
+    auto cleaner = make_cleaner();
+    CleaningContext context = cleaner->create_context();
+    std::vector<DataQuality> qualities;
+    for (OHLCV bar : bars) qualities.push_back(outcome(cleaner->clean_ohlcv(bar, context), bar));
+    return qualities;
+}
+
+// 交错序列中属于 symbol 的结果（按出现顺序）
+static std::vector<DataQuality> pick(const std::vector<OHLCV>& mixed, const std::vector<DataQuality>& qualities,
+                                     const std::string& symbol) {
+    std::vector<DataQuality> picked;
+    for (size_t i = 0; i < mixed.size(); i++) {
+        if (mixed[i].symbol == symbol) picked.push_back(qualities[i]);
+    }
+    return picked;
+}
+
+static size_t count_not_good(const std::vector<DataQuality>& qualities) {
+    return static_cast<size_t>(std::count_if(qualities.begin(), qualities.end(),
+                                             [](DataQuality q) { return q != DataQuality::GOOD; }));
+}
+
+int main() {
+    std::cout << "========== 逐流清洗上下文测试 ==========\n" << std::endl;
+
+    const size_t n = 4000;
+    const std::vector<OHLCV> btc = make_bars(n, 51, "BTCUSDT", 60000.0);
+    const std::vector<OHLCV> eth = make_bars(n, 52, "ETHUSDT", 3000.0);
+    const std::vector<DataQuality> btc_alone = clean_alone(btc);
+    const std::vector<DataQuality> eth_alone = clean_alone(eth);
+
+    // 随机交错（保持每个交易对内部的顺序）
+    std::vector<OHLCV> mixed;
+    {
+        std::mt19937 rng(53);
+        size_t i = 0, j = 0;
+        while (i < n || j < n) {
+            bool take_btc = j == n || (i < n && rng() % 2 == 0);
+            mixed.push_back(take_btc ? btc[i++] : eth[j++]);
+        }
+    }
+
+    check(count_not_good(btc_alone) > 20 && count_not_good(eth_alone) > 20 &&
+          count_not_good(btc_alone) < n / 10 && count_not_good(eth_alone) < n / 10,
+          "单独清洗：每个交易对有 " + std::to_string(count_not_good(btc_alone)) + " / " +
+          std::to_string(count_not_good(eth_alone)) + " 根被标记（规则确实依赖历史）");
+
+    // 1. 内部上下文：逐根清洗交错序列，与单独清洗相同
+    {
+        auto cleaner = make_cleaner();
+        std::vector<DataQuality> qualities;
+        for (OHLCV bar : mixed) qualities.push_back(outcome(cleaner->clean_ohlcv(bar), bar));
+        check(pick(mixed, qualities, "BTCUSDT") == btc_alone && pick(mixed, qualities, "ETHUSDT") == eth_alone &&
+              cleaner->stream_count() == 2, "clean_ohlcv(bar)：两个交易对各用一个内部上下文，结果与单独清洗相同");
+
+        cleaner->reset_streams();
+        qualities.clear();
+        for (OHLCV bar : mixed) qualities.push_back(outcome(cleaner->clean_ohlcv(bar), bar));
+        check(pick(mixed, qualities, "BTCUSDT") == btc_alone && pick(mixed, qualities, "ETHUSDT") == eth_alone,
+              "reset_streams 后重新清洗：结果相同");
+    }
+
+    // 2. 调用者持有的上下文：每个交易对一个
+    {
+        auto cleaner = make_cleaner();
+        CleaningContext btc_context = cleaner->create_context();
+        CleaningContext eth_context = cleaner->create_context();
+        std::vector<DataQuality> qualities;
+        for (OHLCV bar : mixed) {
+            DataQuality returned = cleaner->clean_ohlcv(bar, bar.symbol == "BTCUSDT" ? btc_context : eth_context);
+            qualities.push_back(outcome(returned, bar));
+        }
+        check(pick(mixed, qualities, "BTCUSDT") == btc_alone && pick(mixed, qualities, "ETHUSDT") == eth_alone &&
+              cleaner->stream_count() == 0, "clean_ohlcv(bar, context)：不创建内部上下文，结果与单独清洗相同");
+
+        btc_context.reset();
+        std::vector<DataQuality> again;
+        for (OHLCV bar : btc) again.push_back(outcome(cleaner->clean_ohlcv(bar, btc_context), bar));
+        check(again == btc_alone, "context.reset 后重新清洗：与新上下文相同");
+    }
+
+    // 3. 反例：交错序列共用一个上下文，历史互相污染
+    {
+        auto cleaner = make_cleaner();
+        CleaningContext shared = cleaner->create_context();
+        std::vector<DataQuality> qualities;
+        for (OHLCV bar : mixed) qualities.push_back(outcome(cleaner->clean_ohlcv(bar, shared), bar));
+        check(count_not_good(qualities) > count_not_good(btc_alone) + count_not_good(eth_alone) + n / 4,
+              "共用一个上下文：" + std::to_string(count_not_good(qualities)) + " 根被标记，远多于分开清洗");
+    }
+
+    // 4. 批量清洗交错序列：保留的K线及其质量标记与单独清洗相同
+    {
+        auto cleaner = make_cleaner();
+        std::vector<OHLCV> kept = cleaner->clean_ohlcv_batch(mixed);
+        std::vector<DataQuality> btc_expected, eth_expected, btc_got, eth_got;
+        for (DataQuality q : btc_alone) {
+            if (q != DataQuality::BAD) btc_expected.push_back(q);
+        }
+        for (DataQuality q : eth_alone) {
+            if (q != DataQuality::BAD) eth_expected.push_back(q);
+        }
+        for (const OHLCV& bar : kept) (bar.symbol == "BTCUSDT" ? btc_got : eth_got).push_back(bar.quality);
+        check(btc_got == btc_expected && eth_got == eth_expected && cleaner->stream_count() == 2,
+              "clean_ohlcv_batch：交错输入中每个交易对保留的K线与质量标记与单独清洗相同");
+    }
+
+    // 5. 同一交易对、不同交易所或周期也是不同的数据流
+    {
+        auto cleaner = make_cleaner();
+        std::vector<OHLCV> streams;
+        for (size_t i = 0; i < n; i++) {
+            OHLCV a = btc[i];
+            OHLCV b = btc[i];
+            b.exchange = "okx";
+            b.close *= 0.5;   // 另一个交易所报价相差一倍：共用历史时每根都是跳变
+            b.open *= 0.5;
+            b.high *= 0.5;
+            b.low *= 0.5;
+            OHLCV c = btc[i];
+            c.timeframe = Timeframe::HOUR_1;
+            streams.push_back(a);
+            streams.push_back(b);
+            streams.push_back(c);
+        }
+        std::vector<DataQuality> qualities;
+        for (OHLCV bar : streams) qualities.push_back(outcome(cleaner->clean_ohlcv(bar), bar));
+        bool same = true;
+        for (size_t i = 0; i < n; i++) {
+            same = same && qualities[3 * i] == btc_alone[i] && qualities[3 * i + 2] == btc_alone[i];
+        }
+        check(same && cleaner->stream_count() == 3, "交易所、周期不同：3 个内部上下文，互不影响");
+    }
+
+    // 6. 多线程：两个线程同时用内部上下文清洗不同交易对
+    {
+        auto cleaner = make_cleaner();
+        std::vector<DataQuality> btc_got, eth_got;
+        auto worker = [&](const std::vector<OHLCV>& bars, std::vector<DataQuality>& out) {
+            for (OHLCV bar : bars) out.push_back(outcome(cleaner->clean_ohlcv(bar), bar));
+        };
+        std::thread t1(worker, std::cref(btc), std::ref(btc_got));
+        std::thread t2(worker, std::cref(eth), std::ref(eth_got));
+        t1.join();
+        t2.join();
+        check(btc_got == btc_alone && eth_got == eth_alone, "两个线程各清洗一个交易对：结果与单独清洗相同");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
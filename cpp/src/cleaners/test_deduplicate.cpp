@@ -0,0 +1,163 @@
+/**
+ * @file test_deduplicate.cpp
+ * @brief K线去重测试（离线）：有序交错输入（线性扫描）与乱序输入（哈希表）对照字符串键的参照实现
+ */
+
+#include "cleaners/data_cleaner.h"
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::cleaners;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static OHLCV make_bar(const std::string& exchange, const std::string& symbol, Timestamp ts, Price close) {
+    OHLCV bar;
+    bar.timestamp = ts;
+    bar.symbol = symbol;
+    bar.exchange = exchange;
+    bar.open = close;
+    bar.high = close;
+    bar.low = close;
+    bar.close = close;
+    return bar;
+}
+
+// 参照：(交易所, 交易对, 时间戳) 为键，输出保持首次出现的位置
+static std::vector<OHLCV> reference(const std::vector<OHLCV>& bars, DuplicatePolicy policy) {
+    std::map<std::tuple<std::string, std::string, Timestamp>, size_t> position;
+    std::vector<OHLCV> result;
+    for (const auto& bar : bars) {
+        auto key = std::make_tuple(bar.exchange, bar.symbol, bar.timestamp);
+        auto it = position.find(key);
+        if (it == position.end()) {
+            position.emplace(key, result.size());
+            result.push_back(bar);
+        } else if (policy == DuplicatePolicy::KEEP_LAST) {
+            result[it->second] = bar;
+        }
+    }
+    return result;
+}
+
+// close 用作每行的唯一编号，比较它即可确认保留的是哪一行
+static bool same_rows(const std::vector<OHLCV>& a, const std::vector<OHLCV>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].timestamp != b[i].timestamp || a[i].exchange != b[i].exchange ||
+            a[i].symbol != b[i].symbol || a[i].close != b[i].close) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::vector<Price> closes(const std::vector<OHLCV>& bars) {
+    std::vector<Price> values;
+    for (const auto& bar : bars) values.push_back(bar.close);
+    return values;
+}
+
+/**
+ * @brief 多个数据流按时间交错，约 20% 的行重复 1~2 次（重复行紧跟原行）
+ */
+static std::vector<OHLCV> make_interleaved(size_t bars_per_stream, unsigned seed) {
+    const std::vector<std::string> exchanges = {"binance", "okx"};
+    const std::vector<std::string> symbols = {"BTCUSDT", "ETHUSDT", "SOLUSDT"};
+    std::mt19937 rng(seed);
+    std::vector<OHLCV> bars;
+    double id = 0.0;
+    for (size_t i = 0; i < bars_per_stream; i++) {
+        for (const auto& exchange : exchanges) {
+            for (const auto& symbol : symbols) {
+                int copies = rng() % 5 == 0 ? 1 + static_cast<int>(rng() % 2) : 0;
+                for (int c = 0; c <= copies; c++) {
+                    bars.push_back(make_bar(exchange, symbol, static_cast<Timestamp>(i) * 60000, id++));
+                }
+            }
+        }
+    }
+    return bars;
+}
+
+int main() {
+    std::cout << "========== K线去重测试 ==========\n" << std::endl;
+
+    // 1. 手工构造：两个数据流交错，重复行不相邻
+    {
+        std::vector<OHLCV> bars = {
+            make_bar("binance", "BTCUSDT", 0, 1),
+            make_bar("okx", "BTCUSDT", 0, 2),        // 同交易对不同交易所：不是重复
+            make_bar("binance", "BTCUSDT", 0, 3),    // 与第1行重复
+            make_bar("okx", "BTCUSDT", 60000, 4),
+            make_bar("binance", "BTCUSDT", 60000, 5),
+            make_bar("okx", "BTCUSDT", 60000, 6),    // 与第4行重复
+            make_bar("binance", "BTCUSDT", 60000, 7),    // 与第5行重复
+        };
+        auto first = DataCleaner::deduplicate(bars, DuplicatePolicy::KEEP_FIRST);
+        auto last = DataCleaner::deduplicate(bars, DuplicatePolicy::KEEP_LAST);
+        check(closes(first) == std::vector<Price>({1, 2, 4, 5}), "有序交错：KEEP_FIRST 保留最先出现的行");
+        check(closes(last) == std::vector<Price>({3, 2, 6, 7}), "有序交错：KEEP_LAST 在首次出现的位置放最后出现的行");
+        check(same_rows(DataCleaner::deduplicate(bars), first), "默认策略为 KEEP_FIRST");
+    }
+
+    // 2. 随机有序交错输入（线性扫描路径）
+    {
+        std::vector<OHLCV> bars = make_interleaved(3000, 1);
+        auto first = DataCleaner::deduplicate(bars, DuplicatePolicy::KEEP_FIRST);
+        auto last = DataCleaner::deduplicate(bars, DuplicatePolicy::KEEP_LAST);
+        check(first.size() == 3000 * 6 && first.size() < bars.size(), "有序交错：每个数据流每个时间戳保留一行");
+        check(same_rows(first, reference(bars, DuplicatePolicy::KEEP_FIRST)), "有序交错：KEEP_FIRST 与参照一致");
+        check(same_rows(last, reference(bars, DuplicatePolicy::KEEP_LAST)), "有序交错：KEEP_LAST 与参照一致");
+    }
+
+    // 3. 打乱顺序（多数据源乱序合并，哈希表路径）
+    {
+        std::vector<OHLCV> bars = make_interleaved(3000, 2);
+        std::mt19937 rng(3);
+        std::shuffle(bars.begin(), bars.end(), rng);
+        auto first = DataCleaner::deduplicate(bars, DuplicatePolicy::KEEP_FIRST);
+        auto last = DataCleaner::deduplicate(bars, DuplicatePolicy::KEEP_LAST);
+        check(first.size() == 3000 * 6, "乱序：每个数据流每个时间戳保留一行");
+        check(same_rows(first, reference(bars, DuplicatePolicy::KEEP_FIRST)), "乱序：KEEP_FIRST 与参照一致");
+        check(same_rows(last, reference(bars, DuplicatePolicy::KEEP_LAST)), "乱序：KEEP_LAST 与参照一致");
+    }
+
+    // 4. 只有一处时间倒退：整体改走哈希表，远处的重复也能去除
+    {
+        std::vector<OHLCV> bars = {
+            make_bar("binance", "BTCUSDT", 0, 1),
+            make_bar("binance", "BTCUSDT", 60000, 2),
+            make_bar("binance", "BTCUSDT", 120000, 3),
+            make_bar("binance", "BTCUSDT", 0, 4),
+            make_bar("binance", "BTCUSDT", 120000, 5),
+        };
+        check(closes(DataCleaner::deduplicate(bars, DuplicatePolicy::KEEP_FIRST)) == std::vector<Price>({1, 2, 3}),
+              "时间倒退：KEEP_FIRST");
+        check(closes(DataCleaner::deduplicate(bars, DuplicatePolicy::KEEP_LAST)) == std::vector<Price>({4, 2, 5}),
+              "时间倒退：KEEP_LAST");
+    }
+
+    // 5. 边界：空输入、没有重复
+    {
+        check(DataCleaner::deduplicate({}, DuplicatePolicy::KEEP_LAST).empty(), "空输入：输出为空");
+        std::vector<OHLCV> bars;
+        for (int i = 0; i < 100; i++) bars.push_back(make_bar("binance", "BTCUSDT", i * 60000, i));
+        check(same_rows(DataCleaner::deduplicate(bars, DuplicatePolicy::KEEP_LAST), bars), "没有重复：原样返回");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file test_fill_missing.cpp
+ * @brief 缺失K线填补测试（离线，使用构造的K线）
+ */
+
+#include "cleaners/data_cleaner.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::cleaners;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static const int64_t MINUTE = 60000;
+
+static OHLCV make_bar(Timestamp ts, Price open, Price close, Volume volume = 5.0) {
+    OHLCV bar;
+    bar.timestamp = ts;
+    bar.symbol = "BTCUSDT";
+    bar.exchange = "binance";
+    bar.timeframe = Timeframe::MINUTE_1;
+    bar.open = open;
+    bar.close = close;
+    bar.high = std::max(open, close) + 1.0;
+    bar.low = std::min(open, close) - 1.0;
+    bar.volume = volume;
+    bar.quote_volume = volume * close;
+    bar.trades_count = 3;
+    return bar;
+}
+
+static bool near(double a, double b) {
+    return std::abs(a - b) < 1e-9;
+}
+
+// 填补的K线：时间戳、价格、成交量与质量标记
+static bool is_filled_bar(const OHLCV& bar, Timestamp ts, Price open, Price close) {
+    return bar.timestamp == ts && near(bar.open, open) && near(bar.close, close) &&
+           near(bar.high, std::max(open, close)) && near(bar.low, std::min(open, close)) &&
+           bar.volume == 0.0 && bar.quote_volume == 0.0 && bar.trades_count == 0 &&
+           bar.quality == DataQuality::MISSING && bar.symbol == "BTCUSDT" &&
+           bar.exchange == "binance" && bar.timeframe == Timeframe::MINUTE_1;
+}
+
+// 原有K线原样保留
+static bool same_bar(const OHLCV& a, const OHLCV& b) {
+    return a.timestamp == b.timestamp && a.open == b.open && a.high == b.high && a.low == b.low &&
+           a.close == b.close && a.volume == b.volume && a.trades_count == b.trades_count &&
+           a.quality == b.quality;
+}
+
+int main() {
+    std::cout << "========== 缺失K线填补测试 ==========\n" << std::endl;
+
+    // 0 分钟收盘 100，4 分钟开盘 110：缺 1、2、3 分钟
+    std::vector<OHLCV> gapped;
+    gapped.push_back(make_bar(0, 99.0, 100.0));
+    gapped.push_back(make_bar(4 * MINUTE, 110.0, 111.0));
+    gapped.push_back(make_bar(5 * MINUTE, 111.0, 112.0));
+
+    // 1. 三种填补方法
+    {
+        GapReport report;
+        auto filled = DataCleaner::fill_missing(gapped, Timeframe::MINUTE_1, FillMethod::FORWARD, &report);
+        check(filled.size() == 6, "FORWARD：补齐 3 根");
+        check(filled.size() == 6 && same_bar(filled[0], gapped[0]) && same_bar(filled[4], gapped[1]) &&
+              same_bar(filled[5], gapped[2]), "FORWARD：原有K线保持原样与顺序");
+        check(filled.size() == 6 && is_filled_bar(filled[1], 1 * MINUTE, 100.0, 100.0) &&
+              is_filled_bar(filled[2], 2 * MINUTE, 100.0, 100.0) &&
+              is_filled_bar(filled[3], 3 * MINUTE, 100.0, 100.0), "FORWARD：价格为缺口前收盘价");
+        check(report.gap_count() == 1 && report.gaps[0].index == 1 && report.gaps[0].missing_bars == 3 &&
+              report.gaps[0].filled && report.missing_bars == 3 && report.filled_bars == 3 &&
+              report.max_gap_ms == 4 * MINUTE, "FORWARD：缺口报告");
+    }
+    {
+        auto filled = DataCleaner::fill_missing(gapped, Timeframe::MINUTE_1, FillMethod::BACKWARD);
+        check(filled.size() == 6 && is_filled_bar(filled[1], 1 * MINUTE, 110.0, 110.0) &&
+              is_filled_bar(filled[3], 3 * MINUTE, 110.0, 110.0), "BACKWARD：价格为缺口后开盘价");
+    }
+    {
+        auto filled = DataCleaner::fill_missing(gapped, Timeframe::MINUTE_1, FillMethod::INTERPOLATE);
+        check(filled.size() == 6 && is_filled_bar(filled[1], 1 * MINUTE, 100.0, 102.5) &&
+              is_filled_bar(filled[2], 2 * MINUTE, 102.5, 105.0) &&
+              is_filled_bar(filled[3], 3 * MINUTE, 105.0, 107.5), "INTERPOLATE：线性插值，开盘价接上一根收盘价");
+
+        auto by_name = DataCleaner::fill_missing(gapped, Timeframe::MINUTE_1, "interpolate");
+        bool same = by_name.size() == filled.size();
+        for (size_t i = 0; same && i < filled.size(); i++) same = same_bar(by_name[i], filled[i]);
+        check(same, "按名称指定方法与枚举结果一致");
+
+        bool threw = false;
+        try {
+            DataCleaner::fill_missing(gapped, Timeframe::MINUTE_1, "nearest");
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        check(threw, "未知方法抛出 invalid_argument");
+    }
+
+    // 2. 时间戳抖动：按周期四舍五入
+    {
+        std::vector<OHLCV> jittered;
+        jittered.push_back(make_bar(0, 100.0, 100.0));
+        jittered.push_back(make_bar(1 * MINUTE + 20000, 100.0, 101.0));    // 1.33 个周期：不算缺口
+        jittered.push_back(make_bar(2 * MINUTE - 15000, 101.0, 102.0));    // 间隔不足一个周期：原样保留
+        jittered.push_back(make_bar(4 * MINUTE + 5000, 102.0, 103.0));     // 2.3 个周期：缺 1 根
+        jittered.push_back(make_bar(7 * MINUTE - 20000, 103.0, 104.0));    // 2.6 个周期：缺 2 根
+
+        GapReport report;
+        auto filled = DataCleaner::fill_missing(jittered, Timeframe::MINUTE_1, FillMethod::FORWARD, &report);
+        check(report.gap_count() == 2 && report.missing_bars == 3, "抖动：只有超过半个周期的偏差算作缺失");
+        check(filled.size() == 8 && is_filled_bar(filled[3], 2 * MINUTE - 15000 + MINUTE, 102.0, 102.0) &&
+              is_filled_bar(filled[5], 4 * MINUTE + 5000 + MINUTE, 103.0, 103.0) &&
+              is_filled_bar(filled[6], 4 * MINUTE + 5000 + 2 * MINUTE, 103.0, 103.0),
+              "抖动：补齐的时间戳从缺口前一根按周期递增");
+
+        std::mt19937 rng(17);
+        std::uniform_int_distribution<int64_t> jitter(-14000, 14000);
+        std::vector<OHLCV> noisy;
+        for (int64_t i = 0; i < 1000; i++) noisy.push_back(make_bar(i * MINUTE + jitter(rng), 100.0, 100.0));
+        check(DataCleaner::fill_missing(noisy, Timeframe::MINUTE_1, FillMethod::FORWARD).size() == noisy.size(),
+              "抖动：相邻间隔不足 1.5 个周期的随机抖动不产生缺口");
+    }
+
+    // 3. max_gap_bars：超过上限的缺口只报告，不填补
+    {
+        std::vector<OHLCV> bars;
+        bars.push_back(make_bar(0, 100.0, 100.0));
+        bars.push_back(make_bar(3 * MINUTE, 100.0, 100.0));     // 缺 2 根
+        bars.push_back(make_bar(9 * MINUTE, 100.0, 100.0));     // 缺 5 根
+        bars.push_back(make_bar(12 * MINUTE, 100.0, 100.0));    // 缺 2 根
+
+        GapReport report;
+        auto filled = DataCleaner::fill_missing(bars, Timeframe::MINUTE_1, FillMethod::FORWARD, &report, 3);
+        check(filled.size() == 8, "max_gap_bars=3：只补齐两段 2 根的缺口");
+        check(report.gap_count() == 3 && report.gaps[0].filled && !report.gaps[1].filled && report.gaps[2].filled &&
+              report.missing_bars == 9 && report.filled_bars == 4, "max_gap_bars=3：报告包含未填补的缺口");
+        check(filled.size() == 8 && same_bar(filled[3], bars[1]) && same_bar(filled[4], bars[2]) &&
+              filled[5].timestamp == 10 * MINUTE, "max_gap_bars=3：长缺口两侧直接相连");
+
+        GapReport unlimited = DataCleaner::find_gaps(bars, Timeframe::MINUTE_1);
+        check(unlimited.filled_bars == 9 &&
+              DataCleaner::fill_missing(bars, Timeframe::MINUTE_1, FillMethod::FORWARD).size() == 13,
+              "max_gap_bars=0：不限制");
+    }
+
+    // 4. 边界：空输入、单根K线、无效周期
+    {
+        GapReport report;
+        report.missing_bars = 42;
+        auto filled = DataCleaner::fill_missing({}, Timeframe::MINUTE_1, FillMethod::FORWARD, &report);
+        check(filled.empty() && report.gap_count() == 0 && report.missing_bars == 0, "空输入：输出为空，报告清零");
+
+        std::vector<OHLCV> single = {make_bar(0, 100.0, 100.0)};
+        check(DataCleaner::fill_missing(single, Timeframe::MINUTE_1, FillMethod::FORWARD).size() == 1,
+              "单根K线：原样返回");
+
+        bool threw = false;
+        try {
+            DataCleaner::fill_missing(gapped, Timeframe::TICK, FillMethod::FORWARD);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        check(threw, "tick 周期抛出 invalid_argument");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
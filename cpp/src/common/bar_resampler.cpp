@@ -0,0 +1,72 @@
+#include "common/bar_resampler.h"
+#include "common/calendar.h"
+#include <stdexcept>
+
+namespace quant_crypto {
+
+void BarResampler::subscribe(Timeframe timeframe) {
+    if (timeframe == Timeframe::TICK) {
+        throw std::invalid_argument("BarResampler: 不能订阅 tick 周期");
+    }
+    auto it = std::lower_bound(states_.begin(), states_.end(), timeframe,
+                               [](const State& s, Timeframe tf) {
+                                   return static_cast<int>(s.timeframe) < static_cast<int>(tf);
+                               });
+    if (it != states_.end() && it->timeframe == timeframe) return;
+
+    State state;
+    state.timeframe = timeframe;
+    state.active = false;
+    state.end = 0;
+    states_.insert(it, state);
+}
+
+void BarResampler::reset() {
+    for (State& state : states_) {
+        state.active = false;
+        state.end = 0;
+    }
+}
+
+std::vector<Timeframe> BarResampler::timeframes() const {
+    std::vector<Timeframe> result;
+    result.reserve(states_.size());
+    for (const State& state : states_) result.push_back(state.timeframe);
+    return result;
+}
+
+const OHLCV* BarResampler::partial(Timeframe timeframe) const {
+    for (const State& state : states_) {
+        if (state.timeframe == timeframe) return state.active ? &state.bar : nullptr;
+    }
+    return nullptr;
+}
+
+void BarResampler::check_base(Timeframe base, Timeframe target) {
+    if (static_cast<int>(target) < static_cast<int>(base)) {
+        throw std::invalid_argument("BarResampler: 订阅周期 " + timeframe_to_string(target) +
+                                    " 小于基础周期 " + timeframe_to_string(base));
+    }
+}
+
+void BarResampler::bucket_bounds(Timeframe timeframe, Timestamp timestamp, Timestamp& start, Timestamp& end) {
+    switch (timeframe) {
+        case Timeframe::TICK:
+            start = end = timestamp;
+            return;
+        case Timeframe::WEEK_1:
+            calendar::period_bounds(calendar::Period::WEEK, timestamp, start, end);
+            return;
+        case Timeframe::MONTH_1:
+            calendar::period_bounds(calendar::Period::MONTH, timestamp, start, end);
+            return;
+        default: {
+            int64_t length = timeframe_to_milliseconds(timeframe);
+            start = calendar::floor_div(timestamp, length) * length;
+            end = start + length;
+            return;
+        }
+    }
+}
+
+} // namespace quant_crypto
@@ -0,0 +1,165 @@
+#include "common/ohlcv_columns.h"
+#include <stdexcept>
+
+namespace quant_crypto {
+
+void OHLCVColumns::clear() {
+    timestamp.clear();
+    open.clear();
+    high.clear();
+    low.clear();
+    close.clear();
+    volume.clear();
+    quote_volume.clear();
+    trades_count.clear();
+    quality.clear();
+}
+
+void OHLCVColumns::reserve(size_t n) {
+    timestamp.reserve(n);
+    open.reserve(n);
+    high.reserve(n);
+    low.reserve(n);
+    close.reserve(n);
+    volume.reserve(n);
+    quote_volume.reserve(n);
+    trades_count.reserve(n);
+    quality.reserve(n);
+}
+
+bool OHLCVColumns::consistent() const {
+    size_t n = timestamp.size();
+    return open.size() == n && high.size() == n && low.size() == n && close.size() == n &&
+           volume.size() == n && quote_volume.size() == n && trades_count.size() == n &&
+           quality.size() == n;
+}
+
+void OHLCVColumns::push_back(const OHLCV& bar) {
+    if (empty()) {
+        symbol = bar.symbol;
+        exchange = bar.exchange;
+        timeframe = bar.timeframe;
+    }
+    timestamp.push_back(bar.timestamp);
+    open.push_back(bar.open);
+    high.push_back(bar.high);
+    low.push_back(bar.low);
+    close.push_back(bar.close);
+    volume.push_back(bar.volume);
+    quote_volume.push_back(bar.quote_volume);
+    trades_count.push_back(bar.trades_count);
+    quality.push_back(bar.quality);
+}
+
+void OHLCVColumns::assign(const OHLCV* bars, size_t n) {
+    if (n > 0) {
+        symbol = bars[0].symbol;
+        exchange = bars[0].exchange;
+        timeframe = bars[0].timeframe;
+    }
+    timestamp.resize(n);
+    open.resize(n);
+    high.resize(n);
+    low.resize(n);
+    close.resize(n);
+    volume.resize(n);
+    quote_volume.resize(n);
+    trades_count.resize(n);
+    quality.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        const OHLCV& bar = bars[i];
+        timestamp[i] = bar.timestamp;
+        open[i] = bar.open;
+        high[i] = bar.high;
+        low[i] = bar.low;
+        close[i] = bar.close;
+        volume[i] = bar.volume;
+        quote_volume[i] = bar.quote_volume;
+        trades_count[i] = bar.trades_count;
+        quality[i] = bar.quality;
+    }
+}
+
+OHLCV OHLCVColumns::row(size_t i) const {
+    OHLCV bar;
+    bar.symbol = symbol;
+    bar.exchange = exchange;
+    bar.timeframe = timeframe;
+    get(i, bar);
+    return bar;
+}
+
+void OHLCVColumns::set(size_t i, const OHLCV& bar) {
+    timestamp[i] = bar.timestamp;
+    open[i] = bar.open;
+    high[i] = bar.high;
+    low[i] = bar.low;
+    close[i] = bar.close;
+    volume[i] = bar.volume;
+    quote_volume[i] = bar.quote_volume;
+    trades_count[i] = bar.trades_count;
+    quality[i] = bar.quality;
+}
+
+void OHLCVColumns::get(size_t i, OHLCV& bar) const {
+    bar.timestamp = timestamp[i];
+    bar.open = open[i];
+    bar.high = high[i];
+    bar.low = low[i];
+    bar.close = close[i];
+    bar.volume = volume[i];
+    bar.quote_volume = quote_volume[i];
+    bar.trades_count = trades_count[i];
+    bar.quality = quality[i];
+}
+
+std::vector<OHLCV> OHLCVColumns::to_bars() const {
+    if (!consistent()) {
+        throw std::invalid_argument("OHLCVColumns::to_bars: 各列长度不一致");
+    }
+    std::vector<OHLCV> bars;
+    bars.reserve(size());
+    for (size_t i = 0; i < size(); i++) bars.push_back(row(i));
+    return bars;
+}
+
+OHLCVColumns OHLCVColumns::from_bars(const std::vector<OHLCV>& bars) {
+    OHLCVColumns columns;
+    columns.assign(bars.data(), bars.size());
+    return columns;
+}
+
+namespace {
+
+template <typename T>
+void compact_column(std::vector<T>& column, const uint8_t* keep) {
+    size_t n = column.size();
+    size_t out = 0;
+    for (size_t i = 0; i < n; i++) {
+        column[out] = column[i];
+        out += keep[i] != 0;
+    }
+    column.resize(out);
+}
+
+} // namespace
+
+size_t OHLCVColumns::compact(const uint8_t* keep) {
+    // 掩码按 size() 行读取，较长的列会越界读
+    if (!consistent()) {
+        throw std::invalid_argument("OHLCVColumns::compact: 各列长度不一致");
+    }
+    // 无分支压缩：每行都写入，只有保留的行推进输出位置
+    compact_column(timestamp, keep);
+    compact_column(open, keep);
+    compact_column(high, keep);
+    compact_column(low, keep);
+    compact_column(close, keep);
+    compact_column(volume, keep);
+    compact_column(quote_volume, keep);
+    compact_column(trades_count, keep);
+    compact_column(quality, keep);
+    return size();
+}
+
+} // namespace quant_crypto
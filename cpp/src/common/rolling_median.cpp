@@ -0,0 +1,241 @@
+#include "common/rolling_median.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace quant_crypto {
+
+// ========== IndexableSkipList ==========
+
+IndexableSkipList::IndexableSkipList(size_t capacity)
+    : levels_(1), size_(0), middle_(NIL), seed_(0x9e3779b97f4a7c15ULL) {
+    if (capacity == 0) {
+        throw std::invalid_argument("IndexableSkipList: 容量必须大于0");
+    }
+    if (capacity >= NIL) {
+        throw std::invalid_argument("IndexableSkipList: 容量过大");
+    }
+    // 层数约为 log2(容量) + 1，保证查找为 O(log n)
+    while (levels_ < MAX_LEVELS && (size_t(1) << levels_) <= capacity) levels_++;
+
+    values_.resize(capacity + 1);
+    heights_.resize(capacity + 1);
+    next_.resize((capacity + 1) * levels_);
+    width_.resize((capacity + 1) * levels_);
+    prev_.resize(capacity + 1);
+    clear();
+}
+
+void IndexableSkipList::clear() {
+    for (size_t level = 0; level < levels_; level++) {
+        next(HEAD, level) = NIL;
+        width(HEAD, level) = 1;
+    }
+    heights_[HEAD] = static_cast<uint8_t>(levels_);
+    free_.clear();
+    for (size_t node = values_.size() - 1; node > HEAD; node--) free_.push_back(static_cast<uint32_t>(node));
+    size_ = 0;
+    middle_ = NIL;
+}
+
+size_t IndexableSkipList::random_height() {
+    // xorshift64：每一位为1的概率是 1/2，连续为1的个数即额外的层数
+    seed_ ^= seed_ << 13;
+    seed_ ^= seed_ >> 7;
+    seed_ ^= seed_ << 17;
+    uint64_t bits = seed_;
+    size_t height = 1;
+    while (height < levels_ && (bits & 1)) {
+        height++;
+        bits >>= 1;
+    }
+    return height;
+}
+
+void IndexableSkipList::insert(double value) {
+    if (free_.empty()) {
+        throw std::length_error("IndexableSkipList: 已满");
+    }
+
+    // 每层找到最后一个 <= value 的节点，并记录在该层前进的元素个数
+    uint32_t chain[MAX_LEVELS];
+    size_t steps[MAX_LEVELS];
+    uint32_t node = HEAD;
+    for (size_t level = levels_; level-- > 0;) {
+        steps[level] = 0;
+        for (uint32_t n = next(node, level); n != NIL && values_[n] <= value; n = next(node, level)) {
+            steps[level] += width(node, level);
+            node = n;
+        }
+        chain[level] = node;
+    }
+
+    uint32_t inserted = free_.back();
+    free_.pop_back();
+    size_t height = random_height();
+    values_[inserted] = value;
+    heights_[inserted] = static_cast<uint8_t>(height);
+
+    // distance 为 chain[level] 到新节点之前跨过的元素个数
+    size_t distance = 0;
+    for (size_t level = 0; level < height; level++) {
+        uint32_t previous = chain[level];
+        next(inserted, level) = next(previous, level);
+        next(previous, level) = inserted;
+        width(inserted, level) = width(previous, level) - static_cast<uint32_t>(distance);
+        width(previous, level) = static_cast<uint32_t>(distance + 1);
+        distance += steps[level];
+    }
+    for (size_t level = height; level < levels_; level++) width(chain[level], level)++;
+    prev_[inserted] = chain[0];
+    if (next(inserted, 0) != NIL) prev_[next(inserted, 0)] = inserted;
+
+    // 新节点排在所有 <= value 的节点之后，只有 value 小于中间值时才在中间节点之前；
+    // 插入后中间名次 (n-1)/2 不变（原为偶数个）或加一（原为奇数个），中间节点至多移动一步
+    if (middle_ == NIL) {
+        middle_ = inserted;
+    } else {
+        bool before = value < values_[middle_];
+        if (size_ % 2 == 1 && before) {
+            middle_ = prev_[middle_];
+        } else if (size_ % 2 == 0 && !before) {
+            middle_ = next(middle_, 0);
+        }
+    }
+    size_++;
+}
+
+bool IndexableSkipList::erase(double value) {
+    // 每层找到最后一个 < value 的节点
+    uint32_t chain[MAX_LEVELS];
+    uint32_t node = HEAD;
+    for (size_t level = levels_; level-- > 0;) {
+        for (uint32_t n = next(node, level); n != NIL && values_[n] < value; n = next(node, level)) {
+            node = n;
+        }
+        chain[level] = node;
+    }
+
+    uint32_t target = next(chain[0], 0);
+    if (target == NIL || values_[target] != value) return false;
+
+    // 删除的是第一个等于 value 的节点：值与中间值相等但不是中间节点时，必在中间节点之前
+    bool is_middle = target == middle_;
+    bool before = !is_middle && value <= values_[middle_];
+    uint32_t successor = next(target, 0);
+    if (is_middle) middle_ = size_ % 2 == 1 ? prev_[target] : successor;
+
+    size_t height = heights_[target];
+    for (size_t level = 0; level < height; level++) {
+        uint32_t previous = chain[level];
+        width(previous, level) += width(target, level) - 1;
+        next(previous, level) = next(target, level);
+    }
+    for (size_t level = height; level < levels_; level++) width(chain[level], level)--;
+    if (successor != NIL) prev_[successor] = chain[0];
+    free_.push_back(target);
+
+    // 删除后中间名次 (n-1)/2 不变（原为偶数个）或减一（原为奇数个）
+    if (size_ == 1) {
+        middle_ = NIL;
+    } else if (!is_middle) {
+        if (size_ % 2 == 1 && !before) {
+            middle_ = prev_[middle_];
+        } else if (size_ % 2 == 0 && before) {
+            middle_ = next(middle_, 0);
+        }
+    }
+    size_--;
+    return true;
+}
+
+double IndexableSkipList::at(size_t rank) const {
+    if (rank >= size_) {
+        throw std::out_of_range("IndexableSkipList: 名次越界");
+    }
+    size_t remaining = rank + 1;
+    uint32_t node = HEAD;
+    for (size_t level = levels_; level-- > 0;) {
+        while (next(node, level) != NIL && width(node, level) <= remaining) {
+            remaining -= width(node, level);
+            node = next(node, level);
+        }
+    }
+    return values_[node];
+}
+
+// ========== RollingMedian ==========
+
+namespace {
+
+/**
+ * 两个升序序列合并后第 k 小与第 k - 1 小（k 从0开始），a(i)/b(i) 按下标取值
+ * 二分 a 中取多少个，共 O(log) 次取值；第 k - 1 小由同一划分再取至多两个值得到
+ */
+template <typename A, typename B>
+void select_kth(A a, size_t a_size, B b, size_t b_size, size_t k, double* kth, double* previous) {
+    size_t lo = k + 1 > b_size ? k + 1 - b_size : 0;
+    size_t hi = std::min(a_size, k + 1);
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        // a 取 i 个、b 取 k + 1 - i 个：a(i) 比 b 取到的最后一个小，说明 a 应多取
+        if (a(i) < b(k - i)) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+
+    // 前 k + 1 小 = a 的前 lo 个 + b 的前 j 个，第 k 小是两段末尾中较大的
+    const double none = -std::numeric_limits<double>::infinity();
+    size_t j = k + 1 - lo;
+    double a_last = lo > 0 ? a(lo - 1) : none;
+    double b_last = j > 0 ? b(j - 1) : none;
+    if (a_last >= b_last) {
+        *kth = a_last;
+        if (previous) *previous = std::max(lo > 1 ? a(lo - 2) : none, b_last);
+    } else {
+        *kth = b_last;
+        if (previous) *previous = std::max(a_last, j > 1 ? b(j - 2) : none);
+    }
+}
+
+} // namespace
+
+RollingMedian::RollingMedian(size_t window) : history_(window), sorted_(window) {}
+
+void RollingMedian::push(double value) {
+    double evicted;
+    if (history_.push(value, &evicted)) sorted_.erase(evicted);
+    sorted_.insert(value);
+}
+
+void RollingMedian::clear() {
+    history_.clear();
+    sorted_.clear();
+}
+
+double RollingMedian::median() const {
+    size_t n = sorted_.size();
+    if (n == 0) return std::numeric_limits<double>::quiet_NaN();
+    if (n % 2 == 1) return sorted_.lower_middle();
+    return (sorted_.lower_middle() + sorted_.upper_middle()) / 2.0;
+}
+
+double RollingMedian::mad() const {
+    size_t n = sorted_.size();
+    if (n == 0) return std::numeric_limits<double>::quiet_NaN();
+
+    // 以 p = n/2 为界：左侧 m - x 从 p-1 向左递增，右侧 x - m 从 p 向右递增
+    double m = median();
+    size_t p = n / 2;
+    auto left = [&](size_t i) { return m - sorted_.at(p - 1 - i); };
+    auto right = [&](size_t i) { return sorted_.at(p + i) - m; };
+
+    double upper;
+    double lower;
+    select_kth(left, p, right, n - p, n / 2, &upper, n % 2 == 1 ? nullptr : &lower);
+    return n % 2 == 1 ? upper : (lower + upper) / 2.0;
+}
+
+} // namespace quant_crypto
@@ -0,0 +1,215 @@
+/**
+ * @file test_bar_resampler.cpp
+ * @brief K线合成测试（离线）：周线/月线的边界（周一、自然月、闰年二月、1970年之前）、
+ *        合成的OHLCV与收盘时机
+ */
+
+#include "common/bar_resampler.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static const Timestamp HOUR = 3600000;
+static const Timestamp DAY = 86400000;
+
+// UTC 零点（手算的常量，不经过被测的日历运算）
+static const Timestamp JAN_01_2024 = 1704067200000;   // 周一
+static const Timestamp JAN_22_2024 = JAN_01_2024 + 21 * DAY;
+static const Timestamp JAN_25_2024 = JAN_01_2024 + 24 * DAY;
+static const Timestamp FEB_01_2024 = 1706745600000;
+static const Timestamp MAR_01_2024 = 1709251200000;   // 2024-02 有 29 天
+static const Timestamp FEB_01_2023 = 1675209600000;
+static const Timestamp MAR_01_2023 = 1677628800000;   // 2023-02 有 28 天
+static const Timestamp DEC_01_2023 = 1701388800000;
+
+struct Closed {
+    Timeframe timeframe;
+    OHLCV bar;
+    size_t at;   // 交付时正在处理的基础K线下标
+};
+
+static OHLCV make_bar(Timestamp ts, Timeframe timeframe, double base) {
+    OHLCV bar;
+    bar.timestamp = ts;
+    bar.symbol = "BTCUSDT";
+    bar.timeframe = timeframe;
+    bar.open = base;
+    bar.close = base + 0.5;
+    bar.high = base + 1.0;
+    bar.low = base - 1.0;
+    bar.volume = 1.0;
+    return bar;
+}
+
+static std::vector<Closed> feed(BarResampler& resampler, const std::vector<OHLCV>& bars) {
+    std::vector<Closed> closed;
+    for (size_t i = 0; i < bars.size(); i++) {
+        resampler.update(bars[i], [&](Timeframe tf, const OHLCV& bar) { closed.push_back({tf, bar, i}); });
+    }
+    return closed;
+}
+
+static std::vector<Closed> only(const std::vector<Closed>& closed, Timeframe timeframe) {
+    std::vector<Closed> result;
+    for (const auto& c : closed) {
+        if (c.timeframe == timeframe) result.push_back(c);
+    }
+    return result;
+}
+
+// 合成的K线等于基础K线 [first, last] 的聚合
+static bool aggregates(const OHLCV& out, const std::vector<OHLCV>& bars, size_t first, size_t last) {
+    double high = bars[first].high, low = bars[first].low, volume = 0.0;
+    for (size_t i = first; i <= last; i++) {
+        high = std::max(high, bars[i].high);
+        low = std::min(low, bars[i].low);
+        volume += bars[i].volume;
+    }
+    return out.open == bars[first].open && out.close == bars[last].close && out.high == high &&
+           out.low == low && out.volume == volume;
+}
+
+int main() {
+    std::cout << "========== K线合成测试 ==========\n" << std::endl;
+
+    // 1. bucket_bounds：周从周一开始，月按自然月
+    {
+        Timestamp start = 0, end = 0;
+        BarResampler::bucket_bounds(Timeframe::WEEK_1, JAN_01_2024 + 2 * DAY + 5 * HOUR, start, end);
+        check(start == JAN_01_2024 && end == JAN_01_2024 + 7 * DAY, "周线：2024-01-03 属于 [01-01 周一, 01-08)");
+        BarResampler::bucket_bounds(Timeframe::WEEK_1, JAN_01_2024 + 7 * DAY - 1, start, end);
+        check(start == JAN_01_2024, "周线：周日 23:59:59.999 仍属于本周");
+        BarResampler::bucket_bounds(Timeframe::WEEK_1, JAN_01_2024 + 7 * DAY, start, end);
+        check(start == JAN_01_2024 + 7 * DAY, "周线：周一 00:00 属于下一周");
+
+        BarResampler::bucket_bounds(Timeframe::MONTH_1, FEB_01_2024 + 28 * DAY + 23 * HOUR, start, end);
+        check(start == FEB_01_2024 && end == MAR_01_2024, "月线：闰年 2024-02-29 属于 [02-01, 03-01)，29 天");
+        BarResampler::bucket_bounds(Timeframe::MONTH_1, FEB_01_2023 + 10 * DAY, start, end);
+        check(start == FEB_01_2023 && end == MAR_01_2023, "月线：平年 2023-02 为 28 天");
+        BarResampler::bucket_bounds(Timeframe::MONTH_1, JAN_01_2024 - 1, start, end);
+        check(start == DEC_01_2023 && end == JAN_01_2024, "月线：12 月跨年到下一年 1 月 1 日");
+
+        // 1970-01-01 是周四：所在周从 1969-12-29 开始
+        BarResampler::bucket_bounds(Timeframe::WEEK_1, 0, start, end);
+        check(start == -3 * DAY && end == 4 * DAY, "周线：1970-01-01 属于 [1969-12-29, 1970-01-05)");
+        BarResampler::bucket_bounds(Timeframe::MONTH_1, -15 * DAY, start, end);
+        check(start == -31 * DAY && end == 0, "月线：1969-12-17 属于 [1969-12-01, 1970-01-01)");
+        BarResampler::bucket_bounds(Timeframe::HOUR_4, -1, start, end);
+        check(start == -4 * HOUR && end == 0, "固定周期：负时间戳向下取整");
+    }
+
+    // 2. 日线合成周线/月线：2024-01-25（周四）到 2024-04-03，共 70 根
+    {
+        std::vector<OHLCV> bars;
+        for (size_t i = 0; i < 70; i++) {
+            bars.push_back(make_bar(JAN_25_2024 + static_cast<Timestamp>(i) * DAY, Timeframe::DAY_1, 100.0 + i));
+        }
+        BarResampler resampler;
+        resampler.subscribe(Timeframe::MONTH_1);
+        resampler.subscribe(Timeframe::WEEK_1);
+        resampler.subscribe(Timeframe::WEEK_1);
+        check(resampler.timeframes() == std::vector<Timeframe>({Timeframe::WEEK_1, Timeframe::MONTH_1}),
+              "订阅按周期从小到大排列，重复订阅忽略");
+        std::vector<Closed> closed = feed(resampler, bars);
+
+        std::vector<Closed> weeks = only(closed, Timeframe::WEEK_1);
+        // 第一周 01-22 ~ 01-28 只有 4 根（周四到周日），之后每周 7 根
+        bool weeks_ok = weeks.size() == 10 && weeks[0].bar.timestamp == JAN_22_2024 && weeks[0].at == 3 &&
+                        aggregates(weeks[0].bar, bars, 0, 3);
+        for (size_t w = 1; weeks_ok && w < weeks.size(); w++) {
+            size_t first = 4 + (w - 1) * 7;
+            weeks_ok = weeks[w].bar.timestamp == JAN_22_2024 + static_cast<Timestamp>(w) * 7 * DAY &&
+                       weeks[w].at == first + 6 && weeks[w].bar.timeframe == Timeframe::WEEK_1 &&
+                       aggregates(weeks[w].bar, bars, first, first + 6);
+        }
+        check(weeks_ok, "周线：时间戳为周一零点，在周日的日线收盘时交付，OHLCV 为该周日线的聚合");
+
+        std::vector<Closed> months = only(closed, Timeframe::MONTH_1);
+        check(months.size() == 3, "月线：1、2、3 月各交付一次");
+        if (months.size() == 3) {
+            check(months[0].bar.timestamp == JAN_01_2024 && months[0].at == 6 && aggregates(months[0].bar, bars, 0, 6),
+                  "1 月：时间戳为 01-01，只含 01-25 ~ 01-31 的 7 根，在 01-31 收盘时交付");
+            check(months[1].bar.timestamp == FEB_01_2024 && months[1].at == 35 &&
+                  aggregates(months[1].bar, bars, 7, 35) && months[1].bar.volume == 29.0,
+                  "2 月（闰年）：29 根，在 02-29 收盘时交付");
+            check(months[2].bar.timestamp == MAR_01_2024 && months[2].at == 66 && aggregates(months[2].bar, bars, 36, 66),
+                  "3 月：31 根，在 03-31 收盘时交付");
+        }
+
+        // 2024-03-31 是周日：周线与月线在同一根日线上收盘，按周期从小到大交付
+        bool ordered = false;
+        for (size_t i = 0; i + 1 < closed.size(); i++) {
+            if (closed[i].at == 66 && closed[i + 1].at == 66) {
+                ordered = closed[i].timeframe == Timeframe::WEEK_1 && closed[i + 1].timeframe == Timeframe::MONTH_1;
+            }
+        }
+        check(ordered, "同时收盘：先交付周线，再交付月线");
+
+        const OHLCV* april = resampler.partial(Timeframe::MONTH_1);
+        check(april && april->timestamp == MAR_01_2024 + 31 * DAY && april->volume == 3.0,
+              "未收盘的 4 月只能通过 partial 查看（3 根），不会交付");
+    }
+
+    // 3. 数据跳过周边界：下一根K线到达时上一周收盘，不包含该K线
+    {
+        const Timestamp sunday_22 = JAN_01_2024 + 6 * DAY + 22 * HOUR;
+        std::vector<OHLCV> bars = {
+            make_bar(JAN_01_2024 + 6 * DAY + 21 * HOUR, Timeframe::HOUR_1, 10.0),
+            make_bar(sunday_22, Timeframe::HOUR_1, 11.0),                  // 周日最后一根缺失
+            make_bar(JAN_01_2024 + 7 * DAY + 2 * HOUR, Timeframe::HOUR_1, 12.0),
+        };
+        BarResampler resampler;
+        resampler.subscribe(Timeframe::WEEK_1);
+        std::vector<Closed> closed = feed(resampler, bars);
+        check(closed.size() == 1 && closed[0].at == 2 && closed[0].bar.timestamp == JAN_01_2024 &&
+              aggregates(closed[0].bar, bars, 0, 1), "缺少周日 23:00：下周一的K线到达时交付上一周，只含两根");
+        check(resampler.partial(Timeframe::WEEK_1) &&
+              resampler.partial(Timeframe::WEEK_1)->timestamp == JAN_01_2024 + 7 * DAY,
+              "下周一的K线开始新的一周");
+    }
+
+    // 4. 1970 年之前：1969-12-25 ~ 1970-01-06 的日线
+    {
+        std::vector<OHLCV> bars;
+        for (int64_t d = -7; d <= 5; d++) bars.push_back(make_bar(d * DAY, Timeframe::DAY_1, 50.0 + d));
+        BarResampler resampler;
+        resampler.subscribe(Timeframe::WEEK_1);
+        resampler.subscribe(Timeframe::MONTH_1);
+        std::vector<Closed> closed = feed(resampler, bars);
+        std::vector<Closed> weeks = only(closed, Timeframe::WEEK_1);
+        std::vector<Closed> months = only(closed, Timeframe::MONTH_1);
+        check(weeks.size() == 2 && weeks[0].bar.timestamp == -10 * DAY && aggregates(weeks[0].bar, bars, 0, 3) &&
+              weeks[1].bar.timestamp == -3 * DAY && aggregates(weeks[1].bar, bars, 4, 10),
+              "周线：1969-12-22 周（4 根）与 1969-12-29 周（跨年 7 根）");
+        check(months.size() == 1 && months[0].bar.timestamp == -31 * DAY && months[0].at == 6 &&
+              aggregates(months[0].bar, bars, 0, 6), "月线：1969-12 在 12-31 收盘时交付");
+    }
+
+    // 5. 订阅周期小于基础周期：抛出 invalid_argument
+    {
+        BarResampler resampler;
+        resampler.subscribe(Timeframe::HOUR_1);
+        bool threw = false;
+        try {
+            resampler.update(make_bar(0, Timeframe::DAY_1, 1.0), [](Timeframe, const OHLCV&) {});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        check(threw, "1h 订阅、日线输入：抛出 invalid_argument");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
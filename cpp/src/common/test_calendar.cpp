@@ -0,0 +1,152 @@
+/**
+ * @file test_calendar.cpp
+ * @brief UTC 日历运算测试（离线）：日/周/月/年边界、闰年规则、1970年之前的时间戳
+ */
+
+#include "common/calendar.h"
+#include <iostream>
+#include <string>
+
+using namespace quant_crypto;
+using namespace quant_crypto::calendar;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+// 对照实现：按规则判断闰年与月份天数，不使用被测的换算公式
+static bool is_leap(int64_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static unsigned days_in_month(int64_t year, unsigned month) {
+    static const unsigned days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && is_leap(year) ? 29 : days[month - 1];
+}
+
+static bool same_date(const CivilDate& d, int64_t year, unsigned month, unsigned day) {
+    return d.year == year && d.month == month && d.day == day;
+}
+
+int main() {
+    std::cout << "========== 日历运算测试 ==========\n" << std::endl;
+
+    // 1. 已知日期
+    {
+        check(days_from_civil(1970, 1, 1) == 0 && days_from_civil(1969, 12, 31) == -1 &&
+              days_from_civil(2000, 1, 1) == 10957 && days_from_civil(1900, 1, 1) == -25567,
+              "1970-01-01 = 0，1969-12-31 = -1，2000-01-01 = 10957，1900-01-01 = -25567");
+        check(from_civil(2024, 1, 1) == 1704067200000 && from_civil(1969, 12, 1) == -31 * MS_PER_DAY,
+              "from_civil：2024-01-01 与 1969-12-01 的毫秒时间戳");
+        check(same_date(to_civil(-1), 1969, 12, 31) && same_date(to_civil(0), 1970, 1, 1) &&
+              same_date(to_civil(-MS_PER_DAY), 1969, 12, 31) && same_date(to_civil(-MS_PER_DAY - 1), 1969, 12, 30),
+              "to_civil：-1ms 属于 1969-12-31，-1天-1ms 属于 1969-12-30");
+        check(floor_div(-1, 7) == -1 && floor_div(-7, 7) == -1 && floor_div(-8, 7) == -2 && floor_div(6, 7) == 0,
+              "floor_div：负数向下取整");
+    }
+
+    // 2. 闰年：能被4整除且不能被100整除，或能被400整除
+    {
+        check(days_from_civil(2000, 3, 1) - days_from_civil(2000, 2, 28) == 2, "2000 年是闰年（能被400整除）");
+        check(days_from_civil(1900, 3, 1) - days_from_civil(1900, 2, 28) == 1, "1900 年不是闰年（能被100整除）");
+        check(days_from_civil(2100, 3, 1) - days_from_civil(2100, 2, 28) == 1, "2100 年不是闰年");
+        check(days_from_civil(2024, 3, 1) - days_from_civil(2024, 2, 28) == 2 &&
+              days_from_civil(2023, 3, 1) - days_from_civil(2023, 2, 28) == 1, "2024 年是闰年，2023 年不是");
+        check(same_date(civil_from_days(days_from_civil(1600, 2, 29)), 1600, 2, 29), "1600-02-29 往返一致");
+    }
+
+    // 3. 逐日遍历 1600-01-01 ~ 2400-12-31：天数与日期互换和对照实现一致
+    {
+        int64_t year = 1600;
+        unsigned month = 1, day = 1;
+        bool ok = true;
+        int64_t days = days_from_civil(1600, 1, 1);
+        int64_t count = 0;
+        while (ok && year <= 2400) {
+            ok = days_from_civil(year, month, day) == days && same_date(civil_from_days(days), year, month, day);
+            days++;
+            count++;
+            if (++day > days_in_month(year, month)) {
+                day = 1;
+                if (++month > 12) {
+                    month = 1;
+                    year++;
+                }
+            }
+        }
+        check(ok && count == 801 * 365 + 195, "1600 ~ 2400 年共 " + std::to_string(count) + " 天逐日互换正确");
+    }
+
+    // 4. 日/周/月/年的起止时间（含 1970 年之前）
+    {
+        bool days_ok = true, weeks_ok = true, months_ok = true, years_ok = true;
+        for (int64_t d = days_from_civil(1960, 1, 1); d <= days_from_civil(1980, 12, 31); d++) {
+            // 每天取三个时刻：零点、中午、23:59:59.999
+            for (int64_t offset : {int64_t(0), 12 * MS_PER_HOUR, MS_PER_DAY - 1}) {
+                Timestamp ts = d * MS_PER_DAY + offset;
+                Timestamp start = 0, end = 0;
+                CivilDate date = civil_from_days(d);
+
+                period_bounds(Period::DAY, ts, start, end);
+                days_ok = days_ok && start == d * MS_PER_DAY && end == start + MS_PER_DAY && day_start(ts) == start;
+
+                // 周一：距 1970-01-05 的天数是 7 的倍数
+                period_bounds(Period::WEEK, ts, start, end);
+                int64_t monday = start / MS_PER_DAY;
+                weeks_ok = weeks_ok && start % MS_PER_DAY == 0 && floor_div(monday - 4, 7) * 7 == monday - 4 &&
+                           start <= ts && ts < end && end - start == MS_PER_WEEK && week_start(ts) == start;
+
+                period_bounds(Period::MONTH, ts, start, end);
+                months_ok = months_ok && start == from_civil(date.year, date.month, 1) &&
+                            end - start == static_cast<int64_t>(days_in_month(date.year, date.month)) * MS_PER_DAY &&
+                            month_start(ts) == start;
+
+                period_bounds(Period::YEAR, ts, start, end);
+                years_ok = years_ok && start == from_civil(date.year, 1, 1) &&
+                           end - start == (is_leap(date.year) ? 366 : 365) * MS_PER_DAY && year_start(ts) == start;
+            }
+        }
+        check(days_ok, "日：1960 ~ 1980 每天的零点、中午、最后一毫秒都落在 [零点, 次日零点)");
+        check(weeks_ok, "周：从周一开始，跨 1970-01-01 的周为 [1969-12-29, 1970-01-05)");
+        check(months_ok, "月：从1日开始，长度与对照的月份天数一致（含闰年二月）");
+        check(years_ok, "年：从1月1日开始，闰年 366 天");
+
+        Timestamp start = 0, end = 0;
+        period_bounds(Period::WEEK, 0, start, end);
+        check(start == -3 * MS_PER_DAY && end == 4 * MS_PER_DAY, "1970-01-01（周四）所在周从 1969-12-29 开始");
+        period_bounds(Period::MONTH, -1, start, end);
+        check(start == -31 * MS_PER_DAY && end == 0, "1969-12-31 23:59:59.999 所在月为 [1969-12-01, 1970-01-01)");
+    }
+
+    // 5. PeriodCursor：只在跨过边界时进入新周期
+    {
+        PeriodCursor cursor(Period::MONTH);
+        size_t entered = 0;
+        for (int64_t d = days_from_civil(1969, 11, 15); d < days_from_civil(1970, 3, 15); d++) {
+            if (cursor.advance(d * MS_PER_DAY + 5 * MS_PER_HOUR)) entered++;
+        }
+        check(entered == 5 && cursor.start() == from_civil(1970, 3, 1) && cursor.end() == from_civil(1970, 4, 1),
+              "按日遍历 1969-11-15 ~ 1970-03-14：进入 5 个月");
+        check(!cursor.advance(from_civil(1970, 3, 31)) && cursor.advance(from_civil(1970, 4, 1)),
+              "月末仍在本月，下月1日零点进入新周期");
+        cursor.reset();
+        check(cursor.advance(from_civil(1970, 4, 2)), "reset 后第一次 advance 返回 true");
+    }
+
+    // 6. 年化换算
+    {
+        check(years_between(0, static_cast<Timestamp>(MS_PER_YEAR)) == 1.0 &&
+              years_between(from_civil(2024, 1, 1), from_civil(2025, 1, 1)) == 366.0 / 365.25,
+              "years_between：按 365.25 天/年");
+        check(periods_per_year(Timeframe::DAY_1) == 365.25 && periods_per_year(Timeframe::HOUR_1) == 365.25 * 24 &&
+              periods_per_year(Timeframe::MONTH_1) == 12.0 && periods_per_year(Timeframe::TICK) == 0.0,
+              "periods_per_year：日线 365.25，小时线 8766，月线 12，TICK 为0");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,253 @@
+/**
+ * @file test_rolling_median.cpp
+ * @brief 滑动中位数 / MAD 与稳健异常检测规则测试（离线，随机数据与暴力排序对照）
+ */
+
+#include "common/rolling_median.h"
+#include "cleaners/data_cleaner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::cleaners;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+// 排序求中位数
+static double brute_median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n % 2 == 1 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+static double brute_mad(const std::vector<double>& values) {
+    double m = brute_median(values);
+    std::vector<double> deviations;
+    for (double v : values) deviations.push_back(std::abs(v - m));
+    return brute_median(deviations);
+}
+
+/**
+ * @brief 随机数据逐个推入，每步与暴力排序比较，返回不一致的步数
+ * @param levels 取值个数（越小重复值越多）
+ */
+static size_t compare_with_brute(size_t window, size_t steps, int levels, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> pick(0, levels - 1);
+    RollingMedian rolling(window);
+    std::deque<double> recent;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < steps; i++) {
+        // 半整数：中位数与偏差都可精确表示
+        double value = pick(rng) * 0.5;
+        rolling.push(value);
+        recent.push_back(value);
+        if (recent.size() > window) recent.pop_front();
+
+        std::vector<double> values(recent.begin(), recent.end());
+        if (rolling.size() != values.size() ||
+            rolling.median() != brute_median(values) ||
+            rolling.mad() != brute_mad(values)) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static OHLCV make_bar(Timestamp ts, Price close, Volume volume) {
+    OHLCV bar;
+    bar.timestamp = ts;
+    bar.symbol = "BTCUSDT";
+    bar.exchange = "binance";
+    bar.open = close;
+    bar.high = close;
+    bar.low = close;
+    bar.close = close;
+    bar.volume = volume;
+    return bar;
+}
+
+int main() {
+    std::cout << "========== 滑动中位数 / MAD 测试 ==========\n" << std::endl;
+
+    // 1. 与暴力排序对照：窗口 1/2/3/100，大量重复值
+    for (size_t window : {1, 2, 3, 100}) {
+        size_t ties = compare_with_brute(window, 5000, 4, static_cast<unsigned>(window));
+        size_t spread = compare_with_brute(window, 5000, 1000, static_cast<unsigned>(window) + 7);
+        check(ties == 0, "窗口 " + std::to_string(window) + "：重复值多的数据与排序结果一致");
+        check(spread == 0, "窗口 " + std::to_string(window) + "：取值分散的数据与排序结果一致");
+    }
+
+    // 2. 边界：空窗口、全部相同、清空后复用
+    {
+        RollingMedian rolling(5);
+        check(std::isnan(rolling.median()) && std::isnan(rolling.mad()), "空窗口返回 NaN");
+        for (int i = 0; i < 8; i++) rolling.push(3.0);
+        check(rolling.full() && rolling.median() == 3.0 && rolling.mad() == 0.0, "全部相同：中位数为该值，MAD 为0");
+        rolling.clear();
+        rolling.push(1.0);
+        rolling.push(4.0);
+        check(rolling.size() == 2 && rolling.median() == 2.5 && rolling.mad() == 1.5, "清空后重新计算");
+    }
+
+    // 3. 跳表：删除不存在的值、按名次访问
+    {
+        IndexableSkipList list(4);
+        list.insert(2.0);
+        list.insert(1.0);
+        list.insert(2.0);
+        check(!list.erase(5.0) && list.size() == 3, "删除不存在的值返回 false");
+        check(list.erase(2.0) && list.size() == 2 && list.at(0) == 1.0 && list.at(1) == 2.0,
+              "重复值只删除一个");
+        bool threw = false;
+        try {
+            RollingMedian invalid(0);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        check(threw, "窗口为0抛出 invalid_argument");
+    }
+
+    // 4. 跳表的中间节点：随机插入、删除（含重复值与删除中间节点本身）后与按名次查找一致
+    {
+        std::mt19937 rng(9);
+        std::uniform_int_distribution<int> pick(0, 9);
+        IndexableSkipList list(64);
+        std::vector<double> values;
+        bool ok = true;
+        for (size_t step = 0; ok && step < 20000; step++) {
+            bool grow = values.empty() || (values.size() < 64 && rng() % 2 == 0);
+            if (grow) {
+                double value = pick(rng);
+                list.insert(value);
+                values.push_back(value);
+            } else {
+                size_t index = rng() % values.size();
+                ok = list.erase(values[index]);
+                values.erase(values.begin() + static_cast<std::ptrdiff_t>(index));
+            }
+            size_t n = list.size();
+            if (n > 0) {
+                ok = ok && list.lower_middle() == list.at((n - 1) / 2) && list.upper_middle() == list.at(n / 2);
+            }
+        }
+        check(ok, "随机插入/删除 20000 次：lower_middle/upper_middle 与 at((n-1)/2)、at(n/2) 一致");
+    }
+
+    std::cout << "\n========== 稳健异常检测规则 ==========\n" << std::endl;
+
+    // 5. 收益率尖峰：噪声有界（均匀分布），阈值以下不会误报
+    {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> noise(-0.001, 0.001);
+        std::vector<OHLCV> bars;
+        std::vector<size_t> price_spikes;
+        std::vector<size_t> volume_spikes;
+        double price = 100.0;
+        for (size_t i = 0; i < 3000; i++) {
+            double ret = noise(rng);
+            // 前 min_samples 根内的尖峰不判断
+            if (i % 400 == 200 || i == 5) {
+                ret = 0.02;
+                if (i != 5) price_spikes.push_back(i);
+            }
+            price *= std::exp(ret);
+            double volume = 10.0 + 100.0 * noise(rng);
+            if (i % 400 == 300) {
+                volume = 100.0;
+                volume_spikes.push_back(i);
+            }
+            bars.push_back(make_bar(static_cast<Timestamp>(i) * 60000, price, volume));
+        }
+
+        auto flagged = [](const std::vector<OHLCV>& data) {
+            std::vector<size_t> indices;
+            for (size_t i = 0; i < data.size(); i++) {
+                if (data[i].quality == DataQuality::SUSPICIOUS) indices.push_back(i);
+            }
+            return indices;
+        };
+
+        DataCleaner returns;
+        returns.add_rule(std::make_shared<RobustOutlierRule>(OutlierTarget::LOG_RETURN, 100, 5.0, 20));
+        std::vector<OHLCV> cleaned = returns.clean_ohlcv_batch(bars);
+        check(cleaned.size() == bars.size(), "收益率：可疑K线保留，不删除");
+        // 尖峰之后价格停在新水平，下一根收益率正常，不应被连带标记
+        check(flagged(cleaned) == price_spikes, "收益率：只标记注入的价格尖峰");
+
+        DataCleaner per_bar;
+        per_bar.add_rule(std::make_shared<RobustOutlierRule>(OutlierTarget::LOG_RETURN, 100, 5.0, 20));
+        CleaningContext context = per_bar.create_context();
+        std::vector<OHLCV> one_by_one = bars;
+        for (auto& bar : one_by_one) per_bar.clean_ohlcv(bar, context);
+        check(flagged(one_by_one) == price_spikes, "收益率：逐根清洗与批量清洗结果一致");
+
+        DataCleaner volumes;
+        volumes.add_rule(std::make_shared<RobustOutlierRule>(OutlierTarget::VOLUME, 100, 5.0, 20));
+        check(flagged(volumes.clean_ohlcv_batch(bars)) == volume_spikes, "成交量：只标记注入的成交量尖峰");
+    }
+
+    // 6. 吞吐量（单核，只输出不断言）
+    //    逐个值：先 median + mad 判断再 push，与 RobustOutlierRule 每根K线的工作相同
+    {
+        std::mt19937 rng(1);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        const size_t n = 2000000;
+        std::vector<double> values(n);
+        for (double& v : values) v = noise(rng);
+        for (size_t window : {20, 100, 1000}) {
+            RollingMedian rolling(window);
+            size_t outliers = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (double v : values) {
+                if (rolling.size() > 0 && std::abs(v - rolling.median()) > 5.0 * 1.4826 * rolling.mad()) outliers++;
+                rolling.push(v);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "   RollingMedian（w = " << window << "）: "
+                      << static_cast<long long>(seconds / n * 1e9) << " ns/次，"
+                      << static_cast<long long>(n / seconds / 1e3) << "K 次/秒，超过 5σ " << outliers << " 个"
+                      << std::endl;
+        }
+
+        // 实时逐根清洗：500 个交易对交错，每根K线查找该流的内部上下文后应用收益率与成交量两条规则
+        const size_t symbols = 500, rounds = 2000;
+        std::vector<OHLCV> ticks;
+        ticks.reserve(symbols * rounds);
+        std::vector<double> prices(symbols, 100.0);
+        for (size_t r = 0; r < rounds; r++) {
+            for (size_t k = 0; k < symbols; k++) {
+                prices[k] *= std::exp(0.001 * noise(rng));
+                OHLCV bar = make_bar(static_cast<Timestamp>(r) * 60000, prices[k], 10.0 + std::abs(noise(rng)));
+                bar.symbol = "SYM" + std::to_string(k);
+                ticks.push_back(bar);
+            }
+        }
+        DataCleaner cleaner;
+        cleaner.add_rule(std::make_shared<RobustOutlierRule>(OutlierTarget::LOG_RETURN, 100, 5.0, 20));
+        cleaner.add_rule(std::make_shared<RobustOutlierRule>(OutlierTarget::VOLUME, 100, 5.0, 20));
+        auto start = std::chrono::steady_clock::now();
+        for (OHLCV& bar : ticks) cleaner.clean_ohlcv(bar);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "   逐根清洗（" << symbols << " 个交易对，两条规则，w = 100）: "
+                  << static_cast<long long>(seconds / ticks.size() * 1e9) << " ns/根，"
+                  << static_cast<long long>(ticks.size() / seconds / 1e3) << "K 根/秒" << std::endl;
+        check(cleaner.stream_count() == symbols, "每个交易对一个上下文");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
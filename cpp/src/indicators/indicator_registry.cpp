@@ -0,0 +1,71 @@
+#include "indicators/indicator_registry.h"
+#include <stdexcept>
+
+namespace quant_crypto {
+namespace indicators {
+
+IndicatorRegistry::Handle IndicatorRegistry::add(Kind kind, int period) {
+    if (period <= 0) {
+        throw std::invalid_argument("IndicatorRegistry: 周期必须大于0");
+    }
+    for (Handle i = 0; i < entries_.size(); i++) {
+        if (entries_[i].kind == kind && entries_[i].period == period) return i;
+    }
+    if (bar_count_ > 0) {
+        throw std::logic_error("IndicatorRegistry: 已开始更新后不能注册新指标");
+    }
+
+    Entry entry;
+    entry.kind = kind;
+    entry.period = period;
+    entry.ready = false;
+    entry.value = 0.0;
+    entry.alpha = 2.0 / (period + 1);
+    entries_.push_back(entry);
+    if (static_cast<size_t>(period) > max_period_) max_period_ = static_cast<size_t>(period);
+    return entries_.size() - 1;
+}
+
+void IndicatorRegistry::reset() {
+    closes_.clear();
+    bar_count_ = 0;
+    for (Entry& entry : entries_) {
+        entry.ready = false;
+        entry.value = 0.0;
+    }
+}
+
+double IndicatorRegistry::window_sum(int period) const {
+    double sum = 0.0;
+    size_t last = closes_.size() - 1;
+    for (int j = 0; j < period; j++) {
+        sum += closes_[last - j];
+    }
+    return sum;
+}
+
+void IndicatorRegistry::update(const OHLCV& bar) {
+    closes_.push_back(bar.close);
+    if (closes_.size() > max_period_) closes_.pop_front();
+    bar_count_++;
+
+    for (Entry& entry : entries_) {
+        size_t period = static_cast<size_t>(entry.period);
+        if (bar_count_ < period) continue;
+
+        if (entry.kind == Kind::SMA) {
+            entry.value = window_sum(entry.period) / entry.period;
+        } else if (!entry.ready) {
+            // EMA 第一个值使用SMA（从旧到新累加，与 calculate_ema 相同）
+            double sum = 0.0;
+            for (size_t i = closes_.size() - period; i < closes_.size(); i++) sum += closes_[i];
+            entry.value = sum / entry.period;
+        } else {
+            entry.value = entry.alpha * bar.close + (1 - entry.alpha) * entry.value;
+        }
+        entry.ready = true;
+    }
+}
+
+} // namespace indicators
+} // namespace quant_crypto
@@ -0,0 +1,210 @@
+/**
+ * @file test_indicator_registry.cpp
+ * @brief 共享指标测试（离线）：IndicatorRegistry 与 TechnicalIndicators 逐位一致，
+ *        多策略引擎共享指标时每个策略的结果与单独回测一致，引擎销毁时解除引用
+ */
+
+#include "indicators/indicator_registry.h"
+#include "indicators/technical_indicators.h"
+#include "backtest/multi_strategy_engine.h"
+#include "strategy/ma_cross_strategy.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::indicators;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static std::vector<OHLCV> make_bars(size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    std::vector<OHLCV> bars;
+    double price = 100.0;
+    for (size_t i = 0; i < n; i++) {
+        OHLCV bar;
+        bar.timestamp = static_cast<Timestamp>(i) * 60000;
+        bar.symbol = "BTCUSDT";
+        bar.open = price;
+        bar.close = price * std::exp(noise(rng));
+        bar.high = std::max(bar.open, bar.close) * 1.002;
+        bar.low = std::min(bar.open, bar.close) * 0.998;
+        bar.volume = 1.0;
+        price = bar.close;
+        bars.push_back(bar);
+    }
+    return bars;
+}
+
+/**
+ * @brief 记录最近一次 set_indicator_registry 收到的指针
+ */
+class RecordingStrategy : public strategy::MACrossStrategy {
+public:
+    explicit RecordingStrategy(const strategy::MACrossConfig& config) : MACrossStrategy(config) {}
+
+    void set_indicator_registry(IndicatorRegistry* registry) override {
+        attached = registry;
+        MACrossStrategy::set_indicator_registry(registry);
+    }
+
+    IndicatorRegistry* attached = nullptr;
+};
+
+static strategy::MACrossConfig ma_config(int fast, int slow) {
+    strategy::MACrossConfig config;
+    config.fast_period = fast;
+    config.slow_period = slow;
+    return config;
+}
+
+static bool same_result(const backtest::BacktestResult& a, const backtest::BacktestResult& b) {
+    if (a.trades.size() != b.trades.size()) return false;
+    for (size_t i = 0; i < a.trades.size(); i++) {
+        if (a.trades[i].timestamp != b.trades[i].timestamp || a.trades[i].price != b.trades[i].price ||
+            a.trades[i].quantity != b.trades[i].quantity || a.trades[i].pnl != b.trades[i].pnl) {
+            return false;
+        }
+    }
+    return a.equity_curve == b.equity_curve && a.final_equity == b.final_equity;
+}
+
+int main() {
+    std::cout << "========== 共享指标测试 ==========\n" << std::endl;
+
+    std::vector<OHLCV> bars = make_bars(3000, 21);
+    std::vector<double> closes;
+    for (const auto& bar : bars) closes.push_back(bar.close);
+
+    // 1. 每根K线的 SMA/EMA 与 calculate_ma/calculate_ema 对应位置逐位相同
+    {
+        IndicatorRegistry registry;
+        const std::vector<int> periods = {1, 5, 20, 60};
+        std::vector<IndicatorRegistry::Handle> sma, ema;
+        for (int p : periods) {
+            sma.push_back(registry.sma(p));
+            ema.push_back(registry.ema(p));
+        }
+        std::vector<std::vector<double>> expected_sma, expected_ema;
+        for (int p : periods) {
+            expected_sma.push_back(TechnicalIndicators::calculate_ma(closes, p));
+            expected_ema.push_back(TechnicalIndicators::calculate_ema(closes, p));
+        }
+
+        bool ready_ok = true, sma_ok = true, ema_ok = true;
+        for (size_t i = 0; i < bars.size(); i++) {
+            registry.update(bars[i]);
+            for (size_t k = 0; k < periods.size(); k++) {
+                size_t period = static_cast<size_t>(periods[k]);
+                bool should_be_ready = i + 1 >= period;
+                ready_ok = ready_ok && registry.ready(sma[k]) == should_be_ready &&
+                           registry.ready(ema[k]) == should_be_ready;
+                if (!should_be_ready) {
+                    ready_ok = ready_ok && registry.value(sma[k]) == 0.0 && registry.value(ema[k]) == 0.0;
+                    continue;
+                }
+                sma_ok = sma_ok && registry.value(sma[k]) == expected_sma[k][i + 1 - period];
+                ema_ok = ema_ok && registry.value(ema[k]) == expected_ema[k][i + 1 - period];
+            }
+        }
+        check(ready_ok, "K线数达到周期前未就绪（值为0），之后就绪");
+        check(sma_ok, "SMA(1/5/20/60) 与 calculate_ma 逐位相同");
+        check(ema_ok, "EMA(1/5/20/60) 与 calculate_ema 逐位相同");
+        check(registry.bar_count() == bars.size(), "bar_count 为输入的K线数");
+
+        registry.reset();
+        check(registry.bar_count() == 0 && !registry.ready(sma[0]) && registry.size() == 8,
+              "reset：清空历史，保留已注册的指标");
+    }
+
+    // 2. 注册：相同指标只注册一次；开始更新后不能注册新指标
+    {
+        IndicatorRegistry registry;
+        IndicatorRegistry::Handle a = registry.sma(20);
+        IndicatorRegistry::Handle b = registry.add(IndicatorRegistry::Kind::SMA, 20);
+        IndicatorRegistry::Handle c = registry.ema(20);
+        check(a == b && a != c && registry.size() == 2, "SMA(20) 重复注册返回同一句柄，EMA(20) 是不同指标");
+
+        bool threw_period = false, threw_late = false;
+        try {
+            registry.sma(0);
+        } catch (const std::invalid_argument&) {
+            threw_period = true;
+        }
+        registry.update(bars[0]);
+        check(registry.sma(20) == a, "开始更新后查询已有指标仍返回句柄");
+        try {
+            registry.sma(30);
+        } catch (const std::logic_error&) {
+            threw_late = true;
+        }
+        check(threw_period && threw_late, "周期 <= 0 抛出 invalid_argument；更新后注册新指标抛出 logic_error");
+    }
+
+    // 3. 多策略共享指标：每个策略的结果与单独回测一致，相同的均线只注册一次
+    {
+        const std::vector<strategy::MACrossConfig> configs = {
+            ma_config(5, 20), ma_config(10, 20), ma_config(5, 60), ma_config(5, 20)};
+        backtest::BacktestConfig config;
+
+        std::vector<backtest::BacktestResult> expected;
+        for (const auto& c : configs) {
+            strategy::MACrossStrategy alone(c);
+            backtest::BacktestEngine engine(config);
+            engine.set_strategy(&alone);
+            engine.set_data(OHLCVSeries(bars));
+            engine.run();
+            expected.push_back(engine.take_result());
+        }
+
+        std::vector<strategy::MACrossStrategy> strategies(configs.begin(), configs.end());
+        backtest::MultiStrategyEngine multi(config);
+        for (auto& s : strategies) multi.add_strategy(&s);
+        multi.set_data(OHLCVSeries(bars));
+        multi.run();
+
+        bool all_same = expected[0].total_trades > 10;
+        for (size_t i = 0; i < configs.size(); i++) all_same = all_same && same_result(multi.get_result(i), expected[i]);
+        check(all_same, "4 个策略：交易与权益曲线与单独回测一致");
+        check(multi.indicators().size() == 4, "SMA 5/10/20/60 各注册一次");
+        check(strategies[0].get_fast_ma() == TechnicalIndicators::calculate_ma(closes, 5).back() &&
+              strategies[2].get_slow_ma() == TechnicalIndicators::calculate_ma(closes, 60).back(),
+              "策略取到的最新均线与 calculate_ma 相同");
+    }
+
+    // 4. 引擎销毁时解除策略对注册表的引用，策略之后可以单独回测
+    {
+        RecordingStrategy strategy(ma_config(5, 20));
+        {
+            backtest::MultiStrategyEngine multi(backtest::BacktestConfig{});
+            multi.add_strategy(&strategy);
+            check(strategy.attached == &multi.indicators(), "添加策略：指向引擎的注册表");
+            multi.set_data(OHLCVSeries(bars));
+            multi.run();
+        }
+        check(strategy.attached == nullptr, "引擎销毁：set_indicator_registry(nullptr)");
+
+        RecordingStrategy fresh(ma_config(5, 20));
+        std::vector<OHLCV> later = make_bars(500, 22);
+        for (const auto& bar : later) {
+            strategy.on_bar(bar);
+            fresh.on_bar(bar);
+        }
+        check(strategy.get_fast_ma() == fresh.get_fast_ma() && strategy.get_slow_ma() == fresh.get_slow_ma(),
+              "解除后自行计算均线，与从未共享的策略相同");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
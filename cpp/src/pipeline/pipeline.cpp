@@ -0,0 +1,177 @@
+#include "pipeline/pipeline.h"
+#include "common/parallel_for.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <stdexcept>
+
+namespace quant_crypto {
+namespace pipeline {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void record(StageStats& stats, size_t bars_in, size_t bars_out, double seconds) {
+    stats.batches++;
+    stats.bars_in += bars_in;
+    stats.bars_out += bars_out;
+    stats.seconds += seconds;
+}
+
+const char* const LOAD_STAGE = "load";
+
+} // namespace
+
+bool VectorSource::next(std::vector<OHLCV>& bars, size_t max_bars) {
+    size_t count = std::min(max_bars, bars_->size() - offset_);
+    bars.insert(bars.end(), bars_->begin() + offset_, bars_->begin() + offset_ + count);
+    offset_ += count;
+    return offset_ < bars_->size();
+}
+
+void StageStats::merge(const StageStats& other) {
+    batches += other.batches;
+    bars_in += other.bars_in;
+    bars_out += other.bars_out;
+    seconds += other.seconds;
+}
+
+Pipeline::Pipeline(SourceFactory source, size_t threads, size_t max_batch_bars)
+    : source_(std::move(source)), threads_(resolve_threads(threads)), max_batch_bars_(max_batch_bars) {
+    if (!source_) {
+        throw std::invalid_argument("Pipeline: 数据源为空");
+    }
+    if (max_batch_bars_ == 0) {
+        throw std::invalid_argument("Pipeline: 每批K线数必须大于0");
+    }
+}
+
+Pipeline& Pipeline::add_stage(std::shared_ptr<Stage> stage, const std::vector<std::string>& inputs) {
+    if (!stage) {
+        throw std::invalid_argument("Pipeline: 阶段为空");
+    }
+    std::vector<std::string> names = stage_names();
+    if (std::find(names.begin(), names.end(), stage->name()) != names.end()) {
+        throw std::invalid_argument("Pipeline: 阶段名重复 " + stage->name());
+    }
+
+    Node node;
+    node.stage = std::move(stage);
+    if (inputs.empty()) {
+        node.inputs.push_back(nodes_.size());   // 上一个阶段（没有时为 load）
+    }
+    for (const auto& input : inputs) {
+        auto it = std::find(names.begin(), names.end(), input);
+        if (it == names.end()) {
+            throw std::invalid_argument("Pipeline: 上游阶段不存在 " + input);
+        }
+        size_t index = static_cast<size_t>(it - names.begin());
+        if (std::find(node.inputs.begin(), node.inputs.end(), index) != node.inputs.end()) {
+            throw std::invalid_argument("Pipeline: 上游阶段重复 " + input);
+        }
+        node.inputs.push_back(index);
+    }
+    nodes_.push_back(std::move(node));
+    return *this;
+}
+
+std::vector<std::string> Pipeline::stage_names() const {
+    std::vector<std::string> names;
+    names.reserve(nodes_.size() + 1);
+    names.push_back(LOAD_STAGE);
+    for (const auto& node : nodes_) names.push_back(node.stage->name());
+    return names;
+}
+
+ShardReport Pipeline::run_shard(const ShardInfo& shard) const {
+    Clock::time_point shard_start = Clock::now();
+    ShardReport report;
+    report.shard = shard;
+    for (const auto& name : stage_names()) report.stages.emplace_back(name);
+
+    // 每个节点输出的最后一个使用者：它直接取走缓冲区，其他使用者复制
+    std::vector<size_t> last_consumer(nodes_.size() + 1, 0);
+    for (size_t i = 0; i < nodes_.size(); i++) {
+        for (size_t input : nodes_[i].inputs) last_consumer[input] = i + 1;
+    }
+
+    try {
+        std::unique_ptr<ShardSource> source = source_(shard);
+        if (!source) {
+            throw std::runtime_error("Pipeline: 数据源为空");
+        }
+
+        std::vector<std::unique_ptr<StageState>> states;
+        states.reserve(nodes_.size());
+        for (const auto& node : nodes_) states.push_back(node.stage->create_state(shard));
+
+        // 每个节点一个缓冲区，批次之间复用
+        std::vector<ShardBatch> batches;
+        batches.reserve(nodes_.size() + 1);
+        for (size_t i = 0; i <= nodes_.size(); i++) batches.emplace_back(shard);
+
+        bool more = true;
+        while (more) {
+            ShardBatch& load = batches[0];
+            load.bars.clear();
+            Clock::time_point start = Clock::now();
+            more = source->next(load.bars, max_batch_bars_);
+            load.last = !more;
+            record(report.stages[0], load.bars.size(), load.bars.size(), seconds_since(start));
+
+            for (size_t i = 0; i < nodes_.size(); i++) {
+                ShardBatch& batch = batches[i + 1];
+                batch.bars.clear();
+                batch.last = load.last;
+                for (size_t input : nodes_[i].inputs) {
+                    std::vector<OHLCV>& from = batches[input].bars;
+                    if (last_consumer[input] != i + 1) {
+                        batch.bars.insert(batch.bars.end(), from.begin(), from.end());
+                    } else if (batch.bars.empty()) {
+                        batch.bars.swap(from);
+                    } else {
+                        batch.bars.insert(batch.bars.end(), std::make_move_iterator(from.begin()),
+                                          std::make_move_iterator(from.end()));
+                    }
+                }
+
+                size_t bars_in = batch.bars.size();
+                start = Clock::now();
+                nodes_[i].stage->process(batch, states[i].get());
+                record(report.stages[i + 1], bars_in, batch.bars.size(), seconds_since(start));
+            }
+        }
+    } catch (const std::exception& e) {
+        report.ok = false;
+        report.error = e.what();
+    }
+
+    report.seconds = seconds_since(shard_start);
+    return report;
+}
+
+PipelineReport Pipeline::run(const std::vector<ShardInfo>& shards) const {
+    Clock::time_point start = Clock::now();
+    PipelineReport report;
+    report.shards.resize(shards.size());
+
+    parallel_for(shards.size(), threads_, [&](size_t i) {
+        report.shards[i] = run_shard(shards[i]);
+    });
+
+    for (const auto& name : stage_names()) report.stages.emplace_back(name);
+    for (const auto& shard : report.shards) {
+        if (!shard.ok) report.failed++;
+        for (size_t s = 0; s < shard.stages.size(); s++) report.stages[s].merge(shard.stages[s]);
+    }
+    report.seconds = seconds_since(start);
+    return report;
+}
+
+} // namespace pipeline
+} // namespace quant_crypto
@@ -0,0 +1,230 @@
+#include "pipeline/stages.h"
+#include "normalizers/data_normalizer.h"
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace quant_crypto {
+namespace pipeline {
+
+namespace {
+
+struct CleanState : StageState {
+    cleaners::CleaningContext context;
+};
+
+// 存储阶段：分片独占的输出文件
+struct StoreState : StageState {
+    std::string path;
+    std::ofstream out;
+};
+
+// 上一批留下的最后一根K线
+struct CarryState : StageState {
+    bool has_bar = false;
+    OHLCV bar;
+};
+
+} // namespace
+
+// ========== 标准化 ==========
+
+NormalizeStage::NormalizeStage(int price_precision, int volume_precision, bool normalize_symbol, bool drop_invalid)
+    : Stage("normalize"),
+      price_precision_(price_precision),
+      volume_precision_(volume_precision),
+      normalize_symbol_(normalize_symbol),
+      drop_invalid_(drop_invalid) {}
+
+void NormalizeStage::process(ShardBatch& batch, StageState* state) const {
+    (void)state;
+    // 与 DataNormalizer::normalize_price/normalize_volume 相同的取整，倍数每批只算一次
+    const double price_multiplier = std::pow(10.0, price_precision_);
+    const double volume_multiplier = std::pow(10.0, volume_precision_);
+    auto round_to = [](double value, double multiplier) { return std::round(value * multiplier) / multiplier; };
+
+    std::vector<OHLCV>& bars = batch.bars;
+    std::string raw_symbol;
+    std::string normalized_symbol;
+    size_t out = 0;
+    for (size_t i = 0; i < bars.size(); i++) {
+        OHLCV& bar = bars[i];
+        bar.open = round_to(bar.open, price_multiplier);
+        bar.high = round_to(bar.high, price_multiplier);
+        bar.low = round_to(bar.low, price_multiplier);
+        bar.close = round_to(bar.close, price_multiplier);
+        bar.volume = round_to(bar.volume, volume_multiplier);
+        bar.quote_volume = round_to(bar.quote_volume, volume_multiplier);
+
+        if (normalize_symbol_) {
+            if (bar.symbol != raw_symbol) {
+                raw_symbol = bar.symbol;
+                normalized_symbol = normalizers::DataNormalizer::normalize_symbol(bar.symbol, bar.exchange);
+            }
+            bar.symbol = normalized_symbol;
+        }
+
+        if (drop_invalid_ && !normalizers::DataNormalizer::validate_ohlcv(bar)) continue;
+        if (out != i) bars[out] = std::move(bar);
+        out++;
+    }
+    bars.erase(bars.begin() + out, bars.end());
+}
+
+// ========== 清洗 ==========
+
+CleanStage::CleanStage(std::shared_ptr<const cleaners::DataCleaner> cleaner)
+    : Stage("clean"), cleaner_(std::move(cleaner)) {
+    if (!cleaner_) {
+        throw std::invalid_argument("CleanStage: 清洗器为空");
+    }
+}
+
+std::unique_ptr<StageState> CleanStage::create_state(const ShardInfo& shard) const {
+    (void)shard;
+    auto state = std::make_unique<CleanState>();
+    state->context = cleaner_->create_context();
+    return state;
+}
+
+void CleanStage::process(ShardBatch& batch, StageState* state) const {
+    if (batch.bars.empty()) return;
+    auto* clean = static_cast<CleanState*>(state);
+    batch.bars = cleaner_->clean_ohlcv_batch(batch.bars, clean->context);
+}
+
+// ========== 去重 ==========
+
+DedupStage::DedupStage(cleaners::DuplicatePolicy policy) : Stage("dedup"), policy_(policy) {}
+
+std::unique_ptr<StageState> DedupStage::create_state(const ShardInfo& shard) const {
+    (void)shard;
+    return std::make_unique<CarryState>();
+}
+
+void DedupStage::process(ShardBatch& batch, StageState* state) const {
+    auto* carry = static_cast<CarryState*>(state);
+    std::vector<OHLCV>& bars = batch.bars;
+    if (carry->has_bar) {
+        bars.insert(bars.begin(), std::move(carry->bar));
+        carry->has_bar = false;
+    }
+    if (bars.empty()) return;
+
+    bars = cleaners::DataCleaner::deduplicate(bars, policy_);
+    // 最后一根留到下一批：下一批开头与它时间戳相同的K线按策略合并
+    if (!batch.last) {
+        carry->bar = std::move(bars.back());
+        carry->has_bar = true;
+        bars.pop_back();
+    }
+}
+
+// ========== 填补 ==========
+
+FillStage::FillStage(cleaners::FillMethod method, size_t max_gap_bars)
+    : Stage("fill"), method_(method), max_gap_bars_(max_gap_bars) {}
+
+std::unique_ptr<StageState> FillStage::create_state(const ShardInfo& shard) const {
+    (void)shard;
+    return std::make_unique<CarryState>();
+}
+
+void FillStage::process(ShardBatch& batch, StageState* state) const {
+    std::vector<OHLCV>& bars = batch.bars;
+    if (bars.empty()) return;
+
+    auto* carry = static_cast<CarryState*>(state);
+    // 带上上一批的最后一根，批次之间的缺口同样被填补；它已经输出过，填补后去掉
+    bool carried = carry->has_bar;
+    if (carried) bars.insert(bars.begin(), carry->bar);
+    std::vector<OHLCV> filled = cleaners::DataCleaner::fill_missing(
+        bars, batch.shard.timeframe, method_, nullptr, max_gap_bars_);
+    if (carried) filled.erase(filled.begin());
+
+    carry->bar = filled.back();
+    carry->has_bar = true;
+    bars.swap(filled);
+}
+
+// ========== 存储 ==========
+
+StoreStage::StoreStage(const std::string& data_dir) : Stage("store"), data_dir_(data_dir) {
+    std::error_code ec;
+    std::filesystem::create_directories(data_dir_, ec);
+    if (ec) {
+        throw std::runtime_error("StoreStage: 无法创建目录 " + data_dir_ + ": " + ec.message());
+    }
+}
+
+std::string StoreStage::path_for(const ShardInfo& shard) const {
+    auto safe = [](std::string name) {
+        for (char& c : name) {
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '.') c = '_';
+        }
+        return name;
+    };
+    std::string name = safe(shard.exchange) + "_" + safe(shard.symbol) + "_" + timeframe_to_string(shard.timeframe);
+    return (std::filesystem::path(data_dir_) / (name + ".csv")).string();
+}
+
+std::unique_ptr<StageState> StoreStage::create_state(const ShardInfo& shard) const {
+    (void)shard;
+    return std::make_unique<StoreState>();
+}
+
+void StoreStage::process(ShardBatch& batch, StageState* state) const {
+    auto* store = static_cast<StoreState*>(state);
+    std::string timeframe = timeframe_to_string(batch.shard.timeframe);
+
+    // 第一批：清空重写，重复运行不会产生重复行
+    if (!store->out.is_open()) {
+        store->path = path_for(batch.shard);
+        store->out.open(store->path, std::ios::out | std::ios::trunc);
+        if (!store->out.is_open()) {
+            throw std::runtime_error("StoreStage: 无法打开 " + store->path);
+        }
+        store->out << "timestamp,symbol,exchange,timeframe,open,high,low,close,volume,quote_volume,trades_count,quality\n";
+        store->out << std::fixed << std::setprecision(8);
+    }
+
+    std::ofstream& out = store->out;
+    for (const auto& bar : batch.bars) {
+        out << bar.timestamp << ','
+            << bar.symbol << ','
+            << bar.exchange << ','
+            << timeframe << ','
+            << bar.open << ','
+            << bar.high << ','
+            << bar.low << ','
+            << bar.close << ','
+            << bar.volume << ','
+            << bar.quote_volume << ','
+            << bar.trades_count << ','
+            << static_cast<int>(bar.quality) << '\n';
+    }
+
+    if (batch.last) out.close();
+    if (!out) {
+        throw std::runtime_error("StoreStage: 写入失败 " + store->path);
+    }
+}
+
+// ========== 自定义 ==========
+
+FunctionStage::FunctionStage(std::string name, Function fn) : Stage(std::move(name)), fn_(std::move(fn)) {
+    if (!fn_) {
+        throw std::invalid_argument("FunctionStage: 函数为空");
+    }
+}
+
+void FunctionStage::process(ShardBatch& batch, StageState* state) const {
+    (void)state;
+    fn_(batch);
+}
+
+} // namespace pipeline
+} // namespace quant_crypto
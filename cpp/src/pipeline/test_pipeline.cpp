@@ -0,0 +1,316 @@
+/**
+ * @file test_pipeline.cpp
+ * @brief 分片流水线测试（离线）：小批次去重/填补与整段处理一致，阶段统计、
+ *        有向无环图的分叉与汇合、分片状态隔离与失败隔离
+ */
+
+#include "pipeline/pipeline.h"
+#include "pipeline/stages.h"
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace quant_crypto;
+using namespace quant_crypto::pipeline;
+using cleaners::DataCleaner;
+using cleaners::DuplicatePolicy;
+using cleaners::FillMethod;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& name) {
+    std::cout << (condition ? "✅ " : "❌ ") << name << std::endl;
+    if (!condition) failures++;
+}
+
+static const Timestamp MINUTE = 60000;
+static const size_t BATCH = 7;
+
+static bool same_bar(const OHLCV& a, const OHLCV& b) {
+    return a.timestamp == b.timestamp && a.symbol == b.symbol && a.exchange == b.exchange &&
+           a.open == b.open && a.high == b.high && a.low == b.low && a.close == b.close &&
+           a.volume == b.volume && a.quality == b.quality;
+}
+
+static bool same_bars(const std::vector<OHLCV>& a, const std::vector<OHLCV>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (!same_bar(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+static OHLCV make_bar(const std::string& symbol, Timestamp ts, double price) {
+    OHLCV bar;
+    bar.timestamp = ts;
+    bar.symbol = symbol;
+    bar.exchange = "binance";
+    bar.timeframe = Timeframe::MINUTE_1;
+    bar.open = price;
+    bar.close = price + 0.5;
+    bar.high = price + 1.0;
+    bar.low = price - 1.0;
+    bar.volume = 1.0;
+    return bar;
+}
+
+/**
+ * @brief 按时间排序的原始K线：随机重复（内容不同，区分 KEEP_FIRST/KEEP_LAST）与缺口，
+ *        并在批次边界上放置重复、跨越多批的重复串和缺口
+ */
+static std::vector<OHLCV> make_raw(const std::string& symbol, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dice(0, 9);
+    std::vector<OHLCV> raw;
+    Timestamp ts = 0;
+    double price = 100.0 + seed;
+    while (raw.size() < 600) {
+        int roll = dice(rng);
+        size_t copies = roll == 0 ? 2 : roll == 1 ? 3 : 1;
+        // 下一根落在批次末尾时强制重复，重复对跨越边界
+        if ((raw.size() + 1) % (3 * BATCH) == 0) copies = 2;
+        for (size_t c = 0; c < copies; c++) raw.push_back(make_bar(symbol, ts, price + c * 0.25));
+        price += 0.1;
+        ts += MINUTE * (dice(rng) == 0 ? 1 + dice(rng) % 4 : 1);
+        // 下一根落在批次开头时制造缺口，缺口跨越边界
+        if (raw.size() % (5 * BATCH) == 0) ts += 3 * MINUTE;
+    }
+    // 跨越多批的重复串
+    for (size_t c = 0; c < 3 * BATCH; c++) raw.push_back(make_bar(symbol, ts, price + c));
+    raw.push_back(make_bar(symbol, ts + 5 * MINUTE, price));
+    return raw;
+}
+
+// 在批次边界两侧：第 k 批的最后一根与第 k+1 批的第一根时间戳相同 / 相差超过一个周期
+static void count_boundaries(const std::vector<OHLCV>& raw, size_t& duplicates, size_t& gaps) {
+    duplicates = gaps = 0;
+    for (size_t i = BATCH; i < raw.size(); i += BATCH) {
+        if (raw[i].timestamp == raw[i - 1].timestamp) duplicates++;
+        if (raw[i].timestamp - raw[i - 1].timestamp > MINUTE) gaps++;
+    }
+}
+
+/**
+ * @brief 收集各分片最终输出的阶段（并发调用，按交易对加锁写入）
+ */
+class Collector {
+public:
+    std::shared_ptr<Stage> stage(const std::string& name) {
+        return std::make_shared<FunctionStage>(name, [this](ShardBatch& batch) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& out = bars_[batch.shard.symbol];
+            out.insert(out.end(), batch.bars.begin(), batch.bars.end());
+            if (batch.last) finished_[batch.shard.symbol]++;
+        });
+    }
+
+    std::map<std::string, std::vector<OHLCV>> bars_;
+    std::map<std::string, int> finished_;
+
+private:
+    std::mutex mutex_;
+};
+
+static SourceFactory make_source(const std::map<std::string, std::shared_ptr<const std::vector<OHLCV>>>& data) {
+    return [data](const ShardInfo& shard) -> std::unique_ptr<ShardSource> {
+        auto it = data.find(shard.symbol);
+        if (it == data.end()) throw std::runtime_error("no data for " + shard.symbol);
+        return std::make_unique<VectorSource>(it->second);
+    };
+}
+
+int main() {
+    std::cout << "========== 分片流水线测试 ==========\n" << std::endl;
+
+    const std::vector<std::string> symbols = {"BTCUSDT", "ETHUSDT", "SOLUSDT", "BNBUSDT", "XRPUSDT"};
+    std::map<std::string, std::shared_ptr<const std::vector<OHLCV>>> data;
+    std::vector<ShardInfo> shards;
+    for (size_t i = 0; i < symbols.size(); i++) {
+        data[symbols[i]] = std::make_shared<const std::vector<OHLCV>>(make_raw(symbols[i], 11 + i));
+        shards.emplace_back("binance", symbols[i], Timeframe::MINUTE_1);
+    }
+
+    // 1. 小批次：去重 + 填补与整段 deduplicate + fill_missing 一致，阶段统计与删除/新增数一致
+    {
+        size_t duplicates = 0, gaps = 0;
+        count_boundaries(*data["BTCUSDT"], duplicates, gaps);
+        check(duplicates > 0 && gaps > 0, "测试数据：重复与缺口跨越批次边界");
+
+        struct Case {
+            DuplicatePolicy policy;
+            FillMethod method;
+            size_t max_gap;
+            size_t threads;
+            std::string name;
+        };
+        const std::vector<Case> cases = {
+            {DuplicatePolicy::KEEP_FIRST, FillMethod::FORWARD, 0, 1, "KEEP_FIRST/FORWARD/1线程"},
+            {DuplicatePolicy::KEEP_LAST, FillMethod::INTERPOLATE, 0, 4, "KEEP_LAST/INTERPOLATE/4线程"},
+            {DuplicatePolicy::KEEP_FIRST, FillMethod::BACKWARD, 2, 3, "KEEP_FIRST/BACKWARD/最大缺口2/3线程"},
+        };
+        for (const auto& c : cases) {
+            Collector collector;
+            Pipeline pipeline(make_source(data), c.threads, BATCH);
+            pipeline.add_stage(std::make_shared<DedupStage>(c.policy))
+                .add_stage(std::make_shared<FillStage>(c.method, c.max_gap))
+                .add_stage(collector.stage("collect"));
+            PipelineReport report = pipeline.run(shards);
+
+            bool all_match = report.failed == 0;
+            size_t raw_total = 0, dropped = 0, added = 0;
+            for (const auto& symbol : symbols) {
+                const std::vector<OHLCV>& raw = *data[symbol];
+                std::vector<OHLCV> deduped = DataCleaner::deduplicate(raw, c.policy);
+                std::vector<OHLCV> expected = DataCleaner::fill_missing(
+                    deduped, Timeframe::MINUTE_1, c.method, nullptr, c.max_gap);
+                all_match = all_match && same_bars(collector.bars_[symbol], expected) &&
+                            collector.finished_[symbol] == 1;
+                raw_total += raw.size();
+                dropped += raw.size() - deduped.size();
+                added += expected.size() - deduped.size();
+            }
+            check(all_match, c.name + "：每个分片的输出与整段处理一致");
+
+            const StageStats& load = report.stages[0];
+            const StageStats& dedup = report.stages[1];
+            const StageStats& fill = report.stages[2];
+            check(load.bars_out == raw_total && dedup.bars_in == raw_total &&
+                  dedup.dropped() == dropped && dedup.added() == 0 &&
+                  fill.added() == added && fill.dropped() == 0 && dropped > 0 && added > 0,
+                  c.name + "：去重删除数、填补新增数与整段处理一致");
+            bool shard_batches = true;
+            for (const auto& shard : report.shards) {
+                size_t expected_batches = (data[shard.shard.symbol]->size() + BATCH - 1) / BATCH;
+                shard_batches = shard_batches && shard.stages[0].batches == expected_batches;
+            }
+            check(shard_batches && load.batches > 5 * symbols.size(), c.name + "：按 max_batch_bars 分批读取");
+        }
+    }
+
+    // 2. 分叉与汇合：load 同时输入 a、b，合并阶段按声明顺序拼接；复制的输入不被下游修改
+    {
+        Collector collector;
+        Pipeline pipeline(make_source(data), 2, BATCH);
+        pipeline
+            .add_stage(std::make_shared<FunctionStage>("a", [](ShardBatch& batch) {
+                for (auto& bar : batch.bars) bar.close += 1000.0;
+            }))
+            .add_stage(std::make_shared<FunctionStage>("b", [](ShardBatch& batch) {
+                for (auto& bar : batch.bars) bar.close *= 2.0;
+                if (!batch.bars.empty()) batch.bars.pop_back();
+            }), {"load"})
+            .add_stage(std::make_shared<FunctionStage>("c", [](ShardBatch& batch) {
+                for (auto& bar : batch.bars) bar.volume = 7.0;
+            }), {"a"})
+            .add_stage(std::make_shared<FunctionStage>("merge", [](ShardBatch&) {}), {"b", "a", "c"})
+            .add_stage(collector.stage("collect"));
+        check(pipeline.stage_names() == std::vector<std::string>({"load", "a", "b", "c", "merge", "collect"}),
+              "阶段名按添加顺序（拓扑顺序）");
+        PipelineReport report = pipeline.run(shards);
+
+        // 逐批构造期望：b(load) + a(load) + c(a(load))
+        bool all_match = report.failed == 0;
+        for (const auto& symbol : symbols) {
+            const std::vector<OHLCV>& raw = *data[symbol];
+            std::vector<OHLCV> expected;
+            for (size_t begin = 0; begin < raw.size(); begin += BATCH) {
+                std::vector<OHLCV> batch(raw.begin() + begin, raw.begin() + std::min(raw.size(), begin + BATCH));
+                std::vector<OHLCV> a = batch, b = batch, c;
+                for (auto& bar : a) bar.close += 1000.0;
+                for (auto& bar : b) bar.close *= 2.0;
+                b.pop_back();
+                c = a;
+                for (auto& bar : c) bar.volume = 7.0;
+                expected.insert(expected.end(), b.begin(), b.end());
+                expected.insert(expected.end(), a.begin(), a.end());
+                expected.insert(expected.end(), c.begin(), c.end());
+            }
+            all_match = all_match && same_bars(collector.bars_[symbol], expected);
+        }
+        check(all_match, "分叉：a、b 各自拿到未被修改的 load 输出；汇合：按 {b, a, c} 顺序拼接");
+
+        const StageStats& merge = report.stages[4];
+        check(merge.bars_in == report.stages[1].bars_out + report.stages[2].bars_out + report.stages[3].bars_out &&
+              merge.bars_in == 3 * report.stages[0].bars_out - report.stages[2].dropped(),
+              "汇合阶段的输入数为各上游输出之和");
+    }
+
+    // 3. 分片状态隔离：同一组阶段对象并发处理多个分片，每个分片与单独运行一致
+    {
+        Collector together;
+        Pipeline pipeline(make_source(data), 4, BATCH);
+        pipeline.add_stage(std::make_shared<DedupStage>()).add_stage(std::make_shared<FillStage>())
+            .add_stage(together.stage("collect"));
+        pipeline.run(shards);
+
+        bool isolated = true;
+        for (const auto& shard : shards) {
+            Collector alone;
+            Pipeline single(make_source(data), 1, BATCH);
+            single.add_stage(std::make_shared<DedupStage>()).add_stage(std::make_shared<FillStage>())
+                .add_stage(alone.stage("collect"));
+            single.run({shard});
+            isolated = isolated && same_bars(together.bars_[shard.symbol], alone.bars_[shard.symbol]);
+        }
+        check(isolated, "4线程 5个分片：每个分片的输出与单独运行一致");
+    }
+
+    // 4. 失败隔离：数据源或阶段抛出异常只影响该分片
+    {
+        std::vector<ShardInfo> with_bad = shards;
+        with_bad.emplace_back("binance", "MISSING", Timeframe::MINUTE_1);
+        Collector collector;
+        Pipeline pipeline(make_source(data), 3, BATCH);
+        pipeline.add_stage(std::make_shared<FunctionStage>("explode", [](ShardBatch& batch) {
+                if (batch.shard.symbol == "ETHUSDT" && batch.last) throw std::runtime_error("boom");
+            }))
+            .add_stage(std::make_shared<DedupStage>())
+            .add_stage(collector.stage("collect"));
+        PipelineReport report = pipeline.run(with_bad);
+
+        check(report.failed == 2 && !report.shards[1].ok && report.shards[1].error == "boom" &&
+              !report.shards[5].ok && report.shards[5].error == "no data for MISSING",
+              "失败的分片：ok = false，记录异常信息");
+        bool others = true;
+        for (size_t i = 0; i < shards.size(); i++) {
+            if (i == 1) continue;
+            const std::string& symbol = shards[i].symbol;
+            others = others && report.shards[i].ok && report.shards[i].shard.symbol == symbol &&
+                     same_bars(collector.bars_[symbol], DataCleaner::deduplicate(*data[symbol]));
+        }
+        check(others, "其他分片正常完成，报告顺序与输入一致");
+    }
+
+    // 5. 参数校验
+    {
+        bool threw_batch = false, threw_name = false, threw_input = false;
+        try {
+            Pipeline(make_source(data), 1, 0);
+        } catch (const std::invalid_argument&) {
+            threw_batch = true;
+        }
+        Pipeline pipeline(make_source(data), 1, BATCH);
+        pipeline.add_stage(std::make_shared<DedupStage>());
+        try {
+            pipeline.add_stage(std::make_shared<DedupStage>());
+        } catch (const std::invalid_argument&) {
+            threw_name = true;
+        }
+        try {
+            pipeline.add_stage(std::make_shared<FillStage>(), {"clean"});
+        } catch (const std::invalid_argument&) {
+            threw_input = true;
+        }
+        check(threw_batch && threw_name && threw_input, "max_batch_bars 为0、阶段名重复、上游不存在：抛出 invalid_argument");
+    }
+
+    std::cout << "\n========== 测试完成：" << (failures == 0 ? "全部通过" : "存在失败")
+              << " ==========" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -16,7 +16,11 @@ namespace strategy{
         }
 
         // 4.更新MA值
-        update_ma();
+        if (registry_) {
+            update_ma_shared();
+        } else {
+            update_ma();
+        }
 
         //5. 如果有持仓，更新当前价格
         if(position_.has_position()){
@@ -35,6 +39,20 @@ namespace strategy{
         return "MA Cross Strategy";
     }
 
+    std::unique_ptr<StrategyBase> MACrossStrategy::clone() const {
+        auto copy = std::make_unique<MACrossStrategy>(*this);
+        copy->registry_ = nullptr;   // 副本自行计算均线（价格历史始终维护）
+        return copy;
+    }
+
+    void MACrossStrategy::set_indicator_registry(indicators::IndicatorRegistry* registry) {
+        registry_ = registry;
+        if (registry) {
+            fast_handle_ = registry->sma(config_.fast_period);
+            slow_handle_ = registry->sma(config_.slow_period);
+        }
+    }
+
     double MACrossStrategy::get_fast_ma() const {
         return fast_ma_.empty() ? 0 : fast_ma_.back();
     }
@@ -67,6 +85,17 @@ namespace strategy{
         }
     }
 
+    void MACrossStrategy::update_ma_shared() {
+        // 共享指标已按本根K线更新，只取最新值
+        if (registry_->ready(fast_handle_)) push_ma(fast_ma_, registry_->value(fast_handle_));
+        if (registry_->ready(slow_handle_)) push_ma(slow_ma_, registry_->value(slow_handle_));
+    }
+
+    void MACrossStrategy::push_ma(std::vector<double>& values, double value) {
+        values.push_back(value);
+        if (values.size() > 2) values.erase(values.begin());   // 只保留2个
+    }
+
     Signal MACrossStrategy::detect_cross(){
         // 1. 检查是否有足够数据（需要至少2个MA值）
         if(fast_ma_.size() < 2 || slow_ma_.size() < 2) return Signal::NONE;
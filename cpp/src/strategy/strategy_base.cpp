@@ -1,5 +1,6 @@
 #include "strategy/strategy_base.h"
 #include <string>
+#include <algorithm>
 #include<iostream>
 
 namespace quant_crypto{
@@ -9,6 +10,7 @@ namespace strategy{
     void StrategyBase::on_init(double initial_capital) {
         capital_ = initial_capital;          // 当前资金
         initial_capital_ = initial_capital;  // 保存初始值（用于计算收益率）
+        order_requests_.clear();
     }
 
     // open_position- 开仓
@@ -55,39 +57,65 @@ namespace strategy{
         return pnl;  // 返回盈利
     }
 
-    // 总权益： 资金+持仓市值
-    double StrategyBase::get_total_equity() const {
-        double equity = capital_;
-        if(position_.has_position()) {
-            equity += position_.quantity * position_.current_price;
-        }
-        return equity;
-    }
-
     // 收益率
     double StrategyBase::get_total_return() const {
         if(initial_capital_ == 0)  return 0;
         return (get_total_equity() - initial_capital_) / initial_capital_ * 100.0;
     }
 
-    // 更新持仓价格
-    void StrategyBase::update_position_price(double current_price){
-        position_.current_price = current_price;
-        if (position_.has_position()) {
-            position_.unrealized_pnl = (current_price - position_.avg_price) * position_.quantity;
-        }
+    void StrategyBase::add_trade(const Trade& trade) {
+        trades_.push_back(trade);
     }
 
-    double StrategyBase::get_capital() const {
-        return capital_;
+    // ========= 订单接口 =========
+    OrderId StrategyBase::submit_order(Side side, OrderType type, double quantity,
+                                       Price price, Price stop_price, int64_t oco_group) {
+        OrderRequest request;
+        request.cancel = false;
+        request.order.id = next_order_id_++;
+        request.order.side = side;
+        request.order.type = type;
+        request.order.quantity = quantity;
+        request.order.price = price;
+        request.order.stop_price = stop_price;
+        request.order.oco_group = oco_group;
+        order_requests_.push_back(request);
+        return request.order.id;
     }
-    
-    Position StrategyBase::get_position() const {
-        return position_;
+
+    OrderId StrategyBase::buy_limit(Price price, double quantity) {
+        return submit_order(Side::BUY, OrderType::LIMIT, quantity, price);
     }
-    
-    void StrategyBase::add_trade(const Trade& trade) {
-        trades_.push_back(trade);
+
+    OrderId StrategyBase::buy_stop(Price stop_price, double quantity) {
+        return submit_order(Side::BUY, OrderType::STOP_MARKET, quantity, 0.0, stop_price);
+    }
+
+    OrderId StrategyBase::stop_loss(Price stop_price, int64_t oco_group) {
+        return submit_order(Side::SELL, OrderType::STOP_MARKET, 0.0, 0.0, stop_price, oco_group);
+    }
+
+    OrderId StrategyBase::take_profit(Price price, int64_t oco_group) {
+        return submit_order(Side::SELL, OrderType::LIMIT, 0.0, price, 0.0, oco_group);
+    }
+
+    void StrategyBase::cancel_order(OrderId id) {
+        OrderRequest request;
+        request.cancel = true;
+        request.order.id = id;
+        order_requests_.push_back(request);
+    }
+
+    std::vector<OrderRequest> StrategyBase::take_order_requests() {
+        std::vector<OrderRequest> requests;
+        requests.swap(order_requests_);
+        return requests;
+    }
+
+    void StrategyBase::subscribe_timeframe(Timeframe timeframe) {
+        if (std::find(timeframes_.begin(), timeframes_.end(), timeframe) == timeframes_.end()) {
+            timeframes_.push_back(timeframe);
+        }
     }
 
 }
@@ -3,6 +3,10 @@
 提供策略回测和性能分析接口
 """
 
+import os
+import time
+from collections import OrderedDict
+
 from fastapi import APIRouter, HTTPException
 from pydantic import BaseModel, Field
 from typing import List, Optional
@@ -19,6 +23,57 @@ except ImportError:
 
 router = APIRouter()
 
+# ========== 缓存 ==========
+# 回测结果缓存：以 K线内容 + 策略参数 + 回测配置 的哈希寻址
+# BACKTEST_CACHE_DIR 非空时，被淘汰的结果写入该目录
+_result_cache = qcc.BacktestResultCache(
+    int(os.environ.get("BACKTEST_CACHE_SIZE", "64")),
+    os.environ.get("BACKTEST_CACHE_DIR", "")
+)
+
+# K线短期缓存：同一 (symbol, interval, limit) 在有效期内不重复请求交易所
+# 按最近使用排序，写入时清除过期项，条目数超过上限时淘汰最久未用的
+_KLINE_CACHE_TTL_SECONDS = 5.0
+_KLINE_CACHE_MAX_ENTRIES = int(os.environ.get("KLINE_CACHE_SIZE", "32"))
+_kline_cache = OrderedDict()
+
+
+def _store_klines(cache_key, now: float, series):
+    """写入K线缓存：先清除过期项，再按 LRU 限制条目数"""
+    expired = [key for key, (fetched_at, _) in _kline_cache.items()
+               if now - fetched_at >= _KLINE_CACHE_TTL_SECONDS]
+    for key in expired:
+        del _kline_cache[key]
+    _kline_cache[cache_key] = (now, series)
+    _kline_cache.move_to_end(cache_key)
+    while len(_kline_cache) > max(_KLINE_CACHE_MAX_ENTRIES, 1):
+        _kline_cache.popitem(last=False)
+
+
+def _fetch_klines(symbol: str, interval: str, limit: int):
+    """获取K线（带短期缓存），返回 OHLCVSeries；失败时返回 (None, 错误信息)"""
+    cache_key = (symbol, interval, limit)
+    cached = _kline_cache.get(cache_key)
+    now = time.monotonic()
+    if cached is not None and now - cached[0] < _KLINE_CACHE_TTL_SECONDS:
+        _kline_cache.move_to_end(cache_key)
+        return cached[1], ""
+
+    binance_config = qcc.BinanceConfig()
+    binance_config.base_url = "https://api.binance.com"
+    binance_config.proxy_enabled = False
+    binance_config.timeout_ms = 10000
+
+    collector = qcc.BinanceCollector(binance_config)
+    klines_result = collector.get_klines(symbol, interval, limit)
+    if not klines_result.success or len(klines_result.data) == 0:
+        return None, klines_result.error_message
+
+    # 转为共享只读序列：哈希与回测都直接引用同一份数据
+    series = qcc.OHLCVSeries(klines_result.data)
+    _store_klines(cache_key, now, series)
+    return series, ""
+
 
 # ========== 请求模型 ==========
 class BacktestRequest(BaseModel):
@@ -111,49 +166,50 @@ async def run_backtest(request: BacktestRequest):
     
     try:
         # ========== 1. 获取历史数据 ==========
-        binance_config = qcc.BinanceConfig()
-        binance_config.base_url = "https://api.binance.com"
-        binance_config.proxy_enabled = False
-        binance_config.timeout_ms = 10000
-        
-        collector = qcc.BinanceCollector(binance_config)
-        klines_result = collector.get_klines(request.symbol, request.interval, request.limit)
-        
-        if not klines_result.success or len(klines_result.data) == 0:
+        klines, error_message = _fetch_klines(request.symbol, request.interval, request.limit)
+        if klines is None:
             raise HTTPException(
                 status_code=400,
-                detail=f"获取K线数据失败: {klines_result.error_message}"
+                detail=f"获取K线数据失败: {error_message}"
             )
         
-        # ========== 2. 创建策略 ==========
-        strategy_config = qcc.MACrossConfig()
-        strategy_config.fast_period = request.fast_period
-        strategy_config.slow_period = request.slow_period
-        strategy_config.position_size = request.position_size
-        
-        strategy = qcc.MACrossStrategy(strategy_config)
-        
-        # ========== 3. 运行回测 ==========
+        # ========== 2. 查询结果缓存 ==========
         backtest_config = qcc.BacktestConfig()
         backtest_config.initial_capital = request.initial_capital
         backtest_config.commission_rate = request.commission_rate
         backtest_config.slippage_rate = request.slippage_rate
         
-        engine = qcc.BacktestEngine(backtest_config)
-        engine.set_strategy(strategy)
-        engine.set_data(klines_result.data)
-        engine.run()
+        strategy_params = {
+            "fast_period": float(request.fast_period),
+            "slow_period": float(request.slow_period),
+            "position_size": float(request.position_size),
+        }
+        cache_key = qcc.BacktestResultCache.make_key(
+            klines, request.strategy_name, strategy_params, backtest_config
+        )
+        cached = _result_cache.find(cache_key)
         
-        backtest_result = engine.get_result()
+        if cached is None:
+            # ========== 3. 创建策略并运行回测 ==========
+            strategy_config = qcc.MACrossConfig()
+            strategy_config.fast_period = request.fast_period
+            strategy_config.slow_period = request.slow_period
+            strategy_config.position_size = request.position_size
+            
+            strategy = qcc.MACrossStrategy(strategy_config)
+            
+            engine = qcc.BacktestEngine(backtest_config)
+            engine.set_strategy(strategy)
+            engine.set_data(klines)
+            engine.run()
+            
+            # ========== 4. 性能分析 ==========
+            analyzer = qcc.PerformanceAnalyzer()
+            metrics = analyzer.analyze(engine.get_result())
+            cached = _result_cache.put(cache_key, engine.take_result(), metrics)
         
-        # ========== 4. 性能分析 ==========
-        analyzer = qcc.PerformanceAnalyzer()
-        metrics = analyzer.analyze(
-            backtest_result.equity_curve,
-            backtest_result.timestamps,
-            backtest_result.trades,
-            request.initial_capital
-        )
+        backtest_result = cached.result
+        metrics = cached.metrics
         
         # ========== 5. 构造响应 ==========
         trades_info = []